@@ -0,0 +1,250 @@
+#include <benchmark/benchmark.h>
+
+#include <Engine/Components/SkeletonAnimator.h>
+#include <Engine/Components/Renderable.h>
+#include <Engine/Components/Transform.h>
+#include <Engine/Utils/singleton.h>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+using namespace Component;
+using namespace Engine::Graphics;
+using Engine::ECS::Entity;
+
+/*
+* Crowd of characters sharing one looping clip, skeletons sized like Mixamo rigs.
+* Every joint has a translation and a rotation channel.
+*/
+struct crowd_scene
+{
+	static unsigned int constexpr JOINT_COUNT = 65;
+	static unsigned int constexpr KEYFRAME_COUNT = 60;
+
+	crowd_scene(size_t _character_count)
+	{
+		animation_handle const animation = clip_animation();
+
+		Singleton<TransformManager>().Clear();
+		Singleton<SkinManager>().Clear();
+		Singleton<SkeletonAnimatorManager>().Clear();
+
+		animation_pose bind_pose;
+		bind_pose.resize(JOINT_COUNT);
+		animation_leaf_node leaf;
+		leaf.set_animation(animation);
+
+		unsigned int id = 0;
+		auto create_entity = [&id]()
+		{
+			Entity e;
+			e.m_id = id++;
+			e.m_counter = 0;
+			return e;
+		};
+
+		std::vector<Transform> joints(JOINT_COUNT);
+		for (size_t c = 0; c < _character_count; c++)
+		{
+			for (unsigned int j = 0; j < JOINT_COUNT; j++)
+			{
+				joints[j] = Singleton<TransformManager>().Create(create_entity());
+				if (j != 0)
+					joints[j].SetParent(joints[j - 1].Owner(), false);
+			}
+
+			Entity const character = create_entity();
+			Singleton<SkinManager>().Create(character).SetSkeletonInstanceNodes(joints);
+			SkeletonAnimator animator = Singleton<SkeletonAnimatorManager>().Create(character);
+			animator.SetBindPose(bind_pose);
+			animator.SetAnimation(leaf);
+			animator.SetPaused(false);
+		}
+	}
+
+	~crowd_scene()
+	{
+		Singleton<SkeletonAnimatorManager>().Clear();
+		Singleton<SkinManager>().Clear();
+		Singleton<TransformManager>().Clear();
+	}
+
+	static animation_handle clip_animation()
+	{
+		static animation_handle const animation = create_animation();
+		return animation;
+	}
+
+	static animation_data const& compressed_clip_animation()
+	{
+		static animation_data const compressed = []()
+		{
+			animation_data animation = *Singleton<ResourceManager>().FindAnimationData(clip_animation());
+			compress_animation(animation, animation_compression_settings());
+			return animation;
+		}();
+		return compressed;
+	}
+
+	static animation_handle create_animation()
+	{
+		auto& res_mgr = Singleton<ResourceManager>();
+		float const duration = 2.0f;
+
+		animation_interpolation_handle const input_handle = res_mgr.m_anim_interpolation_handle_counter++;
+		std::vector<float>& keyframes = res_mgr.m_anim_interpolation_data_map[input_handle].m_data;
+		for (unsigned int k = 0; k < KEYFRAME_COUNT; k++)
+			keyframes.push_back(duration * (float)k / (float)(KEYFRAME_COUNT - 1));
+
+		auto add_channel = [&](animation_data& _animation, uint8_t _joint, animation_channel_data::E_target_path _path)
+		{
+			animation_interpolation_handle const output_handle = res_mgr.m_anim_interpolation_handle_counter++;
+			std::vector<float>& output = res_mgr.m_anim_interpolation_data_map[output_handle].m_data;
+			for (unsigned int k = 0; k < KEYFRAME_COUNT; k++)
+			{
+				float const t = (float)k / (float)KEYFRAME_COUNT;
+				if (_path == animation_channel_data::ROTATION)
+				{
+					glm::quat const rotation = glm::angleAxis(t * 6.2831f, glm::normalize(glm::vec3(1.0f, (float)_joint, 0.5f)));
+					output.insert(output.end(), { rotation.x, rotation.y, rotation.z, rotation.w });
+				}
+				else
+					output.insert(output.end(), { t, 0.1f * (float)_joint, 0.0f });
+			}
+
+			animation_sampler_handle const sampler_handle = res_mgr.m_anim_sampler_handle_counter++;
+			res_mgr.m_anim_sampler_data_map[sampler_handle] = { input_handle, output_handle, animation_sampler_data::LINEAR };
+			_animation.m_animation_channels.push_back({ sampler_handle, _path, _joint });
+		};
+
+		animation_data animation;
+		std::unordered_map<uint8_t, uint8_t> joint_channel_counts;
+		for (unsigned int j = 0; j < JOINT_COUNT; j++)
+		{
+			add_channel(animation, (uint8_t)j, animation_channel_data::TRANSLATION);
+			add_channel(animation, (uint8_t)j, animation_channel_data::ROTATION);
+			joint_channel_counts[(uint8_t)j] = 2;
+		}
+		animation.set_joint_node_channel_counts(joint_channel_counts);
+		animation.m_duration = duration;
+		animation.m_name = "benchmark_crowd_clip";
+		res_mgr.ResolveAnimationChannels(animation);
+
+		animation_handle const handle = res_mgr.m_anim_handle_counter++;
+		res_mgr.m_anim_data_map.emplace(handle, std::move(animation));
+		return handle;
+	}
+};
+
+static void run_animator_benchmark(benchmark::State& _state, bool _parallel)
+{
+	size_t const character_count = (size_t)_state.range(0);
+	crowd_scene scene(character_count);
+
+	auto& animator_manager = Singleton<SkeletonAnimatorManager>();
+	animator_manager.SetParallelUpdate(_parallel);
+	for (auto _ : _state)
+	{
+		animator_manager.UpdateAnimatorInstances(1.0f / 60.0f);
+		benchmark::ClobberMemory();
+	}
+	animator_manager.SetParallelUpdate(true);
+
+	_state.SetItemsProcessed(_state.iterations() * character_count);
+}
+
+static void BM_AnimatorUpdate_Serial(benchmark::State& _state)
+{
+	run_animator_benchmark(_state, false);
+}
+
+static void BM_AnimatorUpdate_Parallel(benchmark::State& _state)
+{
+	run_animator_benchmark(_state, true);
+}
+
+static void run_sampling_benchmark(benchmark::State& _state, animation_data const& _animation)
+{
+	float channel_data[1024];
+	animation_key_cursors key_cursors;
+	float time = 0.0f;
+	for (auto _ : _state)
+	{
+		AnimationUtil::compute_animation_channel_data(&_animation, time, channel_data, true, &key_cursors);
+		time = AnimationUtil::rollover_modulus(time + 1.0f / 60.0f, _animation.m_duration);
+		benchmark::DoNotOptimize(channel_data);
+	}
+	_state.counters["bytes"] = (double)animation_memory_usage(_animation);
+	_state.SetItemsProcessed(_state.iterations() * _animation.m_animation_channels.size());
+}
+
+static void BM_AnimationSampling_Raw(benchmark::State& _state)
+{
+	run_sampling_benchmark(_state, *Singleton<ResourceManager>().FindAnimationData(crowd_scene::clip_animation()));
+}
+
+static void BM_AnimationSampling_Compressed(benchmark::State& _state)
+{
+	run_sampling_benchmark(_state, crowd_scene::compressed_clip_animation());
+}
+
+/*
+* Two and three way blends of poses the size of crowd skeletons, as evaluated by 1D and 2D blend nodes.
+*/
+static void run_pose_blend_benchmark(benchmark::State& _state, Engine::Math::ESIMDLevel _level)
+{
+	if (_level > Engine::Math::get_supported_simd_level())
+	{
+		_state.SkipWithError("SIMD level not supported");
+		return;
+	}
+
+	animation_pose poses[3];
+	for (int p = 0; p < 3; p++)
+	{
+		poses[p].resize(crowd_scene::JOINT_COUNT);
+		for (unsigned int j = 0; j < crowd_scene::JOINT_COUNT; j++)
+		{
+			Engine::Math::transform3D joint;
+			joint.position = glm::vec3((float)p, 0.1f * (float)j, 0.0f);
+			joint.rotation = glm::angleAxis(0.1f * (float)(j + p), glm::normalize(glm::vec3(1.0f, (float)j, 0.5f)));
+			poses[p].set_joint_transform(j, joint);
+		}
+	}
+	float const barycentric_weights[3] = { 0.2f, 0.3f, 0.5f };
+
+	animation_pose blended;
+	for (auto _ : _state)
+	{
+		blended.mix(poses[0], poses[1], 0.3f, _level);
+		blended.mix(poses, barycentric_weights, _level);
+		benchmark::ClobberMemory();
+	}
+
+	_state.SetItemsProcessed(_state.iterations() * 2 * crowd_scene::JOINT_COUNT);
+}
+
+static void BM_PoseBlend_Scalar(benchmark::State& _state)
+{
+	run_pose_blend_benchmark(_state, Engine::Math::eScalar);
+}
+
+static void BM_PoseBlend_SSE(benchmark::State& _state)
+{
+	run_pose_blend_benchmark(_state, Engine::Math::eSSE);
+}
+
+static void BM_PoseBlend_AVX2(benchmark::State& _state)
+{
+	run_pose_blend_benchmark(_state, Engine::Math::eAVX2);
+}
+
+BENCHMARK(BM_AnimationSampling_Raw);
+BENCHMARK(BM_AnimationSampling_Compressed);
+BENCHMARK(BM_PoseBlend_Scalar);
+BENCHMARK(BM_PoseBlend_SSE);
+BENCHMARK(BM_PoseBlend_AVX2);
+BENCHMARK(BM_AnimatorUpdate_Serial)->RangeMultiplier(10)->Range(1, 1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_AnimatorUpdate_Parallel)->RangeMultiplier(10)->Range(1, 1000)->Unit(benchmark::kMicrosecond);
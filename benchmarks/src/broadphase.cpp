@@ -0,0 +1,129 @@
+#include <benchmark/benchmark.h>
+
+#include <Engine/Physics/dynamic_aabb_tree.h>
+#include <Engine/Physics/sweep_and_prune.h>
+#include <Engine/Math/geometry_intersection.hpp>
+
+#include <random>
+#include <cmath>
+
+using namespace Engine::Physics;
+using namespace Engine::Math;
+
+/*
+* Unit boxes scattered in a cube with roughly constant density, that
+* wobble a little every frame to mimic a temporally coherent scene.
+*/
+struct broadphase_scene
+{
+	std::vector<aabb>		base_bounds;
+	std::vector<float>		phases;
+	std::vector<aabb>		bounds;
+	unsigned int			frame = 0;
+
+	explicit broadphase_scene(size_t _box_count)
+	{
+		float const side = std::cbrt(float(_box_count) * 8.0f);
+		std::mt19937 rng(1337);
+		std::uniform_real_distribution<float> position_dist(0.0f, side);
+		std::uniform_real_distribution<float> phase_dist(0.0f, 6.2831f);
+
+		base_bounds.resize(_box_count);
+		phases.resize(_box_count);
+		for (size_t i = 0; i < _box_count; i++)
+		{
+			base_bounds[i].center = glm::vec3(position_dist(rng), position_dist(rng), position_dist(rng));
+			base_bounds[i].extent = glm::vec3(0.5f);
+			phases[i] = phase_dist(rng);
+		}
+		bounds = base_bounds;
+	}
+
+	void step()
+	{
+		frame++;
+		for (size_t i = 0; i < bounds.size(); i++)
+		{
+			float const offset = 0.05f * std::sin(float(frame) * 0.1f + phases[i]);
+			bounds[i].center = base_bounds[i].center + glm::vec3(offset, -offset, offset);
+		}
+	}
+};
+
+static void BM_Broadphase_AllPairs(benchmark::State& _state)
+{
+	broadphase_scene scene((size_t)_state.range(0));
+	std::vector<broadphase_pair> pairs;
+
+	for (auto _ : _state)
+	{
+		scene.step();
+
+		pairs.clear();
+		for (uint32_t i = 0; i < (uint32_t)scene.bounds.size(); i++)
+		{
+			for (uint32_t j = i + 1; j < (uint32_t)scene.bounds.size(); j++)
+			{
+				if (intersect_aabb_aabb(scene.bounds[i], scene.bounds[j]))
+					pairs.emplace_back(i, j);
+			}
+		}
+		benchmark::DoNotOptimize(pairs.data());
+	}
+	_state.counters["pairs"] = (double)pairs.size();
+}
+
+static void BM_Broadphase_DynamicAABBTree(benchmark::State& _state)
+{
+	broadphase_scene scene((size_t)_state.range(0));
+	std::vector<broadphase_pair> pairs;
+
+	dynamic_aabb_tree tree;
+	std::vector<dynamic_aabb_tree::proxy_id> proxies(scene.bounds.size());
+	for (uint32_t i = 0; i < (uint32_t)scene.bounds.size(); i++)
+		proxies[i] = tree.create_proxy(scene.bounds[i], i);
+
+	for (auto _ : _state)
+	{
+		scene.step();
+
+		for (size_t i = 0; i < scene.bounds.size(); i++)
+			tree.move_proxy(proxies[i], scene.bounds[i]);
+		tree.compute_pairs(pairs);
+		benchmark::DoNotOptimize(pairs.data());
+	}
+	_state.counters["pairs"] = (double)pairs.size();
+	_state.counters["height"] = (double)tree.height();
+}
+
+static void BM_Broadphase_SweepAndPrune(benchmark::State& _state)
+{
+	broadphase_scene scene((size_t)_state.range(0));
+	std::vector<broadphase_pair> pairs;
+
+	sweep_and_prune sap;
+	std::vector<sweep_and_prune::proxy_id> proxies(scene.bounds.size());
+	for (uint32_t i = 0; i < (uint32_t)scene.bounds.size(); i++)
+		proxies[i] = sap.create_proxy(scene.bounds[i], i);
+	sap.update();
+
+	size_t pair_events = 0;
+	for (auto _ : _state)
+	{
+		scene.step();
+
+		sap.clear_events();
+		for (size_t i = 0; i < scene.bounds.size(); i++)
+			sap.update_proxy(proxies[i], scene.bounds[i]);
+		sap.update();
+		sap.compute_pairs(pairs);
+		pair_events += sap.m_added_pairs.size() + sap.m_removed_pairs.size();
+		benchmark::DoNotOptimize(pairs.data());
+	}
+	_state.counters["pairs"] = (double)pairs.size();
+	_state.counters["pair_events"] = benchmark::Counter((double)pair_events, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_Broadphase_AllPairs)->Arg(1000)->Arg(5000)->Arg(15000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Broadphase_DynamicAABBTree)->Arg(1000)->Arg(5000)->Arg(15000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Broadphase_SweepAndPrune)->Arg(1000)->Arg(5000)->Arg(15000)->Unit(benchmark::kMillisecond);
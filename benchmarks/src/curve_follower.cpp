@@ -0,0 +1,66 @@
+#include <benchmark/benchmark.h>
+
+#include <Engine/Components/CurveFollower.h>
+#include <Engine/Components/Transform.h>
+#include <Engine/Utils/singleton.h>
+
+using namespace Component;
+using Engine::ECS::Entity;
+
+/*
+* Followers on a single linear curve, every other one playing. Followers are stored in the archetype
+* storage, with playing followers in their own archetype.
+*/
+static void setup_followers(unsigned int _follower_count)
+{
+	auto& transform_manager = Singleton<TransformManager>();
+	auto& curve_manager = Singleton<CurveInterpolatorManager>();
+	auto& follower_manager = Singleton<CurveFollowerManager>();
+	follower_manager.Clear();
+	curve_manager.Clear();
+	transform_manager.Clear();
+
+	unsigned int id = 0;
+	auto create_entity = [&id]()
+	{
+		Entity e;
+		e.m_id = id++;
+		e.m_counter = 0;
+		return e;
+	};
+
+	Entity const curve_entity = create_entity();
+	transform_manager.Create(curve_entity);
+	CurveInterpolator curve = curve_manager.Create(curve_entity);
+	piecewise_curve linear_curve;
+	linear_curve.m_type = piecewise_curve::EType::Linear;
+	linear_curve.m_nodes = { glm::vec3(0.0f), glm::vec3(10.0f, 0.0f, 0.0f), glm::vec3(10.0f, 10.0f, 0.0f) };
+	curve.SetPiecewiseCurve(linear_curve, 64u);
+
+	for (unsigned int i = 0; i < _follower_count; i++)
+	{
+		Entity const e = create_entity();
+		transform_manager.Create(e);
+		CurveFollower follower = follower_manager.Create(e);
+		follower.GetFollowerData().m_curve_component = curve;
+		if (i % 2 == 0)
+			follower.SetPlayingState(true);
+	}
+}
+
+static void BM_UpdateCurveFollowers(benchmark::State& _state)
+{
+	unsigned int const follower_count = (unsigned int)_state.range(0);
+	setup_followers(follower_count);
+
+	for (auto _ : _state)
+		Singleton<CurveFollowerManager>().UpdateFollowers(1.0f / 60.0f);
+
+	Singleton<CurveFollowerManager>().Clear();
+	Singleton<CurveInterpolatorManager>().Clear();
+	Singleton<TransformManager>().Clear();
+
+	_state.SetItemsProcessed(_state.iterations() * follower_count);
+}
+
+BENCHMARK(BM_UpdateCurveFollowers)->Arg(1000)->Arg(10000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,120 @@
+#include <benchmark/benchmark.h>
+
+#include <Engine/ECS/entity.h>
+#include <Engine/Components/Transform.h>
+#include <Engine/Utils/singleton.h>
+
+#include <vector>
+
+using Component::TransformManager;
+using Engine::ECS::Entity;
+using Engine::ECS::EntityManager;
+
+/*
+* Create a batch of entities, then queue and free all of them, like a scene being loaded and unloaded.
+* Manager is not the singleton, so no component managers receive destruction messages.
+*/
+static void BM_EntityCreateDestroy(benchmark::State& _state)
+{
+	unsigned int const entity_count = (unsigned int)_state.range(0);
+	std::vector<Entity> entities(entity_count);
+
+	EntityManager entity_manager;
+	for (auto _ : _state)
+	{
+		bool const created = entity_manager.EntityCreationRequest(entities.data(), entity_count);
+		benchmark::DoNotOptimize(created);
+		entity_manager.EntityDelayedDeletion(entities.data(), entity_count);
+		benchmark::DoNotOptimize(entity_manager.FreeQueuedEntities());
+	}
+
+	_state.SetItemsProcessed(_state.iterations() * entity_count);
+}
+
+// Create and destroy entities one at a time, with every ID being reused many times.
+static void BM_EntityCreateDestroy_Single(benchmark::State& _state)
+{
+	unsigned int const entity_count = (unsigned int)_state.range(0);
+
+	EntityManager entity_manager;
+	for (auto _ : _state)
+	{
+		for (unsigned int i = 0; i < entity_count; i++)
+		{
+			Entity const e = entity_manager.EntityCreationRequest();
+			entity_manager.EntityDelayedDeletion(e);
+		}
+		benchmark::DoNotOptimize(entity_manager.FreeQueuedEntities());
+	}
+
+	_state.SetItemsProcessed(_state.iterations() * entity_count);
+}
+
+/*
+* Transforms in small hierarchies of a root with 9 children. Every 5th entity is destroyed, so that
+* destroyed entities are spread over the whole scene and include both roots and children.
+*/
+static std::vector<Entity> create_destroy_scene(unsigned int _transform_count)
+{
+	auto& transform_manager = Singleton<TransformManager>();
+	transform_manager.Clear();
+
+	std::vector<Entity> destroyed_entities;
+	Entity root;
+	for (unsigned int i = 0; i < _transform_count; i++)
+	{
+		Entity e;
+		e.m_id = i;
+		e.m_counter = 0;
+		auto transform = transform_manager.Create(e);
+		if (i % 10 == 0)
+			root = e;
+		else
+			transform.SetParent(root, false);
+		if (i % 5 == 0)
+			destroyed_entities.push_back(e);
+	}
+	return destroyed_entities;
+}
+
+static void run_destroy_benchmark(benchmark::State& _state, bool _batched)
+{
+	unsigned int const transform_count = (unsigned int)_state.range(0);
+	auto& transform_manager = Singleton<TransformManager>();
+
+	size_t destroyed_count = 0;
+	for (auto _ : _state)
+	{
+		_state.PauseTiming();
+		std::vector<Entity> const destroyed_entities = create_destroy_scene(transform_count);
+		_state.ResumeTiming();
+
+		if (_batched)
+			transform_manager.Destroy(destroyed_entities.data(), (unsigned int)destroyed_entities.size());
+		else
+		{
+			for (Entity const e : destroyed_entities)
+				transform_manager.Destroy(&e, 1);
+		}
+		destroyed_count += destroyed_entities.size();
+	}
+	transform_manager.Clear();
+
+	_state.SetItemsProcessed(destroyed_count);
+}
+
+static void BM_DestroyTransforms_OneByOne(benchmark::State& _state)
+{
+	run_destroy_benchmark(_state, false);
+}
+
+static void BM_DestroyTransforms_Batched(benchmark::State& _state)
+{
+	run_destroy_benchmark(_state, true);
+}
+
+BENCHMARK(BM_EntityCreateDestroy)->Arg(10000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_EntityCreateDestroy_Single)->Arg(10000)->Unit(benchmark::kMillisecond);
+// 10K of 50K transforms destroyed.
+BENCHMARK(BM_DestroyTransforms_OneByOne)->Arg(50000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DestroyTransforms_Batched)->Arg(50000)->Unit(benchmark::kMillisecond);
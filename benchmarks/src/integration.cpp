@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+
+#include <Engine/Physics/integration.h>
+
+#include <random>
+#include <vector>
+
+using namespace Engine::Physics;
+using namespace Engine::Math;
+
+/*
+* Bodies with random rotations, momentums and diagonal inertia, laid out as the SoA arrays of
+* rigidbody_data_collection.
+*/
+struct integration_scene
+{
+	std::vector<glm::vec3>	positions, linear_momentums, forces;
+	std::vector<float>		inv_masses;
+	std::vector<glm::quat>	rotations;
+	std::vector<glm::vec3>	angular_momentums, torques;
+	std::vector<glm::mat3>	inv_inertial_tensors, inv_world_tensors;
+
+	explicit integration_scene(size_t _body_count)
+	{
+		std::mt19937 rng(1337);
+		std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+		auto random_vec3 = [&]() { return glm::vec3(dist(rng), dist(rng), dist(rng)); };
+
+		for (size_t i = 0; i < _body_count; i++)
+		{
+			positions.push_back(random_vec3() * 100.0f);
+			linear_momentums.push_back(random_vec3());
+			forces.push_back(glm::vec3(0.0f, -9.81f, 0.0f));
+			inv_masses.push_back(1.0f);
+			rotations.push_back(glm::normalize(glm::quat(dist(rng), dist(rng), dist(rng), dist(rng))));
+			angular_momentums.push_back(random_vec3());
+			torques.push_back(glm::vec3(0.0f));
+			glm::vec3 const inv_diagonal = glm::vec3(1.0f) + glm::abs(random_vec3());
+			inv_inertial_tensors.push_back(glm::mat3(
+				glm::vec3(inv_diagonal.x, 0.0f, 0.0f), glm::vec3(0.0f, inv_diagonal.y, 0.0f), glm::vec3(0.0f, 0.0f, inv_diagonal.z)
+			));
+		}
+		inv_world_tensors.resize(_body_count);
+		compute_inv_world_tensors(rotations.data(), inv_inertial_tensors.data(), inv_world_tensors.data(), _body_count);
+	}
+};
+
+static void run_integration_benchmark(benchmark::State& _state, ESIMDLevel _level)
+{
+	if (_level > get_supported_simd_level())
+	{
+		_state.SkipWithError("SIMD level not supported");
+		return;
+	}
+
+	size_t const body_count = (size_t)_state.range(0);
+	integration_scene scene(body_count);
+
+	for (auto _ : _state)
+	{
+		integrate_linear_euler(1.0f / 60.0f, scene.positions.data(), scene.linear_momentums.data(), scene.forces.data(),
+			scene.inv_masses.data(), body_count, _level);
+		integrate_angular_euler(1.0f / 60.0f, scene.rotations.data(), scene.angular_momentums.data(), scene.torques.data(),
+			scene.inv_inertial_tensors.data(), scene.inv_world_tensors.data(), body_count, _level);
+		benchmark::ClobberMemory();
+	}
+
+	_state.SetItemsProcessed(_state.iterations() * body_count);
+}
+
+static void BM_Integration_Scalar(benchmark::State& _state)
+{
+	run_integration_benchmark(_state, eScalar);
+}
+
+static void BM_Integration_SSE(benchmark::State& _state)
+{
+	run_integration_benchmark(_state, eSSE);
+}
+
+static void BM_Integration_AVX2(benchmark::State& _state)
+{
+	run_integration_benchmark(_state, eAVX2);
+}
+
+BENCHMARK(BM_Integration_Scalar)->Arg(10000)->Arg(30000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Integration_SSE)->Arg(10000)->Arg(30000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Integration_AVX2)->Arg(10000)->Arg(30000)->Arg(100000)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+
+#include <Engine/Physics/narrowphase.h>
+#include <Engine/Physics/convex_hull.h>
+#include <Engine/Physics/dynamic_aabb_tree.h>
+#include <Engine/Utils/job_system.h>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <random>
+#include <cmath>
+#include <thread>
+
+using namespace Engine::Physics;
+using namespace Engine::Math;
+
+/*
+* Randomly rotated unit cubes resting in a dense pile, with candidate pairs
+* computed once up front so that only narrowphase is measured.
+*/
+struct narrowphase_scene
+{
+	half_edge_data_structure		hull;
+	std::vector<narrowphase_body>	bodies;
+	std::vector<broadphase_pair>	pairs;
+
+	explicit narrowphase_scene(size_t _body_count)
+	{
+		glm::vec3 const vertices[] = {
+			{ -0.5f, -0.5f, -0.5f }, { 0.5f, -0.5f, -0.5f }, { -0.5f, 0.5f, -0.5f }, { 0.5f, 0.5f, -0.5f },
+			{ -0.5f, -0.5f,  0.5f }, { 0.5f, -0.5f,  0.5f }, { -0.5f, 0.5f,  0.5f }, { 0.5f, 0.5f,  0.5f },
+		};
+		hull = construct_convex_hull(vertices, 8);
+
+		float const side = std::cbrt(float(_body_count)) * 1.2f;
+		std::mt19937 rng(1337);
+		std::uniform_real_distribution<float> position_dist(0.0f, side);
+		std::uniform_real_distribution<float> angle_dist(0.0f, 6.2831f);
+
+		dynamic_aabb_tree tree;
+		bodies.resize(_body_count);
+		for (size_t i = 0; i < _body_count; i++)
+		{
+			narrowphase_body& body = bodies[i];
+			body.hull = &hull;
+			body.world_transform.position = glm::vec3(position_dist(rng), position_dist(rng), position_dist(rng));
+			body.world_transform.rotation = glm::quat(glm::vec3(angle_dist(rng), angle_dist(rng), angle_dist(rng)));
+			body.bounding_volume.center = body.world_transform.position;
+			body.bounding_volume.extent = glm::vec3(0.8661f);
+			body.entity_id = (uint16_t)i;
+			tree.create_proxy(body.bounding_volume, (uint32_t)i);
+		}
+		tree.compute_pairs(pairs);
+	}
+};
+
+static void BM_Narrowphase_Threads(benchmark::State& _state)
+{
+	static narrowphase_scene const scene(5000);
+
+	unsigned int const thread_count = (unsigned int)_state.range(0);
+	Engine::Utils::job_system jobs(thread_count);
+	narrowphase_context context;
+
+	for (auto _ : _state)
+	{
+		compute_narrowphase(scene.bodies.data(), scene.pairs.data(), scene.pairs.size(), &jobs, context);
+		benchmark::DoNotOptimize(context.merged_output.contacts.data());
+	}
+	_state.counters["pairs"] = (double)scene.pairs.size();
+	_state.counters["manifolds"] = (double)context.merged_output.results.size();
+	_state.counters["pairs_per_second"] = benchmark::Counter(
+		(double)scene.pairs.size(), benchmark::Counter::kIsIterationInvariantRate
+	);
+}
+
+BENCHMARK(BM_Narrowphase_Threads)
+	->DenseRange(1, std::max(std::thread::hardware_concurrency(), 1u))
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
@@ -0,0 +1,206 @@
+#include <benchmark/benchmark.h>
+
+#include <Engine/Physics/resolution.hpp>
+#include <Engine/Utils/job_system.h>
+#include <Engine/Utils/singleton.h>
+
+#include <algorithm>
+#include <thread>
+
+using namespace Engine::Physics;
+using rigidbody_data_collection = Component::RigidBodyManager::rigidbody_data_collection;
+
+/*
+* Two-dimensional pyramid of unit boxes resting on a static ground body. Every box rests on two
+* boxes of the row below, so the constraint graph has the long dependency chains of a real stack.
+* Contacts are generated analytically once, and bodies are not integrated, so only the solver is
+* measured.
+*/
+struct pyramid_scene
+{
+	static constexpr float PENETRATION = 0.01f;
+
+	global_contact_data		contact_data;
+	size_t					box_count = 0;
+
+	explicit pyramid_scene(size_t _box_count)
+	{
+		rigidbody_data_collection& rigidbodies = Singleton<Component::RigidBodyManager>().m_rigidbodies_data;
+		rigidbodies = rigidbody_data_collection();
+
+		// Ground
+		push_body(rigidbodies, glm::vec3(0.0f, -0.5f, 0.0f));
+		rigidbodies.m_inv_masses[0] = 0.0f;
+		rigidbodies.m_inertial_tensors[0] = glm::mat3(0.0f);
+		rigidbodies.m_inv_inertial_tensors[0] = glm::mat3(0.0f);
+		rigidbodies.update_inv_world_tensor(0);
+
+		// Find number of boxes in bottom row.
+		size_t base = 1;
+		while (base * (base + 1) / 2 < _box_count)
+			base++;
+
+		std::vector<size_t> previous_row, row;
+		for (size_t row_idx = 0; row_idx < base && box_count < _box_count; row_idx++)
+		{
+			row.clear();
+			size_t const row_size = base - row_idx;
+			// Bottom of boxes in this row, which is where they touch the row below.
+			float const bottom = (float)row_idx * (1.0f - PENETRATION);
+			for (size_t i = 0; i < row_size && box_count < _box_count; i++)
+			{
+				float const x = (float)i + 0.5f * (float)row_idx - 0.5f * (float)base;
+				size_t const box = push_body(rigidbodies, glm::vec3(x, bottom + 0.5f - PENETRATION, 0.0f));
+				row.push_back(box);
+				box_count++;
+
+				if (row_idx == 0)
+					add_manifold(rigidbodies, 0, box, x - 0.5f, x + 0.5f, bottom);
+				else
+				{
+					add_manifold(rigidbodies, previous_row[i], box, x - 0.5f, x, bottom);
+					add_manifold(rigidbodies, previous_row[i + 1], box, x, x + 0.5f, bottom);
+				}
+			}
+			std::swap(previous_row, row);
+		}
+	}
+
+	static size_t push_body(rigidbody_data_collection& _rigidbodies, glm::vec3 _position)
+	{
+		Engine::ECS::Entity e;
+		e.m_id = (uint16_t)_rigidbodies.size();
+		e.m_counter = 0;
+		size_t const index = _rigidbodies.push_element(e, _position, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), 1.0f, glm::mat3(1.0f / 6.0f));
+		_rigidbodies.m_restitution[index] = 0.0f;
+		return index;
+	}
+
+	// Contacts on the top face of body A over [_min_x, _max_x], with normal pointing up towards body B.
+	void add_manifold(rigidbody_data_collection const& _rigidbodies, size_t _body_A, size_t _body_B, float _min_x, float _max_x, float _y)
+	{
+		Engine::ECS::Entity const entity_A = _rigidbodies.m_index_entities[_body_A];
+		Engine::ECS::Entity const entity_B = _rigidbodies.m_index_entities[_body_B];
+
+		contact_manifold& cm = contact_data.all_contact_manifolds.emplace_back();
+		cm.rigidbodies = { Component::RigidBody(entity_A), Component::RigidBody(entity_B) };
+		cm.pair_key = make_contact_pair_key(entity_A, entity_B);
+		cm.data.first_contact_index = (uint32_t)contact_data.all_contacts.size();
+		cm.data.contact_count = 4;
+		cm.data.is_edge_edge = false;
+
+		glm::vec3 const points[] = {
+			{ _min_x, _y, -0.5f }, { _max_x, _y, -0.5f }, { _min_x, _y, 0.5f }, { _max_x, _y, 0.5f }
+		};
+		for (uint16_t i = 0; i < 4; i++)
+		{
+			contact& c = contact_data.all_contacts.emplace_back();
+			c.point = points[i];
+			c.penetration = PENETRATION;
+			c.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+			c.identifier = { entity_A.ID(), entity_B.ID(), i, i };
+		}
+	}
+
+	/*
+	* @brief	Start a step from rest with gravity applied, as a resting pyramid would.
+	*/
+	static void reset_velocities(physics_simulation_parameters const& _parameters)
+	{
+		rigidbody_data_collection& rigidbodies = Singleton<Component::RigidBodyManager>().m_rigidbodies_data;
+		for (size_t i = 0; i < rigidbodies.size(); i++)
+		{
+			rigidbodies.m_linear_momentums[i] = rigidbodies.m_inv_masses[i] > 0.0f
+				? glm::vec3(0.0f, -9.81f * _parameters.timestep, 0.0f) / rigidbodies.m_inv_masses[i]
+				: glm::vec3(0.0f);
+			rigidbodies.m_angular_momentums[i] = glm::vec3(0.0f);
+		}
+	}
+
+	/*
+	* @brief	Penetration left after integrating the solved velocities over one step, averaged over contacts.
+	*/
+	float compute_residual_penetration(physics_simulation_parameters const& _parameters) const
+	{
+		float residual_sum = 0.0f;
+		for (contact_manifold const& cm : contact_data.all_contact_manifolds)
+		{
+			rigidbody_data const rbA = cm.rigidbodies.first.GetRigidBodyData();
+			rigidbody_data const rbB = cm.rigidbodies.second.GetRigidBodyData();
+			size_t const end_contact_idx = cm.data.first_contact_index + cm.data.contact_count;
+			for (size_t contact_idx = cm.data.first_contact_index; contact_idx < end_contact_idx; contact_idx++)
+			{
+				contact const& c = contact_data.all_contacts[contact_idx];
+				glm::vec3 const relative_vel =
+					-rbA.get_linear_velocity() - glm::cross(rbA.get_angular_velocity(), c.point - rbA.position) +
+					rbB.get_linear_velocity() + glm::cross(rbB.get_angular_velocity(), c.point - rbB.position);
+				residual_sum += std::max(c.penetration - glm::dot(c.normal, relative_vel) * _parameters.timestep, 0.0f);
+			}
+		}
+		return residual_sum / (float)contact_data.all_contacts.size();
+	}
+};
+
+static void run_pyramid_benchmark(benchmark::State& _state, bool _parallel, bool _simd, unsigned int _thread_count)
+{
+	pyramid_scene scene(2000);
+
+	physics_simulation_parameters parameters;
+	parameters.parallel_resolution = _parallel;
+	parameters.simd_resolution = _simd;
+	Engine::Utils::job_system jobs(_thread_count);
+	contact_solver_context solver_context;
+
+	for (auto _ : _state)
+	{
+		_state.PauseTiming();
+		pyramid_scene::reset_velocities(parameters);
+		_state.ResumeTiming();
+
+		compute_resolution_gauss_seidel(scene.contact_data, parameters, &jobs, &solver_context);
+	}
+
+	_state.counters["boxes"] = (double)scene.box_count;
+	_state.counters["manifolds"] = (double)scene.contact_data.all_contact_manifolds.size();
+	_state.counters["colours"] = (double)solver_context.colour_count();
+	_state.counters["lanes"] = _simd ? (double)Engine::Math::simd_float::WIDTH : 1.0;
+	_state.counters["residual_penetration"] = scene.compute_residual_penetration(parameters);
+}
+
+static void BM_Resolution_Pyramid_Serial(benchmark::State& _state)
+{
+	run_pyramid_benchmark(_state, false, false, 1);
+}
+
+static void BM_Resolution_Pyramid_SIMD(benchmark::State& _state)
+{
+	run_pyramid_benchmark(_state, false, true, 1);
+}
+
+static void BM_Resolution_Pyramid_Parallel(benchmark::State& _state)
+{
+	run_pyramid_benchmark(_state, true, false, (unsigned int)_state.range(0));
+}
+
+static void BM_Resolution_Pyramid_Parallel_SIMD(benchmark::State& _state)
+{
+	run_pyramid_benchmark(_state, true, true, (unsigned int)_state.range(0));
+}
+
+BENCHMARK(BM_Resolution_Pyramid_Serial)
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
+
+BENCHMARK(BM_Resolution_Pyramid_SIMD)
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
+
+BENCHMARK(BM_Resolution_Pyramid_Parallel)
+	->DenseRange(1, std::max(std::thread::hardware_concurrency(), 1u))
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
+
+BENCHMARK(BM_Resolution_Pyramid_Parallel_SIMD)
+	->DenseRange(1, std::max(std::thread::hardware_concurrency(), 1u))
+	->Unit(benchmark::kMillisecond)
+	->UseRealTime();
@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+
+#include <Engine/Components/Transform.h>
+#include <Engine/Utils/singleton.h>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <random>
+#include <vector>
+
+using Component::TransformManager;
+using Engine::ECS::Entity;
+using Engine::Math::transform3D;
+
+/*
+* Hierarchies of equal size, shaped like skeletons: every node is attached to a random earlier
+* node of its own hierarchy.
+*/
+struct transform_scene
+{
+	std::vector<Entity> roots;
+
+	transform_scene(size_t _transform_count, size_t _hierarchy_count)
+	{
+		auto& transform_manager = Singleton<TransformManager>();
+		transform_manager.Clear();
+
+		std::mt19937 rng(1337);
+		std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+
+		size_t const hierarchy_size = _transform_count / _hierarchy_count;
+		std::vector<Entity> hierarchy;
+		unsigned int id = 0;
+		for (size_t h = 0; h < _hierarchy_count; h++)
+		{
+			hierarchy.clear();
+			for (size_t n = 0; n < hierarchy_size; n++)
+			{
+				Entity e;
+				e.m_id = id++;
+				e.m_counter = 0;
+				auto transform = transform_manager.Create(e);
+
+				transform3D local;
+				local.position = glm::vec3(dist(rng), dist(rng), dist(rng));
+				local.rotation = glm::normalize(glm::quat(dist(rng), dist(rng), dist(rng), dist(rng)));
+				transform.SetLocalTransform(local);
+
+				if (n != 0)
+					transform.SetParent(hierarchy[std::uniform_int_distribution<size_t>(0, n - 1)(rng)], false);
+				hierarchy.push_back(e);
+			}
+			roots.push_back(hierarchy.front());
+		}
+		transform_manager.UpdateWorldMatrices();
+	}
+
+	// Move every root, so that every world matrix has to be recomputed.
+	void step()
+	{
+		auto& transform_manager = Singleton<TransformManager>();
+		for (Entity const root : roots)
+		{
+			auto transform = transform_manager.Get(root);
+			transform.SetLocalPosition(transform.GetLocalPosition() + glm::vec3(0.01f, 0.0f, 0.0f));
+		}
+	}
+};
+
+static void run_transform_benchmark(benchmark::State& _state, bool _parallel)
+{
+	size_t const transform_count = (size_t)_state.range(0);
+	transform_scene scene(transform_count, (size_t)_state.range(1));
+
+	auto& transform_manager = Singleton<TransformManager>();
+	transform_manager.SetParallelUpdate(_parallel);
+	for (auto _ : _state)
+	{
+		scene.step();
+		transform_manager.UpdateWorldMatrices();
+		benchmark::ClobberMemory();
+	}
+	transform_manager.SetParallelUpdate(true);
+	transform_manager.Clear();
+
+	_state.SetItemsProcessed(_state.iterations() * transform_count);
+}
+
+static void BM_TransformUpdate_Serial(benchmark::State& _state)
+{
+	run_transform_benchmark(_state, false);
+}
+
+static void BM_TransformUpdate_Parallel(benchmark::State& _state)
+{
+	run_transform_benchmark(_state, true);
+}
+
+BENCHMARK(BM_TransformUpdate_Serial)->Args({ 5000, 50 })->Args({ 50000, 500 })->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TransformUpdate_Parallel)->Args({ 5000, 50 })->Args({ 50000, 500 })->Unit(benchmark::kMicrosecond);
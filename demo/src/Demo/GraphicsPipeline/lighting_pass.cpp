@@ -5,6 +5,7 @@
 #include <Engine/Components/Transform.h>
 #include <Engine/Components/Camera.h>
 #include <Engine/Components/Renderable.h>
+#include <Engine/ECS/view.h>
 
 #include "../render_common.h"
 
@@ -235,18 +236,18 @@ namespace Sandbox {
 		// ### Render objects onto shadow map textures.
 
 		// Collect all entity world matrices and renderables before directional light pass.
-		auto entity_to_renderable_map = Singleton<RenderableManager>().GetAllRenderables();
-		std::vector<glm::mat4x4> entity_world_matrices;
-		std::vector<mesh_handle> entity_renderable_meshes;
+		Engine::ECS::View<Renderable, Transform> const renderable_view;
+		Engine::Utils::frame_vector<glm::mat4x4> entity_world_matrices(&s_frame_arena);
+		Engine::Utils::frame_vector<mesh_handle> entity_renderable_meshes(&s_frame_arena);
 
-		entity_world_matrices.reserve(entity_to_renderable_map.size());
-		entity_renderable_meshes.reserve(entity_to_renderable_map.size());
+		entity_world_matrices.reserve(renderable_view.size_hint());
+		entity_renderable_meshes.reserve(renderable_view.size_hint());
 
-		for (auto pair : entity_to_renderable_map)
+		renderable_view.each([&](Entity _e, Engine::Managers::Resource const& _mesh, auto const&)
 		{
-			entity_world_matrices.push_back(pair.first.GetComponent<Transform>().ComputeWorldTransform().GetMatrix());
-			entity_renderable_meshes.push_back(pair.second.Handle());
-		}
+			entity_world_matrices.push_back(Transform(_e).ComputeWorldMatrix());
+			entity_renderable_meshes.push_back(_mesh.Handle());
+		});
 
 		// TODO: Optimizations like sorting by renderable type, culling against partition AABB's, etc...
 
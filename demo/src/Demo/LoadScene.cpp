@@ -208,9 +208,9 @@ namespace Sandbox
 	//				// Due to how GLTF object is loaded, animator is guaranteed to have Skin Component.
 	//				auto skin_joints = animator_entity.GetComponent<Component::Skin>().GetSkeletonInstanceNodes();
 	//				animation_pose new_pose;
-	//				new_pose.m_joint_transforms.resize(skin_joints.size());
+	//				new_pose.resize(skin_joints.size());
 	//				for (unsigned int i = 0; i < skin_joints.size(); ++i)
-	//					new_pose.m_joint_transforms[i] = skin_joints[i].GetLocalTransform();
+	//					new_pose.set_joint_transform(i, skin_joints[i].GetLocalTransform());
 
 	//				skeleton_animator.Deserialize(*animator_iter);
 	//				skeleton_animator.SetBindPose(std::move(new_pose));
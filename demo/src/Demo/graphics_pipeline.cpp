@@ -10,6 +10,8 @@
 #include <Engine/Editor/editor.h>
 #include <Engine/Utils/singleton.h>
 #include <Engine/ECS/entity.h>
+#include <Engine/ECS/view.h>
+#include <Engine/Utils/allocation_tracker.h>
 
 // Components
 #include <Engine/Components/Camera.h>
@@ -100,6 +102,8 @@ namespace Sandbox
 
 	void GraphicsPipelineRender()
 	{
+		ENGINE_ALLOCATION_SCOPE(eGraphics);
+
 		///////////////////////////////////////////
 		//		Scene Rendering Pipeline
 		///////////////////////////////////////////
@@ -117,7 +121,7 @@ namespace Sandbox
 		using index_buffer_handle = Engine::Graphics::buffer_handle;
 		using namespace Engine::Graphics;
 
-		auto cameras = Singleton<Component::CameraManager>().AllCameras();
+		auto const& cameras = Singleton<Component::CameraManager>().AllCameras();
 		Entity camera_entity = Entity::InvalidEntity; 
 		Entity const editor_cam_entity = Singleton<Engine::Editor::Editor>().EditorCameraEntity;
 		if (cameras.size() > 1)
@@ -166,25 +170,19 @@ namespace Sandbox
 		new_cam_data_ubo.m_view_dir = cam_transform.rotation * glm::vec3(0.0f, 0.0f, -1.0f);
 		update_camera_ubo(new_cam_data_ubo);
 
-		auto all_renderables = Singleton<Component::RenderableManager>().GetAllRenderables();
-
-		std::vector<decltype(all_renderables)::value_type> sorted_renderables;
+		using renderable_entry = std::pair<Entity, Engine::Managers::Resource>;
+		Engine::Utils::frame_vector<renderable_entry> sorted_renderables(&s_frame_arena);
+		Engine::Utils::frame_vector<renderable_entry> skinned_renderables(&s_frame_arena);
 		// Sort skin-less renderables from skinned renderables.
-		std::copy_if(
-			all_renderables.begin(), all_renderables.end(), std::back_inserter(sorted_renderables),
-			[](decltype(all_renderables)::value_type const& pair)->bool
+		auto const& skin_storage = Singleton<Component::SkinManager>().GetComponentStorage();
+		Engine::ECS::View<Component::Renderable, Component::Transform>().each(
+			[&](Entity _e, Engine::Managers::Resource const& _mesh, auto const&)
 			{
-				return !pair.first.HasComponent<Component::Skin>();
+				(skin_storage.contains(_e) ? skinned_renderables : sorted_renderables).emplace_back(_e, _mesh);
 			}
 		);
 		unsigned int first_skinned_renderable_index = (unsigned int)sorted_renderables.size();
-		std::copy_if(
-			all_renderables.begin(), all_renderables.end(), std::back_inserter(sorted_renderables),
-			[](decltype(all_renderables)::value_type const& pair)->bool
-			{
-				return pair.first.HasComponent<Component::Skin>();
-			}
-		);
+		sorted_renderables.insert(sorted_renderables.end(), skinned_renderables.begin(), skinned_renderables.end());
 
 
 		res_mgr.BindFramebuffer(s_framebuffer_gbuffer);
@@ -240,6 +238,9 @@ namespace Sandbox
 		res_mgr.UseProgram(program_draw_gbuffer);
 		set_bound_program_uniform_locations();
 
+		// Reused by every skinned renderable.
+		Engine::Utils::frame_vector<glm::mat4x4> joint_skinning_matrices(&s_frame_arena);
+
 		for (unsigned int renderable_idx = 0; renderable_idx < sorted_renderables.size(); ++renderable_idx)
 		{
 			Engine::ECS::Entity const renderable_entity = sorted_renderables[renderable_idx].first;
@@ -254,10 +255,8 @@ namespace Sandbox
 				set_bound_program_uniform_locations();
 			}
 
-			Component::Transform renderable_transform = renderable_entity.GetComponent<Component::Transform>();
-			// TODO: Use cached world matrix in transform manager (once implemented)
-			auto model_transform = renderable_transform.ComputeWorldTransform();
-			glm::mat4 const mesh_model_matrix = model_transform.GetMatrix();
+			Component::Transform const renderable_transform(renderable_entity);
+			glm::mat4 const mesh_model_matrix = renderable_transform.ComputeWorldMatrix();
 			glm::mat4 const matrix_mv = camera_view_matrix * mesh_model_matrix;
 			glm::mat4 const matrix_t_inv_mv = glm::transpose(glm::inverse(matrix_mv));
 
@@ -270,15 +269,14 @@ namespace Sandbox
 				Component::Skin const skin_component = renderable_entity.GetComponent<Component::Skin>();
 				std::vector<Component::Transform> const& skin_skeleton_instance_nodes = skin_component.GetSkeletonInstanceNodes();
 				std::vector<glm::mat4x4> const& skin_inv_bind_matrices = skin_component.GetSkinNodeInverseBindMatrices();
-				std::vector<glm::mat4x4> joint_skinning_matrices;
 				Engine::Math::transform3D const skeleton_root_inv_transform =
 					skin_component.GetSkeletonRootNode().GetParent().GetComponent<Component::Transform>().ComputeWorldTransform().GetInverse();
 				assert(skin_skeleton_instance_nodes.size() <= 128);
+				joint_skinning_matrices.clear();
 				joint_skinning_matrices.reserve(skin_skeleton_instance_nodes.size());
 				// Compute joint->model matrices
 				for (Component::Transform const& joint_node : skin_skeleton_instance_nodes)
 				{
-					// TODO: Use cached world matrix in transform manager (once implemented)
 					joint_skinning_matrices.emplace_back(
 						(skeleton_root_inv_transform * joint_node.ComputeWorldTransform()).GetMatrix()
 					);
@@ -574,7 +572,7 @@ namespace Sandbox
 		res_mgr.BindFramebuffer(s_framebuffer_gbuffer);
 
 		// Render debug all skeleton nodes
-		auto skin_entity_map = Singleton<Component::SkinManager>().GetAllSkinEntities();
+		auto const& skin_entity_map = Singleton<Component::SkinManager>().GetAllSkinEntities();
 		if (!skin_entity_map.empty())
 		{
 			res_mgr.UseProgram(program_draw_gbuffer);
@@ -588,7 +586,7 @@ namespace Sandbox
 			glDepthFunc(GL_LEQUAL);
 			glDisable(GL_BLEND);
 
-			for (auto skin_entity_pair : skin_entity_map)
+			for (auto const& skin_entity_pair : skin_entity_map)
 			{
 				if (!skin_entity_pair.second.m_render_joints)
 					continue;
@@ -683,9 +681,7 @@ namespace Sandbox
 				for (Component::CurveInterpolator curve_comp : curve_entities)
 				{
 					Component::Transform renderable_transform = curve_comp.Owner().GetComponent<Component::Transform>();
-					// TODO: Use cached world matrix in transform manager (once implemented)
-					auto model_transform = renderable_transform.ComputeWorldTransform();
-					glm::mat4 const mesh_model_matrix = model_transform.GetMatrix();
+					glm::mat4 const mesh_model_matrix = renderable_transform.ComputeWorldMatrix();
 					glm::mat4 const matrix_mv = camera_view_matrix * mesh_model_matrix;
 					glm::mat4 const matrix_t_inv_mv = glm::transpose(glm::inverse(matrix_mv));
 
@@ -770,7 +766,6 @@ namespace Sandbox
 
 						node_transform.position = node_modified;
 						Component::Transform renderable_transform = curve_comp.Owner().GetComponent<Component::Transform>();
-						// TODO: Use cached world matrix in transform manager (once implemented)
 						glm::mat4 const mesh_model_matrix = renderable_transform.ComputeWorldMatrix() * node_transform.GetMatrix();
 						glm::mat4 const matrix_mv = camera_view_matrix * mesh_model_matrix;
 						glm::mat4 const matrix_t_inv_mv = glm::transpose(glm::inverse(matrix_mv));
@@ -786,9 +781,7 @@ namespace Sandbox
 					set_line_mesh(&line_mesh[0], (unsigned int)line_mesh.size());
 
 					Component::Transform curve_transform = curve_comp.Owner().GetComponent<Component::Transform>();
-					// TODO: Use cached world matrix in transform manager (once implemented)
-					auto model_transform = curve_transform.ComputeWorldTransform();
-					glm::mat4 const mesh_model_matrix = model_transform.GetMatrix();
+					glm::mat4 const mesh_model_matrix = curve_transform.ComputeWorldMatrix();
 					glm::mat4 const matrix_mv = camera_view_matrix * mesh_model_matrix;
 					glm::mat4 const matrix_t_inv_mv = glm::transpose(glm::inverse(matrix_mv));
 
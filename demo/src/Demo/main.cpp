@@ -11,17 +11,20 @@
 #include <Engine/Components/SkeletonAnimator.h>
 #include <Engine/Components/CurveFollower.h>
 #include <Engine/Components/Rigidbody.h>
+#include <Engine/Components/Transform.h>
 #include <Engine/Physics/Collider.h>
 
 #include <Engine/Graphics/misc/load_obj_mesh.hpp>
 
 #include <Engine/Managers/resource_manager.h>
+#include <Engine/Utils/allocation_tracker.h>
 
 #include <Engine/Physics/convex_hull_loader.h>
 #include <Engine/Physics/point_hull.h>
 #include <Engine/Physics/physics_manager.hpp>
 
 #include "Demo/sandbox.h"
+#include "Demo/render_common.h"
 #include "Demo/Components/SandboxCompManager.h"
 
 #include <thread>
@@ -49,6 +52,7 @@ fs::path const scene_directory("data//scenes//");
 
 static fs::path s_load_scene_at_path;
 static bool show_physics_debug_window = false;
+static bool show_allocations_window = false;
 
 
 void load_scene(fs::path _scene_path)
@@ -125,6 +129,7 @@ void menu_bar()
 		}
 
 		ImGui::MenuItem("Physics", "Ctrl+P", &show_physics_debug_window, &show_physics_debug_window);
+		ImGui::MenuItem("Allocations", nullptr, &show_allocations_window);
 
 		ImGui::EndMainMenuBar();
 
@@ -239,6 +244,8 @@ void update_loop()
 		Singleton<Component::CurveFollowerManager>().UpdateFollowers(TEMP_DT);
 		Singleton<Component::SkeletonAnimatorManager>().UpdateAnimatorInstances(TEMP_DT);
 
+		// Colliders and physics read world transforms of animated and followed entities.
+		Singleton<Component::TransformManager>().UpdateWorldMatrices();
 		Singleton<Component::ColliderManager>().TestColliderIntersections();
 
 		auto& scene_physics_mgr = Singleton<Engine::Physics::ScenePhysicsManager>();
@@ -251,11 +258,16 @@ void update_loop()
 
 		if (show_physics_debug_window)
 			Singleton<Engine::Physics::ScenePhysicsManager>().DisplayEditorWindow();
+		if (show_allocations_window)
+			Engine::Utils::allocation_tracker::display_editor_window();
 
 		sdl_manager.set_gl_debug_state(false);
 
 		Singleton<Engine::ECS::EntityManager>().FreeQueuedEntities();
 
+		// Rendering reads world matrices of transforms moved by physics.
+		Singleton<Component::TransformManager>().UpdateWorldMatrices();
+
 
 		Singleton<Engine::Managers::ResourceManager>().DisplayEditorWidget();
 		Singleton<Engine::Editor::Editor>().Render();
@@ -264,6 +276,10 @@ void update_loop()
 
 		SDL_GL_SwapWindow(Singleton<Engine::sdl_manager>().m_window);
 
+		// Transient containers of this frame are no longer in use.
+		Sandbox::s_frame_arena.reset();
+		Engine::Utils::allocation_tracker::end_frame();
+
 		if (sdl_manager.m_want_quit || sdl_manager.m_want_restart)
 			break;
 	}
@@ -52,6 +52,8 @@ namespace Sandbox
 
 	double			s_time = 0.0;
 
+	Engine::Utils::frame_arena	s_frame_arena;
+
 	GfxAmbientOcclusion s_ambient_occlusion;
 
 	GLuint s_buffers[1];
@@ -4,6 +4,7 @@
 #include <Engine/Graphics/manager.h>
 #include <Engine/Math/Transform3D.h>
 #include <Engine/Graphics/camera_data.h>
+#include <Engine/Utils/frame_arena.h>
 
 namespace Sandbox
 {
@@ -56,6 +57,9 @@ namespace Sandbox
 
 	extern double			s_time;
 
+	// Transient containers of a frame. Owned by the update loop, which resets it after the buffer swap.
+	extern Engine::Utils::frame_arena	s_frame_arena;
+
 	// Ambient occlusion data
 	struct GfxAmbientOcclusion
 	{
@@ -28,7 +28,7 @@ namespace Component
 	};
 	class CameraManager : public TCompManager<Camera>
 	{
-		std::unordered_map<Entity, Engine::Graphics::camera_data, Entity::hash> m_camera_data_map;
+		sparse_set<Engine::Graphics::camera_data> m_camera_data_map;
 
 		// Inherited via TCompManager
 		bool impl_create(Entity _e) final;
@@ -46,6 +46,7 @@ namespace Component
 
 		const char* GetComponentTypeName() const final { return "Camera"; }
 		auto const& AllCameras() const { return m_camera_data_map; }
+		decltype(m_camera_data_map)& GetComponentStorage() { return m_camera_data_map; }
 
 
 		// Inherited via TCompManager
@@ -16,10 +16,8 @@ namespace Component
 	{
 		std::vector<Entity> remove_from_updateable;
 		// Animate positions
-		for (Entity animateable_entity : m_animateable)
+		GetStorage().each<follower_data, follower_playing_tag>([&](Entity animateable_entity, follower_data& update_data, follower_playing_tag&)
 		{
-			follower_data & update_data = m_follower_map.at(animateable_entity);
-
 			float arclength_travelled = 0.0f;
 			// Update distance depending on used distance-time function
 			if (update_data.m_distance_time_func == follower_data::eLinear)
@@ -106,18 +104,18 @@ namespace Component
 				}
 			}
 			update_data.m_arclength = std::clamp(new_arclength, 0.0f, MAX_CURVE_ARCLENGTH);
-		}
+		});
 		// Update positions of following entities.
-		for (auto pair : m_follower_map)
+		GetStorage().each<follower_data>([](Entity _follower, follower_data& _data)
 		{
-			if (pair.second.m_curve_component.IsValid())
+			if (_data.m_curve_component.IsValid())
 			{
-				glm::vec3 const curve_world_position = pair.second.m_curve_component.Owner().GetComponent<Component::Transform>().ComputeWorldTransform().position;
-				pair.first.GetComponent<Component::Transform>().SetLocalPosition(
-					curve_world_position + pair.second.m_curve_component.GetPiecewiseCurve().m_lut.get_distance_position(pair.second.m_arclength)
+				glm::vec3 const curve_world_position = _data.m_curve_component.Owner().GetComponent<Component::Transform>().ComputeWorldTransform().position;
+				_follower.GetComponent<Component::Transform>().SetLocalPosition(
+					curve_world_position + _data.m_curve_component.GetPiecewiseCurve().m_lut.get_distance_position(_data.m_arclength)
 				);
 			}
-		}
+		});
 	}
 
 	void CurveFollowerManager::impl_deserialize_data(nlohmann::json const& _j)
@@ -125,8 +123,15 @@ namespace Component
 		int const serializer_version = _j["serializer_version"];
 		if (serializer_version == 1)
 		{
-			m_follower_map = _j["m_follower_map"].get<decltype(m_follower_map)>();
-			m_animateable = _j["m_animateable"].get<decltype(m_animateable)>();
+			// Version 1 stored an entity to follower map and the set of playing followers.
+			auto followers = _j["m_follower_map"].get<std::vector<std::pair<Entity, follower_data>>>();
+			for (auto& follower : followers)
+				GetStorage().emplace<follower_data>(follower.first, std::move(follower.second));
+			for (Entity const playing_entity : _j["m_animateable"].get<std::vector<Entity>>())
+			{
+				if (GetStorage().has<follower_data>(playing_entity))
+					GetStorage().emplace<follower_playing_tag>(playing_entity);
+			}
 		}
 	}
 
@@ -134,14 +139,21 @@ namespace Component
 	{
 		_j["serializer_version"] = 1;
 
-		_j["m_follower_map"] = m_follower_map;
-		_j["m_animateable"] = m_animateable;
+		std::vector<std::pair<Entity, follower_data>> followers;
+		std::vector<Entity> playing_entities;
+		GetStorage().each<follower_data>([&](Entity _e, follower_data& _data)
+		{
+			followers.emplace_back(_e, _data);
+			if (GetStorage().has<follower_playing_tag>(_e))
+				playing_entities.push_back(_e);
+		});
+		_j["m_follower_map"] = followers;
+		_j["m_animateable"] = playing_entities;
 	}
 
 	void CurveFollowerManager::set_follower_playing_state(Entity _e, bool _play_state)
 	{
-		follower_data& data = m_follower_map.at(_e);
-		bool is_playing = m_animateable.find(_e) != m_animateable.end();
+		follower_data& data = get_data(_e);
 		if (_play_state && data.m_curve_component.IsValid())
 		{
 			float const MAX_CURVE_ARCLENGTH = data.m_curve_component.GetPiecewiseCurve().m_lut.m_arclengths.back();
@@ -149,17 +161,18 @@ namespace Component
 				data.m_arclength = data.m_arclength + MAX_CURVE_ARCLENGTH;
 			else if (data.m_lin_dist_time_data.m_travel_rate > 0.0f && data.m_arclength > MAX_CURVE_ARCLENGTH)
 				data.m_arclength = data.m_arclength - MAX_CURVE_ARCLENGTH;
-			m_animateable.insert(_e);
+			// Moves the follower to the archetype of playing followers, data references are invalidated.
+			GetStorage().emplace<follower_playing_tag>(_e);
 		}
 		else
-			m_animateable.erase(_e);
+			GetStorage().remove<follower_playing_tag>(_e);
 
 	}
 
 	void CurveFollowerManager::impl_clear()
 	{
-		m_follower_map.clear();
-		m_animateable.clear();
+		GetStorage().remove_all<follower_playing_tag>();
+		TArchetypeCompManager::impl_clear();
 	}
 
 	bool CurveFollowerManager::impl_create(Entity _e)
@@ -170,7 +183,7 @@ namespace Component
 		new_follower_data.m_max_travel_rate = 1.0f;
 		new_follower_data.m_loop = true;
 		new_follower_data.m_curve_component = Entity::InvalidEntity;
-		m_follower_map.emplace(_e, std::move(new_follower_data));
+		GetStorage().emplace<follower_data>(_e, std::move(new_follower_data));
 		// set_follower_playing_state(_e, false); // Implied
 		return true;
 	}
@@ -178,26 +191,20 @@ namespace Component
 	void CurveFollowerManager::impl_destroy(Entity const* _entities, unsigned int _count)
 	{
 		for (unsigned int i = 0; i < _count; ++i)
-		{
-			m_follower_map.erase(_entities[i]);
-			m_animateable.erase(_entities[i]);
-		}
-	}
-
-	bool CurveFollowerManager::impl_component_owned_by_entity(Entity _entity) const
-	{
-		return m_follower_map.find(_entity) != m_follower_map.end();
+			GetStorage().remove<follower_playing_tag>(_entities[i]);
+		TArchetypeCompManager::impl_destroy(_entities, _count);
 	}
 
 	void CurveFollowerManager::impl_edit_component(Entity _entity)
 	{
-		follower_data& data = m_follower_map.at(_entity);
-
-		bool is_playing = m_animateable.find(_entity) != m_animateable.end();
+		bool is_playing = GetStorage().has<follower_playing_tag>(_entity);
 		if (ImGui::Checkbox("Is Playing", &is_playing))
 		{
 			set_follower_playing_state(_entity, is_playing);
 		}
+		// Fetched after changing playing state, which moves follower data.
+		follower_data& data = get_data(_entity);
+
 		bool casted_loop = data.m_loop;
 		if (ImGui::Checkbox("Is Looping", &casted_loop))
 			data.m_loop = casted_loop;
@@ -284,11 +291,11 @@ namespace Component
 
 	follower_data& CurveFollower::GetFollowerData()
 	{
-		return GetManager().m_follower_map.at(Owner());
+		return GetManager().get_data(Owner());
 	}
 	bool CurveFollower::GetPlayingState() const
 	{
-		return GetManager().m_animateable.find(Owner()) != GetManager().m_animateable.end();
+		return GetManager().GetStorage().has<follower_playing_tag>(Owner());
 	}
 	void CurveFollower::SetPlayingState(bool _state)
 	{
@@ -1,7 +1,7 @@
 #ifndef COMPONENTS_CURVEFOLLOWER_H
 #define COMPONENTS_CURVEFOLLOWER_H
 
-#include <Engine/ECS/component_manager.h>
+#include <Engine/ECS/archetype_comp_manager.h>
 #include "CurveInterpolator.h"
 
 namespace Component
@@ -52,6 +52,10 @@ namespace Component
 		friend class CurveFollowerManager;
 	};
 
+	// Tags followers that travel along their curve. Playing followers share an archetype, so they
+	// are advanced without visiting paused ones.
+	struct follower_playing_tag {};
+
 	class CurveFollowerManager;
 	struct CurveFollower final : public IComp<CurveFollowerManager>
 	{
@@ -62,19 +66,14 @@ namespace Component
 		bool GetPlayingState() const;
 		void SetPlayingState(bool _state);
 	};
-	class CurveFollowerManager final : public TCompManager<CurveFollower>
+	class CurveFollowerManager final : public TArchetypeCompManager<CurveFollower, follower_data>
 	{
-		std::unordered_map<Entity, follower_data, Entity::hash> m_follower_map;
-
-		std::unordered_set<Entity, Entity::hash> m_animateable;
-
 		void set_follower_distance(Entity _e, follower_data& _data, float _distance);
 		void set_follower_playing_state(Entity _e, bool _play_state);
 
 		virtual void impl_clear() override;
 		virtual bool impl_create(Entity _e) override;
 		virtual void impl_destroy(Entity const* _entities, unsigned int _count) override;
-		virtual bool impl_component_owned_by_entity(Entity _entity) const override;
 		virtual void impl_edit_component(Entity _entity) override;
 
 		friend struct CurveFollower;
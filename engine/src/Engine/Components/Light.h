@@ -63,7 +63,7 @@ namespace Component
 	{
 		friend struct PointLight;
 
-		std::unordered_map<Entity, unsigned int, Entity::hash> m_entity_map;
+		sparse_set<unsigned int> m_entity_map;
 		// Store light data in SOA format so we can pass many lights at once if we desire to do so.
 		std::vector<Entity> m_index_entities;
 		std::vector<glm::vec3> m_light_color_arr;
@@ -87,6 +87,8 @@ namespace Component
 
 		const char* GetComponentTypeName() const final { return "PointLight"; }
 		Collection GetPointLightCollection() const;
+		// Maps entities to their index in light data arrays.
+		decltype(m_entity_map)& GetComponentStorage() { return m_entity_map; }
 
 
 		// Inherited via TCompManager
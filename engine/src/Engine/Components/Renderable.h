@@ -46,7 +46,7 @@ namespace Component
 	{
 		friend struct Renderable;
 
-		std::unordered_map<Entity, Engine::Managers::Resource, Entity::hash> m_mesh_map;
+		sparse_set<Engine::Managers::Resource> m_mesh_map;
 
 		void impl_clear() final;
 		bool impl_create(Entity _e) final;
@@ -60,6 +60,7 @@ namespace Component
 		const char* GetComponentTypeName() const final { return "Renderable"; }
 
 		decltype(m_mesh_map) const& GetAllRenderables() const { return m_mesh_map; }
+		decltype(m_mesh_map)& GetComponentStorage() { return m_mesh_map; }
 
 
 		// Inherited via TCompManager
@@ -82,7 +83,7 @@ namespace Component
 			NLOHMANN_DEFINE_TYPE_INTRUSIVE(skin_instance, m_skin_handle, m_skeleton_root, m_skeleton_instance_nodes)
 		};
 
-		std::unordered_map<Entity, skin_instance, Entity::hash> m_skin_instance_map;
+		sparse_set<skin_instance> m_skin_instance_map;
 
 		// Inherited via TCompManager
 		virtual void impl_clear() override;
@@ -96,6 +97,7 @@ namespace Component
 		virtual const char* GetComponentTypeName() const override;
 
 		decltype(m_skin_instance_map) const& GetAllSkinEntities() const { return m_skin_instance_map; }
+		decltype(m_skin_instance_map)& GetComponentStorage() { return m_skin_instance_map; }
 
 
 		// Inherited via TCompManager
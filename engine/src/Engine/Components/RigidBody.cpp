@@ -6,6 +6,7 @@
 
 #include <Engine/Physics/integration.h>
 #include <Engine/Editor/editor.h>
+#include <Engine/Utils/algorithm.h>
 
 #include <algorithm>
 
@@ -38,28 +39,62 @@ namespace Component
 			{
 				Transform entity_transform_component = m_rigidbodies_data.m_index_entities[i].GetComponent<Transform>();
 				assert(entity_transform_component.GetParent() == Entity::InvalidEntity && "Rigidbody entities are assumed to have no parent.");
-				m_rigidbodies_data.m_positions[i] = entity_transform_component.GetLocalPosition();
-				m_rigidbodies_data.m_rotations[i] = entity_transform_component.GetLocalRotation();
+				glm::vec3 const position = entity_transform_component.GetLocalPosition();
+				glm::quat const rotation = entity_transform_component.GetLocalRotation();
+
+				// Wake up sleeping bodies that have been moved externally (e.g. in the editor).
+				bool const rotation_changed = rotation != m_rigidbodies_data.m_rotations[i];
+				if (m_rigidbodies_data.is_sleeping(i) && (position != m_rigidbodies_data.m_positions[i] || rotation_changed))
+					m_rigidbodies_data.wake(i);
+
+				m_rigidbodies_data.m_positions[i] = position;
+				m_rigidbodies_data.m_rotations[i] = rotation;
+				if (rotation_changed)
+					m_rigidbodies_data.update_inv_world_tensor(i);
 			}
 		}
 
-		integrate_linear_euler(
-			_dt,
-			&m_rigidbodies_data.m_positions.front(),
-			&m_rigidbodies_data.m_linear_momentums.front(),
-			&m_rigidbodies_data.m_force_accumulators.front(),
-			&m_rigidbodies_data.m_inv_masses.front(),
-			rigidbody_count - m_rigidbodies_data.m_skip_linear_integration_count
-		);
+		// Only integrate contiguous ranges of awake bodies.
+		auto for_each_awake_range = [this](size_t const _count, auto&& _integrate_range)
+		{
+			size_t begin = 0;
+			while (begin < _count)
+			{
+				while (begin < _count && m_rigidbodies_data.is_sleeping(begin))
+					begin++;
+				size_t end = begin;
+				while (end < _count && !m_rigidbodies_data.is_sleeping(end))
+					end++;
+				if (end > begin)
+					_integrate_range(begin, end - begin);
+				begin = end;
+			}
+		};
 
-		integrate_angular_euler(
-			_dt,
-			&m_rigidbodies_data.m_rotations.front(),
-			&m_rigidbodies_data.m_angular_momentums.front(),
-			&m_rigidbodies_data.m_torque_accumulators.front(),
-			&m_rigidbodies_data.m_inv_inertial_tensors.front(),
-			rigidbody_count
-		);
+		for_each_awake_range(rigidbody_count - m_rigidbodies_data.m_skip_linear_integration_count, [&](size_t _first, size_t _count)
+		{
+			integrate_linear_euler(
+				_dt,
+				&m_rigidbodies_data.m_positions[_first],
+				&m_rigidbodies_data.m_linear_momentums[_first],
+				&m_rigidbodies_data.m_force_accumulators[_first],
+				&m_rigidbodies_data.m_inv_masses[_first],
+				_count
+			);
+		});
+
+		for_each_awake_range(rigidbody_count, [&](size_t _first, size_t _count)
+		{
+			integrate_angular_euler(
+				_dt,
+				&m_rigidbodies_data.m_rotations[_first],
+				&m_rigidbodies_data.m_angular_momentums[_first],
+				&m_rigidbodies_data.m_torque_accumulators[_first],
+				&m_rigidbodies_data.m_inv_inertial_tensors[_first],
+				&m_rigidbodies_data.m_inv_world_tensors[_first],
+				_count
+			);
+		});
 	}
 
 	void RigidBodyManager::ClearForces()
@@ -79,6 +114,10 @@ namespace Component
 		size_t const rigidbody_count = m_rigidbodies_data.size();
 		for (size_t i = 0; i < rigidbody_count; i++)
 		{
+			// Sleeping bodies have not moved since their transform was last updated.
+			if (m_rigidbodies_data.is_sleeping(i))
+				continue;
+
 			Transform entity_transform_component = m_rigidbodies_data.m_index_entities[i].GetComponent<Transform>();
 			entity_transform_component.SetLocalPosition(m_rigidbodies_data.m_positions[i]);
 			entity_transform_component.SetLocalRotation(m_rigidbodies_data.m_rotations[i]);
@@ -97,6 +136,7 @@ namespace Component
 
 	void RigidBodyManager::ApplyForce(size_t _entity_index, glm::vec3 _force, glm::vec3 _offset)
 	{
+		m_rigidbodies_data.wake(_entity_index);
 		m_rigidbodies_data.m_force_accumulators[_entity_index] += _force;
 		m_rigidbodies_data.m_torque_accumulators[_entity_index] += glm::cross(_offset, _force);
 	}
@@ -105,6 +145,7 @@ namespace Component
 	{
 		m_rigidbodies_data.m_inertial_tensors[_entity_index] = _inertial_tensor;
 		m_rigidbodies_data.m_inv_inertial_tensors[_entity_index] = glm::inverse(_inertial_tensor);
+		m_rigidbodies_data.update_inv_world_tensor(_entity_index);
 	}
 
 	Engine::Physics::rigidbody_data RigidBodyManager::GetEntityRigidBodyData(Entity _e) const
@@ -119,6 +160,7 @@ namespace Component
 		rb_data.torque_accumulator = m_rigidbodies_data.m_torque_accumulators[entity_index];
 		rb_data.inertial_tensor = m_rigidbodies_data.m_inertial_tensors[entity_index];
 		rb_data.inv_inertial_tensor= m_rigidbodies_data.m_inv_inertial_tensors[entity_index];
+		rb_data.inv_world_tensor = m_rigidbodies_data.m_inv_world_tensors[entity_index];
 		rb_data.inv_mass = m_rigidbodies_data.m_inv_masses[entity_index];
 		rb_data.restitution = m_rigidbodies_data.m_restitution[entity_index];
 		rb_data.friction_coefficient = m_rigidbodies_data.m_friction_coefficient[entity_index];
@@ -139,6 +181,7 @@ namespace Component
 		m_rigidbodies_data.m_inv_masses[entity_index] = _rb_data.inv_mass;
 		m_rigidbodies_data.m_restitution[entity_index] = _rb_data.restitution;
 		m_rigidbodies_data.m_friction_coefficient[entity_index] = _rb_data.friction_coefficient;
+		m_rigidbodies_data.update_inv_world_tensor(entity_index);
 	}
 
 	void RigidBodyManager::impl_clear()
@@ -170,11 +213,7 @@ namespace Component
 
 	void RigidBodyManager::impl_destroy(Entity const* _entities, unsigned int _count)
 	{
-		for (size_t i = 0; i < _count; i++)
-		{
-			if (m_rigidbodies_data.has(_entities[i]))
-				m_rigidbodies_data.erase(_entities[i]);
-		}
+		m_rigidbodies_data.erase(_entities, _count);
 	}
 
 	bool RigidBodyManager::impl_component_owned_by_entity(Entity _entity) const
@@ -273,6 +312,8 @@ namespace Component
 			m_rigidbodies_data = _j["rigidbody_data"];
 			m_rigidbodies_data.m_force_accumulators.resize(m_rigidbodies_data.m_entity_map.size(), glm::vec3(0.0f));
 			m_rigidbodies_data.m_torque_accumulators.resize(m_rigidbodies_data.m_entity_map.size(), glm::vec3(0.0f));
+			m_rigidbodies_data.m_sleep_timers.assign(m_rigidbodies_data.m_entity_map.size(), 0);
+			m_rigidbodies_data.m_sleep_islands.assign(m_rigidbodies_data.m_entity_map.size(), rigidbody_data_collection::AWAKE_ISLAND);
 			m_rigidbodies_data.m_inv_inertial_tensors.resize(m_rigidbodies_data.m_entity_map.size());
 			for (size_t i = 0; i < m_rigidbodies_data.size(); i++)
 			{
@@ -281,6 +322,7 @@ namespace Component
 				else
 					m_rigidbodies_data.m_inv_inertial_tensors[i] = glm::inverse(m_rigidbodies_data.m_inertial_tensors[i]);
 			}
+			m_rigidbodies_data.update_inv_world_tensors();
 		}
 	}
 
@@ -322,6 +364,12 @@ namespace Component
 		m_restitution.push_back(0.5f);
 		m_friction_coefficient.push_back(0.8f);
 
+		m_inv_world_tensors.emplace_back();
+		update_inv_world_tensor(new_element_index);
+
+		m_sleep_timers.push_back(0);
+		m_sleep_islands.push_back(AWAKE_ISLAND);
+
 		// Update enabled & disabled linear integration partitions.
 		m_skip_linear_integration_count += 1;
 		enable_linear_integration(_entity, true);
@@ -334,12 +382,73 @@ namespace Component
 		// If entity has linear integration enabled,
 		// disable it so it is in front of disabled partition.
 		enable_linear_integration(_entity, false);
-		// Swap with back
-		swap_back(size() - m_skip_linear_integration_count);
+		// Swap with back, and point map of swapped back entity to its new index.
+		size_t const entity_index = size() - m_skip_linear_integration_count;
+		if (swap_back(entity_index))
+			m_entity_map.at(m_index_entities[entity_index]) = entity_index;
 		pop_back();
 		m_entity_map.erase(_entity);
 	}
 
+	/*
+	* @brief	Erase bodies of many entities at once. Entities without rigidbody are skipped.
+	* @details	Arrays are compacted once along the sorted indices of erased bodies, which keeps the
+	*			integrated and skipped partitions contiguous. Indices of moved bodies are patched once.
+	*/
+	void RigidBodyManager::rigidbody_data_collection::erase(Entity const* _entities, size_t _count)
+	{
+		std::vector<size_t> erased_indices;
+		erased_indices.reserve(_count);
+		for (size_t i = 0; i < _count; i++)
+		{
+			auto const map_iter = m_entity_map.find(_entities[i]);
+			if (map_iter == m_entity_map.end())
+				continue;
+			erased_indices.push_back(map_iter->second);
+			m_entity_map.erase(map_iter);
+		}
+		if (erased_indices.empty())
+			return;
+		std::sort(erased_indices.begin(), erased_indices.end());
+
+		size_t const skip_partition_begin = size() - m_skip_linear_integration_count;
+		size_t const erased_skipped_count = erased_indices.end() - std::lower_bound(erased_indices.begin(), erased_indices.end(), skip_partition_begin);
+
+		auto erase_indices = [&erased_indices](auto& _container)
+		{
+			Engine::Utils::erase_sorted_indices(_container, erased_indices);
+		};
+
+		// Map
+		erase_indices(m_index_entities);
+
+		// Linear
+		erase_indices(m_positions);
+		erase_indices(m_linear_momentums);
+		erase_indices(m_force_accumulators);
+		// Angular
+		erase_indices(m_rotations);
+		erase_indices(m_angular_momentums);
+		erase_indices(m_torque_accumulators);
+		// Constant properties
+		erase_indices(m_inv_masses);
+		erase_indices(m_inertial_tensors);
+		erase_indices(m_inv_inertial_tensors);
+		erase_indices(m_restitution);
+		erase_indices(m_friction_coefficient);
+		// Derived
+		erase_indices(m_inv_world_tensors);
+		// Sleeping
+		erase_indices(m_sleep_timers);
+		erase_indices(m_sleep_islands);
+
+		m_skip_linear_integration_count -= erased_skipped_count;
+
+		// Only bodies behind the first erased index have moved.
+		for (size_t i = erased_indices.front(); i < size(); i++)
+			m_entity_map.at(m_index_entities[i]) = i;
+	}
+
 	bool RigidBodyManager::rigidbody_data_collection::has(Entity _entity) const
 	{
 		return m_entity_map.find(_entity) != m_entity_map.end();
@@ -383,6 +492,11 @@ namespace Component
 		swap_indices(m_inv_inertial_tensors);
 		swap_indices(m_restitution);
 		swap_indices(m_friction_coefficient);
+		// Derived
+		swap_indices(m_inv_world_tensors);
+		// Sleeping
+		swap_indices(m_sleep_timers);
+		swap_indices(m_sleep_islands);
 
 		return true;
 	}
@@ -405,6 +519,11 @@ namespace Component
 		m_restitution.pop_back();
 		m_friction_coefficient.pop_back();
 
+		m_inv_world_tensors.pop_back();
+
+		m_sleep_timers.pop_back();
+		m_sleep_islands.pop_back();
+
 		m_skip_linear_integration_count -= 1;
 	}
 
@@ -450,6 +569,64 @@ namespace Component
 		}
 	}
 
+	/*
+	* @brief	Put bodies of an island to sleep, removing their momentum.
+	* @param	size_t const *	Indices of bodies in island
+	* @param	size_t			Number of bodies in island
+	*/
+	void RigidBodyManager::rigidbody_data_collection::sleep_island(size_t const* _entity_indices, size_t _count)
+	{
+		uint32_t const island = m_next_sleep_island++;
+		if (m_next_sleep_island == AWAKE_ISLAND)
+			m_next_sleep_island = 0;
+
+		for (size_t i = 0; i < _count; i++)
+		{
+			size_t const entity_index = _entity_indices[i];
+			m_sleep_islands[entity_index] = island;
+			m_linear_momentums[entity_index] = glm::vec3(0.0f);
+			m_angular_momentums[entity_index] = glm::vec3(0.0f);
+		}
+	}
+
+	/*
+	* @brief	Wake up body, and all bodies sleeping in the same island.
+	* @param	size_t	Index of body
+	*/
+	void RigidBodyManager::rigidbody_data_collection::wake(size_t const _entity_index)
+	{
+		uint32_t const island = m_sleep_islands[_entity_index];
+		m_sleep_timers[_entity_index] = 0;
+		if (island == AWAKE_ISLAND)
+			return;
+
+		for (size_t i = 0; i < size(); i++)
+		{
+			if (m_sleep_islands[i] == island)
+			{
+				m_sleep_islands[i] = AWAKE_ISLAND;
+				m_sleep_timers[i] = 0;
+			}
+		}
+	}
+
+	void RigidBodyManager::rigidbody_data_collection::wake_all()
+	{
+		std::fill(m_sleep_timers.begin(), m_sleep_timers.end(), uint16_t(0));
+		std::fill(m_sleep_islands.begin(), m_sleep_islands.end(), AWAKE_ISLAND);
+	}
+
+	void RigidBodyManager::rigidbody_data_collection::update_inv_world_tensor(size_t const _entity_index)
+	{
+		Engine::Physics::compute_inv_world_tensors(&m_rotations[_entity_index], &m_inv_inertial_tensors[_entity_index], &m_inv_world_tensors[_entity_index], 1);
+	}
+
+	void RigidBodyManager::rigidbody_data_collection::update_inv_world_tensors()
+	{
+		m_inv_world_tensors.resize(size());
+		Engine::Physics::compute_inv_world_tensors(m_rotations.data(), m_inv_inertial_tensors.data(), m_inv_world_tensors.data(), size());
+	}
+
 	Engine::Physics::rigidbody_data RigidBody::GetRigidBodyData() const
 	{
 		return GetManager().GetEntityRigidBodyData(Owner());
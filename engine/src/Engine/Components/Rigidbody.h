@@ -36,6 +36,7 @@ namespace Component
 			);
 
 			void erase(Entity _entity);
+			void erase(Entity const* _entities, size_t _count);
 			bool has(Entity _entity) const;
 			size_t get_entity_index(Entity _entity) const;
 			bool swap_back(size_t _idx);
@@ -46,7 +47,18 @@ namespace Component
 			bool is_linear_integration_enabled(size_t const _entity_index) const;
 			void enable_linear_integration(Entity const _entity, bool _state);
 
-			std::unordered_map<Entity, size_t, Entity::hash> m_entity_map;
+			bool is_sleeping(size_t const _entity_index) const { return m_sleep_islands[_entity_index] != AWAKE_ISLAND; }
+			void sleep_island(size_t const* _entity_indices, size_t _count);
+			void wake(size_t const _entity_index);
+			void wake_all();
+
+			// Recompute cached world inverse inertia tensors, after rotations or tensors were changed directly.
+			void update_inv_world_tensor(size_t const _entity_index);
+			void update_inv_world_tensors();
+
+			static constexpr uint32_t AWAKE_ISLAND = ~0u;
+
+			sparse_set<size_t> m_entity_map;
 			// Index map
 			std::vector<Entity> m_index_entities;
 
@@ -69,6 +81,15 @@ namespace Component
 			std::vector<float>		m_restitution;
 			std::vector<float>		m_friction_coefficient; // [0,1]
 
+			// ### Derived (not serialized)
+			// R * I^-1 * R^T for current rotation. Updated by integration, and when rotation or tensor is set.
+			std::vector<glm::mat3>	m_inv_world_tensors;
+
+			// ### Sleeping (not serialized, bodies are awake when loaded)
+			std::vector<uint16_t>	m_sleep_timers;			// Consecutive frames spent below sleep velocity thresholds
+			std::vector<uint32_t>	m_sleep_islands;		// Island body is sleeping in, or AWAKE_ISLAND
+			uint32_t				m_next_sleep_island = 0;
+
 			NLOHMANN_DEFINE_TYPE_INTRUSIVE(
 				rigidbody_data_collection,
 				m_entity_map,
@@ -94,6 +115,8 @@ namespace Component
 
 		// Inherited via TCompManager
 		virtual const char* GetComponentTypeName() const override;
+		// Maps entities to their index in rigidbody data collection.
+		decltype(rigidbody_data_collection::m_entity_map)& GetComponentStorage() { return m_rigidbodies_data.m_entity_map; }
 
 		void Integrate(float _dt);
 		void ClearForces();
@@ -1,16 +1,22 @@
 #include "SkeletonAnimator.h"
 #include <Engine/Utils/algorithm.h>
+#include <Engine/Utils/allocation_tracker.h>
+#include <Engine/Utils/job_system.h>
 #include <Engine/Utils/logging.h>
 #include <Engine/Managers/input.h>
 #include <Engine/Graphics/sdl_window.h>
 #include <Engine/Math/Transform3D.h>
 
 #include "Renderable.h"
+#include "animation_pose_simd.hpp"
+#include <Engine/ECS/view.h>
 
 #include <imgui_stdlib.h>
 #include <imgui_internal.h>
 
+#include <algorithm>
 #include <array>
+#include <cassert>
 #include <fstream>
 #include <filesystem>
 #include <delaunator/delaunator.hpp>
@@ -32,95 +38,268 @@ namespace Component
         m_anim_speed = _speed && ((~0) << 2);
     }
 
+    using Engine::Math::transform3D;
+    size_t constexpr JOINT_LANES = joint_transform_lanes::JOINT_LANES;
+
+    static void set_identity_lanes(joint_transform_lanes& _block, size_t _first_lane)
+    {
+        for (size_t lane = _first_lane; lane < JOINT_LANES; ++lane)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                _block.m_position[c][lane] = 0.0f;
+                _block.m_scale[c][lane] = 1.0f;
+            }
+            _block.m_rotation[0][lane] = 1.0f;
+            _block.m_rotation[1][lane] = 0.0f;
+            _block.m_rotation[2][lane] = 0.0f;
+            _block.m_rotation[3][lane] = 0.0f;
+        }
+    }
+
     /*
-    * Applies given blend mask to this pose.
-    * @param    animation_blend_mask        Mask to apply
-    * @details  TODO: My understanding is probably wrong and should instead perhaps be
-    * interpolating between the desired joint transform and the bind pose joint transform.
+    * Scalar blend of joint lanes, used where SIMD kernels are not available.
+    * @param    TWeights    Callable returning weight of the right pose at block and lane.
     */
-    void animation_pose::apply_blend_mask(animation_blend_mask const & _mask, animation_pose const& _other)
+    template<typename TWeights>
+    static void blend_joint_lanes_scalar(
+        joint_transform_lanes* _dest,
+        joint_transform_lanes const* _left,
+        joint_transform_lanes const* _right,
+        TWeights&& _right_weights,
+        size_t _block_count
+    )
     {
-        using interp_type = Engine::Graphics::animation_sampler_data::E_interpolation_type;
+        for (size_t b = 0; b < _block_count; ++b)
+        {
+            for (size_t lane = 0; lane < JOINT_LANES; ++lane)
+            {
+                float const right_weight = _right_weights(b, lane);
+                float const left_weight = 1.0f - right_weight;
+                for (int c = 0; c < 3; ++c)
+                {
+                    _dest[b].m_position[c][lane] = left_weight * _left[b].m_position[c][lane] + right_weight * _right[b].m_position[c][lane];
+                    _dest[b].m_scale[c][lane] = left_weight * _left[b].m_scale[c][lane] + right_weight * _right[b].m_scale[c][lane];
+                }
+                float rotation[4];
+                float length_squared = 0.0f;
+                for (int c = 0; c < 4; ++c)
+                {
+                    rotation[c] = left_weight * _left[b].m_rotation[c][lane] + right_weight * _right[b].m_rotation[c][lane];
+                    length_squared += rotation[c] * rotation[c];
+                }
+                float const inv_length = 1.0f / std::sqrt(length_squared);
+                for (int c = 0; c < 4; ++c)
+                    _dest[b].m_rotation[c][lane] = rotation[c] * inv_length;
+            }
+        }
+    }
 
-        for (unsigned int i = 0; i < m_joint_transforms.size(); ++i)
+    static void blend_joint_lanes_scalar(
+        joint_transform_lanes* _dest,
+        joint_transform_lanes const* const _poses[3],
+        float const _weights[3],
+        size_t _block_count
+    )
+    {
+        for (size_t b = 0; b < _block_count; ++b)
         {
-            bool use_left = _mask[i] >= 1.0f;
-            m_joint_transforms[i] = use_left ? 
-                m_joint_transforms[i] : 
-                _other.m_joint_transforms[i];
+            for (size_t lane = 0; lane < JOINT_LANES; ++lane)
+            {
+                for (int c = 0; c < 3; ++c)
+                {
+                    _dest[b].m_position[c][lane] =
+                        _poses[0][b].m_position[c][lane] * _weights[0] +
+                        _poses[1][b].m_position[c][lane] * _weights[1] +
+                        _poses[2][b].m_position[c][lane] * _weights[2];
+                    _dest[b].m_scale[c][lane] =
+                        _poses[0][b].m_scale[c][lane] * _weights[0] +
+                        _poses[1][b].m_scale[c][lane] * _weights[1] +
+                        _poses[2][b].m_scale[c][lane] * _weights[2];
+                }
+                float rotation[4];
+                float length_squared = 0.0f;
+                for (int c = 0; c < 4; ++c)
+                {
+                    rotation[c] =
+                        _poses[0][b].m_rotation[c][lane] * _weights[0] +
+                        _poses[1][b].m_rotation[c][lane] * _weights[1] +
+                        _poses[2][b].m_rotation[c][lane] * _weights[2];
+                    length_squared += rotation[c] * rotation[c];
+                }
+                float const inv_length = 1.0f / std::sqrt(length_squared);
+                for (int c = 0; c < 4; ++c)
+                    _dest[b].m_rotation[c][lane] = rotation[c] * inv_length;
+            }
         }
     }
 
-    animation_pose& animation_pose::apply_blend_factor(float _factor, animation_pose const & _bind_pose)
+    // Blend blocks of joints with the widest kernel available.
+    static void blend_pose_lanes(
+        joint_transform_lanes* _dest,
+        joint_transform_lanes const* _left,
+        joint_transform_lanes const* _right,
+        float _right_weight,
+        size_t _block_count,
+        Engine::Math::ESIMDLevel _simd_level
+    )
+    {
+#if defined(ENGINE_SIMD_AVX2_KERNELS)
+        if (_simd_level >= Engine::Math::eAVX2 && Engine::Math::get_supported_simd_level() >= Engine::Math::eAVX2)
+            AnimationUtil::blend_joint_lanes_avx2(_dest, _left, _right, _right_weight, _block_count);
+        else
+#endif
+        if (_simd_level >= Engine::Math::eSSE)
+            AnimationUtil::blend_joint_lanes(_dest, _left, _right, _right_weight, _block_count);
+        else
+            blend_joint_lanes_scalar(_dest, _left, _right, [_right_weight](size_t, size_t) { return _right_weight; }, _block_count);
+    }
+
+    static void blend_pose_lanes(
+        joint_transform_lanes* _dest,
+        joint_transform_lanes const* _left,
+        joint_transform_lanes const* _right,
+        float const* _right_weights,
+        size_t _block_count,
+        Engine::Math::ESIMDLevel _simd_level
+    )
+    {
+#if defined(ENGINE_SIMD_AVX2_KERNELS)
+        if (_simd_level >= Engine::Math::eAVX2 && Engine::Math::get_supported_simd_level() >= Engine::Math::eAVX2)
+            AnimationUtil::blend_joint_lanes_avx2(_dest, _left, _right, _right_weights, _block_count);
+        else
+#endif
+        if (_simd_level >= Engine::Math::eSSE)
+            AnimationUtil::blend_joint_lanes(_dest, _left, _right, _right_weights, _block_count);
+        else
+            blend_joint_lanes_scalar(_dest, _left, _right, [_right_weights](size_t _block, size_t _lane) { return _right_weights[_block * JOINT_LANES + _lane]; }, _block_count);
+    }
+
+    static void blend_pose_lanes(
+        joint_transform_lanes* _dest,
+        joint_transform_lanes const* const _poses[3],
+        float const _weights[3],
+        size_t _block_count,
+        Engine::Math::ESIMDLevel _simd_level
+    )
+    {
+#if defined(ENGINE_SIMD_AVX2_KERNELS)
+        if (_simd_level >= Engine::Math::eAVX2 && Engine::Math::get_supported_simd_level() >= Engine::Math::eAVX2)
+            AnimationUtil::blend_joint_lanes_avx2(_dest, _poses, _weights, _block_count);
+        else
+#endif
+        if (_simd_level >= Engine::Math::eSSE)
+            AnimationUtil::blend_joint_lanes(_dest, _poses, _weights, _block_count);
+        else
+            blend_joint_lanes_scalar(_dest, _poses, _weights, _block_count);
+    }
+
+    void animation_pose::clear()
     {
-        using interp_type = Engine::Graphics::animation_sampler_data::E_interpolation_type;
+        m_joint_lanes.clear();
+        m_joint_count = 0;
+    }
 
-        glm::vec3 const zero_vec(0.0f);
-        glm::vec3 const one_vec(1.0f);
-        glm::quat const identity_quat(zero_vec);
-        float const inv_mask = 1.0f - _factor;
-        for (unsigned int i = 0; i < m_joint_transforms.size(); ++i)
+    void animation_pose::resize(size_t _joint_count)
+    {
+        size_t const first_reset_joint = std::min(m_joint_count, _joint_count);
+        m_joint_lanes.resize((_joint_count + JOINT_LANES - 1) / JOINT_LANES);
+        m_joint_count = _joint_count;
+        // Joints past the previous count and padding lanes of the last block become identity transforms.
+        for (size_t b = first_reset_joint / JOINT_LANES; b < m_joint_lanes.size(); ++b)
+            set_identity_lanes(m_joint_lanes[b], b == first_reset_joint / JOINT_LANES ? first_reset_joint % JOINT_LANES : 0);
+    }
+
+    transform3D animation_pose::get_joint_transform(size_t _joint) const
+    {
+        joint_transform_lanes const& block = m_joint_lanes[_joint / JOINT_LANES];
+        size_t const lane = _joint % JOINT_LANES;
+        transform3D transform;
+        transform.position = glm::vec3(block.m_position[0][lane], block.m_position[1][lane], block.m_position[2][lane]);
+        transform.scale = glm::vec3(block.m_scale[0][lane], block.m_scale[1][lane], block.m_scale[2][lane]);
+        transform.rotation = glm::quat(block.m_rotation[0][lane], block.m_rotation[1][lane], block.m_rotation[2][lane], block.m_rotation[3][lane]);
+        return transform;
+    }
+
+    void animation_pose::set_joint_transform(size_t _joint, transform3D const& _transform)
+    {
+        joint_transform_lanes& block = m_joint_lanes[_joint / JOINT_LANES];
+        size_t const lane = _joint % JOINT_LANES;
+        for (int c = 0; c < 3; ++c)
         {
-            Engine::Math::transform3D& current_transform = m_joint_transforms[i];
-            Engine::Math::transform3D const & bind_transform = _bind_pose.m_joint_transforms[i];
-            AnimationUtil::interpolate_vector(
-                &current_transform.position,
-                &current_transform.position,
-                &bind_transform.position,
-                inv_mask,
-                interp_type::LINEAR
-            );
-            AnimationUtil::interpolate_vector(
-                &current_transform.scale,
-                &current_transform.scale,
-                &bind_transform.scale,
-                inv_mask,
-                interp_type::LINEAR
-            );
-            AnimationUtil::interpolate_quaternion(
-                &current_transform.rotation,
-                &current_transform.rotation,
-                &bind_transform.rotation,
-                inv_mask,
-                interp_type::LINEAR,
-                false
-            );
+            block.m_position[c][lane] = _transform.position[c];
+            block.m_scale[c][lane] = _transform.scale[c];
         }
+        block.m_rotation[0][lane] = _transform.rotation.w;
+        block.m_rotation[1][lane] = _transform.rotation.x;
+        block.m_rotation[2][lane] = _transform.rotation.y;
+        block.m_rotation[3][lane] = _transform.rotation.z;
+    }
 
-        return *this;
+    void animation_pose::set_joint_transforms(transform3D const* _transforms, size_t _count)
+    {
+        resize(_count);
+        for (size_t i = 0; i < _count; ++i)
+            set_joint_transform(i, _transforms[i]);
     }
 
-    animation_pose& animation_pose::mix(animation_pose const& _left, animation_pose const& _right, float _blend_param)
+    /*
+    * Applies given blend mask to this pose.
+    * @param    animation_blend_mask        Mask to apply, weight of this pose per joint.
+    * @param    animation_pose const &      Pose used where mask weight is zero.
+    * @details  Joints in between are blended with the mask as weight, such that masks of zeros and
+    * ones pick joints from either pose.
+    * TODO: My understanding is probably wrong and should instead perhaps be
+    * interpolating between the desired joint transform and the bind pose joint transform.
+    */
+    void animation_pose::apply_blend_mask(animation_blend_mask const & _mask, animation_pose const& _other, Engine::Math::ESIMDLevel _simd_level)
     {
-        using interp_type = Engine::Graphics::animation_sampler_data::E_interpolation_type;
-        if (_left.m_joint_transforms.size() == _right.m_joint_transforms.size())
-            m_joint_transforms.resize(_left.m_joint_transforms.size());
-        for (unsigned int i = 0; i < m_joint_transforms.size(); ++i)
+        // Empty mask uses all joints of this pose.
+        size_t const joint_count = std::min({ m_joint_count, _other.m_joint_count, _mask.m_joint_blend_masks.size() });
+        size_t const full_block_count = joint_count / JOINT_LANES;
+        float const* mask = _mask.m_joint_blend_masks.data();
+        blend_pose_lanes(m_joint_lanes.data(), _other.m_joint_lanes.data(), m_joint_lanes.data(), mask, full_block_count, _simd_level);
+
+        // Mask of the last block is padded with weights keeping this pose.
+        if (size_t const remaining_joints = joint_count % JOINT_LANES)
         {
-            Engine::Math::transform3D& current_transform = m_joint_transforms[i];
-            AnimationUtil::interpolate_vector(
-                &current_transform.position,
-                &_left.m_joint_transforms[i].position,
-                &_right.m_joint_transforms[i].position,
-                _blend_param,
-                interp_type::LINEAR
-            );
-            AnimationUtil::interpolate_vector(
-                &current_transform.scale,
-                &_left.m_joint_transforms[i].scale,
-                &_right.m_joint_transforms[i].scale,
-                _blend_param,
-                interp_type::LINEAR
-            );
-            AnimationUtil::interpolate_quaternion(
-                &current_transform.rotation,
-                &_left.m_joint_transforms[i].rotation,
-                &_right.m_joint_transforms[i].rotation,
-                _blend_param,
-                interp_type::LINEAR,
-                false
+            alignas(32) float block_mask[JOINT_LANES];
+            for (size_t lane = 0; lane < JOINT_LANES; ++lane)
+                block_mask[lane] = lane < remaining_joints ? mask[full_block_count * JOINT_LANES + lane] : 1.0f;
+            blend_pose_lanes(
+                &m_joint_lanes[full_block_count],
+                &_other.m_joint_lanes[full_block_count],
+                &m_joint_lanes[full_block_count],
+                block_mask, 1, _simd_level
             );
         }
+    }
+
+    animation_pose& animation_pose::apply_blend_factor(float _factor, animation_pose const & _bind_pose, Engine::Math::ESIMDLevel _simd_level)
+    {
+        blend_pose_lanes(
+            m_joint_lanes.data(),
+            m_joint_lanes.data(),
+            _bind_pose.m_joint_lanes.data(),
+            1.0f - _factor,
+            std::min(m_joint_lanes.size(), _bind_pose.m_joint_lanes.size()),
+            _simd_level
+        );
+        return *this;
+    }
+
+    animation_pose& animation_pose::mix(animation_pose const& _left, animation_pose const& _right, float _blend_param, Engine::Math::ESIMDLevel _simd_level)
+    {
+        if (_left.m_joint_count == _right.m_joint_count)
+            resize(_left.m_joint_count);
+        blend_pose_lanes(
+            m_joint_lanes.data(),
+            _left.m_joint_lanes.data(),
+            _right.m_joint_lanes.data(),
+            _blend_param,
+            std::min({ m_joint_lanes.size(), _left.m_joint_lanes.size(), _right.m_joint_lanes.size() }),
+            _simd_level
+        );
         return *this;
     }
 
@@ -130,40 +309,76 @@ namespace Component
     * @param    float const[3]              Pointer to array of 3 barycentric weights used for interpolation.
     * @returns  animation_pose &            
     */
-    animation_pose& animation_pose::mix(animation_pose const _poses[3], float const _blend_params[3])
+    animation_pose& animation_pose::mix(animation_pose const _poses[3], float const _blend_params[3], Engine::Math::ESIMDLevel _simd_level)
     {
 
         if (
-            _poses[0].m_joint_transforms.size() == _poses[1].m_joint_transforms.size() &&
-            _poses[1].m_joint_transforms.size() == _poses[2].m_joint_transforms.size()
+            _poses[0].m_joint_count == _poses[1].m_joint_count &&
+            _poses[1].m_joint_count == _poses[2].m_joint_count
             )
         {
-            m_joint_transforms.resize(_poses[0].m_joint_transforms.size());
+            resize(_poses[0].m_joint_count);
         }
         // Perform linear interpolation between all components of each joint transform of all input poses
-        for (unsigned int i = 0; i < m_joint_transforms.size(); ++i)
-        {
-            Engine::Math::transform3D const& p0_transform = _poses[0].m_joint_transforms[i];
-            Engine::Math::transform3D const& p1_transform = _poses[1].m_joint_transforms[i];
-            Engine::Math::transform3D const& p2_transform = _poses[2].m_joint_transforms[i];
-            // TODO: Apply blend masks
-            m_joint_transforms[i].position =
-                p0_transform.position * _blend_params[0] +
-                p1_transform.position * _blend_params[1] +
-                p2_transform.position * _blend_params[2];
-            m_joint_transforms[i].scale =
-                p0_transform.scale * _blend_params[0] +
-                p1_transform.scale * _blend_params[1] +
-                p2_transform.scale * _blend_params[2];
-            m_joint_transforms[i].rotation = glm::normalize(
-                p0_transform.rotation * _blend_params[0] +
-                p1_transform.rotation * _blend_params[1] +
-                p2_transform.rotation * _blend_params[2]
-            );
-        }
+        // TODO: Apply blend masks
+        joint_transform_lanes const* const joint_lanes[3] = {
+            _poses[0].m_joint_lanes.data(),
+            _poses[1].m_joint_lanes.data(),
+            _poses[2].m_joint_lanes.data()
+        };
+        blend_pose_lanes(
+            m_joint_lanes.data(),
+            joint_lanes,
+            _blend_params,
+            std::min({
+                m_joint_lanes.size(),
+                _poses[0].m_joint_lanes.size(),
+                _poses[1].m_joint_lanes.size(),
+                _poses[2].m_joint_lanes.size()
+            }),
+            _simd_level
+        );
         return *this;
     }
 
+    /*
+    * Make room for poses of a blend tree and skeleton. Only allocates when the stack has to grow.
+    * @param    size_t      Number of poses, scratch_pose_count() of the blend tree.
+    * @param    size_t      Number of joints of the skeleton.
+    */
+    void animation_pose_stack::reserve(size_t _pose_count, size_t _joint_count)
+    {
+        assert(m_size == 0);
+        if (_pose_count > m_poses.size())
+        {
+            m_poses.resize(_pose_count);
+            m_joint_capacity = 0;
+        }
+        if (_joint_count > m_joint_capacity)
+        {
+            size_t const block_count = (_joint_count + JOINT_LANES - 1) / JOINT_LANES;
+            for (animation_pose& pose : m_poses)
+                pose.m_joint_lanes.reserve(block_count);
+            m_joint_capacity = _joint_count;
+        }
+    }
+
+    animation_pose* animation_pose_stack::push(size_t _count)
+    {
+        assert(m_size + _count <= m_poses.size());
+        animation_pose* const poses = m_poses.data() + m_size;
+        for (size_t i = 0; i < _count; ++i)
+            poses[i].clear();
+        m_size += _count;
+        return poses;
+    }
+
+    void animation_pose_stack::pop(size_t _count)
+    {
+        assert(_count <= m_size);
+        m_size -= _count;
+    }
+
     void animation_leaf_node::set_animation(animation_handle _animation)
     {
         m_animation = _animation;
@@ -180,7 +395,7 @@ namespace Component
                                             .FindAnimationData(m_animation);
 
         float anim_channel_data[1024];
-        _out_pose->m_joint_transforms.resize(_context.m_bind_pose->m_joint_transforms.size());
+        _out_pose->resize(_context.m_bind_pose->joint_count());
         // Use animation to compute new pose.
         if (anim_data)
         {
@@ -188,13 +403,13 @@ namespace Component
                 anim_data,
                 _time,
                 anim_channel_data,
-                true
+                true,
+                &m_key_cursors
             );
-            AnimationUtil::convert_joint_channels_to_transforms(
+            AnimationUtil::convert_joint_channels_to_pose(
                 anim_data,
                 anim_channel_data,
-                &_out_pose->m_joint_transforms.front(),
-                (unsigned int)_out_pose->m_joint_transforms.size()
+                _out_pose
             );
         }
         // Use bind pose as fallback pose.
@@ -214,6 +429,11 @@ namespace Component
         return data ? data->m_duration : 0.0f;
     }
 
+    size_t animation_leaf_node::scratch_pose_count() const
+    {
+        return 0;
+    }
+
     /*
     * @param    std::unique_ptr<animation_tree_node> &&     Blend tree node to add to this node
     * @param    float                                       Point within 1D blend space
@@ -303,10 +523,8 @@ namespace Component
 
         bool apply_mask = !m_blend_mask.m_joint_blend_masks.empty();
 
-        animation_pose bound_poses[2]{
-            animation_pose(),
-            animation_pose()
-        };
+        animation_pose_stack::scope scratch(*_context.m_scratch_poses, 2);
+        animation_pose* const bound_poses = scratch.m_poses;
         m_child_blend_nodes[bound_left]->compute_pose(
             AnimationUtil::rollover_modulus(_time * m_time_warps[bound_left], node_warped_duration(bound_left)),
             &bound_poses[0],
@@ -322,7 +540,7 @@ namespace Component
         {
 
             // Return early if we are not able to find two valid poses to interpolate between.
-            if (bound_poses[0].m_joint_transforms.empty() || bound_poses[1].m_joint_transforms.empty())
+            if (bound_poses[0].empty() || bound_poses[1].empty())
             {
                 *_out_pose = *_context.m_bind_pose;
                 return;
@@ -352,6 +570,17 @@ namespace Component
         return max_duration;
     }
 
+    /*
+    * @returns  size_t  Poses of the two bounding nodes, plus those of the deepest child evaluated while they are held.
+    */
+    size_t animation_blend_1D::scratch_pose_count() const
+    {
+        size_t max_child_count = 0;
+        for (std::unique_ptr<animation_tree_node> const& child : m_child_blend_nodes)
+            max_child_count = std::max(max_child_count, child->scratch_pose_count());
+        return 2 + max_child_count;
+    }
+
     void animation_blend_2D::add_node(std::unique_ptr<animation_tree_node>&& _node, glm::vec2 _new_point, animation_blend_mask _blend_mask)
     {
         m_child_blend_nodes.emplace_back(std::move(_node));
@@ -370,6 +599,7 @@ namespace Component
     {
         m_child_blend_nodes.erase(m_child_blend_nodes.begin() + _index);
         m_blendspace_points.erase(m_blendspace_points.begin() + _index);
+        m_time_warps.erase(m_time_warps.begin() + _index);
         triangulate_blendspace_points();
     }
 
@@ -462,8 +692,6 @@ namespace Component
         
         auto find_tri_result = find_triangle(m_blend_parameter);
 
-        animation_pose bound_poses[3];
-
         uint8_t const tri_node_indices[3]{ 
             std::get<0>(find_tri_result.first),
             std::get<1>(find_tri_result.first),
@@ -480,18 +708,21 @@ namespace Component
             return;
         }
 
+        animation_pose_stack::scope scratch(*_context.m_scratch_poses, 3);
+        animation_pose* const bound_poses = scratch.m_poses;
         for (unsigned int i = 0; i < 3; ++i)
         {
             m_child_blend_nodes[tri_node_indices[i]]->compute_pose(
-                AnimationUtil::rollover_modulus(_time * m_time_warps[i], node_warped_duration(tri_node_indices[i])),
+                AnimationUtil::rollover_modulus(_time * m_time_warps[tri_node_indices[i]], node_warped_duration(tri_node_indices[i])),
                 &bound_poses[i],
                 _context
             );
             // Early return if we failed to animate pose.
             // This happens when the node does not have a valid animation.
-            if (bound_poses[i].m_joint_transforms.empty())
+            if (bound_poses[i].empty())
             {
                 *_out_pose = *_context.m_bind_pose;
+                return;
             }
         }
 
@@ -511,6 +742,14 @@ namespace Component
         return max_duration;
     }
 
+    size_t animation_blend_2D::scratch_pose_count() const
+    {
+        size_t max_child_count = 0;
+        for (std::unique_ptr<animation_tree_node> const& child : m_child_blend_nodes)
+            max_child_count = std::max(max_child_count, child->scratch_pose_count());
+        return 3 + max_child_count;
+    }
+
 
 
     static bool gui_dragdrop_animation_handle(animation_handle* _anim)
@@ -1127,87 +1366,154 @@ namespace AnimationUtil
             return 0.0f;
     }
 
-    void convert_joint_channels_to_transforms(
+    /*
+    * Write sampled channels of animation into joint lanes of pose. Joints without channels keep
+    * their transforms.
+    */
+    void convert_joint_channels_to_pose(
         animation_data const * _animation_data, float const* _in_anim_channel_data, 
-        Engine::Math::transform3D* const _joint_transforms, unsigned int _joint_transform_count)
+        animation_pose* _pose)
     {
         // Go over all animated properties and assign them to the corresponding transforms.
-        unsigned int channel_idx = 0;
         unsigned int curr_joint_idx = 0;
         unsigned int instance_data_channel_offset = 0;
         unsigned int joint_channels_offset = 0;
         typedef animation_channel_data::E_target_path channel_target_path;
-        Engine::Math::transform3D* modify_joint_transform = _joint_transforms;
-        while (curr_joint_idx < _joint_transform_count)
+        size_t constexpr JOINT_LANES = joint_transform_lanes::JOINT_LANES;
+        while (curr_joint_idx < _pose->joint_count())
         {
+            joint_transform_lanes& modify_joint_lanes = _pose->m_joint_lanes[curr_joint_idx / JOINT_LANES];
+            size_t const lane = curr_joint_idx % JOINT_LANES;
+            float const* channel_data = _in_anim_channel_data + instance_data_channel_offset;
             uint8_t const curr_joint_channel_count = _animation_data->get_skeleton_joint_index_channel_count(curr_joint_idx);
             for (unsigned int i = 0; i < curr_joint_channel_count; ++i)
             {
                 switch (_animation_data->m_animation_channels[joint_channels_offset + i].m_target_path)
                 {
                 case channel_target_path::TRANSLATION:
-                    modify_joint_transform->position = *(glm::vec3 const*)(_in_anim_channel_data + instance_data_channel_offset);
-                    instance_data_channel_offset += 3;
+                    for (int c = 0; c < 3; ++c)
+                        modify_joint_lanes.m_position[c][lane] = channel_data[c];
+                    channel_data += 3;
                     break;
                 case channel_target_path::SCALE:
-                    modify_joint_transform->scale = *(glm::vec3 const*)(_in_anim_channel_data + instance_data_channel_offset);
-                    instance_data_channel_offset += 3;
+                    for (int c = 0; c < 3; ++c)
+                        modify_joint_lanes.m_scale[c][lane] = channel_data[c];
+                    channel_data += 3;
                     break;
                 case channel_target_path::ROTATION:
-                    modify_joint_transform->rotation = *(glm::quat const*)(_in_anim_channel_data + instance_data_channel_offset);
-                    instance_data_channel_offset += 4;
+                {
+                    glm::quat const rotation = *(glm::quat const*)channel_data;
+                    modify_joint_lanes.m_rotation[0][lane] = rotation.w;
+                    modify_joint_lanes.m_rotation[1][lane] = rotation.x;
+                    modify_joint_lanes.m_rotation[2][lane] = rotation.y;
+                    modify_joint_lanes.m_rotation[3][lane] = rotation.z;
+                    channel_data += 4;
                     break;
                 }
+                }
             }
+            instance_data_channel_offset = (unsigned int)(channel_data - _in_anim_channel_data);
             joint_channels_offset += curr_joint_channel_count;
             curr_joint_idx++;
-            modify_joint_transform++;
         }
     }
 
+    /*
+    * Find keyframes to interpolate between at given time.
+    * @param    std::vector<float> const &  Ascending keyframe times
+    * @param    float                       Time to sample at
+    * @param    uint32_t *                  Left keyframe index sampled last, updated to new interval. Optional.
+    * @returns  std::pair<unsigned, unsigned>   Left and right keyframe indices
+    * @details  Playback is almost always monotonic, so the cursor is advanced linearly from the last
+    *           interval. Seeking backwards, looping and large jumps fall back to binary search.
+    */
+    std::pair<unsigned int, unsigned int> find_keyframe_interval(
+        std::vector<float> const& _keyframes,
+        float _time,
+        uint32_t* _key_cursor
+    )
+    {
+        unsigned int constexpr MAX_LINEAR_KEY_STEPS = 4;
+
+        unsigned int const keyframe_count = (unsigned int)_keyframes.size();
+        if (keyframe_count < 2)
+            return { 0, 0 };
+
+        auto binary_search = [&]()
+        {
+            return (unsigned int)Engine::Utils::float_binary_search(_keyframes.data(), keyframe_count, _time).first;
+        };
+
+        unsigned int left = 0;
+        if (!_key_cursor || *_key_cursor > keyframe_count - 2 || (*_key_cursor > 0 && _time < _keyframes[*_key_cursor]))
+            left = binary_search();
+        else
+        {
+            left = *_key_cursor;
+            unsigned int steps = 0;
+            while (left + 2 < keyframe_count && _keyframes[left + 1] <= _time)
+            {
+                if (++steps > MAX_LINEAR_KEY_STEPS)
+                {
+                    left = binary_search();
+                    break;
+                }
+                ++left;
+            }
+        }
+
+        if (_key_cursor)
+            *_key_cursor = left;
+        return { left, left + 1 };
+    }
+
+    /*
+    * Sample all channels of animation at given time.
+    * @param    animation_key_cursors *     Keyframe cursors of the sampling animation instance. If null,
+    *                                       keyframes are found by binary search.
+    * @details  Compressed animations are sampled from their tracks, decompressing only the two keys
+    *           around the sampled time. Otherwise channels have to be resolved by
+    *           ResourceManager::ResolveAnimationChannels.
+    */
     void compute_animation_channel_data(
         animation_data const * _animation_data,
         float _time, 
         float* _out_anim_channel_data,
-        bool _use_slerp
+        bool _use_slerp,
+        animation_key_cursors* _key_cursors
     )
     {
-        auto const & res_mgr = Singleton<ResourceManager>();
-
-        unsigned int skeleton_joint_idx = -1;
-        unsigned int joint_channels_offset = 0;
-        unsigned int new_joint_channel_idx = -1;
-
-        animation_interpolation_handle cached_input_handle = 0;
-        animation_interpolation_data const* cached_input_interp_data = nullptr;
+        size_t const channel_count = _animation_data->m_animation_channels.size();
+        uint32_t* key_cursors = nullptr;
+        if (_key_cursors)
+        {
+            if (_key_cursors->m_channel_keys.size() != channel_count)
+                _key_cursors->m_channel_keys.assign(channel_count, 0);
+            key_cursors = _key_cursors->m_channel_keys.data();
+        }
 
-        float right_weight = 0.0f;
-        unsigned int interp_left_idx, interp_right_idx;
+        bool const compressed = !_animation_data->m_compressed_tracks.empty();
         unsigned int instance_data_offset = 0;
-        for (; joint_channels_offset < _animation_data->m_animation_channels.size(); ++joint_channels_offset)
+        for (size_t channel_idx = 0; channel_idx < channel_count; ++channel_idx)
         {
-            // Fetch new input and output interpolation data.
-            animation_channel_data const& channel_data = _animation_data->m_animation_channels[joint_channels_offset];
-            auto& sampler_data = res_mgr.m_anim_sampler_data_map.at(channel_data.m_anim_sampler_handle);
-            if (sampler_data.m_anim_interp_input_handle != cached_input_handle)
-            {
-                cached_input_handle = sampler_data.m_anim_interp_input_handle;
-                cached_input_interp_data = &res_mgr.m_anim_interpolation_data_map.at(cached_input_handle);
-
-            }
-            animation_interpolation_data const& output_interp_data = res_mgr.m_anim_interpolation_data_map.at(sampler_data.m_anim_interp_output_handle);
-            std::vector<float> const& keyframe_arr = cached_input_interp_data->m_data;
+            animation_channel_data const& channel_data = _animation_data->m_animation_channels[channel_idx];
+            compressed_animation_track const* track = compressed ? &_animation_data->m_compressed_tracks[channel_idx] : nullptr;
+            assert((track || channel_data.m_sampler) && "Animation channels have not been resolved.");
+            std::vector<float> const& keyframe_arr = track ? track->m_key_times : channel_data.m_input->m_data;
+            float const* output_data = track ? nullptr : channel_data.m_output->m_data.data();
+            // Compressed tracks are always sampled linearly.
+            animation_sampler_data::E_interpolation_type const interpolation_type = track
+                ? animation_sampler_data::E_interpolation_type::LINEAR
+                : channel_data.m_sampler->m_interpolation_type;
 
             // Search for upper and lower bound of key in keyframe array
-            auto pair = Engine::Utils::float_binary_search(
-                &keyframe_arr.front(),
-                keyframe_arr.size(),
-                _time
+            auto const [interp_left_idx, interp_right_idx] = find_keyframe_interval(
+                keyframe_arr,
+                _time,
+                key_cursors ? key_cursors + channel_idx : nullptr
             );
-            interp_left_idx = pair.first;
-            interp_right_idx = pair.second;
             // If we are between two keyframes, interpolate between left and right index properties
-            right_weight = 0.0f;
+            float right_weight = 0.0f;
             if (interp_right_idx != interp_left_idx)
             {
                 right_weight =
@@ -1220,34 +1526,55 @@ namespace AnimationUtil
             {
             case animation_channel_data::E_target_path::TRANSLATION:
             case animation_channel_data::E_target_path::SCALE:
+            {
+                glm::vec3 left, right;
+                if (track)
+                {
+                    left = track->vector(interp_left_idx);
+                    right = track->vector(interp_right_idx);
+                }
+                else
+                {
+                    left = reinterpret_cast<glm::vec3 const*>(output_data)[interp_left_idx];
+                    right = reinterpret_cast<glm::vec3 const*>(output_data)[interp_right_idx];
+                }
                 AnimationUtil::interpolate_vector(
                     reinterpret_cast<glm::vec3*>(_out_anim_channel_data + instance_data_offset),
-                    reinterpret_cast<glm::vec3 const*>(&output_interp_data.m_data.front()) + interp_left_idx,
-                    reinterpret_cast<glm::vec3 const*>(&output_interp_data.m_data.front()) + interp_right_idx,
+                    &left,
+                    &right,
                     right_weight,
-                    sampler_data.m_interpolation_type
+                    interpolation_type
                 );
                 instance_data_offset += 3;
                 break;
+            }
             case animation_channel_data::E_target_path::ROTATION:
+            {
+                glm::quat left, right;
+                if (track)
+                {
+                    left = track->rotation(interp_left_idx);
+                    right = track->rotation(interp_right_idx);
+                    // Quantization picks the sign of each key independently, interpolate along the shorter arc.
+                    if (glm::dot(left, right) < 0.0f)
+                        right = -right;
+                }
+                else
+                {
+                    left = reinterpret_cast<glm::quat const*>(output_data)[interp_left_idx];
+                    right = reinterpret_cast<glm::quat const*>(output_data)[interp_right_idx];
+                }
                 AnimationUtil::interpolate_quaternion(
                     reinterpret_cast<glm::quat*>(_out_anim_channel_data + instance_data_offset),
-                    reinterpret_cast<glm::quat const*>(&output_interp_data.m_data.front()) + interp_left_idx,
-                    reinterpret_cast<glm::quat const*>(&output_interp_data.m_data.front()) + interp_right_idx,
+                    &left,
+                    &right,
                     right_weight,
-                    sampler_data.m_interpolation_type,
+                    interpolation_type,
                     _use_slerp
                 );
                 instance_data_offset += 4;
                 break;
             }
-
-
-            // Set up next joint channel batch to process
-            if (joint_channels_offset >= new_joint_channel_idx)
-            {
-                new_joint_channel_idx += _animation_data->get_skeleton_joint_index_channel_count(skeleton_joint_idx);
-                ++skeleton_joint_idx;
             }
         }
     }
@@ -1303,6 +1630,10 @@ namespace AnimationUtil
 //                     Skeleton Animator (Single Animation)
 ///////////////////////////////////////////////////////////////////////////////
 
+SkeletonAnimatorManager::SkeletonAnimatorManager() = default;
+// Defined here, where the cached view type is complete.
+SkeletonAnimatorManager::~SkeletonAnimatorManager() = default;
+
 const char* SkeletonAnimatorManager::GetComponentTypeName() const
 {
     return "SkeletonAnimator";
@@ -1310,55 +1641,83 @@ const char* SkeletonAnimatorManager::GetComponentTypeName() const
 
 void SkeletonAnimatorManager::UpdateAnimatorInstances(float _dt)
 {
-    auto& res_mgr = Singleton<ResourceManager>();
+    ENGINE_ALLOCATION_SCOPE(eAnimation);
 
-    for (auto & pair : m_entity_animator_data)
+    // Animators without a Skin component have no joints to animate.
+    if (!m_animated_skins_view)
+        m_animated_skins_view = std::make_unique<Engine::ECS::CachedView<Component::SkeletonAnimator, Component::Skin>>();
+    m_animator_updates.clear();
+    m_animated_skins_view->each([&](Entity _animator_entity, animator_data & animator, auto const & _skin)
     {
-        Entity animator_entity = pair.first;
-
-        animator_data & animator = pair.second;
-
         // Skip if handle is invalid.
         if (animator.m_blendtree_root_node == nullptr || animator.m_instance.m_paused)
-            continue;
+            return;
 
-        Component::Skin skin_comp = animator_entity.GetComponent<Component::Skin>();
-        assert(skin_comp.IsValid() && "Animator entity does not have valid Skin component");
-        std::vector<Component::Transform> const & skeleton_joint_transforms = skin_comp.GetSkeletonInstanceNodes();
+        std::vector<Component::Transform> const & skeleton_joint_transforms = _skin.m_skeleton_instance_nodes;
         if (skeleton_joint_transforms.empty())
-            continue;
+            return;
 
-        compute_pose_context context;
-        context.m_bind_pose = &animator.m_bind_pose;
+        m_animator_updates.push_back({ &animator, skeleton_joint_transforms.data(), (unsigned int)skeleton_joint_transforms.size() });
+    });
 
-        animation_pose new_pose;
-        animator.m_blendtree_root_node->compute_pose(
-            animator.m_instance.m_global_time, 
-            &new_pose,
-            context
-        );
+    auto& jobs = Singleton<Engine::Utils::job_system>();
+    if (m_thread_scratch_poses.size() < jobs.thread_count())
+        m_thread_scratch_poses.resize(jobs.thread_count());
+    auto evaluate_range = [this, _dt](size_t _begin, size_t _end, unsigned int _thread_index)
+    {
+        // Allocation scopes are per thread, workers have to open their own.
+        ENGINE_ALLOCATION_SCOPE(eAnimation);
+        for (size_t i = _begin; i < _end; i++)
+            evaluate_animator(*m_animator_updates[i].m_animator, m_thread_scratch_poses[_thread_index], _dt);
+    };
+    if (!m_parallel_update || jobs.thread_count() == 1 || m_animator_updates.size() < 2 * MIN_ANIMATORS_PER_BATCH)
+        evaluate_range(0, m_animator_updates.size(), 0);
+    else
+        jobs.parallel_for(m_animator_updates.size(), MIN_ANIMATORS_PER_BATCH, evaluate_range);
 
+    for (animator_update const& update : m_animator_updates)
+    {
         // Check if we were able to compute new pose.
-        if (!new_pose.m_joint_transforms.empty())
+        animation_pose const& pose = update.m_animator->m_pose;
+        if (!pose.empty())
         {
             // Update transform component data for each joint
             update_joint_transform_components(
-                &skeleton_joint_transforms.front(), 
-                &new_pose.m_joint_transforms.front(),
-                (unsigned int)new_pose.m_joint_transforms.size()
+                update.m_joints,
+                pose,
+                std::min((unsigned int)pose.joint_count(), update.m_joint_count)
             );
         }
-
-        // Rollover time between [0, duration]
-        float const animator_duration = animator.m_blendtree_root_node->duration();
-        animation_instance& instance = animator.m_instance;
-        instance.m_global_time += _dt * instance.m_anim_speed;
-        float new_time = AnimationUtil::rollover_modulus(instance.m_global_time, animator_duration);
-        instance.m_paused = (!instance.m_loop && new_time != instance.m_global_time);
-        instance.m_global_time = (float)(!instance.m_paused) * new_time + (float)(instance.m_paused) * animator_duration;
     }
 }
 
+/*
+* Compute new pose of animator and advance its time. Only reads shared animation data,
+* so animators can be evaluated concurrently, each thread with its own scratch poses.
+*/
+void SkeletonAnimatorManager::evaluate_animator(animator_data& _animator, animation_pose_stack& _scratch_poses, float _dt)
+{
+    _scratch_poses.reserve(_animator.m_blendtree_root_node->scratch_pose_count(), _animator.m_bind_pose.joint_count());
+    compute_pose_context context;
+    context.m_bind_pose = &_animator.m_bind_pose;
+    context.m_scratch_poses = &_scratch_poses;
+
+    _animator.m_pose.clear();
+    _animator.m_blendtree_root_node->compute_pose(
+        _animator.m_instance.m_global_time,
+        &_animator.m_pose,
+        context
+    );
+
+    // Rollover time between [0, duration]
+    float const animator_duration = _animator.m_blendtree_root_node->duration();
+    animation_instance& instance = _animator.m_instance;
+    instance.m_global_time += _dt * instance.m_anim_speed;
+    float new_time = AnimationUtil::rollover_modulus(instance.m_global_time, animator_duration);
+    instance.m_paused = (!instance.m_loop && new_time != instance.m_global_time);
+    instance.m_global_time = (float)(!instance.m_paused) * new_time + (float)(instance.m_paused) * animator_duration;
+}
+
 void SkeletonAnimatorManager::impl_deserialize_data(nlohmann::json const& _j)
 {
     assert(_j.empty());
@@ -1371,6 +1730,7 @@ void SkeletonAnimatorManager::impl_serialize_data(nlohmann::json& _j) const
 void SkeletonAnimatorManager::impl_clear()
 {
     m_entity_animator_data.clear();
+    m_animated_skins_view.reset();
 }
 
 bool SkeletonAnimatorManager::impl_create(Entity _e)
@@ -1449,14 +1809,14 @@ SkeletonAnimatorManager::animator_data& SkeletonAnimatorManager::get_entity_anim
 
 void SkeletonAnimatorManager::update_joint_transform_components(
     Component::Transform const * _components, 
-    Engine::Math::transform3D const* _transforms, 
+    animation_pose const& _pose, 
     unsigned int _joint_count
 )
 {
     for (unsigned int i = 0; i < _joint_count; ++i)
     {
         Component::Transform edit_transform = _components[i];
-        edit_transform.SetLocalTransform(_transforms[i]);
+        edit_transform.SetLocalTransform(_pose.get_joint_transform(i));
     }
 }
 
@@ -1586,7 +1946,7 @@ void SkeletonAnimatorManager::window_edit_blendtree(std::unique_ptr<animation_tr
             if (mask_enabled)
             {
                 s_p_edit_blend_mask->m_joint_blend_masks.resize(
-                    get_entity_animator(m_edit_tree).m_bind_pose.m_joint_transforms.size(), 1.0f
+                    get_entity_animator(m_edit_tree).m_bind_pose.joint_count(), 1.0f
                 );
             }
             else
@@ -1790,12 +2150,16 @@ void from_json(nlohmann::json const& _j, animation_instance& _instance)
 
 void to_json(nlohmann::json& _j, animation_pose const& _instance)
 {
-    _j["joint_transforms"] = _instance.m_joint_transforms;
+    std::vector<Engine::Math::transform3D> joint_transforms(_instance.joint_count());
+    for (size_t i = 0; i < joint_transforms.size(); ++i)
+        joint_transforms[i] = _instance.get_joint_transform(i);
+    _j["joint_transforms"] = joint_transforms;
 }
 
 void from_json(nlohmann::json const& _j, animation_pose& _instance)
 {
-    _instance.m_joint_transforms = _j["joint_transforms"].get<std::vector<Engine::Math::transform3D>>();
+    std::vector<Engine::Math::transform3D> const joint_transforms = _j["joint_transforms"];
+    _instance.set_joint_transforms(joint_transforms.data(), joint_transforms.size());
 }
 
 void to_json(nlohmann::json& _j, SkeletonAnimatorManager::animator_data const& _animator)
@@ -1,11 +1,22 @@
 #include <Engine/ECS/component_manager.h>
 #include <Engine/Graphics/manager.h>
+#include <Engine/Math/simd.hpp>
+#include "joint_transform_lanes.h"
+#include <memory_resource>
 #include <stack>
 #include <tuple>
 
+namespace Engine {
+namespace ECS {
+	template<typename... TComps>
+	class CachedView;
+}
+}
+
 namespace Component
 {
 	struct Transform;
+	struct Skin;
 
 	using namespace Engine::ECS;
 	using namespace Engine::Graphics;
@@ -38,14 +49,53 @@ namespace Component
 		}
 	};
 
-	struct animation_pose
+	// Keyframe interval each channel of an animation was last sampled in.
+	struct animation_key_cursors
 	{
-		std::vector<Engine::Math::transform3D> m_joint_transforms;
+		// Left keyframe index per channel.
+		std::vector<uint32_t> m_channel_keys;
+	};
 
-		void apply_blend_mask(animation_blend_mask const & _mask, animation_pose const & _other);
-		animation_pose & apply_blend_factor(float _factor, animation_pose const& _bind_pose);
-		animation_pose& mix(animation_pose const& _left, animation_pose const& _right, float _blend_param);
-		animation_pose& mix(animation_pose const _poses[3], float const _blend_params[3]);
+	struct animation_pose
+	{
+		// Joints are allocated from the given memory resource, the default resource otherwise.
+		// Lanes past the joint count of the last block hold identity transforms.
+		std::pmr::vector<joint_transform_lanes> m_joint_lanes;
+		size_t m_joint_count = 0;
+
+		animation_pose() = default;
+		explicit animation_pose(std::pmr::memory_resource* _resource) : m_joint_lanes(_resource) {}
+
+		size_t joint_count() const { return m_joint_count; }
+		bool empty() const { return m_joint_count == 0; }
+		void clear();
+		// New joints are identity transforms.
+		void resize(size_t _joint_count);
+
+		Engine::Math::transform3D get_joint_transform(size_t _joint) const;
+		void set_joint_transform(size_t _joint, Engine::Math::transform3D const& _transform);
+		void set_joint_transforms(Engine::Math::transform3D const* _transforms, size_t _count);
+
+		/*
+		* Blending functions lerp positions and scales and nlerp rotations of joints.
+		* @param	ESIMDLevel		Widest kernel to use. Defaults to the widest one supported by the CPU.
+		*/
+		void apply_blend_mask(
+			animation_blend_mask const & _mask, animation_pose const & _other,
+			Engine::Math::ESIMDLevel _simd_level = Engine::Math::get_supported_simd_level()
+		);
+		animation_pose & apply_blend_factor(
+			float _factor, animation_pose const& _bind_pose,
+			Engine::Math::ESIMDLevel _simd_level = Engine::Math::get_supported_simd_level()
+		);
+		animation_pose& mix(
+			animation_pose const& _left, animation_pose const& _right, float _blend_param,
+			Engine::Math::ESIMDLevel _simd_level = Engine::Math::get_supported_simd_level()
+		);
+		animation_pose& mix(
+			animation_pose const _poses[3], float const _blend_params[3],
+			Engine::Math::ESIMDLevel _simd_level = Engine::Math::get_supported_simd_level()
+		);
 	};
 
 	struct animation_tree_node;
@@ -56,18 +106,57 @@ namespace Component
 		animation_tree_node** selected_node_ptr;
 	};
 
+	/*
+	* @brief	Scratch poses for the intermediate results of blend tree evaluation.
+	* @details	Blend nodes push poses for their children and pop them once blended. Poses keep their
+	*			joint buffers between evaluations, so once the stack is reserved for a blend tree and
+	*			its skeleton, evaluating the tree does not allocate.
+	*/
+	struct animation_pose_stack
+	{
+		std::vector<animation_pose> m_poses;
+		size_t m_size = 0;
+		size_t m_joint_capacity = 0;
+
+		// Pointers to pushed poses stay valid until the next reserve, which may only be called on an empty stack.
+		void reserve(size_t _pose_count, size_t _joint_count);
+		// Returns _count contiguous empty poses.
+		animation_pose* push(size_t _count);
+		void pop(size_t _count);
+
+		// Poses pushed for the lifetime of the scope.
+		struct scope
+		{
+			animation_pose_stack & m_stack;
+			animation_pose * m_poses;
+			size_t m_count;
+
+			scope(animation_pose_stack & _stack, size_t _count) : m_stack(_stack), m_poses(_stack.push(_count)), m_count(_count) {}
+			~scope() { m_stack.pop(m_count); }
+
+			scope(scope const&) = delete;
+			scope& operator=(scope const&) = delete;
+		};
+	};
+
 	struct compute_pose_context
 	{
 		animation_pose const * m_bind_pose;
+		// Reserved for scratch_pose_count() of the evaluated tree.
+		animation_pose_stack * m_scratch_poses;
 	};
 
 	struct animation_tree_node
 	{
 		static std::unique_ptr<animation_tree_node> create(nlohmann::json const& _j);
 
+		// Child nodes are owned through pointers to this base.
+		virtual ~animation_tree_node() = default;
 
 		virtual void compute_pose(float _time, animation_pose * _out_pose, compute_pose_context const& _context) const = 0;
 		virtual float duration() const = 0;
+		// Maximum number of scratch poses in use at once while computing the pose of this node.
+		virtual size_t scratch_pose_count() const = 0;
 
 		int gui_node(gui_node_context& _context);
 
@@ -91,6 +180,8 @@ namespace Component
 	{
 
 		animation_handle		m_animation = 0;
+		// Each animator owns its blend tree, so sampling state of this animator's playback can live in its leaves.
+		animation_key_cursors mutable	m_key_cursors;
 
 		animation_leaf_node() { m_name = default_name(); }
 
@@ -99,6 +190,7 @@ namespace Component
 		// Inherited via animation_tree_node
 		virtual void compute_pose(float _time, animation_pose* _out_pose, compute_pose_context const & _context) const override;
 		virtual float duration() const override;
+		virtual size_t scratch_pose_count() const override;
 		virtual void gui_edit() override;
 
 	private:
@@ -129,6 +221,7 @@ namespace Component
 		// Inherited via animation_tree_node
 		virtual void compute_pose(float _time, animation_pose* _out_pose, compute_pose_context const& _context) const override;
 		virtual float duration() const override;
+		virtual size_t scratch_pose_count() const override;
 		virtual void gui_edit() override;
 
 	private:
@@ -174,6 +267,7 @@ namespace Component
 		// Inherited via animation_tree_node
 		virtual void compute_pose(float _time, animation_pose* _out_pose, compute_pose_context const& _context) const override;
 		virtual float duration() const override;
+		virtual size_t scratch_pose_count() const override;
 		virtual void gui_edit() override;
 
 	private:
@@ -190,17 +284,22 @@ namespace Component
 
 		float rollover_modulus(float _value, float _maximum);
 
-		void convert_joint_channels_to_transforms(
+		void convert_joint_channels_to_pose(
 			animation_data const * _animation_data,
 			float const* _in_anim_channel_data,
-			Engine::Math::transform3D* const _joint_transforms,
-			unsigned int _joint_transform_count
+			animation_pose* _pose
 		);
 		void compute_animation_channel_data( 
 			animation_data const * _animation_data,
 			float _time, 
 			float* _out_anim_channel_data,
-			bool _use_slerp
+			bool _use_slerp,
+			animation_key_cursors* _key_cursors = nullptr
+		);
+		std::pair<unsigned int, unsigned int> find_keyframe_interval(
+			std::vector<float> const& _keyframes,
+			float _time,
+			uint32_t* _key_cursor
 		);
 		void interpolate_vector(
 			glm::vec3* _dest,
@@ -240,6 +339,16 @@ namespace Component
 			animation_instance						m_instance;
 			animation_pose							m_bind_pose;
 			std::unique_ptr<animation_tree_node>	m_blendtree_root_node;
+			// Pose evaluated in the last update, its buffer is reused every frame.
+			animation_pose							m_pose;
+		};
+
+		// Animator whose pose is evaluated this update, and the joints it is written back to.
+		struct animator_update
+		{
+			animator_data*					m_animator;
+			Component::Transform const*		m_joints;
+			unsigned int					m_joint_count;
 		};
 
 		friend void to_json(nlohmann::json& _j, animator_data const& _animator);
@@ -247,13 +356,24 @@ namespace Component
 
 		// TODO: Existential processing, split instances by whether they should be animated or not.
 		// I.e. sort by playing / paused / invalid.
-		std::unordered_map<Entity, animator_data, Entity::hash> m_entity_animator_data;
+		sparse_set<animator_data> m_entity_animator_data;
 
 
 		bool m_use_slerp = true;
 		Entity m_edit_tree = Entity::InvalidEntity;
 		animation_tree_node * m_editing_tree_node;
 		bool m_blendtree_editor_open = false;
+		bool m_parallel_update = true;
+
+		// Animators with a Skin component. Created on first update, since constructing a view
+		// requires the managers of both components.
+		std::unique_ptr<Engine::ECS::CachedView<SkeletonAnimator, Skin>> m_animated_skins_view;
+		std::vector<animator_update> m_animator_updates;
+		// Scratch poses of blend tree evaluation per job system thread.
+		std::vector<animation_pose_stack> m_thread_scratch_poses;
+
+		// Below this many animators, handing batches to workers costs more than it saves.
+		static unsigned int constexpr MIN_ANIMATORS_PER_BATCH = 4;
 
 		// Inherited via TCompManager
 		virtual void impl_clear() override;
@@ -264,15 +384,30 @@ namespace Component
 
 		animator_data& get_entity_animator(Entity _e);
 
-		void update_joint_transform_components(Component::Transform const* _components, Engine::Math::transform3D const* _transforms, unsigned int _joint_count);
+		static void evaluate_animator(animator_data& _animator, animation_pose_stack& _scratch_poses, float _dt);
+		void update_joint_transform_components(Component::Transform const* _components, animation_pose const& _pose, unsigned int _joint_count);
 
 		void window_edit_blendtree(std::unique_ptr<animation_tree_node> & _tree_root);
 
 	public:
 
+		SkeletonAnimatorManager();
+		~SkeletonAnimatorManager();
+
 		virtual const char* GetComponentTypeName() const override;
+		decltype(m_entity_animator_data)& GetComponentStorage() { return m_entity_animator_data; }
+
+		/*
+		* @brief	Evaluate blend trees of all playing animators and write poses to their joints.
+		* @details	Animators only read shared animation data, so with parallel updates enabled their
+		*			poses are evaluated on the job system. Joint transforms are written back serially
+		*			afterwards, since marking transforms dirty touches shared transform storage.
+		*/
 		void UpdateAnimatorInstances(float _dt);
 
+		bool GetParallelUpdate() const { return m_parallel_update; }
+		void SetParallelUpdate(bool _parallel) { m_parallel_update = _parallel; }
+
 
 		// Inherited via TCompManager
 		virtual void impl_deserialize_data(nlohmann::json const& _j) override;
@@ -8,6 +8,8 @@
 #include <Engine/Components/Rigidbody.h>
 
 #include <Engine/Editor/editor.h>
+#include <Engine/Utils/algorithm.h>
+#include <Engine/Utils/job_system.h>
 
 #include <SDL2/SDL_scancode.h>
 #include <glm/gtx/quaternion.hpp>
@@ -24,17 +26,24 @@ namespace Component
 	{
 		m_entity_indexer_map.clear();
 
+		m_transform_owners.clear();
 		m_local_transforms.clear();
 		m_parent.clear();
 		m_first_child.clear();
 		m_next_sibling.clear();
 
 		m_world_matrix_data.clear();
+		m_world_transform_data.clear();
 		m_world_matrix_owners.clear();
+		m_world_matrix_parents.clear();
+		m_world_matrix_transforms.clear();
+		m_world_matrix_dirty.clear();
 
 		m_root_entities.clear();
 
 		m_dirty_matrix_count = 0;
+		m_matrix_order_dirty = false;
+		m_root_subtree_ends.clear();
 	}
 
 	bool TransformManager::impl_create(Entity _e)
@@ -57,18 +66,30 @@ namespace Component
 		m_next_sibling.push_back(Entity::InvalidEntity);
 
 
+		// New roots at the back keep matrices sorted parents-first.
 		m_world_matrix_owners.push_back(_e);
 		m_world_matrix_data.push_back(math_transform().GetMatrix());
+		m_world_transform_data.push_back(math_transform());
+		m_world_matrix_parents.push_back(INVALID_MATRIX_INDEX);
+		m_world_matrix_transforms.push_back(new_indexer.transform);
+		m_world_matrix_dirty.push_back(0);
+		m_root_subtree_ends.push_back((unsigned int)m_world_matrix_owners.size());
 
 		m_root_entities.insert(_e);
 
-		m_dirty_matrix_count++;
+		mark_matrix_dirty(new_indexer.matrix);
 
 		return true;
 	}
 
 	void TransformManager::impl_destroy(Entity const* _entities, unsigned int _count)
 	{
+		if (_count > 1 && _count >= m_transform_owners.size() / BULK_DESTROY_FRACTION)
+		{
+			remove_entries(_entities, _count);
+			return;
+		}
+
 		for (unsigned int i = 0; i < _count; ++i)
 		{
 			if(ComponentOwnedByEntity(_entities[i]))
@@ -83,28 +104,16 @@ namespace Component
 
 	void TransformManager::remove_entry(Entity _e)
 	{
-		indexer_data entity_indexer = get_entity_indexer_data(_e);
-
 		detach_all_entity_children(_e);
 		detach_entity_from_parent(_e);
 
-		// Swap matrix indices such that entity matrix data is in back of dirty partition
-
-		// If matrix is not dirty, swap with back of clean partition.
-		if (!check_matrix_dirty(entity_indexer.matrix) && entity_indexer.matrix != last_clean_matrix_index())
-		{
-			swap_matrix_indices(entity_indexer.matrix, last_clean_matrix_index());
-			entity_indexer.matrix = last_clean_matrix_index();
+		indexer_data const entity_indexer = get_entity_indexer_data(_e);
 
-			// Swap backmost clean index with backmost dirty index
-			swap_matrix_indices(entity_indexer.matrix, (uint16_t)m_local_transforms.size() - 1);
-		}
-		// If index IS dirty, swap with back index of dirty partition
-		else
-		{
-			swap_matrix_indices(entity_indexer.matrix, (uint16_t)m_local_transforms.size() - 1);
+		// Move matrix data to back. This breaks the parents-first order of the moved matrix.
+		if (m_world_matrix_dirty[entity_indexer.matrix])
 			m_dirty_matrix_count--;
-		}
+		swap_matrix_indices(entity_indexer.matrix, (unsigned int)m_world_matrix_owners.size() - 1u);
+		m_matrix_order_dirty = true;
 
 		swap_transform_index_to_back(entity_indexer.transform);
 
@@ -122,10 +131,139 @@ namespace Component
 		// Pop back all matrix data contianers
 		m_world_matrix_owners.pop_back();
 		m_world_matrix_data.pop_back();
+		m_world_transform_data.pop_back();
+		m_world_matrix_parents.pop_back();
+		m_world_matrix_transforms.pop_back();
+		m_world_matrix_dirty.pop_back();
 
 		m_root_entities.erase(_e);
 	}
 
+	/*
+	* Remove transforms of many entities at once.
+	* @param	Entity const *	Entities to remove transforms of. Entities without transform are skipped.
+	* @param	unsigned int	Number of entities
+	* @detail	Surviving children of removed entities are detached with their world transform maintained,
+	*			same as with remove_entry. Transform and matrix data is then compacted once along the
+	*			sorted indices of removed entries, and indexers of moved entries are patched once.
+	*/
+	void TransformManager::remove_entries(Entity const* _entities, unsigned int _count)
+	{
+		using Engine::Math::transform3D;
+
+		// Flag transforms to remove, skipping entities without transform and duplicates.
+		std::vector<uint8_t> removed_flags(m_transform_owners.size(), 0);
+		std::vector<unsigned int> removed_transforms;
+		removed_transforms.reserve(_count);
+		for (unsigned int i = 0; i < _count; ++i)
+		{
+			auto const indexer_iter = m_entity_indexer_map.find(_entities[i]);
+			if (indexer_iter == m_entity_indexer_map.end() || removed_flags[indexer_iter->second.transform])
+				continue;
+			removed_flags[indexer_iter->second.transform] = 1;
+			removed_transforms.push_back(indexer_iter->second.transform);
+		}
+		if (removed_transforms.empty())
+			return;
+
+		// World transforms of removed parents have to be computed before the hierarchy changes.
+		std::vector<std::pair<unsigned int, transform3D>> orphaned_children;
+		for (unsigned int const removed_index : removed_transforms)
+		{
+			Entity child = m_first_child[removed_index];
+			bool computed_parent_transform = false;
+			transform3D parent_transform;
+			while (child != Entity::InvalidEntity)
+			{
+				unsigned int const child_index = get_entity_indexer_data(child).transform;
+				if (!removed_flags[child_index])
+				{
+					if (!computed_parent_transform)
+					{
+						parent_transform = Get(m_transform_owners[removed_index]).ComputeWorldTransform();
+						computed_parent_transform = true;
+					}
+					orphaned_children.emplace_back(child_index, parent_transform);
+				}
+				child = m_next_sibling[child_index];
+			}
+		}
+
+		// Unlink removed children from child lists of surviving parents, once per parent.
+		std::vector<uint8_t> relinked_parent_flags(m_transform_owners.size(), 0);
+		for (unsigned int const removed_index : removed_transforms)
+		{
+			Entity const parent = m_parent[removed_index];
+			if (parent == Entity::InvalidEntity)
+				continue;
+			unsigned int const parent_index = get_entity_indexer_data(parent).transform;
+			if (removed_flags[parent_index] || relinked_parent_flags[parent_index])
+				continue;
+			relinked_parent_flags[parent_index] = 1;
+
+			Entity* link = &m_first_child[parent_index];
+			while (*link != Entity::InvalidEntity)
+			{
+				unsigned int const child_index = get_entity_indexer_data(*link).transform;
+				if (removed_flags[child_index])
+					*link = m_next_sibling[child_index];
+				else
+					link = &m_next_sibling[child_index];
+			}
+		}
+
+		// Surviving children of removed entities become roots.
+		for (auto const& [child_index, parent_transform] : orphaned_children)
+		{
+			m_local_transforms[child_index] = parent_transform * m_local_transforms[child_index];
+			m_parent[child_index] = Entity::InvalidEntity;
+			m_next_sibling[child_index] = Entity::InvalidEntity;
+			m_root_entities.insert(m_transform_owners[child_index]);
+			mark_matrix_dirty(get_entity_indexer_data(m_transform_owners[child_index]).matrix);
+		}
+
+		std::vector<unsigned int> removed_matrices;
+		removed_matrices.reserve(removed_transforms.size());
+		for (unsigned int const removed_index : removed_transforms)
+		{
+			Entity const owner = m_transform_owners[removed_index];
+			unsigned int const matrix_index = get_entity_indexer_data(owner).matrix;
+			if (m_world_matrix_dirty[matrix_index])
+				m_dirty_matrix_count--;
+			removed_matrices.push_back(matrix_index);
+
+			m_entity_indexer_map.erase(owner);
+			m_root_entities.erase(owner);
+		}
+		std::sort(removed_transforms.begin(), removed_transforms.end());
+		std::sort(removed_matrices.begin(), removed_matrices.end());
+
+		using Engine::Utils::erase_sorted_indices;
+		erase_sorted_indices(m_transform_owners, removed_transforms);
+		erase_sorted_indices(m_local_transforms, removed_transforms);
+		erase_sorted_indices(m_parent, removed_transforms);
+		erase_sorted_indices(m_first_child, removed_transforms);
+		erase_sorted_indices(m_next_sibling, removed_transforms);
+
+		erase_sorted_indices(m_world_matrix_owners, removed_matrices);
+		erase_sorted_indices(m_world_matrix_data, removed_matrices);
+		erase_sorted_indices(m_world_transform_data, removed_matrices);
+		erase_sorted_indices(m_world_matrix_parents, removed_matrices);
+		erase_sorted_indices(m_world_matrix_transforms, removed_matrices);
+		erase_sorted_indices(m_world_matrix_dirty, removed_matrices);
+
+		// Only entries behind the first removed index have moved.
+		for (unsigned int i = removed_transforms.front(); i < (unsigned int)m_transform_owners.size(); i++)
+			m_entity_indexer_map.at(m_transform_owners[i]).transform = i;
+		for (unsigned int i = removed_matrices.front(); i < (unsigned int)m_world_matrix_owners.size(); i++)
+			m_entity_indexer_map.at(m_world_matrix_owners[i]).matrix = i;
+		for (unsigned int i = 0; i < (unsigned int)m_world_matrix_owners.size(); i++)
+			m_world_matrix_transforms[i] = get_entity_indexer_data(m_world_matrix_owners[i]).transform;
+
+		// Compaction keeps parents-first order, but parents and subtrees of matrices have changed.
+		m_matrix_order_dirty = true;
+	}
+
 	TransformManager::indexer_data TransformManager::get_entity_indexer_data(Entity _e) const
 	{
 		return m_entity_indexer_map.at(_e);
@@ -133,9 +271,9 @@ namespace Component
 
 	/*
 	* Swap transform data at given index with that of back index.
-	* @param	uint16_t		Index to swap with back
+	* @param	unsigned int	Index to swap with back
 	*/
-	void TransformManager::swap_transform_index_to_back(uint16_t _idx)
+	void TransformManager::swap_transform_index_to_back(unsigned int _idx)
 	{
 		if (m_local_transforms.empty() || _idx == m_local_transforms.size() - 1)
 			return;
@@ -145,7 +283,11 @@ namespace Component
 		Entity const back_entity = m_transform_owners[back_entity_idx];
 
 		// Update indexers in entity to indexer map
-		std::swap(m_entity_indexer_map.at(index_entity).transform, m_entity_indexer_map.at(back_entity).transform);
+		indexer_data& index_indexer = m_entity_indexer_map.at(index_entity);
+		indexer_data& back_indexer = m_entity_indexer_map.at(back_entity);
+		std::swap(index_indexer.transform, back_indexer.transform);
+		m_world_matrix_transforms[index_indexer.matrix] = index_indexer.transform;
+		m_world_matrix_transforms[back_indexer.matrix] = back_indexer.transform;
 		// Swap data at indices in actual transform data vectors.
 		std::swap(m_local_transforms[_idx], m_local_transforms[back_entity_idx]);
 		std::swap(m_transform_owners[_idx], m_transform_owners[back_entity_idx]);
@@ -159,29 +301,19 @@ namespace Component
 		mark_matrix_dirty(get_entity_indexer_data(_e).matrix);
 	}
 
-	void TransformManager::mark_matrix_dirty(uint16_t _idx)
+	void TransformManager::mark_matrix_dirty(unsigned int _matrix_idx)
 	{
-		// Return early if index is already early
-		if (check_matrix_dirty(_idx))
+		if (m_world_matrix_dirty[_matrix_idx])
 			return;
 
-		// If not dirty yet, swap with back clean index (unless already in back)
-		if (_idx == last_clean_matrix_index())
-		{
-			swap_matrix_indices(_idx, last_clean_matrix_index());
-			m_dirty_matrix_count++;
-		}
-	}
-
-	bool TransformManager::check_matrix_dirty(uint16_t _idx) const
-	{
-		return (m_local_transforms.size() - _idx <= m_dirty_matrix_count);
+		m_world_matrix_dirty[_matrix_idx] = 1;
+		m_dirty_matrix_count++;
 	}
 
 	bool TransformManager::attach_entity_to_parent(Entity _entity, Entity _target, bool _maintainWorldTransform)
 	{
-		uint16_t const target_index = get_entity_indexer_data(_target).transform;
-		uint16_t const entity_index = get_entity_indexer_data(_entity).transform;
+		unsigned int const target_index = get_entity_indexer_data(_target).transform;
+		unsigned int const entity_index = get_entity_indexer_data(_entity).transform;
 
 		// Return early if given child entity is already attached to parent.
 		if (m_parent[entity_index] == _target)
@@ -196,7 +328,7 @@ namespace Component
 		{
 			// Iterate through linked sibling list
 			Entity iter_child_entity = m_first_child[target_index];
-			uint16_t iter_child_index = get_entity_indexer_data(iter_child_entity).transform;
+			unsigned int iter_child_index = get_entity_indexer_data(iter_child_entity).transform;
 			while (m_next_sibling[iter_child_index] != Entity::InvalidEntity)
 			{
 				iter_child_entity = m_next_sibling[iter_child_index];
@@ -214,6 +346,7 @@ namespace Component
 		}
 
 		mark_matrix_dirty(_entity);
+		m_matrix_order_dirty = true;
 
 		m_root_entities.erase(_entity);
 
@@ -226,14 +359,14 @@ namespace Component
 	*/
 	void TransformManager::detach_entity_from_parent(Entity _entity, bool _maintainWorldTransform)
 	{
-		uint16_t const entity_transform_index = get_entity_indexer_data(_entity).transform;
+		unsigned int const entity_transform_index = get_entity_indexer_data(_entity).transform;
 		Entity const parent = m_parent[entity_transform_index];
 
 		// Return early if child has no parent to detach from.
 		if (parent == Entity::InvalidEntity)
 			return;
 
-		uint16_t const parent_index = get_entity_indexer_data(parent).transform;
+		unsigned int const parent_index = get_entity_indexer_data(parent).transform;
 
 		// Remove child from children list
 
@@ -250,7 +383,7 @@ namespace Component
 		else
 		{
 			Entity child_iter = m_first_child[parent_index];
-			uint16_t child_iter_index = get_entity_indexer_data(child_iter).transform;
+			unsigned int child_iter_index = get_entity_indexer_data(child_iter).transform;
 			// No bounds checking since we know that entity is guaranteed to be a child of parent.
 			while (m_next_sibling[child_iter_index] != _entity)
 			{
@@ -273,6 +406,7 @@ namespace Component
 		m_root_entities.insert(_entity);
 
 		mark_matrix_dirty(_entity);
+		m_matrix_order_dirty = true;
 	}
 
 	void TransformManager::detach_all_entity_children(Entity _entity, bool _maintainWorldTransform)
@@ -305,14 +439,17 @@ namespace Component
 	}
 
 	/*
-	* Swap matrices at input indices with each other
-	* This is used for maintaining the correct update order when
-	* computing matrices, or when removing entities
-	* @param	uint16_t	Index 1
-	* @param	uint16_t	Index 2
+	* Swap matrices at input indices with each other.
+	* Parent indices referring to either matrix are not updated, so matrices have to be sorted
+	* again before the next update.
+	* @param	unsigned int	Index 1
+	* @param	unsigned int	Index 2
 	*/
-	void TransformManager::swap_matrix_indices(uint16_t _idx1, uint16_t _idx2)
+	void TransformManager::swap_matrix_indices(unsigned int _idx1, unsigned int _idx2)
 	{
+		if (_idx1 == _idx2)
+			return;
+
 		// Update bi-directional entity-matrix-index map
 		Entity const e1 = m_world_matrix_owners[_idx1];
 		Entity const e2 = m_world_matrix_owners[_idx2];
@@ -323,15 +460,120 @@ namespace Component
 
 		// Swap matrix data
 		std::swap(m_world_matrix_data[_idx1], m_world_matrix_data[_idx2]);
+		std::swap(m_world_transform_data[_idx1], m_world_transform_data[_idx2]);
+		std::swap(m_world_matrix_parents[_idx1], m_world_matrix_parents[_idx2]);
+		std::swap(m_world_matrix_transforms[_idx1], m_world_matrix_transforms[_idx2]);
+		std::swap(m_world_matrix_dirty[_idx1], m_world_matrix_dirty[_idx2]);
+	}
+
+	/*
+	* Reorder matrix data depth-first from every root, such that parents precede their children
+	* and the subtree of every root is contiguous. Roots keep their relative order.
+	*/
+	void TransformManager::sort_world_matrices()
+	{
+		size_t const matrix_count = m_world_matrix_owners.size();
+
+		std::vector<unsigned int> sorted_indices;
+		sorted_indices.reserve(matrix_count);
+		std::vector<Entity> stack;
+		m_root_subtree_ends.clear();
+		for (size_t i = 0; i < matrix_count; i++)
+		{
+			Entity const root = m_world_matrix_owners[i];
+			if (m_parent[m_world_matrix_transforms[i]] != Entity::InvalidEntity)
+				continue;
+
+			stack.push_back(root);
+			while (!stack.empty())
+			{
+				Entity const e = stack.back();
+				stack.pop_back();
+				indexer_data const e_indexer = get_entity_indexer_data(e);
+				sorted_indices.push_back(e_indexer.matrix);
+				for (Entity child = m_first_child[e_indexer.transform]; child != Entity::InvalidEntity; child = m_next_sibling[get_entity_indexer_data(child).transform])
+					stack.push_back(child);
+			}
+			m_root_subtree_ends.push_back((unsigned int)sorted_indices.size());
+		}
+		assert(sorted_indices.size() == matrix_count);
+
+		auto reorder = [&sorted_indices](auto& _data)
+		{
+			std::remove_reference_t<decltype(_data)> sorted_data;
+			sorted_data.reserve(_data.size());
+			for (unsigned int const idx : sorted_indices)
+				sorted_data.push_back(_data[idx]);
+			_data = std::move(sorted_data);
+		};
+		reorder(m_world_matrix_owners);
+		reorder(m_world_matrix_data);
+		reorder(m_world_transform_data);
+		reorder(m_world_matrix_transforms);
+		reorder(m_world_matrix_dirty);
+
+		for (unsigned int i = 0; i < (unsigned int)matrix_count; i++)
+			m_entity_indexer_map.at(m_world_matrix_owners[i]).matrix = i;
+
+		for (unsigned int i = 0; i < (unsigned int)matrix_count; i++)
+		{
+			Entity const parent = m_parent[m_world_matrix_transforms[i]];
+			m_world_matrix_parents[i] = (parent == Entity::InvalidEntity)
+				? INVALID_MATRIX_INDEX
+				: get_entity_indexer_data(parent).matrix;
+		}
+
+		m_matrix_order_dirty = false;
+	}
+
+	/*
+	* Split matrices into runs of whole root subtrees, such that no subtree is split between runs.
+	* Runs hold at least MIN_MATRICES_PER_UPDATE_RANGE matrices, except possibly the last one.
+	* @param	unsigned int	Number of runs to aim for
+	*/
+	void TransformManager::partition_update_ranges(unsigned int _range_count)
+	{
+		unsigned int const matrix_count = (unsigned int)m_world_matrix_owners.size();
+		unsigned int const target_size = std::max(MIN_MATRICES_PER_UPDATE_RANGE, matrix_count / std::max(_range_count, 1u));
+
+		m_update_range_ends.clear();
+		unsigned int range_begin = 0;
+		for (unsigned int const subtree_end : m_root_subtree_ends)
+		{
+			if (subtree_end - range_begin < target_size)
+				continue;
+			m_update_range_ends.push_back(subtree_end);
+			range_begin = subtree_end;
+		}
+		if (range_begin != matrix_count)
+			m_update_range_ends.push_back(matrix_count);
 	}
 
 	/*
-	* Returns last clean index in internal data list.
-	* @returns	uint16_t	Back index of clean partition
+	* Sweep matrices in [begin, end) parents-first, and recompute those that are dirty or have a
+	* dirty ancestor. Range has to consist of whole root subtrees.
+	* Dirty flags of the range are cleared after the sweep, since children read the flags of their parents.
+	* @param	unsigned int	First matrix index
+	* @param	unsigned int	One past last matrix index
 	*/
-	uint16_t TransformManager::last_clean_matrix_index() const
+	void TransformManager::update_world_matrix_range(unsigned int _begin, unsigned int _end)
 	{
-		return (uint16_t)m_local_transforms.size() - m_dirty_matrix_count - 1;
+		for (unsigned int i = _begin; i < _end; i++)
+		{
+			unsigned int const parent_idx = m_world_matrix_parents[i];
+			if (parent_idx != INVALID_MATRIX_INDEX && m_world_matrix_dirty[parent_idx])
+				m_world_matrix_dirty[i] = 1;
+			if (!m_world_matrix_dirty[i])
+				continue;
+
+			Engine::Math::transform3D const& local_transform = m_local_transforms[m_world_matrix_transforms[i]];
+			m_world_transform_data[i] = (parent_idx == INVALID_MATRIX_INDEX)
+				? local_transform
+				: m_world_transform_data[parent_idx] * local_transform;
+			m_world_matrix_data[i] = m_world_transform_data[i].GetMatrix();
+		}
+
+		std::fill(m_world_matrix_dirty.begin() + _begin, m_world_matrix_dirty.begin() + _end, uint8_t(0));
 	}
 
 
@@ -348,6 +590,34 @@ namespace Component
 		return entity_list;
 	}
 
+	void TransformManager::UpdateWorldMatrices()
+	{
+		if (m_matrix_order_dirty)
+			sort_world_matrices();
+
+		if (m_dirty_matrix_count == 0)
+			return;
+
+		unsigned int const matrix_count = (unsigned int)m_world_matrix_owners.size();
+		auto& jobs = Singleton<Engine::Utils::job_system>();
+		if (!m_parallel_update || jobs.thread_count() == 1 || matrix_count < 2 * MIN_MATRICES_PER_UPDATE_RANGE)
+			update_world_matrix_range(0, matrix_count);
+		else
+		{
+			// Several ranges per thread, so uneven subtree sizes and dynamic batch assignment even out.
+			partition_update_ranges(jobs.thread_count() * 4);
+			jobs.parallel_for(m_update_range_ends.size(), 1,
+				[this](size_t _begin, size_t _end, unsigned int)
+				{
+					for (size_t r = _begin; r < _end; r++)
+						update_world_matrix_range(r == 0 ? 0 : m_update_range_ends[r - 1], m_update_range_ends[r]);
+				}
+			);
+		}
+
+		m_dirty_matrix_count = 0;
+	}
+
 	void TransformManager::DisplaySceneGraph()
 	{
 		auto root_nodes = Singleton<TransformManager>().GetRootEntities();
@@ -639,16 +909,23 @@ namespace Component
 			m_next_sibling = _j["m_next_sibling"].get<decltype(m_next_sibling)>();
 			m_root_entities = _j["m_root_entities"].get<decltype(m_root_entities)>();
 
-			m_world_matrix_data.resize(m_entity_indexer_map.size());
-			m_world_matrix_owners.resize(m_entity_indexer_map.size());
-			size_t i = 0;
+			size_t const matrix_count = m_entity_indexer_map.size();
+			m_world_matrix_data.assign(matrix_count, glm::mat4x4(1.0f));
+			m_world_transform_data.assign(matrix_count, Engine::Math::transform3D());
+			m_world_matrix_owners.resize(matrix_count);
+			m_world_matrix_parents.assign(matrix_count, INVALID_MATRIX_INDEX);
+			m_world_matrix_transforms.resize(matrix_count);
+			m_world_matrix_dirty.assign(matrix_count, 1);
+			unsigned int i = 0;
 			for (auto& [entity, entity_indexer_data] : m_entity_indexer_map)
 			{
 				m_world_matrix_owners[i] = entity;
+				m_world_matrix_transforms[i] = entity_indexer_data.transform;
 				entity_indexer_data.matrix = i++;
 			}
 		}
-		m_dirty_matrix_count = m_entity_indexer_map.size();
+		m_dirty_matrix_count = (unsigned int)m_entity_indexer_map.size();
+		m_matrix_order_dirty = true;
 	}
 
 	void TransformManager::impl_serialize_data(nlohmann::json& _j) const
@@ -720,100 +997,78 @@ namespace Component
 	}
 
 	/*
-	* Computes model to world transform using entity hierarchy.
+	* Gets model to world transform, cached by the last world matrix update.
+	* If any transform changed since, compute it from scratch using entity hierarchy.
 	* @returns	Transform 3D
 	*/
 	Engine::Math::transform3D Transform::ComputeWorldTransform() const
 	{
-		unsigned int entity_iter_transform_idx = GetManager().get_entity_indexer_data(m_owner).transform;
-		Engine::Math::transform3D model_to_world_transform = GetManager().m_local_transforms[entity_iter_transform_idx];
-		Entity parent_entity = GetManager().m_parent[entity_iter_transform_idx];
+		auto const& mgr = GetManager();
+		TransformManager::indexer_data const owner_indexer = mgr.get_entity_indexer_data(m_owner);
+		if (mgr.m_dirty_matrix_count == 0)
+			return mgr.m_world_transform_data[owner_indexer.matrix];
+
+		unsigned int entity_iter_transform_idx = owner_indexer.transform;
+		Engine::Math::transform3D model_to_world_transform = mgr.m_local_transforms[entity_iter_transform_idx];
+		Entity parent_entity = mgr.m_parent[entity_iter_transform_idx];
 		while (parent_entity != Entity::InvalidEntity)
 		{
-			unsigned int const parent_transform_index = GetManager().get_entity_indexer_data(parent_entity).transform;
-			model_to_world_transform = GetManager().m_local_transforms[parent_transform_index] * model_to_world_transform;
-			parent_entity = GetManager().m_parent[parent_transform_index];
+			unsigned int const parent_transform_index = mgr.get_entity_indexer_data(parent_entity).transform;
+			model_to_world_transform = mgr.m_local_transforms[parent_transform_index] * model_to_world_transform;
+			parent_entity = mgr.m_parent[parent_transform_index];
 		}
 		return model_to_world_transform;
 	}
 
 	/*
-	* Gets model to world matrix using precomputed matrix.
-	* If precomputed matrix is outdated (dirty), recompute from scratch using model to world transform.
+	* Gets model to world matrix, cached by the last world matrix update.
+	* If any transform changed since, compute it from scratch using entity hierarchy.
 	* @returns	Model to World matrix
 	*/
 	glm::mat4x4 Transform::ComputeWorldMatrix() const
 	{
-		using indexer_data = TransformManager::indexer_data;
-		auto& mgr = GetManager();
-		indexer_data owner_indexer = mgr.get_entity_indexer_data(m_owner);
-		// If owner index is NOT dirty, use pre-computed matrix
-		if (!mgr.check_matrix_dirty(owner_indexer.matrix))
-		{
-			return mgr.m_world_matrix_data[owner_indexer.matrix];
-		}
-		// If owner index IS dirty, re-compute model to world matrix.
-		else
-		{
-			glm::mat4x4 transformation_matrix = mgr.m_local_transforms[owner_indexer.transform].GetMatrix();
-			Entity parent_iter = mgr.m_parent[owner_indexer.transform];
-			if (parent_iter != Entity::InvalidEntity)
-			{
-				while (parent_iter != Entity::InvalidEntity)
-				{
-					indexer_data const parent_indexer = mgr.get_entity_indexer_data(parent_iter);
-					// If parent is NOT dirty, use precomputed matrix and exit early.
-					if (!mgr.check_matrix_dirty(parent_indexer.matrix))
-					{
-						transformation_matrix = mgr.m_world_matrix_data[parent_indexer.matrix] * transformation_matrix;
-						break;
-					}
-					// Otherwise, keep going up the hierarchy until we reach the end or reach a valid precomputed matrix
-					else
-					{
-						transformation_matrix = mgr.m_world_matrix_data[parent_indexer.matrix] * transformation_matrix;
-						parent_iter = mgr.m_parent[parent_indexer.transform];
-					}
-				}
-			}
-			return transformation_matrix;
-		}
+		auto const& mgr = GetManager();
+		if (mgr.m_dirty_matrix_count == 0)
+			return mgr.m_world_matrix_data[mgr.get_entity_indexer_data(m_owner).matrix];
+
+		// Same as cached matrices, such that results do not depend on when matrices were updated.
+		return ComputeWorldTransform().GetMatrix();
 	}
 
 	void Transform::SetLocalTransform(Engine::Math::transform3D _value)
 	{
-		unsigned int const entity_transform_index = GetManager().get_entity_indexer_data(m_owner).transform;
-		GetManager().m_local_transforms[entity_transform_index] = _value;
-		GetManager().mark_matrix_dirty(entity_transform_index);
+		TransformManager::indexer_data const entity_indexer = GetManager().get_entity_indexer_data(m_owner);
+		GetManager().m_local_transforms[entity_indexer.transform] = _value;
+		GetManager().mark_matrix_dirty(entity_indexer.matrix);
 	}
 	void Transform::SetLocalPosition(glm::vec3 _value)
 	{
-		unsigned int const entity_transform_index = GetManager().get_entity_indexer_data(m_owner).transform;
-		GetManager().m_local_transforms[entity_transform_index].position = _value;
-		GetManager().mark_matrix_dirty(entity_transform_index);
+		TransformManager::indexer_data const entity_indexer = GetManager().get_entity_indexer_data(m_owner);
+		GetManager().m_local_transforms[entity_indexer.transform].position = _value;
+		GetManager().mark_matrix_dirty(entity_indexer.matrix);
 	}
 	void Transform::SetLocalScale(glm::vec3 _value)
 	{
-		unsigned int const entity_transform_index = GetManager().get_entity_indexer_data(m_owner).transform;
-		GetManager().m_local_transforms[entity_transform_index].scale = _value;
-		GetManager().mark_matrix_dirty(entity_transform_index);
+		TransformManager::indexer_data const entity_indexer = GetManager().get_entity_indexer_data(m_owner);
+		GetManager().m_local_transforms[entity_indexer.transform].scale = _value;
+		GetManager().mark_matrix_dirty(entity_indexer.matrix);
 	}
 	void Transform::SetLocalRotation(glm::quat _value)
 	{
-		unsigned int const entity_transform_index = GetManager().get_entity_indexer_data(m_owner).transform;
-		GetManager().m_local_transforms[entity_transform_index].rotation = _value;
-		GetManager().mark_matrix_dirty(entity_transform_index);
+		TransformManager::indexer_data const entity_indexer = GetManager().get_entity_indexer_data(m_owner);
+		GetManager().m_local_transforms[entity_indexer.transform].rotation = _value;
+		GetManager().mark_matrix_dirty(entity_indexer.matrix);
 	}
 	bool Transform::HasChildren() const
 	{
 		unsigned int const entity_transform_index = GetManager().get_entity_indexer_data(m_owner).transform;
-		auto manager = GetManager();
+		auto const& manager = GetManager();
 		return manager.m_first_child[entity_transform_index] != Entity::InvalidEntity;
 	}
 	std::vector<Entity> Transform::GetChildren() const
 	{
 		unsigned int const entity_transform_index = GetManager().get_entity_indexer_data(m_owner).transform;
-		auto manager = GetManager();
+		auto const& manager = GetManager();
 		std::vector<Entity> children;
 		Entity child_iter = manager.m_first_child[entity_transform_index];
 		while (child_iter != Entity::InvalidEntity)
@@ -47,7 +47,7 @@ namespace Component
 		};
 
 		// Double-linked maps
-		std::unordered_map<Entity, indexer_data, Entity::hash>	m_entity_indexer_map;
+		sparse_set<indexer_data>								m_entity_indexer_map;
 
 		// Transform and relationship data
 		// Referred to by indexer_data/transform variable
@@ -57,11 +57,31 @@ namespace Component
 		std::vector<Entity>						m_first_child;
 		std::vector<Entity>						m_next_sibling;
 
-		// Referred to by indexer_data/matrix variable
+		// Referred to by indexer_data/matrix variable.
+		// Sorted such that every parent precedes its children, and every root is followed by its subtree.
 		std::vector<Entity>						m_world_matrix_owners;
 		std::vector<glm::mat4x4>				m_world_matrix_data;
-		// How many world matrices need to be recomputed from back to front.
+		std::vector<Engine::Math::transform3D>	m_world_transform_data;
+		std::vector<unsigned int>				m_world_matrix_parents;		// Matrix index of parent, INVALID_MATRIX_INDEX for roots
+		std::vector<unsigned int>				m_world_matrix_transforms;	// Transform index of owner
+		std::vector<uint8_t>					m_world_matrix_dirty;		// Local transform changed since last update
+		// How many world matrices have been marked dirty since the last update.
+		// Cached world data is only valid when this is zero.
 		unsigned int m_dirty_matrix_count = 0;
+		// Hierarchy changed since the last update, so matrices have to be sorted again.
+		bool m_matrix_order_dirty = false;
+		// One past the last matrix index of every root subtree, in matrix order.
+		std::vector<unsigned int>				m_root_subtree_ends;
+		// Contiguous runs of root subtrees that are updated independently of each other.
+		std::vector<unsigned int>				m_update_range_ends;
+		bool m_parallel_update = true;
+
+		static unsigned int constexpr INVALID_MATRIX_INDEX = ~0u;
+		// Below this many matrices per range, handing ranges to workers costs more than it saves.
+		static unsigned int constexpr MIN_MATRICES_PER_UPDATE_RANGE = 1024;
+		// Destroying at least this fraction of all transforms at once compacts data in a single pass,
+		// instead of detaching and swapping out entities one by one.
+		static unsigned int constexpr BULK_DESTROY_FRACTION = 64;
 
 		std::unordered_set<Entity, Entity::hash> m_root_entities;
 
@@ -74,15 +94,17 @@ namespace Component
 		bool impl_component_owned_by_entity(Entity _entity) const final;
 
 		void remove_entry(Entity _e);
+		void remove_entries(Entity const* _entities, unsigned int _count);
 		indexer_data get_entity_indexer_data(Entity _e) const;
 
-		void swap_transform_index_to_back(uint16_t _idx);
+		void swap_transform_index_to_back(unsigned int _idx);
 
 		void mark_matrix_dirty(Entity _e);
-		void mark_matrix_dirty(uint16_t _idx);
-		bool check_matrix_dirty(uint16_t _idx) const;
-		void swap_matrix_indices(uint16_t _idx1, uint16_t _idx2);
-		uint16_t last_clean_matrix_index() const;
+		void mark_matrix_dirty(unsigned int _matrix_idx);
+		void swap_matrix_indices(unsigned int _idx1, unsigned int _idx2);
+		void sort_world_matrices();
+		void partition_update_ranges(unsigned int _range_count);
+		void update_world_matrix_range(unsigned int _begin, unsigned int _end);
 
 		bool attach_entity_to_parent(Entity _entity, Entity _target, bool _maintainWorldTransform = true);
 		void detach_entity_from_parent(Entity _child, bool _maintainWorldTransform = true);
@@ -100,6 +122,20 @@ namespace Component
 		// Inherited via TCompManager
 		const char* GetComponentTypeName() const final { return "Transform"; }
 		std::vector<Entity> GetRootEntities() const;
+		decltype(m_entity_indexer_map)& GetComponentStorage() { return m_entity_indexer_map; }
+
+		/*
+		* @brief	Recompute world transforms and matrices of dirty transforms and their descendants.
+		* @details	Matrices are kept sorted parents-first, so a single linear sweep propagates dirty
+		*			flags down the hierarchy. Sorting only happens after the hierarchy has changed.
+		*			World transforms and matrices are read from cache until the next change.
+		*			With parallel updates enabled, runs of whole root subtrees are swept on the
+		*			job system. Subtrees never read each other's data, so no synchronisation is needed.
+		*/
+		void UpdateWorldMatrices();
+
+		bool GetParallelUpdate() const { return m_parallel_update; }
+		void SetParallelUpdate(bool _parallel) { m_parallel_update = _parallel; }
 
 		void DisplaySceneGraph();
 
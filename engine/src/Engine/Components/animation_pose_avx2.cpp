@@ -0,0 +1,45 @@
+// Compiled with AVX2 flags when ENGINE_SIMD_AVX2_KERNELS is defined, see engine/CMakeLists.txt.
+// Kernels are only called after checking CPU support at runtime.
+#if defined(ENGINE_SIMD_AVX2_KERNELS) && defined(__AVX2__)
+
+#include "animation_pose_simd.hpp"
+
+namespace Component {
+namespace AnimationUtil {
+
+	void blend_joint_lanes_avx2(
+		joint_transform_lanes* _dest,
+		joint_transform_lanes const* _left,
+		joint_transform_lanes const* _right,
+		float const _right_weight,
+		size_t const _block_count
+	)
+	{
+		blend_joint_lanes(_dest, _left, _right, _right_weight, _block_count);
+	}
+
+	void blend_joint_lanes_avx2(
+		joint_transform_lanes* _dest,
+		joint_transform_lanes const* _left,
+		joint_transform_lanes const* _right,
+		float const* _right_weights,
+		size_t const _block_count
+	)
+	{
+		blend_joint_lanes(_dest, _left, _right, _right_weights, _block_count);
+	}
+
+	void blend_joint_lanes_avx2(
+		joint_transform_lanes* _dest,
+		joint_transform_lanes const* const _poses[3],
+		float const _weights[3],
+		size_t const _block_count
+	)
+	{
+		blend_joint_lanes(_dest, _poses, _weights, _block_count);
+	}
+
+}
+}
+
+#endif
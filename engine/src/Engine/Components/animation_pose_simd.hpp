@@ -0,0 +1,188 @@
+#pragma once
+
+/*
+* SIMD pose blending kernels, compiled once per instruction set by including this header from a
+* translation unit with the matching compiler flags. Kernels have internal linkage and only work on
+* joint_transform_lanes, such that no glm function is instantiated with wider instructions than the
+* rest of the build.
+*/
+
+#include <Engine/Math/simd.hpp>
+
+#include "joint_transform_lanes.h"
+
+namespace Component {
+namespace AnimationUtil {
+
+	// Lane types depend on the lane width, so they live in the namespace of the instruction set.
+inline namespace ENGINE_SIMD_NAMESPACE {
+
+	/*
+	* @brief	Joint transforms of WIDTH joints in SIMD lanes.
+	*/
+	struct simd_joint_transforms
+	{
+		Engine::Math::simd_vec3	position;
+		Engine::Math::simd_vec3	scale;
+		Engine::Math::simd_quat	rotation;
+	};
+
+}
+
+	static_assert(
+		joint_transform_lanes::JOINT_LANES % Engine::Math::simd_float::WIDTH == 0,
+		"Blocks of joint lanes have to fill whole SIMD lane packs."
+	);
+
+	static inline simd_joint_transforms load_joint_lanes(joint_transform_lanes const& _block, size_t _lane)
+	{
+		using Engine::Math::simd_float;
+		return {
+			{ simd_float::load(&_block.m_position[0][_lane]), simd_float::load(&_block.m_position[1][_lane]), simd_float::load(&_block.m_position[2][_lane]) },
+			{ simd_float::load(&_block.m_scale[0][_lane]), simd_float::load(&_block.m_scale[1][_lane]), simd_float::load(&_block.m_scale[2][_lane]) },
+			{
+				simd_float::load(&_block.m_rotation[0][_lane]), simd_float::load(&_block.m_rotation[1][_lane]),
+				simd_float::load(&_block.m_rotation[2][_lane]), simd_float::load(&_block.m_rotation[3][_lane])
+			}
+		};
+	}
+
+	static inline void store_joint_lanes(simd_joint_transforms const& _joints, joint_transform_lanes& _block, size_t _lane)
+	{
+		_joints.position.x.store(&_block.m_position[0][_lane]);
+		_joints.position.y.store(&_block.m_position[1][_lane]);
+		_joints.position.z.store(&_block.m_position[2][_lane]);
+		_joints.scale.x.store(&_block.m_scale[0][_lane]);
+		_joints.scale.y.store(&_block.m_scale[1][_lane]);
+		_joints.scale.z.store(&_block.m_scale[2][_lane]);
+		_joints.rotation.w.store(&_block.m_rotation[0][_lane]);
+		_joints.rotation.x.store(&_block.m_rotation[1][_lane]);
+		_joints.rotation.y.store(&_block.m_rotation[2][_lane]);
+		_joints.rotation.z.store(&_block.m_rotation[3][_lane]);
+	}
+
+	// Rotations are scaled component-wise, to be normalized after summing.
+	static inline simd_joint_transforms weighted_joint_lanes(simd_joint_transforms const& _joints, Engine::Math::simd_float _weight)
+	{
+		return {
+			_joints.position * _weight,
+			_joints.scale * _weight,
+			{ _joints.rotation.w * _weight, _joints.rotation.x * _weight, _joints.rotation.y * _weight, _joints.rotation.z * _weight }
+		};
+	}
+
+	static inline simd_joint_transforms add_joint_lanes(simd_joint_transforms const& _a, simd_joint_transforms const& _b)
+	{
+		return {
+			_a.position + _b.position,
+			_a.scale + _b.scale,
+			{ _a.rotation.w + _b.rotation.w, _a.rotation.x + _b.rotation.x, _a.rotation.y + _b.rotation.y, _a.rotation.z + _b.rotation.z }
+		};
+	}
+
+	/*
+	* @brief	Lerp positions and scales, nlerp rotations of two poses in packs of WIDTH joints.
+	* @param	TWeights	Callable returning simd_float weights of the right pose at block and lane.
+	*/
+	template<typename TWeights>
+	static inline void blend_joint_lanes_weighted(
+		joint_transform_lanes* _dest,
+		joint_transform_lanes const* _left,
+		joint_transform_lanes const* _right,
+		TWeights&& _right_weights,
+		size_t const _block_count
+	)
+	{
+		using namespace Engine::Math;
+		size_t constexpr WIDTH = simd_float::WIDTH;
+		simd_float const one = simd_float::broadcast(1.0f);
+
+		for (size_t b = 0; b < _block_count; b++)
+		{
+			for (size_t lane = 0; lane < joint_transform_lanes::JOINT_LANES; lane += WIDTH)
+			{
+				simd_float const right_weight = _right_weights(b, lane);
+				simd_joint_transforms blended = add_joint_lanes(
+					weighted_joint_lanes(load_joint_lanes(_left[b], lane), one - right_weight),
+					weighted_joint_lanes(load_joint_lanes(_right[b], lane), right_weight)
+				);
+				blended.rotation = normalize(blended.rotation);
+				store_joint_lanes(blended, _dest[b], lane);
+			}
+		}
+	}
+
+	static inline void blend_joint_lanes(
+		joint_transform_lanes* _dest,
+		joint_transform_lanes const* _left,
+		joint_transform_lanes const* _right,
+		float const _right_weight,
+		size_t const _block_count
+	)
+	{
+		Engine::Math::simd_float const right_weight = Engine::Math::simd_float::broadcast(_right_weight);
+		blend_joint_lanes_weighted(_dest, _left, _right, [right_weight](size_t, size_t) { return right_weight; }, _block_count);
+	}
+
+	// Weights of the right pose are given per joint, JOINT_LANES per block.
+	static inline void blend_joint_lanes(
+		joint_transform_lanes* _dest,
+		joint_transform_lanes const* _left,
+		joint_transform_lanes const* _right,
+		float const* _right_weights,
+		size_t const _block_count
+	)
+	{
+		blend_joint_lanes_weighted(_dest, _left, _right, [_right_weights](size_t _block, size_t _lane)
+		{
+			return Engine::Math::simd_float::load(&_right_weights[_block * joint_transform_lanes::JOINT_LANES + _lane]);
+		}, _block_count);
+	}
+
+	/*
+	* @brief	Barycentric blend of three poses in packs of WIDTH joints.
+	*/
+	static inline void blend_joint_lanes(
+		joint_transform_lanes* _dest,
+		joint_transform_lanes const* const _poses[3],
+		float const _weights[3],
+		size_t const _block_count
+	)
+	{
+		using namespace Engine::Math;
+		size_t constexpr WIDTH = simd_float::WIDTH;
+		simd_float const weights[3] = {
+			simd_float::broadcast(_weights[0]), simd_float::broadcast(_weights[1]), simd_float::broadcast(_weights[2])
+		};
+
+		for (size_t b = 0; b < _block_count; b++)
+		{
+			for (size_t lane = 0; lane < joint_transform_lanes::JOINT_LANES; lane += WIDTH)
+			{
+				simd_joint_transforms blended = weighted_joint_lanes(load_joint_lanes(_poses[0][b], lane), weights[0]);
+				blended = add_joint_lanes(blended, weighted_joint_lanes(load_joint_lanes(_poses[1][b], lane), weights[1]));
+				blended = add_joint_lanes(blended, weighted_joint_lanes(load_joint_lanes(_poses[2][b], lane), weights[2]));
+				blended.rotation = normalize(blended.rotation);
+				store_joint_lanes(blended, _dest[b], lane);
+			}
+		}
+	}
+
+#if defined(ENGINE_SIMD_AVX2_KERNELS)
+	// Defined in animation_pose_avx2.cpp, which is compiled with AVX2 flags.
+	void blend_joint_lanes_avx2(
+		joint_transform_lanes* _dest, joint_transform_lanes const* _left, joint_transform_lanes const* _right,
+		float const _right_weight, size_t const _block_count
+	);
+	void blend_joint_lanes_avx2(
+		joint_transform_lanes* _dest, joint_transform_lanes const* _left, joint_transform_lanes const* _right,
+		float const* _right_weights, size_t const _block_count
+	);
+	void blend_joint_lanes_avx2(
+		joint_transform_lanes* _dest, joint_transform_lanes const* const _poses[3],
+		float const _weights[3], size_t const _block_count
+	);
+#endif
+
+}
+}
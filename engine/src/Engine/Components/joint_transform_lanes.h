@@ -0,0 +1,24 @@
+#ifndef ENGINE_COMPONENTS_JOINT_TRANSFORM_LANES_H
+#define ENGINE_COMPONENTS_JOINT_TRANSFORM_LANES_H
+
+#include <cstddef>
+
+namespace Component
+{
+	/*
+	* @brief	Transforms of JOINT_LANES joints in structure-of-arrays layout, such that poses are
+	*			blended a SIMD lane pack of joints at a time without transposing them.
+	* @details	Kept free of glm, such that SIMD kernels compiled with wider instructions than the rest
+	*			of the build can include it.
+	*/
+	struct alignas(32) joint_transform_lanes
+	{
+		static size_t constexpr JOINT_LANES = 8;
+
+		float m_position[3][JOINT_LANES];
+		float m_scale[3][JOINT_LANES];
+		float m_rotation[4][JOINT_LANES];	// w, x, y, z
+	};
+}
+
+#endif // !ENGINE_COMPONENTS_JOINT_TRANSFORM_LANES_H
@@ -0,0 +1,89 @@
+#ifndef ENGINE_ECS_ARCHETYPE_COMP_MANAGER_H
+#define ENGINE_ECS_ARCHETYPE_COMP_MANAGER_H
+
+#include "component_manager.h"
+#include "archetype_storage.h"
+
+#include <Engine/Utils/singleton.h>
+
+namespace Engine {
+namespace ECS {
+
+	/*
+	* @brief	Component manager that keeps its per-entity data in the shared archetype storage.
+	* @details	Opt-in alternative to a manager owning its own arrays. Data of all managers deriving from this
+	*			lives in the same chunks, so entities owning several of these components can be iterated
+	*			with archetype_storage::each() without lookups. Every manager needs its own TData type.
+	*			Derived managers implement editing and type name, and can use serialize_storage() and
+	*			deserialize_storage() when TData is convertible to json.
+	*/
+	template<class TComp, typename TData>
+	class TArchetypeCompManager : public TCompManager<TComp>
+	{
+	public:
+
+		typedef TData data_type;
+
+		static archetype_storage& GetStorage() { return Singleton<archetype_storage>(); }
+
+	protected:
+
+		TData&	get_data(Entity _e) { return GetStorage().template get<TData>(_e); }
+		TData const& get_data(Entity _e) const { return GetStorage().template get<TData>(_e); }
+
+		void impl_clear() override
+		{
+			GetStorage().template remove_all<TData>();
+		}
+
+		bool impl_create(Entity _e) override
+		{
+			GetStorage().template emplace<TData>(_e);
+			return true;
+		}
+
+		void impl_destroy(Entity const* _entities, unsigned int _count) override
+		{
+			for (unsigned int i = 0; i < _count; i++)
+				GetStorage().template remove<TData>(_entities[i]);
+		}
+
+		bool impl_component_owned_by_entity(Entity _entity) const override
+		{
+			return GetStorage().template has<TData>(_entity);
+		}
+
+		void serialize_storage(nlohmann::json& _j) const
+		{
+			_j["serializer_version"] = 1;
+
+			std::vector<Entity> entities;
+			std::vector<TData> data;
+			GetStorage().template each<TData>([&](Entity _e, TData& _data)
+			{
+				entities.push_back(_e);
+				data.push_back(_data);
+			});
+			_j["m_entities"] = entities;
+			_j["m_data"] = data;
+		}
+
+		void deserialize_storage(nlohmann::json const& _j)
+		{
+			impl_clear();
+
+			int const serializer_version = _j["serializer_version"];
+			if (serializer_version >= 1)
+			{
+				std::vector<Entity> const entities = _j["m_entities"];
+				std::vector<TData> data = _j["m_data"];
+				for (size_t i = 0; i < entities.size() && i < data.size(); i++)
+					GetStorage().template emplace<TData>(entities[i], std::move(data[i]));
+			}
+		}
+	};
+
+}
+}
+
+#endif // !ENGINE_ECS_ARCHETYPE_COMP_MANAGER_H
@@ -0,0 +1,179 @@
+#include "archetype_storage.h"
+
+#include <cassert>
+#include <mutex>
+
+namespace Engine {
+namespace ECS {
+
+	namespace
+	{
+		size_t align_up(size_t _offset, size_t _alignment)
+		{
+			return (_offset + _alignment - 1) / _alignment * _alignment;
+		}
+	}
+
+	// Registry is shared by all storages, types register on first use from any thread.
+	static std::mutex s_type_registry_mutex;
+
+	std::vector<archetype_storage::component_type_info>& archetype_storage::type_registry()
+	{
+		static std::vector<component_type_info> registry;
+		return registry;
+	}
+
+	archetype_storage::component_type_id archetype_storage::register_type(component_type_info const& _info)
+	{
+		std::lock_guard<std::mutex> const lock(s_type_registry_mutex);
+		std::vector<component_type_info>& registry = type_registry();
+		if (registry.size() >= MAX_COMPONENT_TYPES)
+			throw std::length_error("Too many component types in archetype storage.");
+		registry.push_back(_info);
+		return (component_type_id)(registry.size() - 1);
+	}
+
+	archetype_storage::component_type_info archetype_storage::get_type_info(component_type_id _type)
+	{
+		std::lock_guard<std::mutex> const lock(s_type_registry_mutex);
+		return type_registry()[_type];
+	}
+
+	int archetype_storage::archetype::column_of(component_type_id _type) const
+	{
+		if (!m_signature.test(_type))
+			return -1;
+		return (int)(std::lower_bound(m_types.begin(), m_types.end(), _type) - m_types.begin());
+	}
+
+	size_t archetype_storage::chunk_count() const
+	{
+		size_t count = 0;
+		for (archetype const& current : m_archetypes)
+			count += current.m_chunks.size();
+		return count;
+	}
+
+	void archetype_storage::destroy(Entity _e)
+	{
+		auto const location_iter = m_entity_locations.find(_e);
+		if (location_iter == m_entity_locations.end())
+			return;
+		erase_row(location_iter->second.archetype, location_iter->second.row);
+		m_entity_locations.erase(_e);
+	}
+
+	void archetype_storage::clear()
+	{
+		for (archetype& current : m_archetypes)
+		{
+			for (size_t column = 0; column < current.m_types.size(); column++)
+				for (unsigned int row = 0; row < current.m_size; row++)
+					current.m_type_infos[column].destroy(current.component_ptr(column, row));
+			current.m_chunks.clear();
+			current.m_size = 0;
+		}
+		m_entity_locations.clear();
+	}
+
+	uint32_t archetype_storage::find_or_create_archetype(signature const& _signature)
+	{
+		auto const lookup_iter = m_archetype_lookup.find(_signature);
+		if (lookup_iter != m_archetype_lookup.end())
+			return lookup_iter->second;
+
+		archetype created;
+		created.m_signature = _signature;
+		size_t row_size = sizeof(Entity);
+		size_t alignment_padding = 0;
+		for (component_type_id type = 0; type < MAX_COMPONENT_TYPES; type++)
+		{
+			if (!_signature.test(type))
+				continue;
+			component_type_info const info = get_type_info(type);
+			created.m_types.push_back(type);
+			created.m_type_infos.push_back(info);
+			row_size += info.size;
+			alignment_padding += info.alignment - 1;
+		}
+
+		// Columns are laid out back to back, each column aligned for its type.
+		created.m_chunk_capacity = (unsigned int)((CHUNK_SIZE - alignment_padding) / row_size);
+		assert(created.m_chunk_capacity > 0);
+
+		size_t offset = sizeof(Entity) * created.m_chunk_capacity;
+		for (component_type_info const& info : created.m_type_infos)
+		{
+			offset = align_up(offset, info.alignment);
+			created.m_column_offsets.push_back(offset);
+			offset += info.size * created.m_chunk_capacity;
+		}
+		assert(offset <= CHUNK_SIZE);
+
+		uint32_t const index = (uint32_t)m_archetypes.size();
+		m_archetypes.push_back(std::move(created));
+		m_archetype_lookup.emplace(_signature, index);
+		return index;
+	}
+
+	unsigned int archetype_storage::push_row(archetype& _archetype, Entity _e)
+	{
+		unsigned int const row = _archetype.m_size;
+		if (row == _archetype.m_chunks.size() * _archetype.m_chunk_capacity)
+			_archetype.m_chunks.push_back(std::make_unique<chunk>());
+		_archetype.m_size++;
+		new (_archetype.entity_ptr(row)) Entity(_e);
+		return row;
+	}
+
+	void archetype_storage::erase_row(uint32_t _archetype, unsigned int _row)
+	{
+		archetype& current = m_archetypes[_archetype];
+		unsigned int const last_row = current.m_size - 1;
+
+		for (size_t column = 0; column < current.m_types.size(); column++)
+			current.m_type_infos[column].destroy(current.component_ptr(column, _row));
+
+		// Fill hole with last row so that rows stay dense.
+		if (_row != last_row)
+		{
+			for (size_t column = 0; column < current.m_types.size(); column++)
+			{
+				void* const last = current.component_ptr(column, last_row);
+				current.m_type_infos[column].move_construct(current.component_ptr(column, _row), last);
+				current.m_type_infos[column].destroy(last);
+			}
+			Entity const moved_entity = *current.entity_ptr(last_row);
+			*current.entity_ptr(_row) = moved_entity;
+			m_entity_locations.at(moved_entity).row = _row;
+		}
+
+		current.m_size--;
+		if (current.m_size <= (current.m_chunks.size() - 1) * current.m_chunk_capacity)
+			current.m_chunks.pop_back();
+	}
+
+	unsigned int archetype_storage::migrate(Entity _e, entity_location _from, uint32_t _to)
+	{
+		unsigned int const row = push_row(m_archetypes[_to], _e);
+		archetype& source = m_archetypes[_from.archetype];
+		archetype& target = m_archetypes[_to];
+
+		// Both type lists are ascending, so shared columns are found in a single merge pass.
+		size_t source_column = 0;
+		for (size_t target_column = 0; target_column < target.m_types.size(); target_column++)
+		{
+			component_type_id const type = target.m_types[target_column];
+			while (source_column < source.m_types.size() && source.m_types[source_column] < type)
+				source_column++;
+			if (source_column < source.m_types.size() && source.m_types[source_column] == type)
+				target.m_type_infos[target_column].move_construct(target.component_ptr(target_column, row), source.component_ptr(source_column, _from.row));
+		}
+
+		// Moved-from components are destroyed with the rest of the source row.
+		erase_row(_from.archetype, _from.row);
+		return row;
+	}
+
+}
+}
@@ -0,0 +1,300 @@
+#ifndef ENGINE_ECS_ARCHETYPE_STORAGE_H
+#define ENGINE_ECS_ARCHETYPE_STORAGE_H
+
+#include "entity.h"
+#include "sparse_set.h"
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Engine {
+namespace ECS {
+
+	/*
+	* @brief	Component storage that groups entities by the set of component types they own.
+	* @details	Every distinct set of component types (signature) is an archetype. Archetypes store their
+	*			entities in fixed-size chunks, in which every component type has its own contiguous column,
+	*			so iterating entities with several components streams linearly through every column.
+	*			Adding or removing a component moves the entity and its components to the archetype
+	*			of its new signature. Removing an entity from an archetype moves the last entity of the
+	*			archetype into its row, so rows stay dense.
+	*			Component types are identified by C++ type, so every type is stored at most once per entity.
+	*			Components must not be added or removed while iterating with each().
+	*/
+	class archetype_storage
+	{
+	public:
+
+		static size_t constexpr CHUNK_SIZE = 16 * 1024;
+		static size_t constexpr CHUNK_ALIGNMENT = 64;
+		static unsigned int constexpr MAX_COMPONENT_TYPES = 64;
+
+		typedef uint32_t component_type_id;
+		typedef std::bitset<MAX_COMPONENT_TYPES> signature;
+
+		archetype_storage() = default;
+		archetype_storage(archetype_storage const&) = delete;
+		archetype_storage& operator=(archetype_storage const&) = delete;
+		~archetype_storage() { clear(); }
+
+		// Unique ID of component type, shared by all storages.
+		template<typename T>
+		static component_type_id type_id()
+		{
+			static component_type_id const id = register_type(make_type_info<T>());
+			return id;
+		}
+
+		/*
+		* @brief	Add component constructed from arguments to entity, if entity does not own one yet.
+		* @return	T &		Component of entity.
+		*/
+		template<typename T, typename... TArgs>
+		T& emplace(Entity _e, TArgs&&... _args);
+
+		// Remove component from entity. Returns whether entity owned the component.
+		template<typename T>
+		bool remove(Entity _e);
+
+		// Remove component from every entity that owns it.
+		template<typename T>
+		void remove_all();
+
+		// Remove all components of entity.
+		void destroy(Entity _e);
+
+		template<typename T>
+		bool has(Entity _e) const;
+
+		template<typename T>
+		T* try_get(Entity _e);
+
+		template<typename T>
+		T& get(Entity _e);
+
+		// Whether entity owns any component in storage.
+		bool contains(Entity _e) const { return m_entity_locations.contains(_e); }
+
+		/*
+		* @brief	Call function for every entity that owns all given components.
+		* @param	TFunc	Callable with signature void(Entity, TComps&...)
+		* @details	Visits matching archetypes chunk by chunk, reading every column linearly.
+		*/
+		template<typename... TComps, typename TFunc>
+		void each(TFunc&& _func);
+
+		size_t entity_count() const { return m_entity_locations.size(); }
+		size_t archetype_count() const { return m_archetypes.size(); }
+		size_t chunk_count() const;
+
+		void clear();
+
+	private:
+
+		struct component_type_info
+		{
+			size_t size;
+			size_t alignment;
+			void (*move_construct)(void* _dst, void* _src);
+			void (*destroy)(void* _ptr);
+		};
+
+		struct alignas(CHUNK_ALIGNMENT) chunk
+		{
+			std::byte m_data[CHUNK_SIZE];
+		};
+
+		struct archetype
+		{
+			signature							m_signature;
+			std::vector<component_type_id>		m_types;			// Ascending
+			std::vector<component_type_info>	m_type_infos;		// Per column
+			std::vector<size_t>					m_column_offsets;	// Per column, entity column is at offset 0
+			unsigned int						m_chunk_capacity = 0;
+			std::vector<std::unique_ptr<chunk>>	m_chunks;
+			unsigned int						m_size = 0;
+
+			// Column of component type, or -1 if archetype does not store it.
+			int column_of(component_type_id _type) const;
+
+			Entity* entity_ptr(unsigned int _row) const
+			{
+				return reinterpret_cast<Entity*>(m_chunks[_row / m_chunk_capacity]->m_data) + (_row % m_chunk_capacity);
+			}
+			void* component_ptr(size_t _column, unsigned int _row) const
+			{
+				return m_chunks[_row / m_chunk_capacity]->m_data + m_column_offsets[_column] + (_row % m_chunk_capacity) * m_type_infos[_column].size;
+			}
+		};
+
+		struct entity_location
+		{
+			uint32_t archetype;
+			uint32_t row;
+		};
+
+		std::vector<archetype>						m_archetypes;
+		std::unordered_map<signature, uint32_t>		m_archetype_lookup;
+		sparse_set<entity_location>					m_entity_locations;
+
+		template<typename T>
+		static component_type_info make_type_info()
+		{
+			static_assert(sizeof(T) <= CHUNK_SIZE / 4, "Component type too large for archetype chunks.");
+			static_assert(alignof(T) <= CHUNK_ALIGNMENT, "Component type alignment exceeds chunk alignment.");
+			return component_type_info{
+				sizeof(T), alignof(T),
+				[](void* _dst, void* _src) { new (_dst) T(std::move(*static_cast<T*>(_src))); },
+				[](void* _ptr) { static_cast<T*>(_ptr)->~T(); }
+			};
+		}
+
+		static std::vector<component_type_info>& type_registry();
+		static component_type_id register_type(component_type_info const& _info);
+		static component_type_info get_type_info(component_type_id _type);
+
+		uint32_t	find_or_create_archetype(signature const& _signature);
+		unsigned int push_row(archetype& _archetype, Entity _e);
+		void		erase_row(uint32_t _archetype, unsigned int _row);
+
+		// Move entity to archetype of given signature, moving components that both archetypes store.
+		// Returns new row. Columns that only the new archetype stores are left unconstructed.
+		unsigned int migrate(Entity _e, entity_location _from, uint32_t _to);
+	};
+
+	template<typename T, typename... TArgs>
+	T& archetype_storage::emplace(Entity _e, TArgs&&... _args)
+	{
+		component_type_id const type = type_id<T>();
+		signature new_signature;
+		auto const location_iter = m_entity_locations.find(_e);
+		if (location_iter != m_entity_locations.end())
+		{
+			archetype& current = m_archetypes[location_iter->second.archetype];
+			int const column = current.column_of(type);
+			if (column >= 0)
+				return *static_cast<T*>(current.component_ptr(column, location_iter->second.row));
+			new_signature = current.m_signature;
+		}
+		new_signature.set(type);
+
+		uint32_t const target = find_or_create_archetype(new_signature);
+		unsigned int const row = (location_iter != m_entity_locations.end())
+			? migrate(_e, location_iter->second, target)
+			: push_row(m_archetypes[target], _e);
+		m_entity_locations[_e] = entity_location{ target, row };
+
+		archetype& target_archetype = m_archetypes[target];
+		return *new (target_archetype.component_ptr(target_archetype.column_of(type), row)) T(std::forward<TArgs>(_args)...);
+	}
+
+	template<typename T>
+	bool archetype_storage::remove(Entity _e)
+	{
+		component_type_id const type = type_id<T>();
+		auto const location_iter = m_entity_locations.find(_e);
+		if (location_iter == m_entity_locations.end())
+			return false;
+
+		entity_location const location = location_iter->second;
+		archetype& current = m_archetypes[location.archetype];
+		if (current.column_of(type) < 0)
+			return false;
+
+		signature new_signature = current.m_signature;
+		new_signature.reset(type);
+		if (new_signature.none())
+		{
+			erase_row(location.archetype, location.row);
+			m_entity_locations.erase(_e);
+			return true;
+		}
+
+		uint32_t const target = find_or_create_archetype(new_signature);
+		unsigned int const row = migrate(_e, location, target);
+		m_entity_locations[_e] = entity_location{ target, row };
+		return true;
+	}
+
+	template<typename T>
+	void archetype_storage::remove_all()
+	{
+		std::vector<Entity> owners;
+		each<T>([&owners](Entity _e, T&) { owners.push_back(_e); });
+		for (Entity const e : owners)
+			remove<T>(e);
+	}
+
+	template<typename T>
+	bool archetype_storage::has(Entity _e) const
+	{
+		auto const location_iter = m_entity_locations.find(_e);
+		return location_iter != m_entity_locations.end()
+			&& m_archetypes[location_iter->second.archetype].m_signature.test(type_id<T>());
+	}
+
+	template<typename T>
+	T* archetype_storage::try_get(Entity _e)
+	{
+		auto const location_iter = m_entity_locations.find(_e);
+		if (location_iter == m_entity_locations.end())
+			return nullptr;
+		archetype const& current = m_archetypes[location_iter->second.archetype];
+		int const column = current.column_of(type_id<T>());
+		return column < 0 ? nullptr : static_cast<T*>(current.component_ptr(column, location_iter->second.row));
+	}
+
+	template<typename T>
+	T& archetype_storage::get(Entity _e)
+	{
+		T* const component = try_get<T>(_e);
+		if (!component)
+			throw std::out_of_range("Entity does not own component in archetype storage.");
+		return *component;
+	}
+
+	template<typename... TComps, typename TFunc>
+	void archetype_storage::each(TFunc&& _func)
+	{
+		signature required;
+		(required.set(type_id<TComps>()), ...);
+
+		for (archetype& current : m_archetypes)
+		{
+			if ((current.m_signature & required) != required || current.m_size == 0)
+				continue;
+
+			int const columns[] = { current.column_of(type_id<TComps>())... };
+			for (size_t c = 0; c < current.m_chunks.size(); c++)
+			{
+				unsigned int const chunk_begin = (unsigned int)c * current.m_chunk_capacity;
+				unsigned int const chunk_rows = std::min(current.m_chunk_capacity, current.m_size - chunk_begin);
+				std::byte* const data = current.m_chunks[c]->m_data;
+				Entity* const entities = reinterpret_cast<Entity*>(data);
+
+				size_t column_index = 0;
+				auto column_ptr = [&](auto* _type_tag)
+				{
+					using T = std::remove_pointer_t<decltype(_type_tag)>;
+					return reinterpret_cast<T*>(data + current.m_column_offsets[columns[column_index++]]);
+				};
+				std::tuple<TComps*...> const column_ptrs{ column_ptr((TComps*)nullptr)... };
+
+				for (unsigned int r = 0; r < chunk_rows; r++)
+					std::apply([&](TComps*... _columns) { _func(entities[r], _columns[r]...); }, column_ptrs);
+			}
+		}
+	}
+
+}
+}
+#endif // !ENGINE_ECS_ARCHETYPE_STORAGE_H
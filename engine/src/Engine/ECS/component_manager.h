@@ -5,6 +5,7 @@
 #include <Engine/Utils/singleton.h>
 #include <Engine/Managers/resource_manager.h>
 #include "entity.h"
+#include "sparse_set.h"
 #include <vector>
 
 namespace Engine {
@@ -4,10 +4,13 @@
 #include <Engine/Components/Nameable.h>
 
 #include <Engine/Serialisation/compress.h>
+#include <Engine/Utils/allocation_tracker.h>
 
 #include "component_manager.h"
 
+#include <algorithm>
 #include <cassert>
+#include <stdexcept>
 
 namespace Engine {
 namespace ECS {
@@ -17,36 +20,65 @@ namespace ECS {
 	typedef unsigned long long compacted_type;
 	unsigned int const compacted_type_bits = sizeof(compacted_type) * 8;
 
+	// Format from_json decodes handles with, set by serialized_entity_format_scope.
+	static serialized_entity_format s_serialized_entity_format;
+
 	void EntityManager::Deserialize(nlohmann::json const& _j)
 	{
 		using namespace Engine::Serialisation;
+
+		m_entity_deletion_queue.clear();
+
 		int const serializer_version = _j["serializer_version"];
 		if (serializer_version == 1)
 		{
-			std::vector<bool> transformed_bit_set = _j["m_entity_in_use_flag"];
-			for (size_t i = 0; i < m_entity_in_use_flag.size(); i++)
-			{
-				m_entity_in_use_flag[i] = transformed_bit_set[i];
-			}
-			m_entity_counters = _j["m_entity_counters"];
-			m_entity_id_iter = _j["m_entity_id_iter"];
+			m_entity_in_use_flag = _j["m_entity_in_use_flag"].get<std::vector<bool>>();
+			m_entity_counters = _j["m_entity_counters"].get<std::vector<uint8_t>>();
 		}
 		if (serializer_version == 2)
 		{
 			{
+				// Version 2 packed use flags 8 per compressed element, in the lowest bits of each element.
 				auto compressed_use_flags = _j["m_entity_in_use_flag"].get<std::vector<compressed_type>>();
-				std::vector<bool> decompressed_use_flags = decompress_data_vector<bool>(compressed_use_flags, m_entity_in_use_flag.size());
+				m_entity_in_use_flag.assign(compressed_use_flags.size() * 8, false);
 				for (size_t i = 0; i < m_entity_in_use_flag.size(); i++)
-					m_entity_in_use_flag[i] = decompressed_use_flags[i];
+					m_entity_in_use_flag[i] = get_compressed_type_entry(compressed_use_flags[i / 8], i % 8, 1) != 0;
 			}
 			{
 				auto compressed_counters = _j["m_entity_counters"].get<std::vector<compressed_type>>();
-				auto decompressed_counters = decompress_data_vector<decltype(m_entity_counters)::value_type>(compressed_counters, m_entity_counters.size());
-				for (size_t i = 0; i < m_entity_counters.size(); i++)
-					m_entity_counters[i] = decompressed_counters[i];
+				m_entity_counters = decompress_data_vector<uint8_t>(compressed_counters);
 			}
+		}
+		if (serializer_version == 1 || serializer_version == 2)
+		{
+			// Legacy managers stored counters of all 16K IDs.
+			size_t const legacy_entity_count = (1u << entity_handle_layout<LEGACY_ENTITY_HANDLE_BITS>::ID_BITS) - 1;
+			m_entity_in_use_flag.resize(legacy_entity_count, false);
+			m_entity_counters.resize(legacy_entity_count, 0);
+
+			// Counters of saved handles wrapped at legacy counter width, so stored counters have to match them.
+			uint8_t const legacy_counter_mask = (1u << entity_handle_layout<LEGACY_ENTITY_HANDLE_BITS>::COUNTER_BITS) - 1;
+			for (uint8_t& counter : m_entity_counters)
+				counter &= legacy_counter_mask;
+		}
+		if (serializer_version == 3)
+		{
+			size_t const slot_count = _j["slot_count"];
+			if (slot_count > MAX_ENTITIES)
+				throw std::runtime_error("[EntityManager] Scene has more entities than entity handles can address.");
+
+			auto compressed_use_flags = _j["m_entity_in_use_flag"].get<std::vector<compressed_type>>();
+			m_entity_in_use_flag = decompress_data_vector<bool>(compressed_use_flags, (unsigned int)slot_count);
+			auto compressed_counters = _j["m_entity_counters"].get<std::vector<compressed_type>>();
+			m_entity_counters = decompress_data_vector<uint8_t>(compressed_counters, (unsigned int)slot_count);
+		}
 
-			m_entity_id_iter = _j["m_entity_id_iter"];
+		m_entity_queued_flag.assign(m_entity_in_use_flag.size(), false);
+		m_free_entity_ids.clear();
+		for (unsigned int i = 0; i < m_entity_in_use_flag.size(); i++)
+		{
+			if (!m_entity_in_use_flag[i])
+				m_free_entity_ids.push_back(i);
 		}
 	}
 
@@ -54,29 +86,11 @@ namespace ECS {
 	{
 		using namespace Engine::Serialisation;
 
-		_j["serializer_version"] = 2;
-
-		//// nlohmann::json does not have a way to
-		//// serialize bitsets directly. Must transform it
-		//// to a vector of bools first.
-		//std::vector<bool> transformed_bitset(m_entity_in_use_flag.size(), false);
-		//for (size_t i = 0; i < m_entity_in_use_flag.size(); i++)
-		//	transformed_bitset[i] = m_entity_in_use_flag[i];
-
-		{
-			std::vector<bool> decompressed_use_flags(m_entity_in_use_flag.size(), false);
-			for (size_t i = 0; i < m_entity_in_use_flag.size(); i++)
-				decompressed_use_flags[i] = m_entity_in_use_flag[i];
-			_j["m_entity_in_use_flag"] = compress_data_vector(decompressed_use_flags);
-		}
-		{
-			std::vector<decltype(m_entity_counters)::value_type> decompressed_counters(m_entity_counters.size(), 0);
-			for (size_t i = 0; i < m_entity_counters.size(); i++)
-				decompressed_counters[i] = m_entity_counters[i];
-			_j["m_entity_counters"] = compress_data_vector(decompressed_counters);
-		}
-
-		_j["m_entity_id_iter"] = m_entity_id_iter;
+		_j["serializer_version"] = 3;
+		_j["entity_handle_bits"] = ENGINE_ENTITY_HANDLE_BITS;
+		_j["slot_count"] = m_entity_in_use_flag.size();
+		_j["m_entity_in_use_flag"] = compress_data_vector(m_entity_in_use_flag);
+		_j["m_entity_counters"] = compress_data_vector(m_entity_counters);
 	}
 
 	/*
@@ -85,18 +99,22 @@ namespace ECS {
 	*/
 	void EntityManager::Reset()
 	{
-		for (unsigned int i = 0; i < MAX_ENTITIES; ++i)
+		for (unsigned int i = 0; i < m_entity_in_use_flag.size(); ++i)
 		{
+			if (!m_entity_in_use_flag[i] || m_entity_queued_flag[i])
+				continue;
 			Entity new_entity;
 			new_entity.m_id = i;
-			m_entity_deletion_queue.insert(new_entity);
+			new_entity.m_counter = m_entity_counters[i];
+			m_entity_deletion_queue.push_back(new_entity);
 		}
 		FreeQueuedEntities();
 
-		m_entity_in_use_flag.reset();
-		memset(&m_entity_counters.front(), 0, sizeof(m_entity_counters));
+		m_entity_in_use_flag.clear();
+		m_entity_queued_flag.clear();
+		m_entity_counters.clear();
+		m_free_entity_ids.clear();
 		m_entity_deletion_queue.clear();
-		m_entity_id_iter = 0;
 	}
 
 	/*
@@ -120,41 +138,40 @@ namespace ECS {
 	*/
 	bool EntityManager::EntityCreationRequest(Entity* _out_handles, unsigned int _request_count)
 	{
+		ENGINE_ALLOCATION_SCOPE(eECS);
+
 		if (_request_count == 0)
 			return true;
 
 		assert(_out_handles);
 
-		unsigned int* temp_handle_idx_arr = (unsigned int*)_malloca(sizeof(unsigned int) * _request_count);
-		unsigned int handles_found = 0;
-
-		unsigned int i = m_entity_id_iter;
-		do
-		{
-			if (!m_entity_in_use_flag.test(i))
-			{
-				temp_handle_idx_arr[handles_found] = i;
-				handles_found++;
-			}
-			i = (++i % MAX_ENTITIES);
-		} while (handles_found != _request_count && i != m_entity_id_iter);
-		m_entity_id_iter = i + 1;
+		if (_request_count > MAX_ENTITIES - EntityCount())
+			return false;
 
-		bool found_requested_handles = (handles_found == _request_count);
-		if (found_requested_handles)
+		auto create_handle = [this](unsigned int _id)
 		{
-			for (unsigned int i = 0; i < _request_count; i++)
-			{
-				Entity new_handle;
-				new_handle.m_id = temp_handle_idx_arr[i];
-				new_handle.m_counter = m_entity_counters[temp_handle_idx_arr[i]];
-				m_entity_in_use_flag.set(temp_handle_idx_arr[i], true);
-				_out_handles[i] = new_handle;
-			}
-		}
-
-		_freea(temp_handle_idx_arr);
-		return found_requested_handles;
+			m_entity_in_use_flag[_id] = true;
+			Entity new_handle;
+			new_handle.m_id = _id;
+			new_handle.m_counter = m_entity_counters[_id];
+			return new_handle;
+		};
+
+		// Reuse free IDs below the high-water mark first, then grow storage for the remaining IDs.
+		unsigned int const reused_count = std::min(_request_count, (unsigned int)m_free_entity_ids.size());
+		for (unsigned int i = 0; i < reused_count; i++)
+			_out_handles[i] = create_handle(m_free_entity_ids[i]);
+		m_free_entity_ids.erase(m_free_entity_ids.begin(), m_free_entity_ids.begin() + reused_count);
+
+		unsigned int const slot_count = (unsigned int)m_entity_in_use_flag.size();
+		unsigned int const grow_count = _request_count - reused_count;
+		m_entity_in_use_flag.resize(slot_count + grow_count, false);
+		m_entity_queued_flag.resize(slot_count + grow_count, false);
+		m_entity_counters.resize(slot_count + grow_count, 0);
+		for (unsigned int i = 0; i < grow_count; i++)
+			_out_handles[reused_count + i] = create_handle(slot_count + i);
+
+		return true;
 	}
 
 	/*
@@ -174,17 +191,17 @@ namespace ECS {
 	void EntityManager::EntityDelayedDeletion(Entity* _entities, unsigned int _entity_count)
 	{
 		assert(_entities);
-		std::vector<Entity> existing_entities;
-		existing_entities.reserve(_entity_count);
+		m_entity_deletion_queue.reserve(m_entity_deletion_queue.size() + _entity_count);
 		for (unsigned int i = 0; i < _entity_count; ++i)
 		{
-			// Check if entity exists before adding it to deletion queue.
-			if(DoesEntityExist(_entities[i]))
-				existing_entities.push_back(_entities[i]);
+			// Entity does not exist anymore once it is queued, and stale handles fail the counter check,
+			// so every live ID is added to the queue at most once.
+			if (DoesEntityExist(_entities[i]))
+			{
+				m_entity_queued_flag[_entities[i].ID()] = true;
+				m_entity_deletion_queue.push_back(_entities[i]);
+			}
 		}
-		// Add into delayed deletion container.
-		// (Containers makes sure only unique handles are added).
-		m_entity_deletion_queue.insert(existing_entities.begin(), existing_entities.end());
 	}
 
 	/*
@@ -194,7 +211,10 @@ namespace ECS {
 	*/
 	bool EntityManager::DoesEntityExist(Entity _entity) const
 	{
-		return m_entity_in_use_flag.test(_entity.m_id) && (m_entity_deletion_queue.find(_entity) == m_entity_deletion_queue.end());
+		return _entity.ID() < m_entity_in_use_flag.size()
+			&& m_entity_in_use_flag[_entity.ID()]
+			&& Entity::data_type(m_entity_counters[_entity.ID()]) == _entity.Counter()
+			&& !m_entity_queued_flag[_entity.ID()];
 	}
 
 	/*
@@ -204,26 +224,31 @@ namespace ECS {
 	*/
 	std::vector<Entity> const EntityManager::FreeQueuedEntities()
 	{
-		// Store entities queued for deletion in list
+		ENGINE_ALLOCATION_SCOPE(eECS);
+
+		// Take list of entities queued for deletion. Entities queued while component managers
+		// handle the destruction message are freed in the next call.
 		std::vector<Entity> deleted_entities;
-		if (!m_entity_deletion_queue.empty())
+		deleted_entities.swap(m_entity_deletion_queue);
+		if (!deleted_entities.empty())
 		{
-
-			deleted_entities.reserve(m_entity_deletion_queue.size());
-			deleted_entities.insert(deleted_entities.begin(), m_entity_deletion_queue.begin(), m_entity_deletion_queue.end());
+			// Sorted by ID, so that managers visit their sparse entity indices in order.
+			std::sort(deleted_entities.begin(), deleted_entities.end());
 
 			// Pass destroyed entities as message to registered component managers
 			for (auto component_manager : m_registered_component_managers)
 				component_manager->receive_entity_destruction_message(deleted_entities);
 
-			// Delete internal list of entities queued for destruction, and mark respective entities as unused.
-			m_entity_deletion_queue.clear();
+			// Mark respective entities as unused, and make their IDs available again.
 			for (unsigned int i = 0; i < deleted_entities.size(); ++i)
 			{
-				m_entity_counters[deleted_entities[i].ID()]++;
-				m_entity_in_use_flag.reset(deleted_entities[i].ID());
+				unsigned int const id = deleted_entities[i].ID();
+				// Counter wraps at counter width of handles, so that it keeps matching handles of its ID.
+				m_entity_counters[id] = (m_entity_counters[id] + 1) & ((1u << Entity::COUNTER_BITS) - 1);
+				m_entity_in_use_flag[id] = false;
+				m_entity_queued_flag[id] = false;
+				m_free_entity_ids.push_back(id);
 			}
-
 		}
 		return deleted_entities;
 	}
@@ -258,9 +283,46 @@ namespace ECS {
 		nameable_comp.SetName(_name);
 	}
 
+	serialized_entity_format get_serialized_entity_format(nlohmann::json const& _entity_manager_j)
+	{
+		serialized_entity_format format;
+		int const serializer_version = _entity_manager_j["serializer_version"];
+		if (serializer_version == 1 || serializer_version == 2)
+		{
+			format.m_handle_bits = LEGACY_ENTITY_HANDLE_BITS;
+			format.m_legacy_handles = true;
+		}
+		if (serializer_version == 3)
+			format.m_handle_bits = _entity_manager_j["entity_handle_bits"].get<unsigned int>();
+
+		if (format.m_handle_bits != 16 && format.m_handle_bits != 32)
+			throw std::runtime_error("[EntityManager] Scene uses an unsupported entity handle width.");
+		return format;
+	}
+
+	Entity deserialize_entity(nlohmann::json const& _j, serialized_entity_format _format)
+	{
+		Entity entity;
+		entity.m_data = convert_serialized_entity_handle<ENGINE_ENTITY_HANDLE_BITS>(
+			_j.get<uint64_t>(), _format.m_handle_bits, _format.m_legacy_handles
+		);
+		return entity;
+	}
+
+	serialized_entity_format_scope::serialized_entity_format_scope(serialized_entity_format _format) :
+		m_previous_format(s_serialized_entity_format)
+	{
+		s_serialized_entity_format = _format;
+	}
+
+	serialized_entity_format_scope::~serialized_entity_format_scope()
+	{
+		s_serialized_entity_format = m_previous_format;
+	}
+
 	void from_json(nlohmann::json const& j, Entity& t)
 	{
-		t.m_data = j.get<uint16_t>();
+		t = deserialize_entity(j, s_serialized_entity_format);
 	}
 
 	void to_json(nlohmann::json & j, Entity const & t)
@@ -4,6 +4,7 @@
 #include <numeric>
 #include <bitset>
 #include <cstdint>
+#include <deque>
 #include <unordered_set>
 #include <vector>
 
@@ -14,15 +15,84 @@ namespace ECS {
 
 	class ICompManager;
 
+#ifndef ENGINE_ENTITY_HANDLE_BITS
+#define ENGINE_ENTITY_HANDLE_BITS 32
+#endif
+
+	/*
+	* @brief	Bit layout of entity handles of given total width.
+	* @details	Handles pack the ID of an entity with a counter of how many times its ID has been reused.
+	*			ID bits bound the number of live entities, counter bits bound how many reuses of an ID
+	*			it takes before a stale handle compares equal to a live one again.
+	*/
+	template<unsigned int TBits>
+	struct entity_handle_layout;
+
+	template<>
+	struct entity_handle_layout<16>
+	{
+		typedef uint16_t data_type;
+		static unsigned int constexpr ID_BITS = 14;
+		static unsigned int constexpr COUNTER_BITS = 2;
+	};
+
+	template<>
+	struct entity_handle_layout<32>
+	{
+		typedef uint32_t data_type;
+		static unsigned int constexpr ID_BITS = 24;
+		static unsigned int constexpr COUNTER_BITS = 8;
+	};
+
+	typedef entity_handle_layout<ENGINE_ENTITY_HANDLE_BITS> entity_layout;
+
+	// Scenes saved before entity serializer version 3 used 16-bit handles.
+	static unsigned int constexpr LEGACY_ENTITY_HANDLE_BITS = 16;
+
+	/*
+	* @brief	Convert saved handle data to the handle layout of given width.
+	* @param	uint64_t		Saved handle data.
+	* @param	unsigned int	Handle width of the saved scene.
+	* @param	bool			Whether the scene predates serializer version 3. Its default handles
+	*							had all ID bits set, but were not shifted past the counter.
+	* @returns	Handle data in target layout. IDs the target layout cannot address become invalid.
+	*/
+	template<unsigned int TTargetBits>
+	typename entity_handle_layout<TTargetBits>::data_type convert_serialized_entity_handle(
+		uint64_t _data, unsigned int _saved_bits, bool _legacy_handles
+	)
+	{
+		using target_layout = entity_handle_layout<TTargetBits>;
+		using data_type = typename target_layout::data_type;
+		data_type const target_invalid = data_type(((1u << target_layout::ID_BITS) - 1) << target_layout::COUNTER_BITS);
+
+		unsigned int const id_bits = _saved_bits == 16 ? entity_handle_layout<16>::ID_BITS : entity_handle_layout<32>::ID_BITS;
+		unsigned int const counter_bits = _saved_bits == 16 ? entity_handle_layout<16>::COUNTER_BITS : entity_handle_layout<32>::COUNTER_BITS;
+		uint64_t const saved_invalid_id = (1u << id_bits) - 1;
+		if (_legacy_handles && _data == saved_invalid_id)
+			return target_invalid;
+		if (!_legacy_handles && _saved_bits == TTargetBits)
+			return (data_type)_data;
+
+		uint64_t const id = _data >> counter_bits;
+		uint64_t const counter = _data & ((1u << counter_bits) - 1);
+		if (id == saved_invalid_id || id >= (1u << target_layout::ID_BITS) - 1)
+			return target_invalid;
+		// Counters wrap at the narrower width, stored entity counters are masked the same way on load.
+		return data_type((id << target_layout::COUNTER_BITS) | (counter & ((1u << target_layout::COUNTER_BITS) - 1)));
+	}
+
 	struct Entity
 	{
-		static unsigned int const ID_BITS = 14;
-		static unsigned int const COUNTER_BITS = 2;
-		static unsigned int const INVALID_ID = (1 << ID_BITS) - 1;
+		typedef entity_layout::data_type data_type;
+
+		static unsigned int constexpr ID_BITS = entity_layout::ID_BITS;
+		static unsigned int constexpr COUNTER_BITS = entity_layout::COUNTER_BITS;
+		static unsigned int constexpr INVALID_ID = (1u << ID_BITS) - 1;
 
 		union
 		{
-			uint16_t m_data = INVALID_ID;
+			data_type m_data = data_type(INVALID_ID) << COUNTER_BITS;
 			static_assert(COUNTER_BITS + ID_BITS == sizeof(m_data) * 8, "Invalid bit size for entity handle.");
 			struct
 			{
@@ -34,7 +104,7 @@ namespace ECS {
 		struct hash
 		{
 			std::size_t operator()(Entity _handle) const {
-				return std::hash<uint16_t>()(_handle.ID());
+				return std::hash<data_type>()(_handle.ID());
 			}
 		};
 
@@ -45,8 +115,8 @@ namespace ECS {
 		Entity& operator=(Entity const& _other) = default;
 		Entity& operator=(Entity&& _other) noexcept = default;
 
-		uint16_t	ID() const { return m_id; }
-		uint16_t	Counter() const { return m_counter; }
+		data_type	ID() const { return m_id; }
+		data_type	Counter() const { return m_counter; }
 		void		DestroyEndOfFrame();
 		bool		Alive() const;
 		const char* GetName() const;
@@ -80,14 +150,21 @@ namespace ECS {
 
 	private:
 
-		// Stores whether an entity ID is currently in use (ID == index in bitset)
-		std::bitset<MAX_ENTITIES>			m_entity_in_use_flag;
-		// Stores Counter of how many times an ID has been used (ID == index in array)
-		std::array<uint8_t, MAX_ENTITIES>	m_entity_counters;
+		static_assert(Entity::COUNTER_BITS <= 8, "Entity counters are stored in bytes.");
 
-		unsigned int				m_entity_id_iter = 0;
+		// Storage grows up to highest ID that has been in use, rather than reserving every possible ID.
+		// Stores whether an entity ID is currently in use (ID == index)
+		std::vector<bool>			m_entity_in_use_flag;
+		// Stores whether an entity ID is queued for deletion (ID == index)
+		std::vector<bool>			m_entity_queued_flag;
+		// Stores Counter of how many times an ID has been used (ID == index)
+		std::vector<uint8_t>		m_entity_counters;
 
-		std::unordered_set<Entity, Entity::hash>	m_entity_deletion_queue;
+		// Unused IDs below the high-water mark, reused oldest first so that counters of
+		// a single ID wrap around as late as possible.
+		std::deque<unsigned int>	m_free_entity_ids;
+
+		std::vector<Entity>			m_entity_deletion_queue;
 
 		std::unordered_multiset<ICompManager*, std::hash<ICompManager*>> m_registered_component_managers;
 
@@ -105,9 +182,50 @@ namespace ECS {
 
 		std::vector<Entity> const FreeQueuedEntities();
 
+		unsigned int	EntityCount() const { return (unsigned int)(m_entity_in_use_flag.size() - m_free_entity_ids.size()); }
+
 		void RegisterComponentManager(ICompManager* _component_manager);
 	};
 
+	/*
+	* @brief	Handle layout entities of a saved scene were serialized with.
+	* @details	Handles of narrower or wider layouts, and all handles of scenes saved before serializer
+	*			version 3, are converted to the current layout on load.
+	*/
+	struct serialized_entity_format
+	{
+		unsigned int	m_handle_bits = ENGINE_ENTITY_HANDLE_BITS;
+		bool			m_legacy_handles = false;
+	};
+
+	/*
+	* @brief	Read the handle format of a scene from its EntityManager data.
+	* @param	nlohmann::json const&	Data written by EntityManager::Serialize.
+	*/
+	serialized_entity_format get_serialized_entity_format(nlohmann::json const& _entity_manager_j);
+
+	/*
+	* @brief	Decode a saved entity handle of given format to the current handle layout.
+	*/
+	Entity deserialize_entity(nlohmann::json const& _j, serialized_entity_format _format);
+
+	/*
+	* @brief	Sets the format from_json decodes entity handles with while the scope is alive.
+	* @details	The previous format is restored on exit, also when loading a scene throws.
+	*/
+	class serialized_entity_format_scope
+	{
+	public:
+		explicit serialized_entity_format_scope(serialized_entity_format _format);
+		~serialized_entity_format_scope();
+
+		serialized_entity_format_scope(serialized_entity_format_scope const&) = delete;
+		serialized_entity_format_scope& operator=(serialized_entity_format_scope const&) = delete;
+
+	private:
+		serialized_entity_format m_previous_format;
+	};
+
 	void from_json(nlohmann::json const& j, Entity& t);
 	void to_json(nlohmann::json& j, Entity const& t);
 
@@ -0,0 +1,189 @@
+#ifndef ENGINE_ECS_SPARSE_SET_H
+#define ENGINE_ECS_SPARSE_SET_H
+
+#include "entity.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace Engine {
+namespace ECS {
+
+	/*
+	* @brief	Map from entities to values, stored as a sparse set.
+	* @details	Values are packed in a dense array of (entity, value) pairs, so iteration is contiguous.
+	*			A sparse array indexed by entity ID stores the dense index of every entity.
+	*			Lookups read the sparse array and the dense entry, whose entity has to match the
+	*			looked up entity including its counter. Stale handles of a reused ID are not found.
+	*			Erasing moves the back entry into the hole, so erasing invalidates iterators and
+	*			references to the back entry. Inserting may invalidate all iterators and references.
+	*			Version changes whenever entries are inserted, erased or moved, so dense indices
+	*			remain valid for as long as the version is unchanged.
+	*			Interface mirrors the subset of std::unordered_map used by component managers.
+	*/
+	template<typename TValue>
+	class sparse_set
+	{
+	public:
+
+		typedef Entity							key_type;
+		typedef TValue							mapped_type;
+		typedef std::pair<Entity, TValue>		value_type;
+		typedef std::vector<value_type>			dense_container;
+		typedef typename dense_container::iterator			iterator;
+		typedef typename dense_container::const_iterator	const_iterator;
+
+		static uint32_t constexpr INVALID_INDEX = ~0u;
+
+		iterator		begin() { return m_dense.begin(); }
+		iterator		end() { return m_dense.end(); }
+		const_iterator	begin() const { return m_dense.begin(); }
+		const_iterator	end() const { return m_dense.end(); }
+
+		size_t	size() const { return m_dense.size(); }
+		bool	empty() const { return m_dense.empty(); }
+
+		void clear()
+		{
+			m_sparse.clear();
+			m_dense.clear();
+			bump_version();
+		}
+
+		void reserve(size_t _count) { m_dense.reserve(_count); }
+
+		uint64_t version() const { return m_version; }
+
+		// Dense index of entity, or INVALID_INDEX if entity is not in set.
+		uint32_t index_of(Entity _e) const
+		{
+			if (_e.ID() >= m_sparse.size())
+				return INVALID_INDEX;
+			uint32_t const dense_index = m_sparse[_e.ID()];
+			return (dense_index != INVALID_INDEX && m_dense[dense_index].first == _e) ? dense_index : INVALID_INDEX;
+		}
+
+		bool	contains(Entity _e) const { return index_of(_e) != INVALID_INDEX; }
+		size_t	count(Entity _e) const { return contains(_e) ? 1 : 0; }
+
+		iterator find(Entity _e)
+		{
+			uint32_t const dense_index = index_of(_e);
+			return dense_index == INVALID_INDEX ? end() : begin() + dense_index;
+		}
+		const_iterator find(Entity _e) const
+		{
+			uint32_t const dense_index = index_of(_e);
+			return dense_index == INVALID_INDEX ? end() : begin() + dense_index;
+		}
+
+		TValue& at(Entity _e)
+		{
+			uint32_t const dense_index = index_of(_e);
+			if (dense_index == INVALID_INDEX)
+				throw std::out_of_range("Entity not in sparse set.");
+			return m_dense[dense_index].second;
+		}
+		TValue const& at(Entity _e) const
+		{
+			uint32_t const dense_index = index_of(_e);
+			if (dense_index == INVALID_INDEX)
+				throw std::out_of_range("Entity not in sparse set.");
+			return m_dense[dense_index].second;
+		}
+
+		TValue& operator[](Entity _e)
+		{
+			return emplace(_e).first->second;
+		}
+
+		/*
+		* @brief	Insert value constructed from arguments, if entity is not in set yet.
+		* @return	std::pair<iterator, bool>	Entry of entity, and whether it was inserted.
+		*/
+		template<typename... TArgs>
+		std::pair<iterator, bool> emplace(Entity _e, TArgs&&... _args)
+		{
+			uint32_t const existing_index = index_of(_e);
+			if (existing_index != INVALID_INDEX)
+				return { begin() + existing_index, false };
+
+			if (_e.ID() >= m_sparse.size())
+				m_sparse.resize(size_t(_e.ID()) + 1, INVALID_INDEX);
+			// Another handle with the same ID should have been erased before its ID was reused.
+			assert(m_sparse[_e.ID()] == INVALID_INDEX);
+
+			m_sparse[_e.ID()] = (uint32_t)m_dense.size();
+			m_dense.emplace_back(std::piecewise_construct, std::forward_as_tuple(_e), std::forward_as_tuple(std::forward<TArgs>(_args)...));
+			bump_version();
+			return { end() - 1, true };
+		}
+
+		std::pair<iterator, bool> insert(value_type const& _value)
+		{
+			return emplace(_value.first, _value.second);
+		}
+
+		// Erase entity by moving back entry into its place. Returns number of erased entries.
+		size_t erase(Entity _e)
+		{
+			uint32_t const dense_index = index_of(_e);
+			if (dense_index == INVALID_INDEX)
+				return 0;
+
+			if (dense_index != m_dense.size() - 1)
+			{
+				m_dense[dense_index] = std::move(m_dense.back());
+				m_sparse[m_dense[dense_index].first.ID()] = dense_index;
+			}
+			m_dense.pop_back();
+			m_sparse[_e.ID()] = INVALID_INDEX;
+			bump_version();
+			return 1;
+		}
+
+		iterator erase(const_iterator _iter)
+		{
+			size_t const dense_index = _iter - m_dense.cbegin();
+			erase(_iter->first);
+			return begin() + dense_index;
+		}
+
+	private:
+
+		std::vector<uint32_t>	m_sparse;
+		dense_container			m_dense;
+		uint64_t				m_version = 0;
+
+		// Versions are unique across all sets of this type, so assigning another set changes the version too.
+		static inline std::atomic<uint64_t> s_version_counter = 0;
+
+		void bump_version() { m_version = ++s_version_counter; }
+	};
+
+	// Serialized as array of [entity, value] pairs, same as std::unordered_map<Entity, TValue>.
+	template<typename TValue>
+	void to_json(nlohmann::json& _j, sparse_set<TValue> const& _set)
+	{
+		_j = nlohmann::json::array();
+		for (auto const& [entity, value] : _set)
+			_j.push_back(nlohmann::json::array({ entity, value }));
+	}
+
+	template<typename TValue>
+	void from_json(nlohmann::json const& _j, sparse_set<TValue>& _set)
+	{
+		_set.clear();
+		_set.reserve(_j.size());
+		for (auto const& pair : _j)
+			_set.emplace(pair.at(0).get<Entity>(), pair.at(1).get<TValue>());
+	}
+
+}
+}
+#endif // !ENGINE_ECS_SPARSE_SET_H
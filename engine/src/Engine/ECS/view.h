@@ -0,0 +1,177 @@
+#ifndef ENGINE_ECS_VIEW_H
+#define ENGINE_ECS_VIEW_H
+
+#include "component_manager.h"
+
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Engine {
+namespace ECS {
+
+	// Sparse set in which manager of component stores its per-entity data.
+	// Managers take part in views by exposing it through GetComponentStorage().
+	template<typename TComp>
+	using component_storage_t = std::remove_reference_t<decltype(TComp::GetManager().GetComponentStorage())>;
+
+	template<typename TComp>
+	using component_data_t = typename component_storage_t<TComp>::mapped_type;
+
+	/*
+	* @brief	Join over entities that own all given components.
+	* @details	Iterates the smallest component storage, and checks membership of every entity in
+	*			the other storages, which is two array reads per storage. Callback receives the
+	*			entity and direct references to the per-entity data of every component manager.
+	*			Component handles can be constructed from the entity without any lookup.
+	*			Components of viewed types must not be created or destroyed during iteration.
+	*/
+	template<typename... TComps>
+	class View
+	{
+		static_assert(sizeof...(TComps) > 0, "View requires at least one component type.");
+
+	public:
+
+		static constexpr size_t COMPONENT_COUNT = sizeof...(TComps);
+
+		View() : m_storages(&TComps::GetManager().GetComponentStorage()...) {}
+
+		/*
+		* @brief	Call function for every entity that owns all components.
+		* @param	TFunc	Callable with signature void(Entity, component_data_t<TComps>&...)
+		*/
+		template<typename TFunc>
+		void each(TFunc&& _func) const
+		{
+			auto invoke = [this, &_func](Entity _e, row_indices const& _indices)
+			{
+				invoke_row(_func, _e, _indices, std::index_sequence_for<TComps...>{});
+			};
+			dispatch_driver(smallest_storage(), invoke, std::index_sequence_for<TComps...>{});
+		}
+
+		// Upper bound on number of entities in view, which is size of smallest storage.
+		size_t size_hint() const
+		{
+			return size_of_storages(std::index_sequence_for<TComps...>{})[smallest_storage()];
+		}
+
+	protected:
+
+		typedef std::array<uint32_t, sizeof...(TComps)> row_indices;
+
+		std::tuple<component_storage_t<TComps>*...> m_storages;
+
+		size_t smallest_storage() const
+		{
+			auto const sizes = size_of_storages(std::index_sequence_for<TComps...>{});
+			return std::min_element(sizes.begin(), sizes.end()) - sizes.begin();
+		}
+
+		template<size_t... Is>
+		std::array<size_t, sizeof...(TComps)> size_of_storages(std::index_sequence<Is...>) const
+		{
+			return { std::get<Is>(m_storages)->size()... };
+		}
+
+		// Iterate storage at driver index, and call function with entity and its dense index in every storage.
+		template<typename TRowFunc, size_t... Is>
+		void dispatch_driver(size_t _driver, TRowFunc& _row_func, std::index_sequence<Is...> _seq) const
+		{
+			((Is == _driver ? each_row<Is>(_row_func, _seq) : void()), ...);
+		}
+
+		template<size_t TDriver, typename TRowFunc, size_t... Is>
+		void each_row(TRowFunc& _func, std::index_sequence<Is...>) const
+		{
+			auto const& driver_storage = *std::get<TDriver>(m_storages);
+			for (uint32_t d = 0; d < (uint32_t)driver_storage.size(); d++)
+			{
+				Entity const e = driver_storage.begin()[d].first;
+				row_indices const indices{ (Is == TDriver ? d : std::get<Is>(m_storages)->index_of(e))... };
+				if (((indices[Is] == component_storage_t<TComps>::INVALID_INDEX) || ...))
+					continue;
+				_func(e, indices);
+			}
+		}
+
+		template<typename TFunc, size_t... Is>
+		void invoke_row(TFunc& _func, Entity _e, row_indices const& _indices, std::index_sequence<Is...>) const
+		{
+			_func(_e, std::get<Is>(m_storages)->begin()[_indices[Is]].second...);
+		}
+	};
+
+	/*
+	* @brief	View that caches matching entities and their dense indices between iterations.
+	* @details	Cache is rebuilt when any of the viewed storages has changed since the last iteration,
+	*			so stable queries only pay for the join once.
+	*/
+	template<typename... TComps>
+	class CachedView : public View<TComps...>
+	{
+		using base = View<TComps...>;
+		using typename base::row_indices;
+
+	public:
+
+		template<typename TFunc>
+		void each(TFunc&& _func)
+		{
+			refresh();
+			for (size_t r = 0; r < m_entities.size(); r++)
+				this->invoke_row(_func, m_entities[r], m_rows[r], std::index_sequence_for<TComps...>{});
+		}
+
+		size_t size()
+		{
+			refresh();
+			return m_entities.size();
+		}
+
+		std::vector<Entity> const& entities()
+		{
+			refresh();
+			return m_entities;
+		}
+
+	private:
+
+		std::vector<Entity>			m_entities;
+		std::vector<row_indices>	m_rows;
+		std::array<uint64_t, sizeof...(TComps)> m_storage_versions{};
+		bool m_built = false;
+
+		template<size_t... Is>
+		std::array<uint64_t, sizeof...(TComps)> storage_versions(std::index_sequence<Is...>) const
+		{
+			return { std::get<Is>(this->m_storages)->version()... };
+		}
+
+		void refresh()
+		{
+			auto const versions = storage_versions(std::index_sequence_for<TComps...>{});
+			if (m_built && versions == m_storage_versions)
+				return;
+
+			m_entities.clear();
+			m_rows.clear();
+			auto collect = [this](Entity _e, row_indices const& _indices)
+			{
+				m_entities.push_back(_e);
+				m_rows.push_back(_indices);
+			};
+			this->dispatch_driver(this->smallest_storage(), collect, std::index_sequence_for<TComps...>{});
+
+			m_storage_versions = versions;
+			m_built = true;
+		}
+	};
+
+}
+}
+#endif // !ENGINE_ECS_VIEW_H
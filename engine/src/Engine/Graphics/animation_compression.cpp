@@ -0,0 +1,311 @@
+#include "animation_compression.h"
+#include "manager.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <unordered_set>
+
+namespace Engine {
+namespace Graphics {
+
+	static float constexpr SQRT_2 = 1.41421356f;
+	static float constexpr ROTATION_COMPONENT_MAX = (float)0x7FFF;
+	static float constexpr VECTOR_COMPONENT_MAX = (float)0xFFFF;
+
+	quantized_rotation quantize_rotation(glm::quat _rotation)
+	{
+		glm::quat const q = glm::normalize(_rotation);
+		float const components[4] = { q.x, q.y, q.z, q.w };
+
+		unsigned int largest = 0;
+		for (unsigned int i = 1; i < 4; i++)
+			if (std::abs(components[i]) > std::abs(components[largest]))
+				largest = i;
+		// q and -q are the same rotation, so largest component can be made positive and left out.
+		float const sign = components[largest] < 0.0f ? -1.0f : 1.0f;
+
+		quantized_rotation result;
+		unsigned int out = 0;
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			if (i == largest)
+				continue;
+			// Smallest components are within [-1/sqrt(2), 1/sqrt(2)].
+			float const normalized = std::clamp(components[i] * sign * SQRT_2, -1.0f, 1.0f);
+			result.m_bits[out++] = (uint16_t)std::lround((normalized * 0.5f + 0.5f) * ROTATION_COMPONENT_MAX);
+		}
+		result.m_bits[0] |= (uint16_t)((largest & 1) << 15);
+		result.m_bits[1] |= (uint16_t)((largest >> 1) << 15);
+		return result;
+	}
+
+	glm::quat dequantize_rotation(quantized_rotation _rotation)
+	{
+		unsigned int const largest = (_rotation.m_bits[0] >> 15) | ((_rotation.m_bits[1] >> 15) << 1);
+
+		float components[4];
+		float length_squared = 0.0f;
+		unsigned int in = 0;
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			if (i == largest)
+				continue;
+			float const normalized = (float)(_rotation.m_bits[in++] & 0x7FFF) / ROTATION_COMPONENT_MAX * 2.0f - 1.0f;
+			components[i] = normalized / SQRT_2;
+			length_squared += components[i] * components[i];
+		}
+		components[largest] = std::sqrt(std::max(0.0f, 1.0f - length_squared));
+		return glm::quat(components[3], components[0], components[1], components[2]);
+	}
+
+	quantized_vector quantize_vector(glm::vec3 _vector, glm::vec3 _range_min, glm::vec3 _range_extent)
+	{
+		quantized_vector result;
+		for (int i = 0; i < 3; i++)
+		{
+			float const normalized = _range_extent[i] > 0.0f
+				? std::clamp((_vector[i] - _range_min[i]) / _range_extent[i], 0.0f, 1.0f)
+				: 0.0f;
+			result.m_bits[i] = (uint16_t)std::lround(normalized * VECTOR_COMPONENT_MAX);
+		}
+		return result;
+	}
+
+	glm::vec3 dequantize_vector(quantized_vector _vector, glm::vec3 _range_min, glm::vec3 _range_extent)
+	{
+		glm::vec3 result;
+		for (int i = 0; i < 3; i++)
+			result[i] = _range_min[i] + _range_extent[i] * ((float)_vector.m_bits[i] / VECTOR_COMPONENT_MAX);
+		return result;
+	}
+
+	glm::quat compressed_animation_track::rotation(size_t _key) const
+	{
+		return dequantize_rotation(m_rotations[_key]);
+	}
+
+	glm::vec3 compressed_animation_track::vector(size_t _key) const
+	{
+		return dequantize_vector(m_vectors[_key], m_range_min, m_range_extent);
+	}
+
+	size_t compressed_animation_track::memory_usage() const
+	{
+		return sizeof(compressed_animation_track)
+			+ m_key_times.size() * sizeof(float)
+			+ m_rotations.size() * sizeof(quantized_rotation)
+			+ m_vectors.size() * sizeof(quantized_vector);
+	}
+
+	/*
+	* Angle of rotation from one unit quaternion to another. Unlike acos of the dot product this stays
+	* accurate for small angles, which is what tolerances are made of.
+	*/
+	static float rotation_angle_between(glm::quat _a, glm::quat _b)
+	{
+		if (glm::dot(_a, _b) < 0.0f)
+			_b = -_b;
+		glm::quat const difference = _a + (-_b);
+		glm::quat const sum = _a + _b;
+		return 4.0f * std::atan2(std::sqrt(glm::dot(difference, difference)), std::sqrt(glm::dot(sum, sum)));
+	}
+
+	/*
+	* Greedily extend every segment from the last kept key for as long as interpolating across the
+	* segment reproduces all skipped keys within tolerance. Segments interpolate the dequantized values
+	* of their keys, such that the tolerance bounds the error of the compressed track and not only the
+	* error of key reduction.
+	* @param	TValue const *	Source values of keys
+	* @param	TValue const *	Dequantized values of keys
+	* @returns	std::vector<size_t>		Indices of kept keys, always including first and last key.
+	*/
+	template<typename TValue, typename TInterpolate, typename TError>
+	static std::vector<size_t> reduce_keys(
+		float const* _key_times, TValue const* _values, TValue const* _dequantized_values, size_t _key_count,
+		float _tolerance, TInterpolate&& _interpolate, TError&& _error
+	)
+	{
+		std::vector<size_t> kept_keys;
+		if (_key_count == 0)
+			return kept_keys;
+
+		auto segment_within_tolerance = [&](size_t _first, size_t _last)
+		{
+			float const segment_duration = _key_times[_last] - _key_times[_first];
+			for (size_t k = _first + 1; k < _last; k++)
+			{
+				float const t = segment_duration > 0.0f ? (_key_times[k] - _key_times[_first]) / segment_duration : 0.0f;
+				if (_error(_interpolate(_dequantized_values[_first], _dequantized_values[_last], t), _values[k]) > _tolerance)
+					return false;
+			}
+			return true;
+		};
+
+		size_t anchor = 0;
+		kept_keys.push_back(anchor);
+		while (anchor + 1 < _key_count)
+		{
+			size_t end = anchor + 1;
+			while (end + 1 < _key_count && segment_within_tolerance(anchor, end + 1))
+				end++;
+			kept_keys.push_back(end);
+			anchor = end;
+		}
+		return kept_keys;
+	}
+
+	compressed_animation_track compress_rotation_track(
+		float const* _key_times,
+		glm::quat const* _rotations,
+		size_t _key_count,
+		float _tolerance
+	)
+	{
+		std::vector<glm::quat> rotations(_rotations, _rotations + _key_count);
+		std::vector<quantized_rotation> quantized_rotations(_key_count);
+		std::vector<glm::quat> dequantized_rotations(_key_count);
+		for (size_t key = 0; key < _key_count; key++)
+		{
+			rotations[key] = glm::normalize(rotations[key]);
+			quantized_rotations[key] = quantize_rotation(rotations[key]);
+			dequantized_rotations[key] = dequantize_rotation(quantized_rotations[key]);
+		}
+
+		std::vector<size_t> const kept_keys = reduce_keys(
+			_key_times, rotations.data(), dequantized_rotations.data(), _key_count, _tolerance,
+			[](glm::quat _left, glm::quat _right, float _t) { return glm::slerp(_left, _right, _t); },
+			[](glm::quat _a, glm::quat _b) { return rotation_angle_between(_a, _b); }
+		);
+
+		compressed_animation_track track;
+		track.m_key_times.reserve(kept_keys.size());
+		track.m_rotations.reserve(kept_keys.size());
+		for (size_t key : kept_keys)
+		{
+			track.m_key_times.push_back(_key_times[key]);
+			track.m_rotations.push_back(quantized_rotations[key]);
+		}
+		return track;
+	}
+
+	compressed_animation_track compress_vector_track(
+		float const* _key_times,
+		glm::vec3 const* _vectors,
+		size_t _key_count,
+		float _tolerance
+	)
+	{
+		compressed_animation_track track;
+		if (_key_count == 0)
+			return track;
+
+		// Range covers all source keys, since kept keys are only known after quantizing them.
+		glm::vec3 range_min = _vectors[0];
+		glm::vec3 range_max = range_min;
+		for (size_t key = 1; key < _key_count; key++)
+		{
+			range_min = glm::min(range_min, _vectors[key]);
+			range_max = glm::max(range_max, _vectors[key]);
+		}
+		track.m_range_min = range_min;
+		track.m_range_extent = range_max - range_min;
+
+		std::vector<quantized_vector> quantized_vectors(_key_count);
+		std::vector<glm::vec3> dequantized_vectors(_key_count);
+		for (size_t key = 0; key < _key_count; key++)
+		{
+			quantized_vectors[key] = quantize_vector(_vectors[key], track.m_range_min, track.m_range_extent);
+			dequantized_vectors[key] = dequantize_vector(quantized_vectors[key], track.m_range_min, track.m_range_extent);
+		}
+
+		std::vector<size_t> const kept_keys = reduce_keys(
+			_key_times, _vectors, dequantized_vectors.data(), _key_count, _tolerance,
+			[](glm::vec3 _left, glm::vec3 _right, float _t) { return _left + (_right - _left) * _t; },
+			[](glm::vec3 _a, glm::vec3 _b) { return glm::length(_a - _b); }
+		);
+
+		track.m_key_times.reserve(kept_keys.size());
+		track.m_vectors.reserve(kept_keys.size());
+		for (size_t key : kept_keys)
+		{
+			track.m_key_times.push_back(_key_times[key]);
+			track.m_vectors.push_back(quantized_vectors[key]);
+		}
+		return track;
+	}
+
+	bool compress_animation(animation_data& _animation, animation_compression_settings const& _settings)
+	{
+		// Compressed tracks are sampled linearly, which is how sampling treats all interpolation types so far.
+		// Cubic spline output holds tangents next to values, so it cannot be compressed like this.
+		for (animation_channel_data const& channel : _animation.m_animation_channels)
+		{
+			assert(channel.m_sampler && "Animation channels have to be resolved before compression.");
+			if (!channel.m_sampler || channel.m_sampler->m_interpolation_type == animation_sampler_data::CUBICSPLINE)
+				return false;
+		}
+
+		std::vector<compressed_animation_track> tracks;
+		tracks.reserve(_animation.m_animation_channels.size());
+		for (animation_channel_data const& channel : _animation.m_animation_channels)
+		{
+			std::vector<float> const& key_times = channel.m_input->m_data;
+			std::vector<float> const& values = channel.m_output->m_data;
+			switch (channel.m_target_path)
+			{
+			case animation_channel_data::ROTATION:
+				assert(values.size() >= key_times.size() * 4);
+				tracks.push_back(compress_rotation_track(
+					key_times.data(), reinterpret_cast<glm::quat const*>(values.data()), key_times.size(),
+					_settings.m_rotation_tolerance
+				));
+				break;
+			case animation_channel_data::TRANSLATION:
+			case animation_channel_data::SCALE:
+				assert(values.size() >= key_times.size() * 3);
+				tracks.push_back(compress_vector_track(
+					key_times.data(), reinterpret_cast<glm::vec3 const*>(values.data()), key_times.size(),
+					channel.m_target_path == animation_channel_data::TRANSLATION
+						? _settings.m_translation_tolerance
+						: _settings.m_scale_tolerance
+				));
+				break;
+			}
+		}
+
+		_animation.m_compressed_tracks = std::move(tracks);
+		for (animation_channel_data& channel : _animation.m_animation_channels)
+		{
+			channel.m_sampler = nullptr;
+			channel.m_input = nullptr;
+			channel.m_output = nullptr;
+		}
+		return true;
+	}
+
+	size_t animation_memory_usage(animation_data const& _animation)
+	{
+		size_t bytes = 0;
+		if (!_animation.m_compressed_tracks.empty())
+		{
+			for (compressed_animation_track const& track : _animation.m_compressed_tracks)
+				bytes += track.memory_usage();
+			return bytes;
+		}
+
+		// Channels may share input data.
+		std::unordered_set<animation_interpolation_data const*> interpolation_data;
+		for (animation_channel_data const& channel : _animation.m_animation_channels)
+		{
+			interpolation_data.insert(channel.m_input);
+			interpolation_data.insert(channel.m_output);
+		}
+		for (animation_interpolation_data const* data : interpolation_data)
+			if (data)
+				bytes += sizeof(animation_interpolation_data) + data->m_data.size() * sizeof(float);
+		return bytes + _animation.m_animation_channels.size() * sizeof(animation_sampler_data);
+	}
+
+}
+}
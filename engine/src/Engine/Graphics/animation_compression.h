@@ -0,0 +1,93 @@
+#ifndef ENGINE_GRAPHICS_ANIMATION_COMPRESSION_H
+#define ENGINE_GRAPHICS_ANIMATION_COMPRESSION_H
+
+#include <glm/vec3.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Engine {
+namespace Graphics {
+
+	struct animation_data;
+
+	struct animation_compression_settings
+	{
+		bool	m_enabled = true;
+		// Largest error of compressed keys per joint channel, including quantization. Tolerances below
+		// the quantization error of a channel keep all of its keys.
+		float	m_translation_tolerance = 1e-3f;
+		float	m_rotation_tolerance = 1e-3f;	// Radians
+		float	m_scale_tolerance = 1e-4f;
+	};
+
+	/*
+	* Smallest-three quaternion in 48 bits. The three smallest components are stored in 15 bits each,
+	* the index of the largest component in the top bits of the first two values.
+	*/
+	struct quantized_rotation
+	{
+		uint16_t m_bits[3];
+	};
+
+	// Vector quantized to 16 bits per component within the range of its track.
+	struct quantized_vector
+	{
+		uint16_t m_bits[3];
+	};
+
+	/*
+	* @brief	Compressed keys of a single animation channel.
+	* @details	Keys are reduced until linear interpolation between the remaining keys deviates from
+	*			the source by more than the tolerance. Rotation channels fill m_rotations, translation
+	*			and scale channels fill m_vectors.
+	*/
+	struct compressed_animation_track
+	{
+		std::vector<float>				m_key_times;
+		std::vector<quantized_rotation>	m_rotations;
+		std::vector<quantized_vector>	m_vectors;
+		glm::vec3						m_range_min{ 0.0f };
+		glm::vec3						m_range_extent{ 0.0f };
+
+		glm::quat	rotation(size_t _key) const;
+		glm::vec3	vector(size_t _key) const;
+		size_t		memory_usage() const;
+	};
+
+	quantized_rotation	quantize_rotation(glm::quat _rotation);
+	glm::quat			dequantize_rotation(quantized_rotation _rotation);
+	quantized_vector	quantize_vector(glm::vec3 _vector, glm::vec3 _range_min, glm::vec3 _range_extent);
+	glm::vec3			dequantize_vector(quantized_vector _vector, glm::vec3 _range_min, glm::vec3 _range_extent);
+
+	compressed_animation_track compress_rotation_track(
+		float const* _key_times,
+		glm::quat const* _rotations,
+		size_t _key_count,
+		float _tolerance
+	);
+	compressed_animation_track compress_vector_track(
+		float const* _key_times,
+		glm::vec3 const* _vectors,
+		size_t _key_count,
+		float _tolerance
+	);
+
+	/*
+	* Compress all channels of animation into its compressed tracks.
+	* @param	animation_data &						Animation with resolved channels
+	* @param	animation_compression_settings const &	Tolerances of key reduction
+	* @returns	bool	False if animation uses interpolation that compressed tracks do not support.
+	*					On success, channels no longer refer to their interpolation data.
+	*/
+	bool compress_animation(animation_data& _animation, animation_compression_settings const& _settings);
+
+	// Bytes used by sampled data of animation, compressed or not.
+	size_t animation_memory_usage(animation_data const& _animation);
+
+}
+}
+
+#endif // !ENGINE_GRAPHICS_ANIMATION_COMPRESSION_H
@@ -810,6 +810,9 @@ namespace Graphics {
 		m_material_handle_counter += (unsigned int)new_material_data_map.size();
 		m_texture_handle_counter += (unsigned int)new_texture_info_map.size();
 		m_skin_handle_counter += (unsigned int)new_skin_data_map.size();
+		animation_handle const first_new_anim_handle = m_anim_handle_counter;
+		animation_sampler_handle const first_new_anim_sampler_handle = m_anim_sampler_handle_counter;
+		animation_interpolation_handle const first_new_anim_interpolation_handle = m_anim_interpolation_handle_counter;
 		m_anim_handle_counter += (unsigned int)new_anim_data_map.size();
 		m_anim_sampler_handle_counter += (unsigned int)new_anim_sampler_data_map.size();
 		m_anim_interpolation_handle_counter += (unsigned int)new_anim_interpolation_data_map.size();
@@ -826,6 +829,11 @@ namespace Graphics {
 		m_anim_sampler_data_map.merge(new_anim_sampler_data_map);
 		m_anim_interpolation_data_map.merge(new_anim_interpolation_data_map);
 
+		for (animation_handle handle = first_new_anim_handle; handle != m_anim_handle_counter; ++handle)
+			ResolveAnimationChannels(m_anim_data_map.at(handle));
+		if (m_animation_compression.m_enabled)
+			compress_imported_animations(first_new_anim_handle, first_new_anim_sampler_handle, first_new_anim_interpolation_handle);
+
 		gltf_model_data model_data;
 		model_data.m_model_name = model_name;
 		model_data.m_meshes = std::move(created_meshes);
@@ -1252,6 +1260,21 @@ namespace Graphics {
 		return iter == m_anim_data_map.end() ? nullptr : &iter->second;
 	}
 
+	/*
+	* Point channels of animation directly to their sampler and interpolation data.
+	* @param	animation_data &	Animation whose samplers and interpolation data are stored in this manager.
+	*/
+	void ResourceManager::ResolveAnimationChannels(animation_data& _animation) const
+	{
+		for (animation_channel_data& channel : _animation.m_animation_channels)
+		{
+			animation_sampler_data const& sampler = m_anim_sampler_data_map.at(channel.m_anim_sampler_handle);
+			channel.m_sampler = &sampler;
+			channel.m_input = &m_anim_interpolation_data_map.at(sampler.m_anim_interp_input_handle);
+			channel.m_output = &m_anim_interpolation_data_map.at(sampler.m_anim_interp_output_handle);
+		}
+	}
+
 	//////////////////////////////////////////////////////////////////
 	//						Framebuffer Methods
 	//////////////////////////////////////////////////////////////////
@@ -1771,6 +1794,44 @@ namespace Graphics {
 		m_material_data_map.clear();
 	}
 
+	/*
+	* Compress animations imported since given handles, and free interpolation data only they used.
+	* Animations that cannot be compressed keep sampling their interpolation data.
+	*/
+	void ResourceManager::compress_imported_animations(
+		animation_handle _first_animation,
+		animation_sampler_handle _first_sampler,
+		animation_interpolation_handle _first_interpolation
+	)
+	{
+		std::unordered_set<animation_sampler_handle> raw_samplers;
+		for (animation_handle handle = _first_animation; handle != m_anim_handle_counter; ++handle)
+		{
+			animation_data& animation = m_anim_data_map.at(handle);
+			if (compress_animation(animation, m_animation_compression))
+				continue;
+			for (animation_channel_data const& channel : animation.m_animation_channels)
+				raw_samplers.insert(channel.m_anim_sampler_handle);
+		}
+
+		std::unordered_set<animation_interpolation_handle> raw_interpolations;
+		for (animation_sampler_handle sampler = _first_sampler; sampler != m_anim_sampler_handle_counter; ++sampler)
+		{
+			if (raw_samplers.count(sampler) == 0)
+			{
+				m_anim_sampler_data_map.erase(sampler);
+				continue;
+			}
+			animation_sampler_data const& sampler_data = m_anim_sampler_data_map.at(sampler);
+			raw_interpolations.insert(sampler_data.m_anim_interp_input_handle);
+			raw_interpolations.insert(sampler_data.m_anim_interp_output_handle);
+		}
+
+		for (animation_interpolation_handle interpolation = _first_interpolation; interpolation != m_anim_interpolation_handle_counter; ++interpolation)
+			if (raw_interpolations.count(interpolation) == 0)
+				m_anim_interpolation_data_map.erase(interpolation);
+	}
+
 	void ResourceManager::reset_counters()
 	{
 		m_mesh_handle_counter = 1;
@@ -2080,7 +2141,7 @@ namespace Graphics {
 
 	void ResourceManager::editor_animation_list()
 	{
-		for (auto const animation : m_anim_data_map)
+		for (auto const& animation : m_anim_data_map)
 		{
 			ImGui::Selectable(animation.second.m_name.c_str());
 			if (ImGui::BeginDragDropSource())
@@ -2,6 +2,7 @@
 #define ENGINE_GRAPHICS_MANAGER_H
 
 #include <Engine/Math/Transform3D.h>
+#include <Engine/Graphics/animation_compression.h>
 #include <unordered_map>
 #include <gl/glew.h>
 #include <tiny_gltf.h>
@@ -33,6 +34,12 @@ namespace Graphics {
 		E_interpolation_type			m_interpolation_type;
 	};
 
+	// This struct is used to store either animation sampler input or output data.
+	struct animation_interpolation_data
+	{
+		std::vector<float>	m_data;
+	};
+
 	struct animation_channel_data
 	{
 		// ROTATION assumes quaternion is in X,Y,Z,W order
@@ -40,6 +47,12 @@ namespace Graphics {
 		animation_sampler_handle		m_anim_sampler_handle;
 		E_target_path					m_target_path; // Name of animated property.
 		uint8_t							m_skeleton_relative_jointnode_index; // Relative ID of node within skeleton.
+
+		// Resolved from sampler handle by ResourceManager::ResolveAnimationChannels, so sampling
+		// does not look up resource maps. Map elements keep their address until deleted.
+		animation_sampler_data const*		m_sampler = nullptr;
+		animation_interpolation_data const*	m_input = nullptr;
+		animation_interpolation_data const*	m_output = nullptr;
 	};
 
 	struct animation_data
@@ -48,6 +61,8 @@ namespace Graphics {
 		// std::unordered_map<uint8_t, uint8_t>	m_skeleton_jointnode_channel_count;
 		std::vector<uint8_t>					m_skeleton_jointnode_channel_count;
 		std::vector<animation_channel_data>		m_animation_channels;
+		// One track per channel if animation has been compressed, sampled instead of interpolation data.
+		std::vector<compressed_animation_track>	m_compressed_tracks;
 		float									m_duration; // Determined by input interpolation data in channels.
 		std::string								m_name;
 
@@ -55,12 +70,6 @@ namespace Graphics {
 		uint8_t get_skeleton_joint_index_channel_count(uint8_t _joint_index) const;
 	};
 
-	// This struct is used to store either animation sampler input or output data.
-	struct animation_interpolation_data
-	{
-		std::vector<float>	m_data;
-	};
-
 	typedef std::string	 filepath_string;
 
 	class ResourceManager
@@ -220,6 +229,9 @@ namespace Graphics {
 		std::unordered_map<animation_sampler_handle, animation_sampler_data> m_anim_sampler_data_map;
 		std::unordered_map<animation_interpolation_handle, animation_interpolation_data> m_anim_interpolation_data_map;
 
+		// Applied to animations of glTF models when they are imported.
+		animation_compression_settings	m_animation_compression;
+
 
 		//////////////////////////////////////////////////////
 		//				Framebuffer Data
@@ -400,6 +412,7 @@ namespace Graphics {
 
 		animation_handle	FindNamedAnimation(std::string const& _name) const;
 		animation_data const * FindAnimationData(animation_handle _handle) const;
+		void				ResolveAnimationChannels(animation_data& _animation) const;
 
 		/*
 		* Framebuffer Methods
@@ -481,6 +494,12 @@ namespace Graphics {
 
 		void reset_counters();
 
+		void compress_imported_animations(
+			animation_handle _first_animation,
+			animation_sampler_handle _first_sampler,
+			animation_interpolation_handle _first_interpolation
+		);
+
 		void delete_meshes(std::vector<mesh_handle> const& _meshes);
 		void delete_skins(std::vector<skin_handle> const& _skins);
 		void delete_buffers(std::vector<buffer_handle> const& _buffers);
@@ -25,5 +25,21 @@ namespace Math {
 		return b;
 	}
 
+	aabb create_aabb_encapsulating_aabbs(aabb const _a1, aabb const _a2)
+	{
+		glm::vec3 const min = glm::min(_a1.center - _a1.extent, _a2.center - _a2.extent);
+		glm::vec3 const max = glm::max(_a1.center + _a1.extent, _a2.center + _a2.extent);
+		aabb b;
+		b.center = (min + max) * 0.5f;
+		b.extent = (max - min) * 0.5f;
+		return b;
+	}
+
+	float compute_aabb_surface_area(aabb const _aabb)
+	{
+		glm::vec3 const e = _aabb.extent;
+		return 8.0f * (e.x * e.y + e.y * e.z + e.z * e.x);
+	}
+
 }
 }
\ No newline at end of file
@@ -40,5 +40,7 @@ namespace Math {
 
 	sphere	create_sphere_encapsulating_aabb(aabb const _aabb);
 	aabb	create_aabb_encapsulating_obb(obb const _obb);
+	aabb	create_aabb_encapsulating_aabbs(aabb const _a1, aabb const _a2);
+	float	compute_aabb_surface_area(aabb const _aabb);
 }
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "geometry.hpp"
+#include <glm/common.hpp>
 
 namespace Engine {
 namespace Math {
@@ -19,5 +20,11 @@ namespace Math {
 			(a1_min.z <= a2_max.z && a1_max.z >= a2_min.z);
 	}
 
+	inline bool contains_aabb_aabb(aabb const& _outer, aabb const& _inner)
+	{
+		glm::vec3 const delta = glm::abs(_inner.center - _outer.center) + _inner.extent;
+		return delta.x <= _outer.extent.x && delta.y <= _outer.extent.y && delta.z <= _outer.extent.z;
+	}
+
 }
 }
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "simd.hpp"
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+namespace Engine {
+namespace Math {
+
+	static ESIMDLevel detect_simd_level()
+	{
+		ESIMDLevel baseline = eScalar;
+#if defined(ENGINE_SIMD_SSE) || defined(ENGINE_SIMD_AVX)
+		baseline = eSSE;
+#endif
+
+#if defined(ENGINE_SIMD_AVX2_KERNELS)
+	#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7)
+			return baseline;
+
+		// AVX and FMA, and OS saves YMM registers.
+		__cpuid(info, 1);
+		bool const has_avx = (info[2] & (1 << 28)) != 0;
+		bool const has_fma = (info[2] & (1 << 12)) != 0;
+		bool const has_osxsave = (info[2] & (1 << 27)) != 0;
+		if (!has_avx || !has_fma || !has_osxsave || (_xgetbv(0) & 0x6) != 0x6)
+			return baseline;
+
+		__cpuidex(info, 7, 0);
+		if (info[1] & (1 << 5))
+			return eAVX2;
+	#else
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+			return eAVX2;
+	#endif
+#endif
+		return baseline;
+	}
+
+	ESIMDLevel get_supported_simd_level()
+	{
+		static ESIMDLevel const level = detect_simd_level();
+		return level;
+	}
+
+}
+}
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <cstddef>
+
+// Widest instruction set enabled by compiler flags. AVX requires /arch:AVX (MSVC) or -mavx.
+// Lane types live in a namespace per instruction set, such that translation units compiled with
+// different flags (e.g. runtime dispatched kernels) do not share inline functions.
+#if defined(__AVX__)
+	#include <immintrin.h>
+	#define ENGINE_SIMD_AVX
+	#define ENGINE_SIMD_NAMESPACE simd_avx
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define ENGINE_SIMD_SSE
+	#define ENGINE_SIMD_NAMESPACE simd_sse
+#else
+	#include <algorithm>
+	#include <cmath>
+	#define ENGINE_SIMD_NAMESPACE simd_scalar
+#endif
+
+namespace Engine {
+namespace Math {
+
+	/*
+	* @brief	Instruction sets kernels can be dispatched to at runtime.
+	*			eSSE is the baseline lane width of the build, which is plain floats on non-x86 targets.
+	*/
+	enum ESIMDLevel : char
+	{
+		eScalar = 0,
+		eSSE = 1,
+		eAVX2 = 2
+	};
+
+	/*
+	* @brief	Widest level supported by both the CPU and the build, detected once.
+	*/
+	ESIMDLevel get_supported_simd_level();
+
+inline namespace ENGINE_SIMD_NAMESPACE {
+
+	/*
+	* @brief
+	* Pack of floats processed in lockstep, WIDTH lanes wide. Uses 8 AVX lanes or 4 SSE lanes
+	* depending on compiler flags, and falls back to plain floats on other targets.
+	* Loads and stores are unaligned.
+	*/
+	struct simd_float
+	{
+#if defined(ENGINE_SIMD_AVX)
+		static constexpr size_t WIDTH = 8;
+		__m256 v;
+
+		static simd_float load(float const* _src) { return { _mm256_loadu_ps(_src) }; }
+		static simd_float broadcast(float _value) { return { _mm256_set1_ps(_value) }; }
+		void store(float* _dst) const { _mm256_storeu_ps(_dst, v); }
+
+		friend simd_float operator+(simd_float _a, simd_float _b) { return { _mm256_add_ps(_a.v, _b.v) }; }
+		friend simd_float operator-(simd_float _a, simd_float _b) { return { _mm256_sub_ps(_a.v, _b.v) }; }
+		friend simd_float operator*(simd_float _a, simd_float _b) { return { _mm256_mul_ps(_a.v, _b.v) }; }
+		friend simd_float operator/(simd_float _a, simd_float _b) { return { _mm256_div_ps(_a.v, _b.v) }; }
+		friend simd_float min(simd_float _a, simd_float _b) { return { _mm256_min_ps(_a.v, _b.v) }; }
+		friend simd_float max(simd_float _a, simd_float _b) { return { _mm256_max_ps(_a.v, _b.v) }; }
+		friend simd_float sqrt(simd_float _a) { return { _mm256_sqrt_ps(_a.v) }; }
+#elif defined(ENGINE_SIMD_SSE)
+		static constexpr size_t WIDTH = 4;
+		__m128 v;
+
+		static simd_float load(float const* _src) { return { _mm_loadu_ps(_src) }; }
+		static simd_float broadcast(float _value) { return { _mm_set1_ps(_value) }; }
+		void store(float* _dst) const { _mm_storeu_ps(_dst, v); }
+
+		friend simd_float operator+(simd_float _a, simd_float _b) { return { _mm_add_ps(_a.v, _b.v) }; }
+		friend simd_float operator-(simd_float _a, simd_float _b) { return { _mm_sub_ps(_a.v, _b.v) }; }
+		friend simd_float operator*(simd_float _a, simd_float _b) { return { _mm_mul_ps(_a.v, _b.v) }; }
+		friend simd_float operator/(simd_float _a, simd_float _b) { return { _mm_div_ps(_a.v, _b.v) }; }
+		friend simd_float min(simd_float _a, simd_float _b) { return { _mm_min_ps(_a.v, _b.v) }; }
+		friend simd_float max(simd_float _a, simd_float _b) { return { _mm_max_ps(_a.v, _b.v) }; }
+		friend simd_float sqrt(simd_float _a) { return { _mm_sqrt_ps(_a.v) }; }
+#else
+		static constexpr size_t WIDTH = 4;
+		float v[WIDTH];
+
+		static simd_float load(float const* _src) { simd_float r; for (size_t i = 0; i < WIDTH; i++) r.v[i] = _src[i]; return r; }
+		static simd_float broadcast(float _value) { simd_float r; for (size_t i = 0; i < WIDTH; i++) r.v[i] = _value; return r; }
+		void store(float* _dst) const { for (size_t i = 0; i < WIDTH; i++) _dst[i] = v[i]; }
+
+		friend simd_float operator+(simd_float _a, simd_float _b) { for (size_t i = 0; i < WIDTH; i++) _a.v[i] += _b.v[i]; return _a; }
+		friend simd_float operator-(simd_float _a, simd_float _b) { for (size_t i = 0; i < WIDTH; i++) _a.v[i] -= _b.v[i]; return _a; }
+		friend simd_float operator*(simd_float _a, simd_float _b) { for (size_t i = 0; i < WIDTH; i++) _a.v[i] *= _b.v[i]; return _a; }
+		friend simd_float operator/(simd_float _a, simd_float _b) { for (size_t i = 0; i < WIDTH; i++) _a.v[i] /= _b.v[i]; return _a; }
+		friend simd_float min(simd_float _a, simd_float _b) { for (size_t i = 0; i < WIDTH; i++) _a.v[i] = std::min(_a.v[i], _b.v[i]); return _a; }
+		friend simd_float max(simd_float _a, simd_float _b) { for (size_t i = 0; i < WIDTH; i++) _a.v[i] = std::max(_a.v[i], _b.v[i]); return _a; }
+		friend simd_float sqrt(simd_float _a) { for (size_t i = 0; i < WIDTH; i++) _a.v[i] = std::sqrt(_a.v[i]); return _a; }
+#endif
+		static simd_float zero() { return broadcast(0.0f); }
+
+		friend simd_float operator-(simd_float _a) { return zero() - _a; }
+		friend simd_float clamp(simd_float _a, simd_float _min, simd_float _max) { return min(max(_a, _min), _max); }
+	};
+
+	/*
+	* @brief	Three-component vectors of WIDTH lanes in structure-of-arrays layout.
+	*/
+	struct simd_vec3
+	{
+		simd_float x, y, z;
+
+		// Loads from x, y and z rows of a float[3][WIDTH] array.
+		static simd_vec3 load(float const _src[][simd_float::WIDTH]) { return { simd_float::load(_src[0]), simd_float::load(_src[1]), simd_float::load(_src[2]) }; }
+		void store(float _dst[][simd_float::WIDTH]) const { x.store(_dst[0]); y.store(_dst[1]); z.store(_dst[2]); }
+
+		// Loads WIDTH consecutive xyz triples (e.g. glm::vec3 arrays), transposing them into lanes.
+		static simd_vec3 load_interleaved(float const* _src)
+		{
+			alignas(32) float lanes[3][simd_float::WIDTH];
+			for (size_t lane = 0; lane < simd_float::WIDTH; lane++)
+			{
+				lanes[0][lane] = _src[3 * lane + 0];
+				lanes[1][lane] = _src[3 * lane + 1];
+				lanes[2][lane] = _src[3 * lane + 2];
+			}
+			return load(lanes);
+		}
+
+		void store_interleaved(float* _dst) const
+		{
+			alignas(32) float lanes[3][simd_float::WIDTH];
+			store(lanes);
+			for (size_t lane = 0; lane < simd_float::WIDTH; lane++)
+			{
+				_dst[3 * lane + 0] = lanes[0][lane];
+				_dst[3 * lane + 1] = lanes[1][lane];
+				_dst[3 * lane + 2] = lanes[2][lane];
+			}
+		}
+
+		friend simd_vec3 operator+(simd_vec3 const& _a, simd_vec3 const& _b) { return { _a.x + _b.x, _a.y + _b.y, _a.z + _b.z }; }
+		friend simd_vec3 operator-(simd_vec3 const& _a, simd_vec3 const& _b) { return { _a.x - _b.x, _a.y - _b.y, _a.z - _b.z }; }
+		friend simd_vec3 operator*(simd_vec3 const& _a, simd_float _s) { return { _a.x * _s, _a.y * _s, _a.z * _s }; }
+	};
+
+	inline simd_float dot(simd_vec3 const& _a, simd_vec3 const& _b)
+	{
+		return _a.x * _b.x + _a.y * _b.y + _a.z * _b.z;
+	}
+
+	inline simd_vec3 cross(simd_vec3 const& _a, simd_vec3 const& _b)
+	{
+		return {
+			_a.y * _b.z - _a.z * _b.y,
+			_a.z * _b.x - _a.x * _b.z,
+			_a.x * _b.y - _a.y * _b.x
+		};
+	}
+
+	/*
+	* @brief	Column-major 3x3 matrices of WIDTH lanes, m[column][row].
+	*/
+	struct simd_mat3
+	{
+		simd_float m[3][3];
+
+		// Loads WIDTH consecutive column-major 3x3 matrices (e.g. glm::mat3 arrays), transposing them into lanes.
+		static simd_mat3 load_interleaved(float const* _src)
+		{
+			alignas(32) float lanes[9][simd_float::WIDTH];
+			for (size_t lane = 0; lane < simd_float::WIDTH; lane++)
+				for (size_t e = 0; e < 9; e++)
+					lanes[e][lane] = _src[9 * lane + e];
+
+			simd_mat3 result;
+			for (size_t e = 0; e < 9; e++)
+				result.m[e / 3][e % 3] = simd_float::load(lanes[e]);
+			return result;
+		}
+
+		void store_interleaved(float* _dst) const
+		{
+			alignas(32) float lanes[9][simd_float::WIDTH];
+			for (size_t e = 0; e < 9; e++)
+				m[e / 3][e % 3].store(lanes[e]);
+			for (size_t lane = 0; lane < simd_float::WIDTH; lane++)
+				for (size_t e = 0; e < 9; e++)
+					_dst[9 * lane + e] = lanes[e][lane];
+		}
+
+		simd_vec3 operator*(simd_vec3 const& _v) const
+		{
+			return {
+				m[0][0] * _v.x + m[1][0] * _v.y + m[2][0] * _v.z,
+				m[0][1] * _v.x + m[1][1] * _v.y + m[2][1] * _v.z,
+				m[0][2] * _v.x + m[1][2] * _v.y + m[2][2] * _v.z
+			};
+		}
+
+		simd_mat3 operator*(simd_mat3 const& _rhs) const
+		{
+			simd_mat3 result;
+			for (size_t c = 0; c < 3; c++)
+				for (size_t r = 0; r < 3; r++)
+					result.m[c][r] = m[0][r] * _rhs.m[c][0] + m[1][r] * _rhs.m[c][1] + m[2][r] * _rhs.m[c][2];
+			return result;
+		}
+
+		simd_mat3 transpose() const
+		{
+			simd_mat3 result;
+			for (size_t c = 0; c < 3; c++)
+				for (size_t r = 0; r < 3; r++)
+					result.m[c][r] = m[r][c];
+			return result;
+		}
+	};
+
+	/*
+	* @brief	Quaternions of WIDTH lanes.
+	*/
+	struct simd_quat
+	{
+		simd_float w, x, y, z;
+
+		// Rotation matrix of normalized quaternions, as glm::mat3_cast.
+		simd_mat3 to_mat3() const
+		{
+			simd_float const one = simd_float::broadcast(1.0f);
+			simd_float const two = simd_float::broadcast(2.0f);
+			simd_float const xx = x * x, yy = y * y, zz = z * z;
+			simd_float const xy = x * y, xz = x * z, yz = y * z;
+			simd_float const wx = w * x, wy = w * y, wz = w * z;
+
+			simd_mat3 r;
+			r.m[0][0] = one - two * (yy + zz);
+			r.m[0][1] = two * (xy + wz);
+			r.m[0][2] = two * (xz - wy);
+			r.m[1][0] = two * (xy - wz);
+			r.m[1][1] = one - two * (xx + zz);
+			r.m[1][2] = two * (yz + wx);
+			r.m[2][0] = two * (xz + wy);
+			r.m[2][1] = two * (yz - wx);
+			r.m[2][2] = one - two * (xx + yy);
+			return r;
+		}
+	};
+
+	inline simd_quat normalize(simd_quat const& _q)
+	{
+		simd_float const inv_length = simd_float::broadcast(1.0f) / sqrt(_q.w * _q.w + _q.x * _q.x + _q.y * _q.y + _q.z * _q.z);
+		return { _q.w * inv_length, _q.x * inv_length, _q.y * inv_length, _q.z * inv_length };
+	}
+
+}
+}
+}
@@ -10,6 +10,9 @@
 #include <Engine/Math/geometry_intersection.hpp>
 
 #include <Engine/Editor/editor.h>
+#include <Engine/Utils/allocation_tracker.h>
+#include <Engine/Utils/job_system.h>
+#include <Engine/Utils/stopwatch.h>
 
 namespace Component
 {
@@ -32,28 +35,39 @@ namespace Component
 		return GetManager().m_data.m_entity_map.at(Owner()).m_collider_resource;
 	}
 
-	Engine::Math::aabb Collider::GetBoundingVolume() const
+	/*
+	* @brief	Compute world-space AABB of convex hull bounding volume.
+	* @param	aabb			Bounding volume of convex hull in model space.
+	* @param	transform3D		Model to world transform of collider.
+	* @return	aabb			World-space AABB encapsulating transformed bounding volume.
+	*/
+	static Engine::Math::aabb compute_collider_bounding_volume(Engine::Math::aabb const& _ch_aabb, Engine::Math::transform3D const& _world_transform)
 	{
-		// Retrieve convex hull resource
-		auto const resource = GetColliderResource();
-		auto const & ch_info = Singleton<ConvexHullManager>().GetConvexHullInfo(resource.Handle());
-		Engine::Math::aabb const ch_aabb = ch_info->m_data.m_aabb_bounding_volume;
-		auto const world_transform = Owner().GetComponent<Transform>().ComputeWorldTransform();
 		Engine::Math::aabb bv_aabb;
 		// Create OBB with world transform.
-		bv_aabb.center = world_transform.TransformPoint(ch_aabb.center);
-		glm::vec3 transformed_extent = world_transform.TransformVector(ch_aabb.extent);
-		glm::quat inv_world_rot = world_transform.rotation;
+		bv_aabb.center = _world_transform.TransformPoint(_ch_aabb.center);
+		glm::vec3 transformed_extent = _world_transform.TransformVector(_ch_aabb.extent);
+		glm::quat inv_world_rot = _world_transform.rotation;
 		inv_world_rot.w *= -1.0f;
 		bv_aabb.extent = inv_world_rot * transformed_extent;
 		
 		Engine::Math::obb bv_obb;
 		bv_obb.aabb = bv_aabb;
-		bv_obb.rotation = world_transform.rotation;
+		bv_obb.rotation = _world_transform.rotation;
 
 		return Engine::Math::create_aabb_encapsulating_obb(bv_obb);
 	}
 
+	Engine::Math::aabb Collider::GetBoundingVolume() const
+	{
+		// Retrieve convex hull resource
+		auto const resource = GetColliderResource();
+		auto const & ch_info = Singleton<ConvexHullManager>().GetConvexHullInfo(resource.Handle());
+		Engine::Math::aabb const ch_aabb = ch_info->m_data.m_aabb_bounding_volume;
+		auto const world_transform = Owner().GetComponent<Transform>().ComputeWorldTransform();
+		return compute_collider_bounding_volume(ch_aabb, world_transform);
+	}
+
 	const char* ColliderManager::GetComponentTypeName() const
 	{
 		return "Collider";
@@ -78,7 +92,9 @@ namespace Component
 			}
 		}
 		map_iter->second.m_collider_resource = _resource;
-		if (_resource.ID() != 0)
+		if (_resource.ID() == 0)
+			remove_broadphase_body(_e);
+		else if (m_create_debug_meshes)
 		{
 			Engine::Physics::convex_hull_handle const input_resource_handle = _resource.Handle();
 			auto debug_mesh_iter = m_data.m_ch_debug_meshes.find(_resource);
@@ -93,9 +109,29 @@ namespace Component
 			m_data.m_ch_debug_meshes.at(_resource).m_ref_count++;
 		}
 	}
+	void ColliderManager::SetBroadphaseMode(EBroadphaseMode _mode)
+	{
+		if (_mode == m_broadphase_mode)
+			return;
+
+		// Proxies are lazily re-created in the structure of the new mode.
+		m_data.m_broadphase_tree.clear();
+		m_data.m_broadphase_sap.clear();
+		for (auto& body : m_data.m_broadphase_bodies)
+			body.m_proxy = NULL_BROADPHASE_PROXY;
+
+		// Sweep-and-prune reports all overlapping pairs as added on its next update, which
+		// recreates the cache entries of its pairs.
+		m_data.m_global_contact_data.cache.clear();
+		m_data.m_global_contact_data.cache.tracks_broadphase_pairs = (_mode == eSweepAndPrune);
+
+		m_broadphase_mode = _mode;
+	}
+
 	void ColliderManager::impl_clear()
 	{
 		m_data = manager_data();
+		m_data.m_global_contact_data.cache.tracks_broadphase_pairs = (m_broadphase_mode == eSweepAndPrune);
 	}
 	bool ColliderManager::impl_create(Entity _e)
 	{
@@ -183,6 +219,9 @@ namespace Component
 			m_data = _j["m_data"];
 		}
 
+		if (!m_create_debug_meshes)
+			return;
+
 		// Create meshes for convex hulls if they do not exist yet.
 		std::map<Engine::Managers::Resource, unsigned int> map_collider_res_refcount;
 		for (auto [e, debug_render_instance] : m_data.m_entity_map)
@@ -354,132 +393,263 @@ namespace Component
 
 
 
-	void ColliderManager::TestColliderIntersections()
+	/*
+	* @brief	Refresh world transforms and bounding volumes of all colliders that have a collider
+	*			resource, and update their proxies in the broadphase structure.
+	*/
+	void ColliderManager::update_broadphase_bodies()
 	{
-		using namespace Engine::Physics;
+		auto const& ch_mgr = Singleton<ConvexHullManager>();
+		auto const& rb_data = Singleton<Component::RigidBodyManager>().m_rigidbodies_data;
+		auto& bodies = m_data.m_broadphase_bodies;
+		auto& shapes = m_data.m_narrowphase_bodies;
+		auto& tree = m_data.m_broadphase_tree;
+		auto& sap = m_data.m_broadphase_sap;
+
+		for (auto const& [entity, instance] : m_data.m_entity_map)
+		{
+			if (!instance.m_collider_resource.ID())
+				continue;
 
-		m_data.m_intersection_results.clear();
-		m_data.m_entity_intersections.clear();
+			auto index_iter = m_data.m_broadphase_body_indices.find(entity);
+			if (index_iter == m_data.m_broadphase_body_indices.end())
+			{
+				index_iter = m_data.m_broadphase_body_indices.emplace(entity, bodies.size()).first;
+				bodies.emplace_back().m_entity = entity;
+				shapes.emplace_back().entity_id = entity.ID();
+			}
+			size_t const body_index = index_iter->second;
+			manager_data::broadphase_body& body = bodies[body_index];
+			narrowphase_body& shape = shapes[body_index];
+
+			shape.hull = &ch_mgr.GetConvexHullInfo(instance.m_collider_resource.Handle())->m_data;
+			shape.world_transform = entity.GetComponent<Component::Transform>().ComputeWorldTransform();
+			shape.bounding_volume = compute_collider_bounding_volume(shape.hull->m_aabb_bounding_volume, shape.world_transform);
+			bool const has_rigidbody = rb_data.has(entity);
+			size_t const rb_index = has_rigidbody ? rb_data.get_entity_index(entity) : 0;
+			shape.is_static = has_rigidbody && rb_data.m_inv_masses[rb_index] == 0.0f;
+			shape.is_sleeping = has_rigidbody && rb_data.is_sleeping(rb_index);
+
+			if (m_broadphase_mode == eDynamicAABBTree)
+			{
+				if (body.m_proxy == NULL_BROADPHASE_PROXY)
+					body.m_proxy = tree.create_proxy(shape.bounding_volume, (uint32_t)body_index);
+				else
+					tree.move_proxy(body.m_proxy, shape.bounding_volume);
+			}
+			else if (m_broadphase_mode == eSweepAndPrune)
+			{
+				if (body.m_proxy == NULL_BROADPHASE_PROXY)
+					body.m_proxy = sap.create_proxy(shape.bounding_volume, (uint32_t)body_index);
+				else
+					sap.update_proxy(body.m_proxy, shape.bounding_volume);
+			}
+		}
+	}
 
-		global_contact_data& mgr_global_contact_data = m_data.m_global_contact_data;
-		mgr_global_contact_data.all_contacts.clear();
-		mgr_global_contact_data.all_contact_manifolds.clear();
-		mgr_global_contact_data.debug_draw_lines.clear();
-		mgr_global_contact_data.debug_draw_points.clear();
+	void ColliderManager::remove_broadphase_body(Entity _e)
+	{
+		auto& bodies = m_data.m_broadphase_bodies;
+		auto index_iter = m_data.m_broadphase_body_indices.find(_e);
+		if (index_iter == m_data.m_broadphase_body_indices.end())
+			return;
 
-		std::array<contact, 128>	contact_stack_arr;
-		size_t						contact_stack_size = 0;
+		size_t const body_index = index_iter->second;
+		if (bodies[body_index].m_proxy != NULL_BROADPHASE_PROXY)
+		{
+			if (m_broadphase_mode == eDynamicAABBTree)
+				m_data.m_broadphase_tree.destroy_proxy(bodies[body_index].m_proxy);
+			else if (m_broadphase_mode == eSweepAndPrune)
+			{
+				// Pairs of the body are reported as removed, while its body index is still valid.
+				auto& sap = m_data.m_broadphase_sap;
+				size_t const first_removed_event = sap.m_removed_pairs.size();
+				sap.destroy_proxy(bodies[body_index].m_proxy);
+				apply_broadphase_pair_events(sap.m_added_pairs.size(), first_removed_event);
+			}
+		}
 
-		auto it1 = m_data.m_entity_map.begin();
-		while (it1 != m_data.m_entity_map.end())
+		// Swap with back body, and update references to it.
+		size_t const back_index = bodies.size() - 1;
+		if (body_index != back_index)
 		{
-			if (!it1->second.m_collider_resource.ID())
+			bodies[body_index] = bodies[back_index];
+			m_data.m_narrowphase_bodies[body_index] = m_data.m_narrowphase_bodies[back_index];
+			m_data.m_broadphase_body_indices.at(bodies[body_index].m_entity) = body_index;
+			if (bodies[body_index].m_proxy != NULL_BROADPHASE_PROXY)
 			{
-				it1++;
-				continue;
+				if (m_broadphase_mode == eDynamicAABBTree)
+					m_data.m_broadphase_tree.set_user_data(bodies[body_index].m_proxy, (uint32_t)body_index);
+				else if (m_broadphase_mode == eSweepAndPrune)
+					m_data.m_broadphase_sap.set_user_data(bodies[body_index].m_proxy, (uint32_t)body_index);
 			}
-			convex_hull_handle const ch_1 = it1->second.m_collider_resource.Handle();
-			auto chi_1 = Singleton<ConvexHullManager>().GetConvexHullInfo(ch_1);
-			auto rb_1 = it1->first.GetComponent<Component::RigidBody>();
-			auto it2 = it1;
-			Engine::Math::transform3D const tr_1 = it1->first.GetComponent<Component::Transform>().ComputeWorldTransform();
-			Engine::Math::aabb const bv1 = Component::Collider(it1->first).GetBoundingVolume();
-			it2++;
-			while (it2 != m_data.m_entity_map.end())
+		}
+		bodies.pop_back();
+		m_data.m_narrowphase_bodies.pop_back();
+		m_data.m_broadphase_body_indices.erase(index_iter);
+	}
+
+	/*
+	* @brief	Compute candidate pairs of broadphase bodies for narrowphase.
+	* @details	Pairs are sorted by body index, such that narrowphase order does not depend
+	*			on the broadphase mode that is used.
+	*/
+	void ColliderManager::compute_broadphase_pairs()
+	{
+		auto const& shapes = m_data.m_narrowphase_bodies;
+		auto& pairs = m_data.m_broadphase_pairs;
+
+		if (m_broadphase_mode == eDynamicAABBTree)
+		{
+			m_data.m_broadphase_tree.compute_pairs(pairs);
+		}
+		else if (m_broadphase_mode == eSweepAndPrune)
+		{
+			auto& sap = m_data.m_broadphase_sap;
+			size_t const first_added_event = sap.m_added_pairs.size();
+			size_t const first_removed_event = sap.m_removed_pairs.size();
+			sap.update();
+			apply_broadphase_pair_events(first_added_event, first_removed_event);
+			sap.compute_pairs(pairs);
+		}
+		else
+		{
+			pairs.clear();
+			for (uint32_t i = 0; i < (uint32_t)shapes.size(); i++)
 			{
-				if (!it2->second.m_collider_resource.ID())
+				for (uint32_t j = i + 1; j < (uint32_t)shapes.size(); j++)
 				{
-					it2++;
-					continue;
+					if (Engine::Math::intersect_aabb_aabb(shapes[i].bounding_volume, shapes[j].bounding_volume))
+						pairs.emplace_back(i, j);
 				}
+			}
+		}
+	}
 
-				// Broad-phase detection
-				Engine::Math::aabb const bv2 = Component::Collider(it2->first).GetBoundingVolume();
-				if (!Engine::Math::intersect_aabb_aabb(bv1, bv2))
-				{
-					it2++;
-					continue;
-				}
+	/*
+	* @brief	Create and evict contact cache entries of sweep-and-prune pairs that started or
+	*			stopped overlapping.
+	* @param	size_t	Index of first added pair event that has not been applied yet
+	* @param	size_t	Index of first removed pair event that has not been applied yet
+	* @details	Events are pairs of broadphase body indices, which are only valid until bodies are
+	*			removed. Events are therefore applied as soon as they are reported. Events of a single
+	*			update are net changes, so removals and additions can be applied in any order.
+	*/
+	void ColliderManager::apply_broadphase_pair_events(size_t _first_added_event, size_t _first_removed_event)
+	{
+		auto const& sap = m_data.m_broadphase_sap;
+		auto const& bodies = m_data.m_broadphase_bodies;
+		auto& cache = m_data.m_global_contact_data.cache;
+		auto& event_keys = m_data.m_broadphase_event_keys;
 
-				// Skip iteration if both objects have rigidbodies and both are static.
-				auto rb_2 = it2->first.GetComponent<Component::RigidBody>();
-				if (rb_1.IsValid() && rb_2.IsValid() &&
-					(rb_1.GetRigidBodyData().inv_mass == 0.0f && rb_2.GetRigidBodyData().inv_mass == 0.0f)
-					)
-				{
-					it2++;
-					continue;
-				}
+		event_keys.clear();
+		for (size_t i = _first_removed_event; i < sap.m_removed_pairs.size(); i++)
+		{
+			broadphase_pair const pair = sap.m_removed_pairs[i];
+			event_keys.push_back(make_contact_pair_key(bodies[pair.first].m_entity, bodies[pair.second].m_entity));
+		}
+		if (!event_keys.empty())
+			cache.evict_pairs(event_keys);
 
-				contact_stack_size = 0;
+		event_keys.clear();
+		for (size_t i = _first_added_event; i < sap.m_added_pairs.size(); i++)
+		{
+			broadphase_pair const pair = sap.m_added_pairs[i];
+			event_keys.push_back(make_contact_pair_key(bodies[pair.first].m_entity, bodies[pair.second].m_entity));
+		}
+		if (!event_keys.empty())
+			cache.add_pairs(event_keys);
+	}
 
-				convex_hull_handle const ch_2 = it2->second.m_collider_resource.Handle();
-				auto chi_2 = Singleton<ConvexHullManager>().GetConvexHullInfo(ch_2);
-				Engine::Math::transform3D const tr_2 = it2->first.GetComponent<Component::Transform>().ComputeWorldTransform();
-				Engine::Physics::contact_manifold manifold;
-				std::pair<Entity, Entity> const entity_pair = std::pair(it1->first, it2->first);
+	void ColliderManager::TestColliderIntersections()
+	{
+		using namespace Engine::Physics;
+		ENGINE_ALLOCATION_SCOPE(ePhysics);
 
-				bool hull1_is_reference_face = false;
-				EIntersectionType result = intersect_convex_hulls_sat(
-					chi_1->m_data, tr_1, it1->first.ID(), 
-					chi_2->m_data, tr_2, it2->first.ID(), 
-					contact_stack_arr.data(), &contact_stack_size,
-					&hull1_is_reference_face
-				);
+		m_data.m_intersection_results.clear();
+		m_data.m_entity_intersections.clear();
 
-				// If an intersection is detected, store results in global contact data.
-				if (result & EIntersectionType::eAnyIntersection)
-				{
-					// Record intersection
-					m_data.m_intersection_results.emplace(entity_pair, result);
-					m_data.m_entity_intersections[it1->first].emplace_back(it2->first);
-					m_data.m_entity_intersections[it2->first].emplace_back(it1->first);
-					
-					contact_manifold new_cm;
-					// Account for face-face intersection using different collider for reference face.
-					new_cm.rigidbodies.first = hull1_is_reference_face ? it1->first : it2->first;
-					new_cm.rigidbodies.second = hull1_is_reference_face ? it2->first : it1->first;
-
-					if (new_cm.rigidbodies.first.IsValid() && new_cm.rigidbodies.second.IsValid())
-					{
-						new_cm.data.first_contact_index = mgr_global_contact_data.all_contacts.size();
-						new_cm.data.contact_count = contact_stack_size;
-						new_cm.data.is_edge_edge = (result == EIntersectionType::eEdgeIntersection);
+		global_contact_data& mgr_global_contact_data = m_data.m_global_contact_data;
+		mgr_global_contact_data.all_contacts.clear();
+		mgr_global_contact_data.all_contact_manifolds.clear();
+		mgr_global_contact_data.debug_draw_lines.clear();
+		mgr_global_contact_data.debug_draw_points.clear();
 
-						mgr_global_contact_data.all_contact_manifolds.push_back(new_cm);
-						mgr_global_contact_data.all_contacts.insert(
-							mgr_global_contact_data.all_contacts.end(),
-							contact_stack_arr.begin(),
-							contact_stack_arr.begin() + contact_stack_size
-						);
+		Engine::Utils::stopwatch phase_stopwatch;
+
+		// Broad-phase detection
+		// Sweep-and-prune pair events are kept until the next test, so they can be inspected.
+		m_data.m_broadphase_sap.clear_events();
+		update_broadphase_bodies();
+		compute_broadphase_pairs();
+		m_last_timings.broadphase_ms = phase_stopwatch.lap_ms();
+
+		// Narrow-phase detection
+		narrowphase_context& narrowphase = m_data.m_narrowphase_context;
+		compute_narrowphase(
+			m_data.m_narrowphase_bodies.data(),
+			m_data.m_broadphase_pairs.data(),
+			m_data.m_broadphase_pairs.size(),
+			m_parallel_narrowphase ? &Singleton<Engine::Utils::job_system>() : nullptr,
+			narrowphase
+		);
+
+		// Store results in global contact data, in pair order.
+		for (narrowphase_result const& np_result : narrowphase.merged_output.results)
+		{
+			broadphase_pair const pair = m_data.m_broadphase_pairs[np_result.pair_index];
+			Entity const e1 = m_data.m_broadphase_bodies[pair.first].m_entity;
+			Entity const e2 = m_data.m_broadphase_bodies[pair.second].m_entity;
+			std::pair<Entity, Entity> const entity_pair = std::pair(e1, e2);
+
+			// Record intersection
+			m_data.m_intersection_results.emplace(entity_pair, np_result.type);
+			m_data.m_entity_intersections[e1].emplace_back(e2);
+			m_data.m_entity_intersections[e2].emplace_back(e1);
+			
+			contact_manifold new_cm;
+			// Account for face-face intersection using different collider for reference face.
+			new_cm.rigidbodies.first = np_result.hull1_is_reference_face ? e1 : e2;
+			new_cm.rigidbodies.second = np_result.hull1_is_reference_face ? e2 : e1;
+			new_cm.pair_key = make_contact_pair_key(e1, e2);
+
+			if (new_cm.rigidbodies.first.IsValid() && new_cm.rigidbodies.second.IsValid())
+			{
+				new_cm.data.first_contact_index = mgr_global_contact_data.all_contacts.size();
+				new_cm.data.contact_count = np_result.contact_count;
+				new_cm.data.is_edge_edge = (np_result.type == EIntersectionType::eEdgeIntersection);
+
+				auto const contacts_begin = narrowphase.merged_output.contacts.begin() + np_result.first_contact_index;
+				mgr_global_contact_data.all_contact_manifolds.push_back(new_cm);
+				mgr_global_contact_data.all_contacts.insert(
+					mgr_global_contact_data.all_contacts.end(),
+					contacts_begin,
+					contacts_begin + np_result.contact_count
+				);
 
 #ifdef DEBUG_RENDER_CONTACTS
 
-						auto const & all_contacts = mgr_global_contact_data.all_contacts;
-						auto const & all_manifolds = mgr_global_contact_data.all_contact_manifolds;
-						if (new_cm.data.is_edge_edge)
-						{
-							contact cm_contact = all_contacts[new_cm.data.first_contact_index];
-							mgr_global_contact_data.debug_draw_lines.push_back(cm_contact.point);
-							mgr_global_contact_data.debug_draw_lines.push_back(cm_contact.point + cm_contact.normal * cm_contact.penetration);
-						}
-						else
-						{
-							for (size_t i = new_cm.data.first_contact_index; i < new_cm.data.first_contact_index + new_cm.data.contact_count; i++)
-							{
-								contact cm_contact = all_contacts[i];
-								mgr_global_contact_data.debug_draw_points.push_back(cm_contact.point);
-							}
-						}
-
-#endif // RENDER_CONTACT_POINTS
+				auto const & all_contacts = mgr_global_contact_data.all_contacts;
+				auto const & all_manifolds = mgr_global_contact_data.all_contact_manifolds;
+				if (new_cm.data.is_edge_edge)
+				{
+					contact cm_contact = all_contacts[new_cm.data.first_contact_index];
+					mgr_global_contact_data.debug_draw_lines.push_back(cm_contact.point);
+					mgr_global_contact_data.debug_draw_lines.push_back(cm_contact.point + cm_contact.normal * cm_contact.penetration);
+				}
+				else
+				{
+					for (size_t i = new_cm.data.first_contact_index; i < new_cm.data.first_contact_index + new_cm.data.contact_count; i++)
+					{
+						contact cm_contact = all_contacts[i];
+						mgr_global_contact_data.debug_draw_points.push_back(cm_contact.point);
 					}
-
 				}
-				it2++;
+
+#endif // RENDER_CONTACT_POINTS
 			}
-			it1++;
 		}
 
+		m_last_timings.narrowphase_ms = phase_stopwatch.lap_ms();
 	}
 }
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include <Engine/Physics/convex_hull.h>
 #include <Engine/Physics/intersection.h>
 #include <Engine/Physics/contact.h>
+#include <Engine/Physics/dynamic_aabb_tree.h>
+#include <Engine/Physics/sweep_and_prune.h>
+#include <Engine/Physics/narrowphase.h>
 #include <Engine/Graphics/manager.h>
 
 #include <unordered_map>
@@ -47,13 +50,36 @@ namespace Component
 			};
 
 
-			std::unordered_map<Entity, ch_debug_render_instance, Entity::hash> m_entity_map;
+			sparse_set<ch_debug_render_instance> m_entity_map;
 			std::map<Engine::Managers::Resource, ch_debug_meshes> m_ch_debug_meshes;
 
+			/*
+			* Collider with a valid collider resource that takes part in broadphase.
+			* Its collision shape is stored at the same index in the narrowphase body array,
+			* and is refreshed when testing intersections.
+			*/
+			struct broadphase_body
+			{
+				Entity												m_entity;
+				Engine::Physics::broadphase_proxy					m_proxy = Engine::Physics::NULL_BROADPHASE_PROXY;	// Proxy in broadphase structure of active mode.
+			};
+
 			std::map<std::pair<Entity,Entity>, Engine::Physics::EIntersectionType> m_intersection_results;
 			std::unordered_map<Entity, std::vector<Entity>, Entity::hash>	m_entity_intersections;
 			Engine::Physics::global_contact_data							m_global_contact_data;
 
+			// Broadphase data (not serialized, rebuilt from entity map when testing intersections)
+			std::vector<broadphase_body>									m_broadphase_bodies;
+			std::vector<Engine::Physics::narrowphase_body>					m_narrowphase_bodies;
+			std::unordered_map<Entity, size_t, Entity::hash>				m_broadphase_body_indices;
+			Engine::Physics::dynamic_aabb_tree								m_broadphase_tree;
+			Engine::Physics::sweep_and_prune								m_broadphase_sap;
+			// Pairs of indices into broadphase body array.
+			std::vector<Engine::Physics::broadphase_pair>					m_broadphase_pairs;
+			// Contact pair keys of sweep-and-prune pair events, applied to the contact cache.
+			std::vector<Engine::Physics::contact_pair_key>					m_broadphase_event_keys;
+			Engine::Physics::narrowphase_context							m_narrowphase_context;
+
 			bool m_render_debug_face_mesh = false; 
 			bool m_render_debug_edge_mesh = true;
 			bool m_render_debug_bounding_volume = false;
@@ -63,16 +89,51 @@ namespace Component
 
 	public:
 
+		enum EBroadphaseMode : char { eAllPairs = 0, eDynamicAABBTree = 1, eSweepAndPrune = 2 };
+
+		// Wall-clock durations of the last intersection test.
+		struct intersection_timings
+		{
+			double broadphase_ms = 0.0;
+			double narrowphase_ms = 0.0;	// Includes storing contacts in global contact data.
+		};
+
 		manager_data m_data;
 
 		// Inherited via TCompManager
 		virtual const char* GetComponentTypeName() const override;
+		decltype(manager_data::m_entity_map)& GetComponentStorage() { return m_data.m_entity_map; }
 		void SetColliderResource(Entity _e, Engine::Managers::Resource _resource);
 
+		EBroadphaseMode GetBroadphaseMode() const { return m_broadphase_mode; }
+		void SetBroadphaseMode(EBroadphaseMode _mode);
+
+		bool GetParallelNarrowphase() const { return m_parallel_narrowphase; }
+		void SetParallelNarrowphase(bool _parallel) { m_parallel_narrowphase = _parallel; }
+
+		/*
+		* Debug meshes of convex hulls are graphics resources. Disable before loading a scene to
+		* run collision detection without a graphics context (e.g. headless benchmarks).
+		*/
+		bool GetCreateDebugMeshes() const { return m_create_debug_meshes; }
+		void SetCreateDebugMeshes(bool _create) { m_create_debug_meshes = _create; }
+
+		intersection_timings const& GetLastTimings() const { return m_last_timings; }
+
 		void TestColliderIntersections();
 
 	private:
 
+		EBroadphaseMode m_broadphase_mode = eDynamicAABBTree;
+		bool m_parallel_narrowphase = true;
+		bool m_create_debug_meshes = true;
+		intersection_timings m_last_timings;
+
+		void update_broadphase_bodies();
+		void remove_broadphase_body(Entity _e);
+		void compute_broadphase_pairs();
+		void apply_broadphase_pair_events(size_t _first_added_event, size_t _first_removed_event);
+
 		virtual void impl_clear() override;
 		virtual bool impl_create(Entity _e) override;
 		virtual void impl_destroy(Entity const* _entities, unsigned int _count) override;
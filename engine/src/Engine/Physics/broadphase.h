@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+namespace Engine {
+namespace Physics {
+
+	/*
+	* @brief
+	* Pair of user values whose bounding volumes overlap in the broadphase.
+	* The first value is always smaller than the second value.
+	*/
+	using broadphase_pair = std::pair<uint32_t, uint32_t>;
+
+	/*
+	* @brief
+	* Handle to an object stored in a broadphase structure.
+	*/
+	typedef int32_t broadphase_proxy;
+
+	constexpr broadphase_proxy NULL_BROADPHASE_PROXY = -1;
+
+}
+}
@@ -3,6 +3,8 @@
 #include <glm/vec3.hpp>
 #include <engine/Components/Rigidbody.h>
 #include <vector>
+#include <unordered_map>
+#include <algorithm>
 
 namespace Engine {
 namespace Physics {
@@ -22,8 +24,8 @@ namespace Physics {
 	*/
 	struct contact_identifier
 	{
-		uint16_t entity_id_1;
-		uint16_t entity_id_2;
+		uint32_t entity_id_1;
+		uint32_t entity_id_2;
 		uint16_t edge_index_1;
 		uint16_t edge_index_2;
 
@@ -42,14 +44,15 @@ namespace Physics {
 
 	using rigidbody_pair = std::pair<Component::RigidBody, Component::RigidBody>;
 
-	struct rigidbody_pair_hash
+	// Identifies a pair of colliding entities independently of their order in a manifold.
+	typedef uint64_t contact_pair_key;
+
+	inline contact_pair_key make_contact_pair_key(Engine::ECS::Entity _e1, Engine::ECS::Entity _e2)
 	{
-		std::size_t operator()(rigidbody_pair pair) const noexcept {
-			using namespace Engine::ECS;
-			std::hash<uint16_t> hasher;
-			return hasher(pair.first.Owner().ID()) ^ hasher(pair.second.Owner().ID());
-		}
-	};
+		uint64_t const lo = std::min(_e1.m_data, _e2.m_data);
+		uint64_t const hi = std::max(_e1.m_data, _e2.m_data);
+		return (lo << 32) | hi;
+	}
 
 	struct contact_manifold_data
 	{
@@ -61,6 +64,7 @@ namespace Physics {
 	struct contact_manifold
 	{
 		rigidbody_pair			rigidbodies;
+		contact_pair_key		pair_key;				// Stable identity of pair, used for contact caching.
 		//Component::RigidBody	rigidbody_A;			// Rigidbody creating point
 		//Component::RigidBody	rigidbody_B;			// Rigidbody creating normal (reference face object)
 		contact_manifold_data	data;
@@ -82,20 +86,55 @@ namespace Physics {
 
 	struct contact_cache
 	{
-		std::unordered_map<
-			rigidbody_pair, 
-			contact_manifold_data,
-			rigidbody_pair_hash
-		>								manifolds;
+		// Sorted by pair key. Buffers keep their capacity between steps.
+		std::vector<std::pair<
+			contact_pair_key,
+			contact_manifold_data
+		>>								manifolds;
 		std::vector<contact_identifier>	identifiers;
 		std::vector<contact_lambdas>	lambdas;
 
-		bool find_cached_pair_manifold_data(rigidbody_pair _pair, contact_manifold_data & _out_data) const {
-			auto iter = manifolds.find(_pair);
-			bool result = (iter != manifolds.end());
+		// Whether manifold entries are created and evicted by broadphase pair events (sweep-and-prune).
+		// Entries then persist while their pair overlaps, and resolution only replaces their contacts.
+		// Otherwise entries are rebuilt from the manifolds of every resolution.
+		bool							tracks_broadphase_pairs = false;
+
+		bool find_cached_pair_manifold_data(contact_pair_key _pair_key, contact_manifold_data & _out_data) const {
+			auto iter = find_pair(manifolds, _pair_key);
+			bool result = (iter != manifolds.end() && iter->first == _pair_key && iter->second.contact_count != 0);
 			if (result) _out_data = iter->second;
 			return result;
 		}
+
+		// Create empty entries for pairs that started overlapping. Sorts the keys, keys of existing entries are ignored.
+		void add_pairs(std::vector<contact_pair_key>& _pair_keys) {
+			std::sort(_pair_keys.begin(), _pair_keys.end());
+			size_t const existing_count = manifolds.size();
+			for (contact_pair_key const key : _pair_keys)
+				manifolds.emplace_back(key, contact_manifold_data{});
+			// Merge is stable, so existing entries are placed before new entries of the same pair and kept.
+			auto const key_less = [](auto const& _lhs, auto const& _rhs) { return _lhs.first < _rhs.first; };
+			std::inplace_merge(manifolds.begin(), manifolds.begin() + existing_count, manifolds.end(), key_less);
+			manifolds.erase(std::unique(manifolds.begin(), manifolds.end(),
+				[](auto const& _lhs, auto const& _rhs) { return _lhs.first == _rhs.first; }), manifolds.end());
+		}
+
+		// Evict entries of pairs that stopped overlapping. Sorts the keys.
+		void evict_pairs(std::vector<contact_pair_key>& _pair_keys) {
+			std::sort(_pair_keys.begin(), _pair_keys.end());
+			manifolds.erase(std::remove_if(manifolds.begin(), manifolds.end(),
+				[&_pair_keys](auto const& _entry) { return std::binary_search(_pair_keys.begin(), _pair_keys.end(), _entry.first); }), manifolds.end());
+		}
+
+		void clear() { manifolds.clear(); identifiers.clear(); lambdas.clear(); }
+
+	private:
+
+		template<typename TManifolds>
+		static auto find_pair(TManifolds& _manifolds, contact_pair_key _pair_key) {
+			return std::lower_bound(_manifolds.begin(), _manifolds.end(), _pair_key,
+				[](auto const& _entry, contact_pair_key _key) { return _entry.first < _key; });
+		}
 	};
 
 	struct global_contact_data
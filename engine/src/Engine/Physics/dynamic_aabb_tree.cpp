@@ -0,0 +1,387 @@
+#include "dynamic_aabb_tree.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Engine {
+namespace Physics {
+
+	/*
+	* @brief	Create a proxy for a bounding volume and insert it in the tree.
+	* @param	aabb		Tight bounding volume of object
+	* @param	uint32_t	User value returned in computed pairs
+	* @return	proxy_id	Handle used to move or destroy the proxy.
+	*/
+	dynamic_aabb_tree::proxy_id dynamic_aabb_tree::create_proxy(Math::aabb const& _bounds, uint32_t _user_data)
+	{
+		proxy_id const leaf = allocate_node();
+		m_nodes[leaf].bounds = fatten(_bounds);
+		m_nodes[leaf].user_data = _user_data;
+		m_nodes[leaf].height = 0;
+		insert_leaf(leaf);
+		m_proxy_count++;
+		return leaf;
+	}
+
+	void dynamic_aabb_tree::destroy_proxy(proxy_id _proxy)
+	{
+		assert(_proxy >= 0 && _proxy < (proxy_id)m_nodes.size() && m_nodes[_proxy].is_leaf());
+		remove_leaf(_proxy);
+		free_node(_proxy);
+		m_proxy_count--;
+	}
+
+	/*
+	* @brief	Update bounding volume of proxy.
+	* @param	proxy_id	Proxy to move
+	* @param	aabb		New tight bounding volume of object
+	* @return	bool		True if the proxy had to be re-inserted.
+	* @details	Proxy is only re-inserted if the tight bounding volume left the fattened
+	*			bounding volume, or if the fattened bounding volume has become much larger
+	*			than necessary (i.e. object shrunk or teleported into its old volume).
+	*/
+	bool dynamic_aabb_tree::move_proxy(proxy_id _proxy, Math::aabb const& _bounds)
+	{
+		assert(_proxy >= 0 && _proxy < (proxy_id)m_nodes.size() && m_nodes[_proxy].is_leaf());
+
+		Math::aabb const& fat_bounds = m_nodes[_proxy].bounds;
+		Math::aabb const new_fat_bounds = fatten(_bounds);
+		bool const contained = Math::contains_aabb_aabb(fat_bounds, _bounds);
+		bool const oversized = Math::compute_aabb_surface_area(fat_bounds) > 4.0f * Math::compute_aabb_surface_area(new_fat_bounds);
+		if (contained && !oversized)
+			return false;
+
+		remove_leaf(_proxy);
+		m_nodes[_proxy].bounds = new_fat_bounds;
+		insert_leaf(_proxy);
+		return true;
+	}
+
+	void dynamic_aabb_tree::clear()
+	{
+		m_nodes.clear();
+		m_root = NULL_NODE;
+		m_free_list = NULL_NODE;
+		m_proxy_count = 0;
+	}
+
+	/*
+	* @brief	Compute all unique pairs of proxies whose fattened bounding volumes overlap.
+	* @param	std::vector<broadphase_pair> &	Output pairs of user values, sorted in ascending order.
+	*/
+	void dynamic_aabb_tree::compute_pairs(std::vector<broadphase_pair>& _out_pairs) const
+	{
+		_out_pairs.clear();
+
+		std::vector<proxy_id> stack;
+		stack.reserve(64);
+		for (proxy_id leaf = 0; leaf < (proxy_id)m_nodes.size(); leaf++)
+		{
+			// Only allocated leaves have a height of zero.
+			if (m_nodes[leaf].height != 0)
+				continue;
+
+			uint32_t const leaf_user_data = m_nodes[leaf].user_data;
+			auto add_pair = [&](proxy_id _other) -> bool
+			{
+				// Only report pair once, from the proxy with the smallest ID.
+				if (_other > leaf)
+				{
+					uint32_t const other_user_data = m_nodes[_other].user_data;
+					_out_pairs.emplace_back(
+						std::min(leaf_user_data, other_user_data),
+						std::max(leaf_user_data, other_user_data)
+					);
+				}
+				return true;
+			};
+			query_impl(m_nodes[leaf].bounds, stack, add_pair);
+		}
+
+		// Sort such that pair order does not depend on tree layout.
+		std::sort(_out_pairs.begin(), _out_pairs.end());
+	}
+
+	dynamic_aabb_tree::proxy_id dynamic_aabb_tree::allocate_node()
+	{
+		proxy_id node_id;
+		if (m_free_list != NULL_NODE)
+		{
+			node_id = m_free_list;
+			m_free_list = m_nodes[node_id].parent;
+		}
+		else
+		{
+			node_id = (proxy_id)m_nodes.size();
+			m_nodes.emplace_back();
+		}
+
+		tree_node& node = m_nodes[node_id];
+		node.parent = NULL_NODE;
+		node.child1 = NULL_NODE;
+		node.child2 = NULL_NODE;
+		node.height = 0;
+		node.user_data = 0;
+		return node_id;
+	}
+
+	void dynamic_aabb_tree::free_node(proxy_id _node)
+	{
+		m_nodes[_node].parent = m_free_list;
+		m_nodes[_node].height = -1;
+		m_free_list = _node;
+	}
+
+	void dynamic_aabb_tree::insert_leaf(proxy_id _leaf)
+	{
+		if (m_root == NULL_NODE)
+		{
+			m_root = _leaf;
+			m_nodes[_leaf].parent = NULL_NODE;
+			return;
+		}
+
+		// Find best sibling for leaf using the surface area heuristic.
+		Math::aabb const leaf_bounds = m_nodes[_leaf].bounds;
+		proxy_id index = m_root;
+		while (!m_nodes[index].is_leaf())
+		{
+			tree_node const& node = m_nodes[index];
+
+			float const area = Math::compute_aabb_surface_area(node.bounds);
+			float const combined_area = Math::compute_aabb_surface_area(Math::create_aabb_encapsulating_aabbs(node.bounds, leaf_bounds));
+
+			// Cost of creating a new parent for this node and the new leaf.
+			float const cost = 2.0f * combined_area;
+			// Minimum cost of pushing the leaf further down the tree.
+			float const inheritance_cost = 2.0f * (combined_area - area);
+
+			auto descend_cost = [&](proxy_id _child) -> float
+			{
+				tree_node const& child = m_nodes[_child];
+				float const merged_area = Math::compute_aabb_surface_area(Math::create_aabb_encapsulating_aabbs(child.bounds, leaf_bounds));
+				if (child.is_leaf())
+					return merged_area + inheritance_cost;
+				else
+					return (merged_area - Math::compute_aabb_surface_area(child.bounds)) + inheritance_cost;
+			};
+
+			float const cost1 = descend_cost(node.child1);
+			float const cost2 = descend_cost(node.child2);
+
+			if (cost < cost1 && cost < cost2)
+				break;
+
+			index = (cost1 < cost2) ? node.child1 : node.child2;
+		}
+
+		proxy_id const sibling = index;
+
+		// Create new parent for sibling and leaf.
+		// (Allocation may invalidate node references, so only refer to nodes by index here)
+		proxy_id const new_parent = allocate_node();
+		proxy_id const old_parent = m_nodes[sibling].parent;
+		m_nodes[new_parent].parent = old_parent;
+		m_nodes[new_parent].bounds = Math::create_aabb_encapsulating_aabbs(leaf_bounds, m_nodes[sibling].bounds);
+		m_nodes[new_parent].height = m_nodes[sibling].height + 1;
+		m_nodes[new_parent].child1 = sibling;
+		m_nodes[new_parent].child2 = _leaf;
+		m_nodes[sibling].parent = new_parent;
+		m_nodes[_leaf].parent = new_parent;
+
+		if (old_parent != NULL_NODE)
+		{
+			if (m_nodes[old_parent].child1 == sibling)
+				m_nodes[old_parent].child1 = new_parent;
+			else
+				m_nodes[old_parent].child2 = new_parent;
+		}
+		else
+			m_root = new_parent;
+
+		refit_ancestors(m_nodes[_leaf].parent);
+	}
+
+	void dynamic_aabb_tree::remove_leaf(proxy_id _leaf)
+	{
+		if (_leaf == m_root)
+		{
+			m_root = NULL_NODE;
+			return;
+		}
+
+		proxy_id const parent = m_nodes[_leaf].parent;
+		proxy_id const grand_parent = m_nodes[parent].parent;
+		proxy_id const sibling = (m_nodes[parent].child1 == _leaf) ? m_nodes[parent].child2 : m_nodes[parent].child1;
+
+		// Replace parent with sibling.
+		if (grand_parent != NULL_NODE)
+		{
+			if (m_nodes[grand_parent].child1 == parent)
+				m_nodes[grand_parent].child1 = sibling;
+			else
+				m_nodes[grand_parent].child2 = sibling;
+			m_nodes[sibling].parent = grand_parent;
+			free_node(parent);
+
+			refit_ancestors(grand_parent);
+		}
+		else
+		{
+			m_root = sibling;
+			m_nodes[sibling].parent = NULL_NODE;
+			free_node(parent);
+		}
+
+		m_nodes[_leaf].parent = NULL_NODE;
+	}
+
+	/*
+	* @brief	Walk up the tree from given node, balancing and recomputing bounds and heights.
+	* @param	proxy_id	First (internal) node to refit.
+	*/
+	void dynamic_aabb_tree::refit_ancestors(proxy_id _node)
+	{
+		proxy_id index = _node;
+		while (index != NULL_NODE)
+		{
+			index = balance(index);
+
+			tree_node& node = m_nodes[index];
+			tree_node const& child1 = m_nodes[node.child1];
+			tree_node const& child2 = m_nodes[node.child2];
+			node.height = 1 + std::max(child1.height, child2.height);
+			node.bounds = Math::create_aabb_encapsulating_aabbs(child1.bounds, child2.bounds);
+
+			index = node.parent;
+		}
+	}
+
+	/*
+	* @brief	Perform left or right rotation if node is imbalanced.
+	* @param	proxy_id	Node to balance
+	* @return	proxy_id	Node that took the place of the input node in the tree.
+	*/
+	dynamic_aabb_tree::proxy_id dynamic_aabb_tree::balance(proxy_id _node)
+	{
+		proxy_id const iA = _node;
+		tree_node& A = m_nodes[iA];
+		if (A.is_leaf() || A.height < 2)
+			return iA;
+
+		proxy_id const iB = A.child1;
+		proxy_id const iC = A.child2;
+		tree_node& B = m_nodes[iB];
+		tree_node& C = m_nodes[iC];
+
+		int32_t const balance_factor = C.height - B.height;
+
+		// Rotate C up
+		if (balance_factor > 1)
+		{
+			proxy_id const iF = C.child1;
+			proxy_id const iG = C.child2;
+			tree_node& F = m_nodes[iF];
+			tree_node& G = m_nodes[iG];
+
+			// Swap A and C
+			C.child1 = iA;
+			C.parent = A.parent;
+			A.parent = iC;
+
+			// A's old parent should point to C
+			if (C.parent != NULL_NODE)
+			{
+				if (m_nodes[C.parent].child1 == iA)
+					m_nodes[C.parent].child1 = iC;
+				else
+					m_nodes[C.parent].child2 = iC;
+			}
+			else
+				m_root = iC;
+
+			// Rotate
+			if (F.height > G.height)
+			{
+				C.child2 = iF;
+				A.child2 = iG;
+				G.parent = iA;
+				A.bounds = Math::create_aabb_encapsulating_aabbs(B.bounds, G.bounds);
+				C.bounds = Math::create_aabb_encapsulating_aabbs(A.bounds, F.bounds);
+				A.height = 1 + std::max(B.height, G.height);
+				C.height = 1 + std::max(A.height, F.height);
+			}
+			else
+			{
+				C.child2 = iG;
+				A.child2 = iF;
+				F.parent = iA;
+				A.bounds = Math::create_aabb_encapsulating_aabbs(B.bounds, F.bounds);
+				C.bounds = Math::create_aabb_encapsulating_aabbs(A.bounds, G.bounds);
+				A.height = 1 + std::max(B.height, F.height);
+				C.height = 1 + std::max(A.height, G.height);
+			}
+
+			return iC;
+		}
+
+		// Rotate B up
+		if (balance_factor < -1)
+		{
+			proxy_id const iD = B.child1;
+			proxy_id const iE = B.child2;
+			tree_node& D = m_nodes[iD];
+			tree_node& E = m_nodes[iE];
+
+			// Swap A and B
+			B.child1 = iA;
+			B.parent = A.parent;
+			A.parent = iB;
+
+			// A's old parent should point to B
+			if (B.parent != NULL_NODE)
+			{
+				if (m_nodes[B.parent].child1 == iA)
+					m_nodes[B.parent].child1 = iB;
+				else
+					m_nodes[B.parent].child2 = iB;
+			}
+			else
+				m_root = iB;
+
+			// Rotate
+			if (D.height > E.height)
+			{
+				B.child2 = iD;
+				A.child1 = iE;
+				E.parent = iA;
+				A.bounds = Math::create_aabb_encapsulating_aabbs(C.bounds, E.bounds);
+				B.bounds = Math::create_aabb_encapsulating_aabbs(A.bounds, D.bounds);
+				A.height = 1 + std::max(C.height, E.height);
+				B.height = 1 + std::max(A.height, D.height);
+			}
+			else
+			{
+				B.child2 = iE;
+				A.child1 = iD;
+				D.parent = iA;
+				A.bounds = Math::create_aabb_encapsulating_aabbs(C.bounds, D.bounds);
+				B.bounds = Math::create_aabb_encapsulating_aabbs(A.bounds, E.bounds);
+				A.height = 1 + std::max(C.height, D.height);
+				B.height = 1 + std::max(A.height, E.height);
+			}
+
+			return iB;
+		}
+
+		return iA;
+	}
+
+	Math::aabb dynamic_aabb_tree::fatten(Math::aabb _bounds) const
+	{
+		_bounds.extent += glm::vec3(m_fat_margin);
+		return _bounds;
+	}
+
+}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "broadphase.h"
+
+#include <Engine/Math/geometry.hpp>
+#include <Engine/Math/geometry_intersection.hpp>
+
+#include <vector>
+
+namespace Engine {
+namespace Physics {
+
+	/*
+	* @brief	Bounding volume hierarchy of fattened AABBs used for broadphase collision detection.
+	* @details	Leaves store a bounding volume that is fattened by a margin. Moving a proxy only
+	*			re-inserts its leaf when the new bounding volume leaves the fattened bounding volume,
+	*			so temporally coherent scenes mostly leave the tree untouched.
+	*			Insertion uses the surface area heuristic, and the tree is kept balanced using
+	*			tree rotations when ancestors are refit.
+	*/
+	struct dynamic_aabb_tree
+	{
+		typedef broadphase_proxy proxy_id;
+
+		static constexpr proxy_id NULL_NODE = NULL_BROADPHASE_PROXY;
+
+		// Margin that is added to each side of the bounding volume of a proxy.
+		float		m_fat_margin = 0.1f;
+
+		proxy_id	create_proxy(Math::aabb const& _bounds, uint32_t _user_data);
+		void		destroy_proxy(proxy_id _proxy);
+		bool		move_proxy(proxy_id _proxy, Math::aabb const& _bounds);
+		void		clear();
+
+		uint32_t			get_user_data(proxy_id _proxy) const { return m_nodes[_proxy].user_data; }
+		void				set_user_data(proxy_id _proxy, uint32_t _user_data) { m_nodes[_proxy].user_data = _user_data; }
+		Math::aabb const&	get_fat_bounds(proxy_id _proxy) const { return m_nodes[_proxy].bounds; }
+		size_t				proxy_count() const { return m_proxy_count; }
+		int32_t				height() const { return m_root == NULL_NODE ? 0 : m_nodes[m_root].height; }
+
+		/*
+		* @brief	Invoke callback for every proxy whose fattened bounding volume overlaps input volume.
+		* @param	aabb		Volume to query
+		* @param	TCallback	bool(proxy_id). Return false to stop the query.
+		*/
+		template<typename TCallback>
+		void query(Math::aabb const& _bounds, TCallback&& _callback) const
+		{
+			std::vector<proxy_id> stack;
+			query_impl(_bounds, stack, _callback);
+		}
+
+		void compute_pairs(std::vector<broadphase_pair>& _out_pairs) const;
+
+	private:
+
+		struct tree_node
+		{
+			Math::aabb	bounds;
+			uint32_t	user_data = 0;
+			proxy_id	parent = NULL_NODE;	// Next free node if node is in free list.
+			proxy_id	child1 = NULL_NODE;
+			proxy_id	child2 = NULL_NODE;
+			int32_t		height = -1;		// Leaf = 0, free node = -1
+
+			bool is_leaf() const { return child1 == NULL_NODE; }
+		};
+
+		std::vector<tree_node>	m_nodes;
+		proxy_id				m_root = NULL_NODE;
+		proxy_id				m_free_list = NULL_NODE;
+		size_t					m_proxy_count = 0;
+
+		proxy_id	allocate_node();
+		void		free_node(proxy_id _node);
+		void		insert_leaf(proxy_id _leaf);
+		void		remove_leaf(proxy_id _leaf);
+		void		refit_ancestors(proxy_id _node);
+		proxy_id	balance(proxy_id _node);
+		Math::aabb	fatten(Math::aabb _bounds) const;
+
+		template<typename TCallback>
+		void query_impl(Math::aabb const& _bounds, std::vector<proxy_id>& _stack, TCallback& _callback) const
+		{
+			if (m_root == NULL_NODE)
+				return;
+
+			_stack.clear();
+			_stack.push_back(m_root);
+			while (!_stack.empty())
+			{
+				proxy_id const node_id = _stack.back();
+				_stack.pop_back();
+
+				tree_node const& node = m_nodes[node_id];
+				if (!Math::intersect_aabb_aabb(node.bounds, _bounds))
+					continue;
+
+				if (node.is_leaf())
+				{
+					if (!_callback(node_id))
+						return;
+				}
+				else
+				{
+					_stack.push_back(node.child1);
+					_stack.push_back(node.child2);
+				}
+			}
+		}
+	};
+
+}
+}
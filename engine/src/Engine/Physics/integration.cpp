@@ -1,4 +1,5 @@
 #include "integration.h"
+#include "integration_simd.hpp"
 #include <glm/gtx/matrix_cross_product.hpp>
 
 namespace Engine {
@@ -10,12 +11,23 @@ namespace Physics {
 		glm::vec3 * _linear_momentums,
 		glm::vec3 const* _forces,
 		float const* _inv_masses,
-		size_t const _count)
+		size_t const _count,
+		Math::ESIMDLevel const _simd_level)
 	{
-		for (size_t i = 0; i < _count; i++)
+		// Integrate packs of bodies with the widest kernel, and the remainder with scalar code.
+		size_t first = 0;
+#if defined(ENGINE_SIMD_AVX2_KERNELS)
+		if (_simd_level >= Math::eAVX2 && Math::get_supported_simd_level() >= Math::eAVX2)
+			first = integrate_linear_euler_avx2(_dt, _positions, _linear_momentums, _forces, _inv_masses, _count);
+		else
+#endif
+		if (_simd_level >= Math::eSSE)
+			first = integrate_linear_euler_lanes(_dt, _positions, _linear_momentums, _forces, _inv_masses, _count);
+
+		for (size_t i = first; i < _count; i++)
 		{
 			_linear_momentums[i] += _forces[i] * _dt;
-			_positions[i] += _linear_momentums[i] * _inv_masses[i] * _dt;
+			_positions[i] += _linear_momentums[i] * (_inv_masses[i] * _dt);
 		}
 	}
 
@@ -25,6 +37,37 @@ namespace Physics {
 		glm::vec3* _angular_moments, 
 		glm::vec3 const* _torques, 
 		glm::mat3 const* _inv_inertial_tensors,
+		glm::mat3* _inv_world_tensors,
+		size_t const _count,
+		Math::ESIMDLevel const _simd_level
+	)
+	{
+		size_t first = 0;
+#if defined(ENGINE_SIMD_AVX2_KERNELS)
+		if (_simd_level >= Math::eAVX2 && Math::get_supported_simd_level() >= Math::eAVX2)
+			first = integrate_angular_euler_avx2(_dt, _rotations, _angular_moments, _torques, _inv_inertial_tensors, _inv_world_tensors, _count);
+		else
+#endif
+		if (_simd_level >= Math::eSSE)
+			first = integrate_angular_euler_lanes(_dt, _rotations, _angular_moments, _torques, _inv_inertial_tensors, _inv_world_tensors, _count);
+
+		for (size_t i = first; i < _count; i++)
+		{
+			_angular_moments[i] += _torques[i] * _dt;
+
+			// World tensor is cached for the rotation at the start of the step.
+			glm::vec3 const omega = _inv_world_tensors[i] * _angular_moments[i];
+			glm::quat const q_dot = 0.5f * glm::quat(0.0f, omega.x, omega.y, omega.z) * _rotations[i];
+			_rotations[i] = glm::normalize(_rotations[i] + q_dot * _dt);
+
+			compute_inv_world_tensors(&_rotations[i], &_inv_inertial_tensors[i], &_inv_world_tensors[i], 1);
+		}
+	}
+
+	void compute_inv_world_tensors(
+		glm::quat const* _rotations,
+		glm::mat3 const* _inv_inertial_tensors,
+		glm::mat3* _out_inv_world_tensors,
 		size_t const _count
 	)
 	{
@@ -35,15 +78,9 @@ namespace Physics {
 			// Use inverse = transpose property of orthonormal rotation matrices.
 			glm::mat3 const inv_rot_mat = glm::transpose(rot_mat);
 
-			glm::mat3 const world_inv_tensor = rot_mat * _inv_inertial_tensors[i] * inv_rot_mat;
-
-			_angular_moments[i] += _torques[i] * _dt;
-
-			glm::vec3 const omega = world_inv_tensor * _angular_moments[i];
-			glm::quat const q_dot = 0.5f * glm::quat(0.0f, omega.x, omega.y, omega.z) * _rotations[i];
-			_rotations[i] = glm::normalize(_rotations[i] + q_dot * _dt);
+			_out_inv_world_tensors[i] = rot_mat * _inv_inertial_tensors[i] * inv_rot_mat;
 		}
 	}
 
 }
-}
\ No newline at end of file
+}
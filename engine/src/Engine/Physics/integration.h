@@ -4,9 +4,17 @@
 #include <glm/mat3x3.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include <Engine/Math/simd.hpp>
+
 namespace Engine {
 namespace Physics {
 
+	/*
+	* @brief	Integrate linear momentum and position of bodies with explicit Euler.
+	* @param	ESIMDLevel		Widest kernel to use. Defaults to the widest one supported by the CPU.
+	* @details	Bodies are integrated in SIMD lanes, the remainder that does not fill a lane pack is
+	*			integrated with scalar code.
+	*/
 	void integrate_linear_euler(
 		float const _dt,
  
@@ -15,16 +23,35 @@ namespace Physics {
 		glm::vec3 const * _forces,
 
 		float const * _inv_masses,
-		size_t const _count
+		size_t const _count,
+		Math::ESIMDLevel const _simd_level = Math::get_supported_simd_level()
 	);
 
+	/*
+	* @brief	Integrate angular momentum and rotation of bodies with explicit Euler.
+	* @param	glm::mat3 *		World inverse inertia tensors. Read for the rotation at the start of
+	*							the step, and overwritten with the tensor of the integrated rotation.
+	* @param	ESIMDLevel		Widest kernel to use. Defaults to the widest one supported by the CPU.
+	*/
 	void integrate_angular_euler(
 		float const _dt,
 		glm::quat * _rotations,
 		glm::vec3 * _angular_moments,
 		glm::vec3 const * _torques,
 		glm::mat3 const * _inv_inertial_tensors,
+		glm::mat3 * _inv_world_tensors,
+		size_t const _count,
+		Math::ESIMDLevel const _simd_level = Math::get_supported_simd_level()
+	);
+
+	/*
+	* @brief	Compute world inverse inertia tensors R * I^-1 * R^T of bodies.
+	*/
+	void compute_inv_world_tensors(
+		glm::quat const * _rotations,
+		glm::mat3 const * _inv_inertial_tensors,
+		glm::mat3 * _out_inv_world_tensors,
 		size_t const _count
 	);
 }
-}
\ No newline at end of file
+}
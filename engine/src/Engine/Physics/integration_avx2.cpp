@@ -0,0 +1,38 @@
+// Compiled with AVX2 flags when ENGINE_SIMD_AVX2_KERNELS is defined, see engine/CMakeLists.txt.
+// Kernels are only called after checking CPU support at runtime.
+#if defined(ENGINE_SIMD_AVX2_KERNELS) && defined(__AVX2__)
+
+#include "integration_simd.hpp"
+
+namespace Engine {
+namespace Physics {
+
+	size_t integrate_linear_euler_avx2(
+		float const _dt,
+		glm::vec3* _positions,
+		glm::vec3* _linear_momentums,
+		glm::vec3 const* _forces,
+		float const* _inv_masses,
+		size_t const _count
+	)
+	{
+		return integrate_linear_euler_lanes(_dt, _positions, _linear_momentums, _forces, _inv_masses, _count);
+	}
+
+	size_t integrate_angular_euler_avx2(
+		float const _dt,
+		glm::quat* _rotations,
+		glm::vec3* _angular_moments,
+		glm::vec3 const* _torques,
+		glm::mat3 const* _inv_inertial_tensors,
+		glm::mat3* _inv_world_tensors,
+		size_t const _count
+	)
+	{
+		return integrate_angular_euler_lanes(_dt, _rotations, _angular_moments, _torques, _inv_inertial_tensors, _inv_world_tensors, _count);
+	}
+
+}
+}
+
+#endif
@@ -0,0 +1,147 @@
+#pragma once
+
+/*
+* SIMD integration kernels, compiled once per instruction set by including this header from a
+* translation unit with the matching compiler flags. Kernels have internal linkage and only access
+* glm types through their data members, such that no glm function is instantiated with wider
+* instructions than the rest of the build.
+*/
+
+#include <glm/vec3.hpp>
+#include <glm/mat3x3.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <Engine/Math/simd.hpp>
+
+namespace Engine {
+namespace Physics {
+
+	static inline Math::simd_quat load_quat_lanes(glm::quat const* _src)
+	{
+		size_t constexpr WIDTH = Math::simd_float::WIDTH;
+		alignas(32) float lanes[4][WIDTH];
+		for (size_t lane = 0; lane < WIDTH; lane++)
+		{
+			lanes[0][lane] = _src[lane].w;
+			lanes[1][lane] = _src[lane].x;
+			lanes[2][lane] = _src[lane].y;
+			lanes[3][lane] = _src[lane].z;
+		}
+		return {
+			Math::simd_float::load(lanes[0]), Math::simd_float::load(lanes[1]),
+			Math::simd_float::load(lanes[2]), Math::simd_float::load(lanes[3])
+		};
+	}
+
+	static inline void store_quat_lanes(Math::simd_quat const& _q, glm::quat* _dst)
+	{
+		size_t constexpr WIDTH = Math::simd_float::WIDTH;
+		alignas(32) float lanes[4][WIDTH];
+		_q.w.store(lanes[0]);
+		_q.x.store(lanes[1]);
+		_q.y.store(lanes[2]);
+		_q.z.store(lanes[3]);
+		for (size_t lane = 0; lane < WIDTH; lane++)
+		{
+			_dst[lane].w = lanes[0][lane];
+			_dst[lane].x = lanes[1][lane];
+			_dst[lane].y = lanes[2][lane];
+			_dst[lane].z = lanes[3][lane];
+		}
+	}
+
+	/*
+	* @brief	Integrate bodies in packs of WIDTH lanes.
+	* @return	Number of bodies integrated, a multiple of WIDTH. The remainder is left to the caller.
+	*/
+	static inline size_t integrate_linear_euler_lanes(
+		float const _dt,
+		glm::vec3* _positions,
+		glm::vec3* _linear_momentums,
+		glm::vec3 const* _forces,
+		float const* _inv_masses,
+		size_t const _count
+	)
+	{
+		using namespace Math;
+		size_t constexpr WIDTH = simd_float::WIDTH;
+		size_t const lane_count = _count - _count % WIDTH;
+		simd_float const dt = simd_float::broadcast(_dt);
+
+		for (size_t i = 0; i < lane_count; i += WIDTH)
+		{
+			simd_vec3 momentum = simd_vec3::load_interleaved(&_linear_momentums[i].x);
+			simd_vec3 position = simd_vec3::load_interleaved(&_positions[i].x);
+			simd_vec3 const force = simd_vec3::load_interleaved(&_forces[i].x);
+			simd_float const inv_mass = simd_float::load(&_inv_masses[i]);
+
+			momentum = momentum + force * dt;
+			position = position + momentum * (inv_mass * dt);
+
+			momentum.store_interleaved(&_linear_momentums[i].x);
+			position.store_interleaved(&_positions[i].x);
+		}
+		return lane_count;
+	}
+
+	/*
+	* @brief	Integrate bodies in packs of WIDTH lanes.
+	* @return	Number of bodies integrated, a multiple of WIDTH. The remainder is left to the caller.
+	*/
+	static inline size_t integrate_angular_euler_lanes(
+		float const _dt,
+		glm::quat* _rotations,
+		glm::vec3* _angular_moments,
+		glm::vec3 const* _torques,
+		glm::mat3 const* _inv_inertial_tensors,
+		glm::mat3* _inv_world_tensors,
+		size_t const _count
+	)
+	{
+		using namespace Math;
+		size_t constexpr WIDTH = simd_float::WIDTH;
+		size_t const lane_count = _count - _count % WIDTH;
+		simd_float const dt = simd_float::broadcast(_dt);
+		simd_float const half_dt = simd_float::broadcast(0.5f * _dt);
+
+		for (size_t i = 0; i < lane_count; i += WIDTH)
+		{
+			simd_vec3 momentum = simd_vec3::load_interleaved(&_angular_moments[i].x);
+			momentum = momentum + simd_vec3::load_interleaved(&_torques[i].x) * dt;
+			momentum.store_interleaved(&_angular_moments[i].x);
+
+			simd_vec3 const omega = simd_mat3::load_interleaved(reinterpret_cast<float const*>(&_inv_world_tensors[i])) * momentum;
+
+			// q += 0.5 * (0, omega) * q * dt
+			simd_quat q = load_quat_lanes(&_rotations[i]);
+			simd_vec3 const v = { q.x, q.y, q.z };
+			simd_vec3 const v_dot = omega * q.w + cross(omega, v);
+			q.w = q.w - dot(omega, v) * half_dt;
+			q.x = q.x + v_dot.x * half_dt;
+			q.y = q.y + v_dot.y * half_dt;
+			q.z = q.z + v_dot.z * half_dt;
+			q = normalize(q);
+			store_quat_lanes(q, &_rotations[i]);
+
+			// Cache tensor of integrated rotation for the next step.
+			simd_mat3 const rot_mat = q.to_mat3();
+			simd_mat3 const inv_tensor = simd_mat3::load_interleaved(reinterpret_cast<float const*>(&_inv_inertial_tensors[i]));
+			(rot_mat * inv_tensor * rot_mat.transpose()).store_interleaved(reinterpret_cast<float*>(&_inv_world_tensors[i]));
+		}
+		return lane_count;
+	}
+
+#if defined(ENGINE_SIMD_AVX2_KERNELS)
+	// Defined in integration_avx2.cpp, which is compiled with AVX2 flags.
+	size_t integrate_linear_euler_avx2(
+		float const _dt, glm::vec3* _positions, glm::vec3* _linear_momentums,
+		glm::vec3 const* _forces, float const* _inv_masses, size_t const _count
+	);
+	size_t integrate_angular_euler_avx2(
+		float const _dt, glm::quat* _rotations, glm::vec3* _angular_moments, glm::vec3 const* _torques,
+		glm::mat3 const* _inv_inertial_tensors, glm::mat3* _inv_world_tensors, size_t const _count
+	);
+#endif
+
+}
+}
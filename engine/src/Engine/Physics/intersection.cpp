@@ -80,8 +80,8 @@ namespace Physics {
 	}
 
 	EIntersectionType intersect_convex_hulls_sat(
-		half_edge_data_structure const& _hull1, transform3D const & _transform1, uint16_t _entity_id_1, 
-		half_edge_data_structure const& _hull2, transform3D const & _transform2, uint16_t _entity_id_2,
+		half_edge_data_structure const& _hull1, transform3D const & _transform1, uint32_t _entity_id_1, 
+		half_edge_data_structure const& _hull2, transform3D const & _transform2, uint32_t _entity_id_2,
 		contact * _out_contacts, size_t * _out_contact_count, 
 		bool* _reference_is_hull1
 	)
@@ -284,8 +284,8 @@ namespace Physics {
 				}
 			}
 
-			uint16_t const reference_entity_id = _reference_is_hull1 ? _entity_id_1 : _entity_id_2;
-			uint16_t const incident_entity_id = !_reference_is_hull1 ? _entity_id_1 : _entity_id_2;
+			uint32_t const reference_entity_id = _reference_is_hull1 ? _entity_id_1 : _entity_id_2;
+			uint32_t const incident_entity_id = !_reference_is_hull1 ? _entity_id_1 : _entity_id_2;
 
 			// Copy vertices of current incident face to vector.
 			// Create list of contacts to clip.
@@ -0,0 +1,165 @@
+#include "islands.hpp"
+#include "resolution.hpp"
+
+#include <glm/gtx/norm.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace Engine {
+namespace Physics {
+
+	static uint32_t find_root(std::vector<uint32_t>& _parents, uint32_t _index)
+	{
+		while (_parents[_index] != _index)
+		{
+			// Path halving
+			_parents[_index] = _parents[_parents[_index]];
+			_index = _parents[_index];
+		}
+		return _index;
+	}
+
+	/*
+	* @brief	Wake up sleeping islands that are in contact with an awake body.
+	* @param	global_contact_data const &		Contacts found this frame
+	* @param	rigidbody_data_collection &		Rigidbodies
+	* @details	Narrowphase skips pairs of bodies that are both static or sleeping,
+	*			so any manifold with a sleeping body was caused by an awake body.
+	*/
+	void wake_contact_islands(
+		global_contact_data const& _global_contact_data,
+		Component::RigidBodyManager::rigidbody_data_collection& _rigidbodies
+	)
+	{
+		for (contact_manifold const& cm : _global_contact_data.all_contact_manifolds)
+		{
+			size_t const index_A = _rigidbodies.get_entity_index(cm.rigidbodies.first.Owner());
+			size_t const index_B = _rigidbodies.get_entity_index(cm.rigidbodies.second.Owner());
+			if (_rigidbodies.is_sleeping(index_A))
+				_rigidbodies.wake(index_A);
+			if (_rigidbodies.is_sleeping(index_B))
+				_rigidbodies.wake(index_B);
+		}
+	}
+
+	/*
+	* @brief	Build islands of awake bodies from contact manifolds, and put islands to sleep
+	*			whose bodies have all been under the sleep velocity thresholds for long enough.
+	* @param	global_contact_data const &		Contacts found this frame
+	* @param	physics_simulation_parameters	Parameters of simulation
+	* @param	rigidbody_data_collection &		Rigidbodies
+	* @param	simulation_islands &			Island buffers, and statistics of last update.
+	*/
+	void update_simulation_islands(
+		global_contact_data const& _global_contact_data,
+		physics_simulation_parameters const& _parameters,
+		Component::RigidBodyManager::rigidbody_data_collection& _rigidbodies,
+		simulation_islands& _islands
+	)
+	{
+		size_t const rigidbody_count = _rigidbodies.size();
+		_islands.island_count = 0;
+		_islands.sleeping_body_count = 0;
+
+		if (!_parameters.sleeping)
+		{
+			_rigidbodies.wake_all();
+			return;
+		}
+
+		auto is_dynamic_awake = [&](size_t _index)
+		{
+			return _rigidbodies.m_inv_masses[_index] > 0.0f && !_rigidbodies.is_sleeping(_index);
+		};
+
+		// Update how long each awake body has been slow enough to sleep.
+		float const linear_threshold_sq = _parameters.sleep_linear_velocity * _parameters.sleep_linear_velocity;
+		float const angular_threshold_sq = _parameters.sleep_angular_velocity * _parameters.sleep_angular_velocity;
+		for (size_t i = 0; i < rigidbody_count; i++)
+		{
+			if (!is_dynamic_awake(i))
+				continue;
+
+			glm::vec3 const linear_velocity = _rigidbodies.m_linear_momentums[i] * _rigidbodies.m_inv_masses[i];
+			glm::vec3 const angular_velocity = _rigidbodies.m_inv_world_tensors[i] * _rigidbodies.m_angular_momentums[i];
+
+			uint16_t& timer = _rigidbodies.m_sleep_timers[i];
+			if (glm::length2(linear_velocity) < linear_threshold_sq && glm::length2(angular_velocity) < angular_threshold_sq)
+				timer = (uint16_t)std::min<uint32_t>(timer + 1u, std::numeric_limits<uint16_t>::max());
+			else
+				timer = 0;
+		}
+
+		// Union bodies connected by contact manifolds.
+		auto& parents = _islands.parents;
+		parents.resize(rigidbody_count);
+		for (uint32_t i = 0; i < (uint32_t)rigidbody_count; i++)
+			parents[i] = i;
+
+		for (contact_manifold const& cm : _global_contact_data.all_contact_manifolds)
+		{
+			uint32_t const index_A = (uint32_t)_rigidbodies.get_entity_index(cm.rigidbodies.first.Owner());
+			uint32_t const index_B = (uint32_t)_rigidbodies.get_entity_index(cm.rigidbodies.second.Owner());
+			if (!is_dynamic_awake(index_A) || !is_dynamic_awake(index_B))
+				continue;
+
+			uint32_t const root_A = find_root(parents, index_A);
+			uint32_t const root_B = find_root(parents, index_B);
+			if (root_A != root_B)
+				parents[std::max(root_A, root_B)] = std::min(root_A, root_B);
+		}
+
+		// Find smallest sleep timer and body count of every island, and sort bodies by island.
+		auto& min_sleep_timers = _islands.min_sleep_timers;
+		auto& island_offsets = _islands.island_offsets;
+		auto& island_bodies = _islands.island_bodies;
+		min_sleep_timers.assign(rigidbody_count, std::numeric_limits<uint16_t>::max());
+		island_offsets.assign(rigidbody_count + 1, 0);
+		for (uint32_t i = 0; i < (uint32_t)rigidbody_count; i++)
+		{
+			if (!is_dynamic_awake(i))
+				continue;
+
+			uint32_t const root = find_root(parents, i);
+			min_sleep_timers[root] = std::min(min_sleep_timers[root], _rigidbodies.m_sleep_timers[i]);
+			island_offsets[root + 1]++;
+			if (root == i)
+				_islands.island_count++;
+		}
+		for (size_t i = 0; i < rigidbody_count; i++)
+			island_offsets[i + 1] += island_offsets[i];
+
+		island_bodies.resize(island_offsets[rigidbody_count]);
+		for (uint32_t i = 0; i < (uint32_t)rigidbody_count; i++)
+		{
+			if (is_dynamic_awake(i))
+				island_bodies[island_offsets[find_root(parents, i)]++] = i;
+		}
+		// Offsets now point to the end of each island, so shift them back.
+		for (size_t i = rigidbody_count; i > 0; i--)
+			island_offsets[i] = island_offsets[i - 1];
+		island_offsets[0] = 0;
+
+		// Put islands to sleep once all of their bodies are resting.
+		for (uint32_t root = 0; root < (uint32_t)rigidbody_count; root++)
+		{
+			if (!is_dynamic_awake(root) || parents[root] != root)
+				continue;
+			if (min_sleep_timers[root] < _parameters.sleep_frame_count)
+				continue;
+
+			size_t const first = island_offsets[root];
+			size_t const count = island_offsets[root + 1] - first;
+			_rigidbodies.sleep_island(&island_bodies[first], count);
+		}
+
+		for (size_t i = 0; i < rigidbody_count; i++)
+		{
+			if (_rigidbodies.is_sleeping(i))
+				_islands.sleeping_body_count++;
+		}
+	}
+
+}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Engine/Components/Rigidbody.h>
+#include "contact.h"
+
+#include <vector>
+
+namespace Engine {
+namespace Physics {
+
+	struct physics_simulation_parameters;
+
+	/*
+	* @brief
+	* Groups of dynamic rigidbodies connected by contact manifolds. Static bodies do not
+	* connect islands, since they are not affected by the bodies resting on them.
+	* Buffers are kept between steps to avoid reallocating them.
+	*/
+	struct simulation_islands
+	{
+		std::vector<uint32_t>	parents;			// Union-find forest over rigidbody indices
+		std::vector<uint16_t>	min_sleep_timers;	// Smallest sleep timer of island, indexed by root
+		std::vector<uint32_t>	island_offsets;		// Start of island in island_bodies, indexed by root
+		std::vector<size_t>		island_bodies;		// Rigidbody indices sorted by island
+
+		size_t					island_count = 0;
+		size_t					sleeping_body_count = 0;
+	};
+
+	void wake_contact_islands(
+		global_contact_data const& _global_contact_data,
+		Component::RigidBodyManager::rigidbody_data_collection& _rigidbodies
+	);
+
+	void update_simulation_islands(
+		global_contact_data const& _global_contact_data,
+		physics_simulation_parameters const& _parameters,
+		Component::RigidBodyManager::rigidbody_data_collection& _rigidbodies,
+		simulation_islands& _islands
+	);
+
+}
+}
@@ -0,0 +1,124 @@
+#include "narrowphase.h"
+
+#include <Engine/Math/geometry_intersection.hpp>
+#include <Engine/Utils/job_system.h>
+
+#include <array>
+#include <limits>
+
+namespace Engine {
+namespace Physics {
+
+	// Number of pairs handed to a thread at once.
+	static size_t const NARROWPHASE_BATCH_SIZE = 32;
+
+	static void compute_narrowphase_batch(
+		narrowphase_body const _bodies[],
+		broadphase_pair const _pairs[],
+		size_t const _begin,
+		size_t const _end,
+		narrowphase_output& _output
+	)
+	{
+		std::array<contact, 128>	contact_stack_arr;
+		size_t						contact_stack_size = 0;
+
+		for (size_t pair_idx = _begin; pair_idx < _end; pair_idx++)
+		{
+			narrowphase_body const& body_1 = _bodies[_pairs[pair_idx].first];
+			narrowphase_body const& body_2 = _bodies[_pairs[pair_idx].second];
+
+			// Fattened bounding volumes of tree may overlap when actual bounding volumes do not.
+			if (!Math::intersect_aabb_aabb(body_1.bounding_volume, body_2.bounding_volume))
+				continue;
+
+			// Skip iteration if both objects have rigidbodies and both are static or sleeping.
+			if ((body_1.is_static || body_1.is_sleeping) && (body_2.is_static || body_2.is_sleeping))
+				continue;
+
+			contact_stack_size = 0;
+
+			bool hull1_is_reference_face = false;
+			EIntersectionType result = intersect_convex_hulls_sat(
+				*body_1.hull, body_1.world_transform, body_1.entity_id,
+				*body_2.hull, body_2.world_transform, body_2.entity_id,
+				contact_stack_arr.data(), &contact_stack_size,
+				&hull1_is_reference_face
+			);
+
+			if (result & EIntersectionType::eAnyIntersection)
+			{
+				narrowphase_result& new_result = _output.results.emplace_back();
+				new_result.pair_index = (uint32_t)pair_idx;
+				new_result.type = result;
+				new_result.hull1_is_reference_face = hull1_is_reference_face;
+				new_result.first_contact_index = (uint32_t)_output.contacts.size();
+				new_result.contact_count = (uint16_t)contact_stack_size;
+				_output.contacts.insert(
+					_output.contacts.end(),
+					contact_stack_arr.begin(),
+					contact_stack_arr.begin() + contact_stack_size
+				);
+			}
+		}
+	}
+
+	void compute_narrowphase(
+		narrowphase_body const _bodies[],
+		broadphase_pair const _pairs[],
+		size_t const _pair_count,
+		Utils::job_system* _job_system,
+		narrowphase_context& _context
+	)
+	{
+		narrowphase_output& merged = _context.merged_output;
+		merged.clear();
+
+		if (!_job_system || _job_system->thread_count() == 1)
+		{
+			compute_narrowphase_batch(_bodies, _pairs, 0, _pair_count, merged);
+			return;
+		}
+
+		auto& thread_outputs = _context.thread_outputs;
+		thread_outputs.resize(_job_system->thread_count());
+		for (narrowphase_output& output : thread_outputs)
+			output.clear();
+
+		_job_system->parallel_for(_pair_count, NARROWPHASE_BATCH_SIZE,
+			[&](size_t _begin, size_t _end, unsigned int _thread_index)
+			{
+				compute_narrowphase_batch(_bodies, _pairs, _begin, _end, thread_outputs[_thread_index]);
+			}
+		);
+
+		// Batches are handed out in increasing order, so the results of each thread are sorted
+		// by pair index. Merge them into a single sequence sorted by pair index.
+		std::vector<size_t>& cursors = _context.merge_cursors;
+		cursors.assign(thread_outputs.size(), 0);
+		while (true)
+		{
+			size_t min_thread = thread_outputs.size();
+			uint32_t min_pair_index = std::numeric_limits<uint32_t>::max();
+			for (size_t t = 0; t < thread_outputs.size(); t++)
+			{
+				if (cursors[t] < thread_outputs[t].results.size() && thread_outputs[t].results[cursors[t]].pair_index < min_pair_index)
+				{
+					min_thread = t;
+					min_pair_index = thread_outputs[t].results[cursors[t]].pair_index;
+				}
+			}
+			if (min_thread == thread_outputs.size())
+				break;
+
+			narrowphase_output const& thread_output = thread_outputs[min_thread];
+			narrowphase_result result = thread_output.results[cursors[min_thread]++];
+			auto const contacts_begin = thread_output.contacts.begin() + result.first_contact_index;
+			result.first_contact_index = (uint32_t)merged.contacts.size();
+			merged.contacts.insert(merged.contacts.end(), contacts_begin, contacts_begin + result.contact_count);
+			merged.results.push_back(result);
+		}
+	}
+
+}
+}
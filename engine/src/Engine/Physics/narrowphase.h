@@ -0,0 +1,79 @@
+#pragma once
+
+#include "broadphase.h"
+#include "contact.h"
+#include "intersection.h"
+
+#include <vector>
+
+namespace Engine {
+namespace Utils { class job_system; }
+namespace Physics {
+
+	/*
+	* @brief
+	* Collision shape of a body, refreshed before running narrowphase.
+	*/
+	struct narrowphase_body
+	{
+		half_edge_data_structure const*	hull = nullptr;
+		Math::transform3D				world_transform;
+		Math::aabb						bounding_volume;
+		uint32_t						entity_id = 0;		// Used for contact identifiers.
+		bool							is_static = false;
+		bool							is_sleeping = false;
+	};
+
+	/*
+	* @brief
+	* Intersection found between the two bodies of a broadphase pair.
+	*/
+	struct narrowphase_result
+	{
+		uint32_t			pair_index;					// Index of broadphase pair
+		EIntersectionType	type;
+		bool				hull1_is_reference_face;	// Whether first body of pair owns the reference face.
+		uint32_t			first_contact_index;		// Index of first contact in contact array of output
+		uint16_t			contact_count;
+	};
+
+	struct narrowphase_output
+	{
+		std::vector<narrowphase_result>	results;
+		std::vector<contact>			contacts;
+
+		void clear() { results.clear(); contacts.clear(); }
+	};
+
+	/*
+	* @brief
+	* Buffers reused between narrowphase runs. Each thread writes into its own output,
+	* which are then merged in pair order.
+	*/
+	struct narrowphase_context
+	{
+		std::vector<narrowphase_output>	thread_outputs;
+		narrowphase_output				merged_output;
+		std::vector<size_t>				merge_cursors;
+	};
+
+	/*
+	* @brief	Run SAT intersection tests over broadphase pairs.
+	* @param	narrowphase_body const *		Bodies indexed by broadphase pairs
+	* @param	broadphase_pair const *			Candidate pairs
+	* @param	size_t							Number of pairs
+	* @param	job_system *					Job system to distribute pairs over, or null to run serially.
+	* @param	narrowphase_context &			Context whose merged output receives intersecting pairs.
+	* @details	Merged results are in increasing pair order, so output is identical to a
+	*			single-threaded run regardless of thread count.
+	*/
+	void compute_narrowphase(
+		narrowphase_body const _bodies[],
+		broadphase_pair const _pairs[],
+		size_t const _pair_count,
+		Utils::job_system* _job_system,
+		narrowphase_context& _context
+	);
+
+}
+}
@@ -2,6 +2,9 @@
 
 #include <Engine/Components/Rigidbody.h>
 #include <Engine/Physics/Collider.h>
+#include <Engine/Utils/allocation_tracker.h>
+#include <Engine/Utils/job_system.h>
+#include <Engine/Utils/stopwatch.h>
 #include "resolution.hpp"
 
 namespace Engine {
@@ -10,10 +13,13 @@ namespace Physics {
 	void ScenePhysicsManager::Reset()
 	{
 		m_session_data = session_data();
+		m_islands = simulation_islands();
 	}
 
 	void ScenePhysicsManager::PhysicsStep(float _dt)
 	{
+		ENGINE_ALLOCATION_SCOPE(ePhysics);
+
 		auto & rb_mgr = Singleton<Component::RigidBodyManager>();
 
 		// Set custom timestep if any valid timestep has been passed.
@@ -21,25 +27,41 @@ namespace Physics {
 		if(_dt > glm::epsilon<float>())
 			new_parameters.timestep = _dt;
 
+		auto& global_contact_data = Singleton<Component::ColliderManager>().m_data.m_global_contact_data;
+
+		m_last_step_timings = step_timings();
+		Engine::Utils::stopwatch phase_stopwatch;
+
+		// Bodies sleeping in contact with awake bodies have to take part in this step.
+		wake_contact_islands(global_contact_data, rb_mgr.m_rigidbodies_data);
+		m_last_step_timings.islands_ms = phase_stopwatch.lap_ms();
+
 		new_parameters.timestep /= new_parameters.subdivisions;
 		for (size_t i = 0; i < new_parameters.subdivisions; i++)
 		{
-			nlohmann::json frame_json;
-			rb_mgr.Serialize(frame_json);
-
-			m_session_data.rigidbody_frame_data[m_session_data.end % m_session_data.rigidbody_frame_data.max_size()] = std::move(frame_json);
-			m_session_data.end++;
-			if (m_session_data.end - m_session_data.begin > m_session_data.rigidbody_frame_data.max_size())
-				m_session_data.begin++;
+			if (m_snapshot_mode != eSnapshotDisabled)
+			{
+				m_session_data.rigidbody_frames.m_delta_encoding = (m_snapshot_mode == eSnapshotDelta);
+				m_session_data.rigidbody_frames.record(rb_mgr.m_rigidbodies_data);
+			}
+			// Recording is editor overhead, not part of any phase.
+			phase_stopwatch.lap_ms();
 
 			compute_resolution_gauss_seidel(
-				Singleton<Component::ColliderManager>().m_data.m_global_contact_data,
-				new_parameters
+				global_contact_data,
+				new_parameters,
+				&Singleton<Engine::Utils::job_system>(),
+				&m_solver_context
 			);
+			m_last_step_timings.solve_ms += phase_stopwatch.lap_ms();
+
 			rb_mgr.Integrate(new_parameters.timestep);
+			m_last_step_timings.integrate_ms += phase_stopwatch.lap_ms();
 		}
+		update_simulation_islands(global_contact_data, new_parameters, rb_mgr.m_rigidbodies_data, m_islands);
 		rb_mgr.ClearForces();
 		rb_mgr.UpdateTransforms();
+		m_last_step_timings.islands_ms += phase_stopwatch.lap_ms();
 	}
 
 	void ScenePhysicsManager::DisplayEditorWindow()
@@ -49,14 +71,15 @@ namespace Physics {
 		{
 			auto& params = m_physics_parameters;
 
-			int frame_count = m_session_data.end - m_session_data.begin;
+			auto& rigidbody_frames = m_session_data.rigidbody_frames;
+			int frame_count = (int)rigidbody_frames.frame_count();
 			peek_frame = std::clamp(peek_frame, 0, std::max(frame_count - 1,0));
 			if (!paused)
 				peek_frame = frame_count - 1;
 			if (ImGui::Checkbox("Paused", &paused))
 			{
 				if(!paused)
-					m_session_data.end = m_session_data.begin + peek_frame;
+					rigidbody_frames.truncate(peek_frame);
 			}
 			ImGui::BeginDisabled(!paused);
 			step = ImGui::Button("Physics Step");
@@ -64,17 +87,31 @@ namespace Physics {
 			{
 				if (paused)
 				{
-					m_session_data.end = m_session_data.begin + peek_frame + 1;
+					rigidbody_frames.truncate(peek_frame + 1);
 					peek_frame++;
 				}
 			}
+			ImGui::BeginDisabled(frame_count == 0);
 			if (ImGui::SliderInt("Frame Record", &peek_frame, 0, frame_count - 1, "%d"))
 			{
-				size_t const frame_index = (m_session_data.begin + peek_frame) % m_session_data.rigidbody_frame_data.max_size();
-				Singleton<Component::RigidBodyManager>().Deserialize(m_session_data.rigidbody_frame_data[frame_index]);
-				Singleton<Component::RigidBodyManager>().UpdateTransforms();
+				auto& rb_mgr = Singleton<Component::RigidBodyManager>();
+				if (rigidbody_frames.restore(peek_frame, rb_mgr.m_rigidbodies_data))
+				{
+					rb_mgr.m_rigidbodies_data.wake_all();
+					rb_mgr.UpdateTransforms();
+				}
 			}
 			ImGui::EndDisabled();
+			ImGui::EndDisabled();
+
+			const char* snapshot_mode_names[] = { "Disabled (Production)", "Full", "Delta" };
+			int snapshot_mode = m_snapshot_mode;
+			if (ImGui::Combo("Frame Recording", &snapshot_mode, snapshot_mode_names, IM_ARRAYSIZE(snapshot_mode_names)))
+			{
+				m_snapshot_mode = (ESnapshotMode)snapshot_mode;
+				rigidbody_frames.clear();
+			}
+			ImGui::Text("Recorded Frames: %zu (%.1f KB)", rigidbody_frames.frame_count(), rigidbody_frames.memory_usage() / 1024.0f);
 
 			ImGui::SliderFloat("Timestep", &m_physics_parameters.timestep, 0.0001f, 1.0f, "%.4f", ImGuiSliderFlags_Logarithmic);
 			m_physics_parameters.timestep = std::clamp(m_physics_parameters.timestep, 0.0001f, 1.0f);
@@ -88,6 +125,47 @@ namespace Physics {
 			ImGui::SliderFloat("Baumgarte Coefficient", &params.baumgarte, 0.0f, 1.0f, "%.3f");
 			ImGui::DragFloat("Slop", &params.slop, 0.001f, 0.0f, 0.1f, "%.3f");
 			ImGui::Checkbox("Contact Caching", &params.contact_caching);
+			ImGui::Checkbox("Parallel Resolution", &params.parallel_resolution);
+			ImGui::Checkbox("SIMD Resolution", &params.simd_resolution);
+			if (params.simd_resolution)
+				ImGui::Text("Contact Batches: %zu (%zu lanes)", m_solver_context.batches.batches.size(), Math::simd_float::WIDTH);
+			if (params.parallel_resolution || params.simd_resolution)
+				ImGui::Text("Constraint Colours: %zu", m_solver_context.colour_count());
+			ImGui::Checkbox("Sleeping", &params.sleeping);
+			ImGui::BeginDisabled(!params.sleeping);
+			ImGui::DragFloat("Sleep Linear Velocity", &params.sleep_linear_velocity, 0.001f, 0.0f, 1.0f, "%.3f");
+			ImGui::DragFloat("Sleep Angular Velocity", &params.sleep_angular_velocity, 0.001f, 0.0f, 1.0f, "%.3f");
+			int sleep_frames = params.sleep_frame_count;
+			if (ImGui::DragInt("Sleep Frames", &sleep_frames, 0.1f, 1, 600, "%d", ImGuiSliderFlags_AlwaysClamp))
+				params.sleep_frame_count = sleep_frames;
+			ImGui::Text("Islands: %zu, Sleeping Bodies: %zu", m_islands.island_count, m_islands.sleeping_body_count);
+			ImGui::EndDisabled();
+
+			auto const& intersection_timings = Singleton<Component::ColliderManager>().GetLastTimings();
+			ImGui::Text("Broadphase: %.3f ms, Narrowphase: %.3f ms", intersection_timings.broadphase_ms, intersection_timings.narrowphase_ms);
+			ImGui::Text("Solve: %.3f ms, Integrate: %.3f ms, Islands: %.3f ms", m_last_step_timings.solve_ms, m_last_step_timings.integrate_ms, m_last_step_timings.islands_ms);
+
+			auto& collider_mgr = Singleton<Component::ColliderManager>();
+			const char* broadphase_mode_names[] = { "All Pairs", "Dynamic AABB Tree", "Sweep And Prune" };
+			int broadphase_mode = collider_mgr.GetBroadphaseMode();
+			if (ImGui::Combo("Broadphase", &broadphase_mode, broadphase_mode_names, IM_ARRAYSIZE(broadphase_mode_names)))
+				collider_mgr.SetBroadphaseMode((Component::ColliderManager::EBroadphaseMode)broadphase_mode);
+			ImGui::Text("Broadphase Pairs: %zu", collider_mgr.m_data.m_broadphase_pairs.size());
+			if (collider_mgr.GetBroadphaseMode() == Component::ColliderManager::eSweepAndPrune)
+			{
+				auto const& sap = collider_mgr.m_data.m_broadphase_sap;
+				ImGui::Text("Pairs Added: %zu, Removed: %zu", sap.m_added_pairs.size(), sap.m_removed_pairs.size());
+				ImGui::Text("Cached Pairs: %zu", collider_mgr.m_data.m_global_contact_data.cache.manifolds.size());
+			}
+
+			bool parallel_narrowphase = collider_mgr.GetParallelNarrowphase();
+			if (ImGui::Checkbox("Parallel Narrowphase", &parallel_narrowphase))
+				collider_mgr.SetParallelNarrowphase(parallel_narrowphase);
+			auto& jobs = Singleton<Utils::job_system>();
+			int thread_count = jobs.thread_count();
+			if (ImGui::SliderInt("Job Threads", &thread_count, 1, Utils::job_system::default_thread_count(), "%d", ImGuiSliderFlags_AlwaysClamp))
+				jobs.set_thread_count(thread_count);
+
 			int timestep_subdivisions = params.subdivisions;
 			if(ImGui::SliderInt("Timestep Subdivisions", &timestep_subdivisions, 1, 32, "%d", ImGuiSliderFlags_AlwaysClamp))
 				params.subdivisions = timestep_subdivisions;
@@ -1,6 +1,8 @@
 #include <imgui.h>
 #include <nlohmann/json.hpp>
 #include "resolution.hpp"
+#include "rigidbody_snapshot.hpp"
+#include "islands.hpp"
 
 namespace Engine {
 namespace Physics {
@@ -9,17 +11,33 @@ namespace Physics {
 	{
 	public:
 
+		/*
+		* Disabling snapshots (e.g. in production) removes all recording cost from the physics step,
+		* but the editor can no longer scrub through previous frames.
+		*/
+		enum ESnapshotMode : char { eSnapshotDisabled = 0, eSnapshotFull = 1, eSnapshotDelta = 2 };
+
 		struct session_data
 		{
-			std::array<nlohmann::json,200> rigidbody_frame_data;
-			size_t begin = 0;
-			size_t end = 0;
+			rigidbody_snapshot_ring rigidbody_frames{ 200 };
+		};
+
+		// Wall-clock durations of the last physics step, summed over timestep subdivisions.
+		struct step_timings
+		{
+			double solve_ms = 0.0;
+			double integrate_ms = 0.0;
+			double islands_ms = 0.0;	// Waking and updating islands, clearing forces and writing back transforms.
 		};
 
 		session_data m_session_data;
+		ESnapshotMode m_snapshot_mode = eSnapshotDelta;
 		bool paused = false;
 		bool step = false;
 		physics_simulation_parameters m_physics_parameters;
+		simulation_islands m_islands;
+		contact_solver_context m_solver_context;
+		step_timings m_last_step_timings;
 
 		bool render_contacts = false;
 		bool render_penetration = false;
@@ -2,441 +2,698 @@
 #include <glm/detail/qualifier.hpp>
 #include "physics_manager.hpp"
 
+#include <Engine/Utils/job_system.h>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+
 namespace Engine {
 namespace Physics {
 
+	// Number of manifolds handed to a thread at once when solving a colour in parallel.
+	static size_t const RESOLUTION_BATCH_SIZE = 16;
+
 	/*
-	* @brief	Step in physics resolution to recover cached contact forces and re-apply them.
-	* @param	global_contact_data			Contact data for all colliding rigidbodies.
-	* @param	float						Delta time in simulation.
-	* @param	physics_simulation_parameters
-	* @param	contact_manifold[]			
-	* @param	size_t						Size of contact manifold array.
-	* @param	contact[]					
-	* @param	precomputed_contact_data[]	1-1 mapping with contact array.
-	* @param	size_t						Size of contact / precomputed_contact_data array.
+	* @brief	Call function for every manifold index. Without a solver context, manifolds are
+	*			visited in order. Otherwise they are visited colour by colour, and the manifolds
+	*			of a colour are distributed over the job system if one is given.
+	* @param	size_t							Number of manifolds
+	* @param	job_system *					Job system, or null to run serially.
+	* @param	contact_solver_context const *	Colouring of manifolds, or null for manifold order.
+	* @param	TFunc							Callable with signature void(size_t manifold_idx)
+	* @param	size_t							First colour to visit, used to skip colours solved in batches.
+	* @details	Order only depends on colouring, so results do not depend on thread count.
 	*/
-	void precompute_contact_data_step(
-		global_contact_data const& _global_contact_data,
-		physics_simulation_parameters const & _parameters,
+	template<typename TFunc>
+	static void for_each_manifold(
+		size_t const _contact_manifold_count,
+		Utils::job_system* _job_system,
+		contact_solver_context const* _solver_context,
+		TFunc&& _func,
+		size_t const _first_colour = 0
+	)
+	{
+		if (!_solver_context)
+		{
+			for (size_t manifold_idx = 0; manifold_idx < _contact_manifold_count; manifold_idx++)
+				_func(manifold_idx);
+			return;
+		}
+
+		size_t const colour_count = _solver_context->colour_count();
+		for (size_t colour = _first_colour; colour < colour_count; colour++)
+		{
+			uint32_t const* colour_manifolds = _solver_context->coloured_manifolds.data() + _solver_context->colour_offsets[colour];
+			size_t const colour_size = _solver_context->colour_offsets[colour + 1] - _solver_context->colour_offsets[colour];
+
+			bool const is_overflow_colour = _solver_context->has_overflow_colour && colour == colour_count - 1;
+			if (!_job_system || is_overflow_colour)
+			{
+				for (size_t i = 0; i < colour_size; i++)
+					_func(colour_manifolds[i]);
+				continue;
+			}
+
+			_job_system->parallel_for(colour_size, RESOLUTION_BATCH_SIZE,
+				[&](size_t _begin, size_t _end, unsigned int _thread_index)
+				{
+					for (size_t i = _begin; i < _end; i++)
+						_func(colour_manifolds[i]);
+				}
+			);
+		}
+	}
+
+	void solver_body_collection::clear()
+	{
+		linear_velocities.clear();
+		angular_velocities.clear();
+		inv_masses.clear();
+		inv_world_tensors.clear();
+		positions.clear();
+		restitution.clear();
+		friction_coefficients.clear();
+		rigidbody_indices.clear();
+	}
+
+	void build_solver_bodies(
 		contact_manifold const _contact_manifold_arr[],
 		size_t const _contact_manifold_count,
-		contact const _contact_arr[],
-		precomputed_contact_data _out_precomputed_contact_data_arr[],
-		size_t const _contact_count
+		Component::RigidBodyManager::rigidbody_data_collection const& _rigidbodies,
+		contact_solver_context& _context
 	)
 	{
-		size_t manifold_end_contact_idx = 0;
+		solver_body_collection& bodies = _context.bodies;
+		bodies.clear();
+		_context.rigidbody_solver_bodies.assign(_rigidbodies.size(), contact_solver_context::INVALID_SOLVER_BODY);
+		_context.manifold_bodies.resize(_contact_manifold_count);
+
+		auto get_solver_body = [&](Engine::ECS::Entity _entity)
+		{
+			size_t const rb_index = _rigidbodies.get_entity_index(_entity);
+			uint32_t& solver_body = _context.rigidbody_solver_bodies[rb_index];
+			if (solver_body != contact_solver_context::INVALID_SOLVER_BODY)
+				return solver_body;
+
+			solver_body = (uint32_t)bodies.size();
+
+			float const inv_mass = _rigidbodies.m_inv_masses[rb_index];
+			glm::mat3 const& inv_world_tensor = _rigidbodies.m_inv_world_tensors[rb_index];
+
+			bodies.linear_velocities.push_back(_rigidbodies.m_linear_momentums[rb_index] * inv_mass);
+			bodies.angular_velocities.push_back(inv_world_tensor * _rigidbodies.m_angular_momentums[rb_index]);
+			bodies.inv_masses.push_back(inv_mass);
+			bodies.inv_world_tensors.push_back(inv_world_tensor);
+			bodies.positions.push_back(_rigidbodies.m_positions[rb_index]);
+			bodies.restitution.push_back(_rigidbodies.m_restitution[rb_index]);
+			bodies.friction_coefficients.push_back(_rigidbodies.m_friction_coefficient[rb_index]);
+			bodies.rigidbody_indices.push_back((uint32_t)rb_index);
+			return solver_body;
+		};
+
 		for (size_t manifold_idx = 0; manifold_idx < _contact_manifold_count; manifold_idx++)
 		{
-			contact_manifold cm = _contact_manifold_arr[manifold_idx];
-			rigidbody_data rbA = cm.rigidbodies.first.GetRigidBodyData();
-			rigidbody_data rbB = cm.rigidbodies.second.GetRigidBodyData();
-			glm::vec3 vA = rbA.get_linear_velocity();
-			glm::vec3 wA = rbA.get_angular_velocity();
-			glm::vec3 vB = rbB.get_linear_velocity();
-			glm::vec3 wB = rbB.get_angular_velocity();
-
-			glm::mat3 const inv_world_tensor_A = rbA.get_inv_world_tensor();
-			glm::mat3 const inv_world_tensor_B = rbB.get_inv_world_tensor();
-
-			// Search for cached rigidbody interaction from previous frame.
-			auto const& cache = _global_contact_data.cache;
-			contact_manifold_data cached_manifold_data;
-			bool cached_interaction_found = false;
-
-			manifold_end_contact_idx += cm.data.contact_count;
-			for (size_t contact_idx = cm.data.first_contact_index; contact_idx < manifold_end_contact_idx; contact_idx++)
+			contact_manifold const& cm = _contact_manifold_arr[manifold_idx];
+			_context.manifold_bodies[manifold_idx].first = get_solver_body(cm.rigidbodies.first.Owner());
+			_context.manifold_bodies[manifold_idx].second = get_solver_body(cm.rigidbodies.second.Owner());
+		}
+	}
+
+	void write_back_solver_bodies(
+		solver_body_collection const& _bodies,
+		Component::RigidBodyManager::rigidbody_data_collection& _rigidbodies
+	)
+	{
+		for (size_t i = 0; i < _bodies.size(); i++)
+		{
+			float const inv_mass = _bodies.inv_masses[i];
+			if (inv_mass <= 0.0f)
+				continue;
+
+			size_t const rb_index = _bodies.rigidbody_indices[i];
+			glm::mat3 const rot_mat = glm::toMat3(_rigidbodies.m_rotations[rb_index]);
+			glm::mat3 const world_tensor = rot_mat * _rigidbodies.m_inertial_tensors[rb_index] * glm::transpose(rot_mat);
+			_rigidbodies.m_linear_momentums[rb_index] = _bodies.linear_velocities[i] / inv_mass;
+			_rigidbodies.m_angular_momentums[rb_index] = world_tensor * _bodies.angular_velocities[i];
+		}
+	}
+
+	/*
+	* @brief	Store velocities of a solver body.
+	* @details	Contacts do not change the velocity of static bodies, so they are skipped.
+	*			Static bodies may be shared by manifolds that are solved in parallel.
+	*/
+	static void store_solver_body_velocities(
+		solver_body_collection& _bodies,
+		uint32_t const _body,
+		glm::vec3 const _linear_velocity,
+		glm::vec3 const _angular_velocity
+	)
+	{
+		if (_bodies.inv_masses[_body] <= 0.0f)
+			return;
+
+		_bodies.linear_velocities[_body] = _linear_velocity;
+		_bodies.angular_velocities[_body] = _angular_velocity;
+	}
+
+	void compute_manifold_colouring(contact_solver_context& _context)
+	{
+		size_t constexpr MAX_COLOURS = contact_solver_context::MAX_COLOURS;
+
+		size_t const contact_manifold_count = _context.manifold_bodies.size();
+		auto const& inv_masses = _context.bodies.inv_masses;
+		auto& body_colour_masks = _context.body_colour_masks;
+		auto& manifold_colours = _context.manifold_colours;
+		body_colour_masks.assign(_context.bodies.size(), 0);
+		manifold_colours.resize(contact_manifold_count);
+
+		// Last entry counts manifolds of overflow colour.
+		std::array<uint32_t, MAX_COLOURS + 1> colour_sizes{};
+		for (size_t manifold_idx = 0; manifold_idx < contact_manifold_count; manifold_idx++)
+		{
+			uint32_t const body_A = _context.manifold_bodies[manifold_idx].first;
+			uint32_t const body_B = _context.manifold_bodies[manifold_idx].second;
+			bool const is_dynamic_A = inv_masses[body_A] > 0.0f;
+			bool const is_dynamic_B = inv_masses[body_B] > 0.0f;
+
+			uint64_t const used_colours =
+				(is_dynamic_A ? body_colour_masks[body_A] : 0) |
+				(is_dynamic_B ? body_colour_masks[body_B] : 0);
+
+			// Lowest colour not used by either body.
+			size_t const colour = std::min<size_t>(std::countr_one(used_colours), MAX_COLOURS);
+			if (colour < MAX_COLOURS)
 			{
-				precomputed_contact_data pcd;
-				contact const & c = _contact_arr[contact_idx];
-
-				// Precompute data required for contact resolution.
-
-				glm::vec3 const rA = c.point - rbA.position;
-				glm::vec3 const rB = c.point - rbB.position;
-				glm::vec3 const cross_rA_n = glm::cross(rA, c.normal);
-				glm::vec3 const cross_rB_n = glm::cross(rB, c.normal);
-
-				float const rel_contact_velocity = glm::dot(c.normal, -vA - glm::cross(wA, rA) + vB + glm::cross(wB, rB));
-				float const restitution_bias = std::min(rbA.restitution, rbB.restitution) * rel_contact_velocity;
-				pcd.bias = restitution_bias + (_parameters.baumgarte - _parameters.slop) * (-c.penetration / _parameters.timestep);
-
-				pcd.effective_mass_contact =
-					rbA.inv_mass + rbB.inv_mass +
-					glm::dot(cross_rA_n, inv_world_tensor_A * cross_rA_n) +
-					glm::dot(cross_rB_n, inv_world_tensor_B * cross_rB_n);
-
-				// Precompute data required for friction resolution.
-				constexpr glm::vec3 up(0.0f, 1.0f, 0.0f);
-				constexpr float epsilon = glm::epsilon<float>();
-				bool const normal_up_parallel = glm::all(glm::epsilonEqual(c.normal, up, epsilon)) || glm::all(glm::epsilonEqual(c.normal, -up, epsilon));
-				// Compute two vectors (u and v) that are tangent and bitangent to normal.
-				pcd.friction_u = glm::normalize(normal_up_parallel
-					? glm::cross(c.normal, glm::vec3(1.0f, 0.0f, 0.0f))
-					: glm::cross(c.normal, glm::vec3(0.0f, 1.0f, 0.0f))
-				);
-				pcd.friction_v = glm::normalize(glm::cross(c.normal, pcd.friction_u));
-
-				glm::vec3 const cross_rA_u = glm::cross(rA, pcd.friction_u);
-				glm::vec3 const cross_rB_u = glm::cross(rB, pcd.friction_u);
-				glm::vec3 const cross_rA_v = glm::cross(rA, pcd.friction_v);
-				glm::vec3 const cross_rB_v = glm::cross(rB, pcd.friction_v);
-
-				pcd.effective_mass_friction_u = rbA.inv_mass + rbB.inv_mass +
-					glm::dot(cross_rA_u, inv_world_tensor_A * cross_rA_u) +
-					glm::dot(cross_rB_u, inv_world_tensor_B * cross_rB_u);
-				pcd.effective_mass_friction_v = rbA.inv_mass + rbB.inv_mass +
-					glm::dot(cross_rA_v, inv_world_tensor_A * cross_rA_v) +
-					glm::dot(cross_rB_v, inv_world_tensor_B * cross_rB_v);
-
-				// Store precomputed contact data into array
-				_out_precomputed_contact_data_arr[contact_idx] = pcd;
+				uint64_t const colour_bit = uint64_t(1) << colour;
+				if (is_dynamic_A) body_colour_masks[body_A] |= colour_bit;
+				if (is_dynamic_B) body_colour_masks[body_B] |= colour_bit;
 			}
+			manifold_colours[manifold_idx] = (uint8_t)colour;
+			colour_sizes[colour]++;
 		}
+
+		// Colours are assigned lowest first, so used colours are contiguous. A manifold only
+		// overflows when all regular colours are in use, so the overflow colour comes last.
+		size_t colour_count = 0;
+		while (colour_count < MAX_COLOURS && colour_sizes[colour_count] != 0)
+			colour_count++;
+		_context.has_overflow_colour = colour_sizes[MAX_COLOURS] != 0;
+		if (_context.has_overflow_colour)
+			colour_count = MAX_COLOURS + 1;
+
+		auto& colour_offsets = _context.colour_offsets;
+		colour_offsets.assign(colour_count + 1, 0);
+		for (size_t colour = 0; colour < colour_count; colour++)
+			colour_offsets[colour + 1] = colour_offsets[colour] + colour_sizes[colour];
+
+		std::array<uint32_t, MAX_COLOURS + 1> colour_cursors;
+		std::copy(colour_offsets.begin(), colour_offsets.end() - 1, colour_cursors.begin());
+		_context.coloured_manifolds.resize(contact_manifold_count);
+		for (size_t manifold_idx = 0; manifold_idx < contact_manifold_count; manifold_idx++)
+			_context.coloured_manifolds[colour_cursors[manifold_colours[manifold_idx]]++] = (uint32_t)manifold_idx;
 	}
 
 	/*
-	* @brief	Apply cached contact forces when available, and initialize contact lambdas
-	*			to their appropriate value.
-	* @param	global_contact_data				Contact data for all colliding rigidbodies.
+	* @brief	Precompute data of each contact in a manifold required for contact resolution.
 	* @param	physics_simulation_parameters
-	* @param	contact_manifold[]			
-	* @param	size_t							Size of contact manifold array.
-	* @param	contact[]					
-	* @param	precomputed_contact_data[]		1-1 mapping with contact array.
-	* @param	size_t							Size of contact array.
+	* @param	contact_manifold const &
+	* @param	solver_body_pair				Solver bodies of manifold
+	* @param	solver_body_collection const &
+	* @param	contact[]
+	* @param	precomputed_contact_data[]	1-1 mapping with contact array.
 	*/
-	void apply_cached_contact_forces_step(
-		global_contact_data const &	_global_contact_data,
+	static void precompute_manifold_contact_data(
 		physics_simulation_parameters const & _parameters,
-		contact_manifold const _contact_manifold_arr[],
-		size_t const _contact_manifold_count,
-		contact const	_contact_arr[],
-		precomputed_contact_data const _precomputed_contact_data_arr[],
-		contact_lambdas _contact_lambdas_arr[],
-		size_t const _contact_count
+		contact_manifold const & _cm,
+		solver_body_pair const _body_pair,
+		solver_body_collection const & _bodies,
+		contact const _contact_arr[],
+		precomputed_contact_data _out_precomputed_contact_data_arr[]
 	)
 	{
-		auto const& cache = _global_contact_data.cache;
-		size_t manifold_end_contact_idx = 0;
-		for (size_t manifold_idx = 0; manifold_idx < _contact_manifold_count; manifold_idx++)
+		uint32_t const body_A = _body_pair.first;
+		uint32_t const body_B = _body_pair.second;
+		float const inv_mass_A = _bodies.inv_masses[body_A];
+		float const inv_mass_B = _bodies.inv_masses[body_B];
+		glm::vec3 const position_A = _bodies.positions[body_A];
+		glm::vec3 const position_B = _bodies.positions[body_B];
+		glm::vec3 const vA = _bodies.linear_velocities[body_A];
+		glm::vec3 const wA = _bodies.angular_velocities[body_A];
+		glm::vec3 const vB = _bodies.linear_velocities[body_B];
+		glm::vec3 const wB = _bodies.angular_velocities[body_B];
+
+		glm::mat3 const& inv_world_tensor_A = _bodies.inv_world_tensors[body_A];
+		glm::mat3 const& inv_world_tensor_B = _bodies.inv_world_tensors[body_B];
+
+		float const restitution = std::min(_bodies.restitution[body_A], _bodies.restitution[body_B]);
+
+		size_t const manifold_end_contact_idx = _cm.data.first_contact_index + _cm.data.contact_count;
+		for (size_t contact_idx = _cm.data.first_contact_index; contact_idx < manifold_end_contact_idx; contact_idx++)
 		{
-			contact_manifold cm = _contact_manifold_arr[manifold_idx];
-			rigidbody_data rbA = cm.rigidbodies.first.GetRigidBodyData();
-			rigidbody_data rbB = cm.rigidbodies.second.GetRigidBodyData();
-			glm::vec3 vA = rbA.get_linear_velocity();
-			glm::vec3 wA = rbA.get_angular_velocity();
-			glm::vec3 vB = rbB.get_linear_velocity();
-			glm::vec3 wB = rbB.get_angular_velocity();
-
-			glm::mat3 const inv_world_tensor_A = rbA.get_inv_world_tensor();
-			glm::mat3 const inv_world_tensor_B = rbB.get_inv_world_tensor();
-
-			// Search for cached rigidbody interaction from previous frame.
-			contact_manifold_data cached_manifold_data;
-			bool cached_interaction_found = cache.find_cached_pair_manifold_data(cm.rigidbodies, cached_manifold_data);
-
-			// If this rigidbody pair has interacted before, perform O(n) search for contacts in
-			// referenced cached contact sub-array and perform warm-start.
-			if (cached_interaction_found)
-			{
-				manifold_end_contact_idx += cm.data.contact_count;
-				for (size_t contact_idx = cm.data.first_contact_index; contact_idx < manifold_end_contact_idx; contact_idx++)
-				{
-					contact_lambdas& cfl = _contact_lambdas_arr[contact_idx];
-					contact const& c = _contact_arr[contact_idx];
-					precomputed_contact_data const& pcd = _precomputed_contact_data_arr[contact_idx];
-
-					glm::vec3 const rA = c.point - rbA.position;
-					glm::vec3 const rB = c.point - rbB.position;
-					glm::vec3 const cross_rA_n = glm::cross(rA, c.normal);
-					glm::vec3 const cross_rB_n = glm::cross(rB, c.normal);
-					glm::vec3 const cross_rA_u = glm::cross(rA, pcd.friction_u);
-					glm::vec3 const cross_rB_u = glm::cross(rB, pcd.friction_u);
-					glm::vec3 const cross_rA_v = glm::cross(rA, pcd.friction_v);
-					glm::vec3 const cross_rB_v = glm::cross(rB, pcd.friction_v);
-
-					size_t const end_contact_idx = cached_manifold_data.first_contact_index + cached_manifold_data.contact_count;
-					for (size_t cached_contact_idx = cached_manifold_data.first_contact_index; cached_contact_idx < end_contact_idx; cached_contact_idx++)
-					{
-						if (cache.identifiers[cached_contact_idx] == c.identifier)
-						{
-							// Copy cached lambda values into accumulator lambda values.
-							// Treat new lambda value as delta lambda, and apply it directly.
-							cfl = cache.lambdas[cached_contact_idx];
-
-							float const delta_lambda_penetration = cfl.lambda_penetration;
-							float const delta_lambda_friction_u = cfl.lambda_friction_u;
-							float const delta_lambda_friction_v = cfl.lambda_friction_v;
-
-							// Apply penetration and friction constraint force
-							vA = vA + rbA.inv_mass * (-pcd.friction_u * delta_lambda_friction_u - pcd.friction_v * delta_lambda_friction_v - c.normal * delta_lambda_penetration);
-							wA = wA + inv_world_tensor_A * (-cross_rA_u * delta_lambda_friction_u - cross_rA_v * delta_lambda_friction_v - cross_rA_n * delta_lambda_penetration);
-							vB = vB + rbB.inv_mass * (pcd.friction_u * delta_lambda_friction_u + pcd.friction_v * delta_lambda_friction_v + c.normal * delta_lambda_penetration);
-							wB = wB + inv_world_tensor_B * (cross_rB_u * delta_lambda_friction_u + cross_rB_v * delta_lambda_friction_v + cross_rB_n * delta_lambda_penetration);
-
-							break;
-						}
-					}
-				}
-			}
+			precomputed_contact_data pcd;
+			contact const & c = _contact_arr[contact_idx];
+
+			// Precompute data required for contact resolution.
+
+			glm::vec3 const rA = c.point - position_A;
+			glm::vec3 const rB = c.point - position_B;
+			glm::vec3 const cross_rA_n = glm::cross(rA, c.normal);
+			glm::vec3 const cross_rB_n = glm::cross(rB, c.normal);
+
+			float const rel_contact_velocity = glm::dot(c.normal, -vA - glm::cross(wA, rA) + vB + glm::cross(wB, rB));
+			float const restitution_bias = restitution * rel_contact_velocity;
+			pcd.bias = restitution_bias + (_parameters.baumgarte - _parameters.slop) * (-c.penetration / _parameters.timestep);
+
+			pcd.effective_mass_contact =
+				inv_mass_A + inv_mass_B +
+				glm::dot(cross_rA_n, inv_world_tensor_A * cross_rA_n) +
+				glm::dot(cross_rB_n, inv_world_tensor_B * cross_rB_n);
+
+			// Precompute data required for friction resolution.
+			constexpr glm::vec3 up(0.0f, 1.0f, 0.0f);
+			constexpr float epsilon = glm::epsilon<float>();
+			bool const normal_up_parallel = glm::all(glm::epsilonEqual(c.normal, up, epsilon)) || glm::all(glm::epsilonEqual(c.normal, -up, epsilon));
+			// Compute two vectors (u and v) that are tangent and bitangent to normal.
+			pcd.friction_u = glm::normalize(normal_up_parallel
+				? glm::cross(c.normal, glm::vec3(1.0f, 0.0f, 0.0f))
+				: glm::cross(c.normal, glm::vec3(0.0f, 1.0f, 0.0f))
+			);
+			pcd.friction_v = glm::normalize(glm::cross(c.normal, pcd.friction_u));
+
+			glm::vec3 const cross_rA_u = glm::cross(rA, pcd.friction_u);
+			glm::vec3 const cross_rB_u = glm::cross(rB, pcd.friction_u);
+			glm::vec3 const cross_rA_v = glm::cross(rA, pcd.friction_v);
+			glm::vec3 const cross_rB_v = glm::cross(rB, pcd.friction_v);
+
+			pcd.effective_mass_friction_u = inv_mass_A + inv_mass_B +
+				glm::dot(cross_rA_u, inv_world_tensor_A * cross_rA_u) +
+				glm::dot(cross_rB_u, inv_world_tensor_B * cross_rB_u);
+			pcd.effective_mass_friction_v = inv_mass_A + inv_mass_B +
+				glm::dot(cross_rA_v, inv_world_tensor_A * cross_rA_v) +
+				glm::dot(cross_rB_v, inv_world_tensor_B * cross_rB_v);
+
+			// Store precomputed contact data into array
+			_out_precomputed_contact_data_arr[contact_idx] = pcd;
+		}
+	}
+
+	/*
+	* @brief	Replace contacts of cache entries created by broadphase pair events with contacts of
+	*			the resolved manifolds.
+	* @param	contact_cache &						Cache with entries of all overlapping pairs
+	* @param	std::vector<contact_manifold> const &	Resolved manifolds, in contact array order.
+	* @details	Entries of pairs without a manifold this step are kept, but have no contacts to warm
+	*			start from. Manifolds of pairs without an entry, e.g. after caching was re-enabled,
+	*			get one.
+	*/
+	static void store_tracked_pair_manifolds(contact_cache& _cache, std::vector<contact_manifold> const& _manifolds)
+	{
+		for (auto& entry : _cache.manifolds)
+			entry.second.contact_count = 0;
 
-			rbA.set_linear_velocity(vA);
-			rbB.set_linear_velocity(vB);
-			rbA.set_angular_velocity(wA);
-			rbB.set_angular_velocity(wB);
+		size_t const entry_count = _cache.manifolds.size();
+		for (contact_manifold const& manifold : _manifolds)
+		{
+			auto const entries_end = _cache.manifolds.begin() + entry_count;
+			auto iter = std::lower_bound(_cache.manifolds.begin(), entries_end, manifold.pair_key,
+				[](auto const& _entry, contact_pair_key _key) { return _entry.first < _key; });
+			if (iter != entries_end && iter->first == manifold.pair_key)
+				iter->second = manifold.data;
+			else
+				_cache.manifolds.emplace_back(manifold.pair_key, manifold.data);
+		}
 
-			// Only set rigidbody data back to rigidbody component after we've gone over
-			// all the contacts between this pair.
-			cm.rigidbodies.first.SetRigidBodyData(rbA);
-			cm.rigidbodies.second.SetRigidBodyData(rbB);
+		if (_cache.manifolds.size() != entry_count)
+		{
+			std::sort(_cache.manifolds.begin() + entry_count, _cache.manifolds.end(),
+				[](auto const& _lhs, auto const& _rhs) { return _lhs.first < _rhs.first; });
+			std::inplace_merge(_cache.manifolds.begin(), _cache.manifolds.begin() + entry_count, _cache.manifolds.end(),
+				[](auto const& _lhs, auto const& _rhs) { return _lhs.first < _rhs.first; });
 		}
 	}
 
 	/*
-	* @brief	Iteratively resolve penetration constraints for contacts
-	* @param	global_contact_data				Contact data for all colliding rigidbodies
-	* @param	physics_simulation_parameters
-	* @param	contact_manifold[]			
-	* @param	size_t							Size of contact manifold array.
-	* @param	contact[]					
+	* @brief	Apply cached contact forces of a manifold when available, and initialize contact
+	*			lambdas to their appropriate value.
+	* @param	contact_cache const &			Cache of previous resolution
+	* @param	contact_manifold const &
+	* @param	solver_body_pair				Solver bodies of manifold
+	* @param	solver_body_collection &
+	* @param	contact[]
 	* @param	precomputed_contact_data[]		1-1 mapping with contact array.
-	* @param	size_t							Size of contact array.
+	* @param	contact_lambdas[]				1-1 mapping with contact array.
 	*/
-	void iterative_constraint_solver_penetration(
-		global_contact_data const& _gobal_contact_data,
-		physics_simulation_parameters const& _parameters,
-		contact_manifold const _contact_manifold_arr[],
-		size_t const _contact_manifold_count,
+	static void apply_cached_manifold_contact_forces(
+		contact_cache const & _cache,
+		contact_manifold const & _cm,
+		solver_body_pair const _body_pair,
+		solver_body_collection & _bodies,
 		contact const _contact_arr[],
 		precomputed_contact_data const _precomputed_contact_data_arr[],
-		contact_lambdas _contact_lambdas_arr[],
-		size_t const _contact_count
+		contact_lambdas _contact_lambdas_arr[]
 	)
 	{
-		for (size_t iteration = 0; iteration < _parameters.resolution_iterations_penetration; iteration++)
+		// Search for cached rigidbody interaction from previous frame.
+		contact_manifold_data cached_manifold_data;
+		bool cached_interaction_found = _cache.find_cached_pair_manifold_data(_cm.pair_key, cached_manifold_data);
+		if (!cached_interaction_found)
+			return;
+
+		uint32_t const body_A = _body_pair.first;
+		uint32_t const body_B = _body_pair.second;
+		float const inv_mass_A = _bodies.inv_masses[body_A];
+		float const inv_mass_B = _bodies.inv_masses[body_B];
+		glm::vec3 const position_A = _bodies.positions[body_A];
+		glm::vec3 const position_B = _bodies.positions[body_B];
+		glm::vec3 vA = _bodies.linear_velocities[body_A];
+		glm::vec3 wA = _bodies.angular_velocities[body_A];
+		glm::vec3 vB = _bodies.linear_velocities[body_B];
+		glm::vec3 wB = _bodies.angular_velocities[body_B];
+
+		glm::mat3 const& inv_world_tensor_A = _bodies.inv_world_tensors[body_A];
+		glm::mat3 const& inv_world_tensor_B = _bodies.inv_world_tensors[body_B];
+
+		// This rigidbody pair has interacted before, perform O(n) search for contacts in
+		// referenced cached contact sub-array and perform warm-start.
+		size_t const manifold_end_contact_idx = _cm.data.first_contact_index + _cm.data.contact_count;
+		for (size_t contact_idx = _cm.data.first_contact_index; contact_idx < manifold_end_contact_idx; contact_idx++)
 		{
-			size_t contact_idx = 0;
-			size_t manifold_end_contact_idx = 0;
-
-			for (size_t i = 0; i < _contact_manifold_count; i++)
+			contact_lambdas& cfl = _contact_lambdas_arr[contact_idx];
+			contact const& c = _contact_arr[contact_idx];
+			precomputed_contact_data const& pcd = _precomputed_contact_data_arr[contact_idx];
+
+			glm::vec3 const rA = c.point - position_A;
+			glm::vec3 const rB = c.point - position_B;
+			glm::vec3 const cross_rA_n = glm::cross(rA, c.normal);
+			glm::vec3 const cross_rB_n = glm::cross(rB, c.normal);
+			glm::vec3 const cross_rA_u = glm::cross(rA, pcd.friction_u);
+			glm::vec3 const cross_rB_u = glm::cross(rB, pcd.friction_u);
+			glm::vec3 const cross_rA_v = glm::cross(rA, pcd.friction_v);
+			glm::vec3 const cross_rB_v = glm::cross(rB, pcd.friction_v);
+
+			size_t const end_contact_idx = cached_manifold_data.first_contact_index + cached_manifold_data.contact_count;
+			for (size_t cached_contact_idx = cached_manifold_data.first_contact_index; cached_contact_idx < end_contact_idx; cached_contact_idx++)
 			{
-				// Precompute common data.
-				contact_manifold cm = _contact_manifold_arr[i];
-				rigidbody_data rbA = cm.rigidbodies.first.GetRigidBodyData();
-				rigidbody_data rbB = cm.rigidbodies.second.GetRigidBodyData();
-
-				glm::mat3 const inv_world_tensor_A = rbA.get_inv_world_tensor();
-				glm::mat3 const inv_world_tensor_B = rbB.get_inv_world_tensor();
-				glm::vec3 vA = rbA.get_linear_velocity();
-				glm::vec3 wA = rbA.get_angular_velocity();
-				glm::vec3 vB = rbB.get_linear_velocity();
-				glm::vec3 wB = rbB.get_angular_velocity();
-
-				manifold_end_contact_idx += cm.data.contact_count;
-				for (size_t contact_idx = cm.data.first_contact_index; contact_idx < manifold_end_contact_idx; contact_idx++)
+				if (_cache.identifiers[cached_contact_idx] == c.identifier)
 				{
-					precomputed_contact_data const pcd = _precomputed_contact_data_arr[contact_idx];
-					contact_lambdas& cfl = _contact_lambdas_arr[contact_idx];
-					contact const & c = _contact_arr[contact_idx];
-					glm::vec3 const rA = c.point - rbA.position;
-					glm::vec3 const rB = c.point - rbB.position;
-					glm::vec3 const cross_rA_n = glm::cross(rA, c.normal);
-					glm::vec3 const cross_rB_n = glm::cross(rB, c.normal);
-
-					// Equal to relative velocity between points
-					glm::vec3 relative_vel = -vA - glm::cross(wA, rA) + vB + glm::cross(wB, rB);
-
-					//// Compute lambda for Baumgarte stabilization
+					// Copy cached lambda values into accumulator lambda values.
+					// Treat new lambda value as delta lambda, and apply it directly.
+					cfl = _cache.lambdas[cached_contact_idx];
 
-					float const JV = glm::dot(c.normal, relative_vel);
+					float const delta_lambda_penetration = cfl.lambda_penetration;
+					float const delta_lambda_friction_u = cfl.lambda_friction_u;
+					float const delta_lambda_friction_v = cfl.lambda_friction_v;
 
-					float delta_lambda_penetration = -((JV + pcd.bias) / pcd.effective_mass_contact);
-					float const new_lambda_penetration = std::max(cfl.lambda_penetration + delta_lambda_penetration, 0.0f);
-					delta_lambda_penetration = new_lambda_penetration - cfl.lambda_penetration;
-					cfl.lambda_penetration = new_lambda_penetration;
+					// Apply penetration and friction constraint force
+					vA = vA + inv_mass_A * (-pcd.friction_u * delta_lambda_friction_u - pcd.friction_v * delta_lambda_friction_v - c.normal * delta_lambda_penetration);
+					wA = wA + inv_world_tensor_A * (-cross_rA_u * delta_lambda_friction_u - cross_rA_v * delta_lambda_friction_v - cross_rA_n * delta_lambda_penetration);
+					vB = vB + inv_mass_B * (pcd.friction_u * delta_lambda_friction_u + pcd.friction_v * delta_lambda_friction_v + c.normal * delta_lambda_penetration);
+					wB = wB + inv_world_tensor_B * (cross_rB_u * delta_lambda_friction_u + cross_rB_v * delta_lambda_friction_v + cross_rB_n * delta_lambda_penetration);
 
-					// Update lambdas in contact, and update rigidbody velocities.
-
-					vA = vA + rbA.inv_mass * -c.normal * delta_lambda_penetration;
-					wA = wA + inv_world_tensor_A * -cross_rA_n * delta_lambda_penetration;
-					vB = vB + rbB.inv_mass * c.normal * delta_lambda_penetration;
-					wB = wB + inv_world_tensor_B * cross_rB_n * delta_lambda_penetration;
+					break;
 				}
-
-				rbA.set_linear_velocity(vA);
-				rbB.set_linear_velocity(vB);
-				rbA.set_angular_velocity(wA);
-				rbB.set_angular_velocity(wB);
-
-				// Only set rigidbody data back to rigidbody component after we've gone over
-				// all the contacts between this pair.
-				cm.rigidbodies.first.SetRigidBodyData(rbA);
-				cm.rigidbodies.second.SetRigidBodyData(rbB);
 			}
 		}
+
+		// Only store velocities after we've gone over all the contacts between this pair.
+		store_solver_body_velocities(_bodies, body_A, vA, wA);
+		store_solver_body_velocities(_bodies, body_B, vB, wB);
 	}
 
 	/*
-	* @brief	Iteratively resolve friction constraints for contacts
-	* @param	global_contact_data				Contact data for all colliding rigidbodies
-	* @param	physics_simulation_parameters
-	* @param	contact_manifold[]
-	* @param	size_t							Size of contact manifold array.
+	* @brief	Resolve penetration constraints for contacts of a manifold once.
+	* @param	contact_manifold const &
+	* @param	solver_body_pair				Solver bodies of manifold
+	* @param	solver_body_collection &
 	* @param	contact[]
 	* @param	precomputed_contact_data[]		1-1 mapping with contact array.
-	* @param	size_t							Size of contact array.
+	* @param	contact_lambdas[]				1-1 mapping with contact array.
 	*/
-	void iterative_constraint_solver_friction(
-		global_contact_data const& _gobal_contact_data,
-		physics_simulation_parameters const& _parameters,
-		contact_manifold const _contact_manifold_arr[],
-		size_t const _contact_manifold_count,
+	static void solve_manifold_penetration(
+		contact_manifold const & _cm,
+		solver_body_pair const _body_pair,
+		solver_body_collection & _bodies,
 		contact const _contact_arr[],
 		precomputed_contact_data const _precomputed_contact_data_arr[],
-		contact_lambdas _contact_lambdas_arr[],
-		size_t const _contact_count
+		contact_lambdas _contact_lambdas_arr[]
 	)
 	{
-		for (size_t iteration = 0; iteration < _parameters.resolution_iterations_friction; iteration++)
+		// Load common data.
+		uint32_t const body_A = _body_pair.first;
+		uint32_t const body_B = _body_pair.second;
+		float const inv_mass_A = _bodies.inv_masses[body_A];
+		float const inv_mass_B = _bodies.inv_masses[body_B];
+		glm::vec3 const position_A = _bodies.positions[body_A];
+		glm::vec3 const position_B = _bodies.positions[body_B];
+
+		glm::mat3 const& inv_world_tensor_A = _bodies.inv_world_tensors[body_A];
+		glm::mat3 const& inv_world_tensor_B = _bodies.inv_world_tensors[body_B];
+		glm::vec3 vA = _bodies.linear_velocities[body_A];
+		glm::vec3 wA = _bodies.angular_velocities[body_A];
+		glm::vec3 vB = _bodies.linear_velocities[body_B];
+		glm::vec3 wB = _bodies.angular_velocities[body_B];
+
+		size_t const manifold_end_contact_idx = _cm.data.first_contact_index + _cm.data.contact_count;
+		for (size_t contact_idx = _cm.data.first_contact_index; contact_idx < manifold_end_contact_idx; contact_idx++)
 		{
-			size_t contact_idx = 0;
-			size_t manifold_end_contact_idx = 0;
+			precomputed_contact_data const pcd = _precomputed_contact_data_arr[contact_idx];
+			contact_lambdas& cfl = _contact_lambdas_arr[contact_idx];
+			contact const & c = _contact_arr[contact_idx];
+			glm::vec3 const rA = c.point - position_A;
+			glm::vec3 const rB = c.point - position_B;
+			glm::vec3 const cross_rA_n = glm::cross(rA, c.normal);
+			glm::vec3 const cross_rB_n = glm::cross(rB, c.normal);
 
-			for (size_t i = 0; i < _contact_manifold_count; i++)
-			{
-				// Precompute common data.
-				contact_manifold cm = _contact_manifold_arr[i];
-				rigidbody_data rbA = cm.rigidbodies.first.GetRigidBodyData();
-				rigidbody_data rbB = cm.rigidbodies.second.GetRigidBodyData();
-
-				glm::mat3 const inv_world_tensor_A = rbA.get_inv_world_tensor();
-				glm::mat3 const inv_world_tensor_B = rbB.get_inv_world_tensor();
-				glm::vec3 vA = rbA.get_linear_velocity();
-				glm::vec3 wA = rbA.get_angular_velocity();
-				glm::vec3 vB = rbB.get_linear_velocity();
-				glm::vec3 wB = rbB.get_angular_velocity();
-
-				float const friction_coefficient = std::min(rbA.friction_coefficient, rbB.friction_coefficient);
-
-				manifold_end_contact_idx += cm.data.contact_count;
-				for (size_t contact_idx = cm.data.first_contact_index; contact_idx < manifold_end_contact_idx; contact_idx++)
-				{
-					precomputed_contact_data const pcd = _precomputed_contact_data_arr[contact_idx];
-					contact_lambdas& cfl = _contact_lambdas_arr[contact_idx];
-					contact const & c = _contact_arr[contact_idx];
-					glm::vec3 const rA = c.point - rbA.position;
-					glm::vec3 const rB = c.point - rbB.position;
-					glm::vec3 const cross_rA_u = glm::cross(rA, pcd.friction_u);
-					glm::vec3 const cross_rB_u = glm::cross(rB, pcd.friction_u);
-					glm::vec3 const cross_rA_v = glm::cross(rA, pcd.friction_v);
-					glm::vec3 const cross_rB_v = glm::cross(rB, pcd.friction_v);
-
-					// Equal to relative velocity between points
-					glm::vec3 relative_vel = -vA - glm::cross(wA, rA) + vB + glm::cross(wB, rB);
-
-					float const constraint_fric_u = glm::dot(relative_vel, pcd.friction_u);
-					float const constraint_fric_v = glm::dot(relative_vel, pcd.friction_v);
-
-					float delta_lambda_friction_u = -(constraint_fric_u / pcd.effective_mass_friction_u);
-					float delta_lambda_friction_v = -(constraint_fric_v / pcd.effective_mass_friction_v);
-
-					float const max_friction_force = friction_coefficient * cfl.lambda_penetration;
-					float const new_lambda_friction_u = std::clamp(cfl.lambda_friction_u + delta_lambda_friction_u, -max_friction_force, max_friction_force);
-					float const new_lambda_friction_v = std::clamp(cfl.lambda_friction_v + delta_lambda_friction_v, -max_friction_force, max_friction_force);
-					delta_lambda_friction_u = new_lambda_friction_u - cfl.lambda_friction_u;
-					delta_lambda_friction_v = new_lambda_friction_v - cfl.lambda_friction_v;
-					cfl.lambda_friction_u = new_lambda_friction_u;
-					cfl.lambda_friction_v = new_lambda_friction_v;
-
-					// Update lambdas in contact, and update rigidbody velocities.
-
-					vA = vA + rbA.inv_mass * (-pcd.friction_u * delta_lambda_friction_u - pcd.friction_v * delta_lambda_friction_v);
-					wA = wA + inv_world_tensor_A * (-cross_rA_u * delta_lambda_friction_u - cross_rA_v * delta_lambda_friction_v);
-					vB = vB + rbB.inv_mass * (pcd.friction_u * delta_lambda_friction_u + pcd.friction_v * delta_lambda_friction_v);
-					wB = wB + inv_world_tensor_B * (cross_rB_u * delta_lambda_friction_u + cross_rB_v * delta_lambda_friction_v);
-				}
+			// Equal to relative velocity between points
+			glm::vec3 relative_vel = -vA - glm::cross(wA, rA) + vB + glm::cross(wB, rB);
 
-				rbA.set_linear_velocity(vA);
-				rbB.set_linear_velocity(vB);
-				rbA.set_angular_velocity(wA);
-				rbB.set_angular_velocity(wB);
+			//// Compute lambda for Baumgarte stabilization
 
-				// Only set rigidbody data back to rigidbody component after we've gone over
-				// all the contacts between this pair.
-				cm.rigidbodies.first.SetRigidBodyData(rbA);
-				cm.rigidbodies.second.SetRigidBodyData(rbB);
-			}
+			float const JV = glm::dot(c.normal, relative_vel);
+
+			float delta_lambda_penetration = -((JV + pcd.bias) / pcd.effective_mass_contact);
+			float const new_lambda_penetration = std::max(cfl.lambda_penetration + delta_lambda_penetration, 0.0f);
+			delta_lambda_penetration = new_lambda_penetration - cfl.lambda_penetration;
+			cfl.lambda_penetration = new_lambda_penetration;
+
+			// Update lambdas in contact, and update rigidbody velocities.
+
+			vA = vA + inv_mass_A * -c.normal * delta_lambda_penetration;
+			wA = wA + inv_world_tensor_A * -cross_rA_n * delta_lambda_penetration;
+			vB = vB + inv_mass_B * c.normal * delta_lambda_penetration;
+			wB = wB + inv_world_tensor_B * cross_rB_n * delta_lambda_penetration;
 		}
+
+		// Only store velocities after we've gone over all the contacts between this pair.
+		store_solver_body_velocities(_bodies, body_A, vA, wA);
+		store_solver_body_velocities(_bodies, body_B, vB, wB);
+	}
+
+	/*
+	* @brief	Resolve friction constraints for contacts of a manifold once.
+	* @param	contact_manifold const &
+	* @param	solver_body_pair				Solver bodies of manifold
+	* @param	solver_body_collection &
+	* @param	contact[]
+	* @param	precomputed_contact_data[]		1-1 mapping with contact array.
+	* @param	contact_lambdas[]				1-1 mapping with contact array.
+	*/
+	static void solve_manifold_friction(
+		contact_manifold const & _cm,
+		solver_body_pair const _body_pair,
+		solver_body_collection & _bodies,
+		contact const _contact_arr[],
+		precomputed_contact_data const _precomputed_contact_data_arr[],
+		contact_lambdas _contact_lambdas_arr[]
+	)
+	{
+		// Load common data.
+		uint32_t const body_A = _body_pair.first;
+		uint32_t const body_B = _body_pair.second;
+		float const inv_mass_A = _bodies.inv_masses[body_A];
+		float const inv_mass_B = _bodies.inv_masses[body_B];
+		glm::vec3 const position_A = _bodies.positions[body_A];
+		glm::vec3 const position_B = _bodies.positions[body_B];
+
+		glm::mat3 const& inv_world_tensor_A = _bodies.inv_world_tensors[body_A];
+		glm::mat3 const& inv_world_tensor_B = _bodies.inv_world_tensors[body_B];
+		glm::vec3 vA = _bodies.linear_velocities[body_A];
+		glm::vec3 wA = _bodies.angular_velocities[body_A];
+		glm::vec3 vB = _bodies.linear_velocities[body_B];
+		glm::vec3 wB = _bodies.angular_velocities[body_B];
+
+		float const friction_coefficient = std::min(_bodies.friction_coefficients[body_A], _bodies.friction_coefficients[body_B]);
+
+		size_t const manifold_end_contact_idx = _cm.data.first_contact_index + _cm.data.contact_count;
+		for (size_t contact_idx = _cm.data.first_contact_index; contact_idx < manifold_end_contact_idx; contact_idx++)
+		{
+			precomputed_contact_data const pcd = _precomputed_contact_data_arr[contact_idx];
+			contact_lambdas& cfl = _contact_lambdas_arr[contact_idx];
+			contact const & c = _contact_arr[contact_idx];
+			glm::vec3 const rA = c.point - position_A;
+			glm::vec3 const rB = c.point - position_B;
+			glm::vec3 const cross_rA_u = glm::cross(rA, pcd.friction_u);
+			glm::vec3 const cross_rB_u = glm::cross(rB, pcd.friction_u);
+			glm::vec3 const cross_rA_v = glm::cross(rA, pcd.friction_v);
+			glm::vec3 const cross_rB_v = glm::cross(rB, pcd.friction_v);
+
+			// Equal to relative velocity between points
+			glm::vec3 relative_vel = -vA - glm::cross(wA, rA) + vB + glm::cross(wB, rB);
+
+			float const constraint_fric_u = glm::dot(relative_vel, pcd.friction_u);
+			float const constraint_fric_v = glm::dot(relative_vel, pcd.friction_v);
+
+			float delta_lambda_friction_u = -(constraint_fric_u / pcd.effective_mass_friction_u);
+			float delta_lambda_friction_v = -(constraint_fric_v / pcd.effective_mass_friction_v);
+
+			float const max_friction_force = friction_coefficient * cfl.lambda_penetration;
+			float const new_lambda_friction_u = std::clamp(cfl.lambda_friction_u + delta_lambda_friction_u, -max_friction_force, max_friction_force);
+			float const new_lambda_friction_v = std::clamp(cfl.lambda_friction_v + delta_lambda_friction_v, -max_friction_force, max_friction_force);
+			delta_lambda_friction_u = new_lambda_friction_u - cfl.lambda_friction_u;
+			delta_lambda_friction_v = new_lambda_friction_v - cfl.lambda_friction_v;
+			cfl.lambda_friction_u = new_lambda_friction_u;
+			cfl.lambda_friction_v = new_lambda_friction_v;
+
+			// Update lambdas in contact, and update rigidbody velocities.
+
+			vA = vA + inv_mass_A * (-pcd.friction_u * delta_lambda_friction_u - pcd.friction_v * delta_lambda_friction_v);
+			wA = wA + inv_world_tensor_A * (-cross_rA_u * delta_lambda_friction_u - cross_rA_v * delta_lambda_friction_v);
+			vB = vB + inv_mass_B * (pcd.friction_u * delta_lambda_friction_u + pcd.friction_v * delta_lambda_friction_v);
+			wB = wB + inv_world_tensor_B * (cross_rB_u * delta_lambda_friction_u + cross_rB_v * delta_lambda_friction_v);
+		}
+
+		// Only store velocities after we've gone over all the contacts between this pair.
+		store_solver_body_velocities(_bodies, body_A, vA, wA);
+		store_solver_body_velocities(_bodies, body_B, vB, wB);
 	}
 
 	/*
 	* @brief	Gauss-Seidel algorithm for contact and friction resolution between
 	*			rigidbodies described by contact manifolds
 	* @param	global_contact_data &			Contact data for all colliding rigidbodies
-	* @param	float							Delta time this frame
 	* @param	physics_simulation_parameters	Parameters of simulation
+	* @param	job_system *					Job system to solve colours on, or null to solve them serially.
+	* @param	contact_solver_context *		Buffers kept between resolutions, or null to use temporary buffers.
 	* 
 	* @details	8 resolution_iterations_penetration are used for resolving friction between rigidbodies.
+	*			Rigidbodies referenced by manifolds are gathered into solver bodies first, and
+	*			their velocities are written back once all iterations are done.
+	*			With parallel or SIMD resolution, each iteration visits manifolds colour by colour
+	*			instead of in manifold order. Every manifold still sees the velocities written by
+	*			manifolds solved before it, so convergence stays Gauss-Seidel-like. SIMD resolution
+	*			solves the manifolds of a colour in lanes, and gives the same lambdas as the scalar
+	*			kernels up to floating point rounding.
 	*/
 	void compute_resolution_gauss_seidel(
 		global_contact_data& _global_contact_data, 
-		physics_simulation_parameters const & _parameters
+		physics_simulation_parameters const & _parameters,
+		Utils::job_system* _job_system,
+		contact_solver_context* _solver_context
 	)
 	{
-		std::vector<precomputed_contact_data> vec_precomputed_contact_data(
-			_global_contact_data.all_contacts.size()
-		);
-		std::vector<contact_lambdas> vec_contact_lambdas(
-			_global_contact_data.all_contacts.size()
-		);
+		contact_manifold const* contact_manifold_arr = _global_contact_data.all_contact_manifolds.data();
+		size_t const contact_manifold_count = _global_contact_data.all_contact_manifolds.size();
+		contact const* contact_arr = _global_contact_data.all_contacts.data();
+
+		contact_solver_context temporary_context;
+		contact_solver_context& context = _solver_context ? *_solver_context : temporary_context;
+
+		// Buffers of the context keep their capacity, so steady-state steps do not allocate.
+		std::vector<precomputed_contact_data>& vec_precomputed_contact_data = context.precomputed_contacts;
+		std::vector<contact_lambdas>& vec_contact_lambdas = context.lambdas;
+		vec_precomputed_contact_data.assign(_global_contact_data.all_contacts.size(), precomputed_contact_data{});
+		vec_contact_lambdas.assign(_global_contact_data.all_contacts.size(), contact_lambdas{});
+		auto& rigidbodies = Singleton<Component::RigidBodyManager>().m_rigidbodies_data;
+
+		build_solver_bodies(contact_manifold_arr, contact_manifold_count, rigidbodies, context);
+		solver_body_collection& bodies = context.bodies;
+		solver_body_pair const* manifold_bodies = context.manifold_bodies.data();
+
+		// SIMD batches are built from colours, so colouring is also required without parallel resolution.
+		contact_solver_context const* colouring = nullptr;
+		if (_parameters.parallel_resolution || _parameters.simd_resolution)
+		{
+			compute_manifold_colouring(context);
+			colouring = &context;
+		}
+		if (!_parameters.parallel_resolution)
+			_job_system = nullptr;
 
 		// Pre-compute repeatedly used data for all contacts.
-		precompute_contact_data_step(
-			_global_contact_data, _parameters,
-			_global_contact_data.all_contact_manifolds.data(),
-			_global_contact_data.all_contact_manifolds.size(),
-			_global_contact_data.all_contacts.data(),
-			vec_precomputed_contact_data.data(),
-			_global_contact_data.all_contacts.size()
+		for_each_manifold(contact_manifold_count, _job_system, colouring,
+			[&](size_t _manifold_idx)
+			{
+				precompute_manifold_contact_data(
+					_parameters, contact_manifold_arr[_manifold_idx], manifold_bodies[_manifold_idx], bodies,
+					contact_arr, vec_precomputed_contact_data.data()
+				);
+			}
 		);
 
 		if(_parameters.contact_caching)
 		{
-			apply_cached_contact_forces_step(
-				_global_contact_data,
-				_parameters,
-				_global_contact_data.all_contact_manifolds.data(),
-				_global_contact_data.all_contact_manifolds.size(),
-				_global_contact_data.all_contacts.data(),
-				vec_precomputed_contact_data.data(),
-				vec_contact_lambdas.data(),
-				_global_contact_data.all_contacts.size()
+			for_each_manifold(contact_manifold_count, _job_system, colouring,
+				[&](size_t _manifold_idx)
+				{
+					apply_cached_manifold_contact_forces(
+						_global_contact_data.cache, contact_manifold_arr[_manifold_idx], manifold_bodies[_manifold_idx], bodies,
+						contact_arr, vec_precomputed_contact_data.data(), vec_contact_lambdas.data()
+					);
+				}
 			);
 		}
 
-		iterative_constraint_solver_penetration(
-			_global_contact_data,
-			_parameters,
-			_global_contact_data.all_contact_manifolds.data(),
-			_global_contact_data.all_contact_manifolds.size(),
-			_global_contact_data.all_contacts.data(),
-			vec_precomputed_contact_data.data(),
-			vec_contact_lambdas.data(),
-			_global_contact_data.all_contacts.size()
-		);
-		
-		iterative_constraint_solver_friction(
-			_global_contact_data,
-			_parameters,
-			_global_contact_data.all_contact_manifolds.data(),
-			_global_contact_data.all_contact_manifolds.size(),
-			_global_contact_data.all_contacts.data(),
-			vec_precomputed_contact_data.data(),
-			vec_contact_lambdas.data(),
-			_global_contact_data.all_contacts.size()
-		);
+		// Regular colours are solved in SIMD batches, which leaves only the overflow colour to the
+		// scalar kernels. Colours are visited in the same order either way.
+		size_t first_scalar_colour = 0;
+		if (_parameters.simd_resolution)
+		{
+			build_contact_batches(contact_manifold_arr, contact_arr, vec_precomputed_contact_data.data(), vec_contact_lambdas.data(), context);
+			first_scalar_colour = context.batches.colour_count();
+		}
+
+		// Iteratively resolve penetration constraints for contacts
+		for (size_t iteration = 0; iteration < _parameters.resolution_iterations_penetration; iteration++)
+		{
+			if (_parameters.simd_resolution)
+				solve_contact_batches_penetration(context, _job_system);
+
+			for_each_manifold(contact_manifold_count, _job_system, colouring,
+				[&](size_t _manifold_idx)
+				{
+					solve_manifold_penetration(
+						contact_manifold_arr[_manifold_idx], manifold_bodies[_manifold_idx], bodies,
+						contact_arr, vec_precomputed_contact_data.data(), vec_contact_lambdas.data()
+					);
+				},
+				first_scalar_colour
+			);
+		}
+
+		// Iteratively resolve friction constraints for contacts
+		for (size_t iteration = 0; iteration < _parameters.resolution_iterations_friction; iteration++)
+		{
+			if (_parameters.simd_resolution)
+				solve_contact_batches_friction(context, _job_system);
+
+			for_each_manifold(contact_manifold_count, _job_system, colouring,
+				[&](size_t _manifold_idx)
+				{
+					solve_manifold_friction(
+						contact_manifold_arr[_manifold_idx], manifold_bodies[_manifold_idx], bodies,
+						contact_arr, vec_precomputed_contact_data.data(), vec_contact_lambdas.data()
+					);
+				},
+				first_scalar_colour
+			);
+		}
+
+		if (_parameters.simd_resolution)
+			store_contact_batch_lambdas(context.batches, vec_contact_lambdas.data());
+
+		write_back_solver_bodies(bodies, rigidbodies);
 
 		/*
 		* Setup data for debug rendering
@@ -463,18 +720,26 @@ namespace Physics {
 		if (_parameters.contact_caching)
 		{
 			contact_cache& cache = _global_contact_data.cache;
-			cache = contact_cache{};
-			for (auto& manifold : _global_contact_data.all_contact_manifolds)
-				cache.manifolds.emplace(manifold.rigidbodies, manifold.data);
-			cache.lambdas = std::move(vec_contact_lambdas);
-			cache.identifiers.insert(
-				cache.identifiers.begin(), 
+			if (cache.tracks_broadphase_pairs)
+				store_tracked_pair_manifolds(cache, _global_contact_data.all_contact_manifolds);
+			else
+			{
+				cache.manifolds.clear();
+				for (auto& manifold : _global_contact_data.all_contact_manifolds)
+					cache.manifolds.emplace_back(manifold.pair_key, manifold.data);
+				std::sort(cache.manifolds.begin(), cache.manifolds.end(),
+					[](auto const& _lhs, auto const& _rhs) { return _lhs.first < _rhs.first; }
+				);
+			}
+			// Lambdas of the previous step are overwritten by the next resolution.
+			cache.lambdas.swap(vec_contact_lambdas);
+			cache.identifiers.assign(
 				_global_contact_data.all_contacts.begin(), 
 				_global_contact_data.all_contacts.end()
 			);
 		}
 		else
-			_global_contact_data.cache = {};
+			_global_contact_data.cache.clear();
 	}
 
 }
@@ -3,8 +3,12 @@
 #include <Engine/Components/Rigidbody.h>
 #include "rigidbody_data.hpp"
 #include "contact.h"
+#include <Engine/Math/simd.hpp>
+
+#include <vector>
 
 namespace Engine {
+namespace Utils { class job_system; }
 namespace Physics {
 
 	struct physics_simulation_parameters
@@ -16,6 +20,13 @@ namespace Physics {
 		float		 baumgarte = 0.2f;
 		float		 slop = 0.02f;
 		bool		 contact_caching = true;
+		bool		 parallel_resolution = false;	// Solve manifolds of each constraint graph colour in parallel.
+		bool		 simd_resolution = false;		// Solve manifolds of a colour in SIMD lanes.
+		// Sleeping
+		bool		 sleeping = true;
+		float		 sleep_linear_velocity = 0.05f;
+		float		 sleep_angular_velocity = 0.05f;
+		unsigned int sleep_frame_count = 30;	// Frames an island has to rest before it is put to sleep.
 	};
 
 	struct precomputed_contact_data
@@ -28,9 +39,202 @@ namespace Physics {
 		float bias;
 	};
 
+	/*
+	* @brief
+	* Solver-local copy of the rigidbodies referenced by contact manifolds, in order of first
+	* reference. Built once per resolution, such that the solver does not look up or copy whole
+	* rigidbodies per manifold. Velocities are written back to rigidbodies at the end.
+	*/
+	struct solver_body_collection
+	{
+		std::vector<glm::vec3>	linear_velocities;
+		std::vector<glm::vec3>	angular_velocities;
+		std::vector<float>		inv_masses;
+		std::vector<glm::mat3>	inv_world_tensors;
+		std::vector<glm::vec3>	positions;
+		std::vector<float>		restitution;
+		std::vector<float>		friction_coefficients;
+		std::vector<uint32_t>	rigidbody_indices;		// Index of body in rigidbody_data_collection
+
+		size_t size() const { return rigidbody_indices.size(); }
+		void clear();
+	};
+
+	// Solver body indices of the two rigidbodies of a manifold.
+	using solver_body_pair = std::pair<uint32_t, uint32_t>;
+
+	// Batches depend on the lane width, so they and the solver context holding them live in the
+	// namespace of the instruction set.
+inline namespace ENGINE_SIMD_NAMESPACE {
+
+	/*
+	* @brief
+	* Contact constraints of up to WIDTH manifolds of the same colour, one manifold per lane.
+	* Row k holds the k-th contact of every lane. Lanes of manifolds with fewer contacts, and lanes
+	* of a partially filled batch, are masked by zero Jacobians and zero effective mass, which makes
+	* their impulses zero.
+	*/
+	struct contact_batch
+	{
+		static constexpr size_t WIDTH = Math::simd_float::WIDTH;
+
+		uint32_t	first_row;
+		uint32_t	row_count;					// Contact count of largest manifold in batch
+		uint32_t	bodies_A[WIDTH];			// Solver bodies, or INVALID_SOLVER_BODY for unused lanes
+		uint32_t	bodies_B[WIDTH];
+		float		inv_masses_A[WIDTH];
+		float		inv_masses_B[WIDTH];
+		float		friction_coefficients[WIDTH];
+	};
+
+	/*
+	* @brief
+	* One contact of each lane of a batch. Angular terms are stored both as r x d, and pre-multiplied
+	* by the inverse world inertia tensor, such that no matrix is applied while iterating.
+	*/
+	struct contact_batch_row
+	{
+		static constexpr size_t WIDTH = Math::simd_float::WIDTH;
+
+		struct jacobian
+		{
+			float	direction[3][WIDTH];		// Normal or tangent
+			float	angular_A[3][WIDTH];		// rA x direction
+			float	angular_B[3][WIDTH];		// rB x direction
+			float	inv_tensor_angular_A[3][WIDTH];
+			float	inv_tensor_angular_B[3][WIDTH];
+			float	inv_effective_mass[WIDTH];
+		};
+
+		jacobian	normal;
+		jacobian	friction_u;
+		jacobian	friction_v;
+		float		bias[WIDTH];
+		float		lambda_penetration[WIDTH];
+		float		lambda_friction_u[WIDTH];
+		float		lambda_friction_v[WIDTH];
+		uint32_t	contact_indices[WIDTH];		// Contact of lane, or ~0u for masked lanes
+	};
+
+	struct contact_batch_collection
+	{
+		std::vector<contact_batch>		batches;
+		std::vector<contact_batch_row>	rows;
+		std::vector<uint32_t>			colour_offsets;		// Start of colour in batches, for every regular colour + 1
+
+		size_t colour_count() const { return colour_offsets.empty() ? 0 : colour_offsets.size() - 1; }
+		void clear();
+	};
+
+	/*
+	* @brief
+	* Solver bodies and manifold colouring. Manifolds are grouped by colour of the constraint graph,
+	* such that no two manifolds of a colour share a dynamic rigidbody. Static rigidbodies are not
+	* written to by the solver, so they do not constrain colouring. Buffers are kept between steps
+	* to avoid reallocating them.
+	*/
+	struct contact_solver_context
+	{
+		// Colours fit in a bitmask per solver body. Manifolds that find no free colour are placed in
+		// an overflow colour, which is solved serially.
+		static constexpr size_t MAX_COLOURS = 64;
+		static constexpr uint32_t INVALID_SOLVER_BODY = ~0u;
+
+		solver_body_collection			bodies;
+		std::vector<solver_body_pair>	manifold_bodies;		// Solver bodies of each manifold
+		std::vector<uint32_t>			rigidbody_solver_bodies;	// Solver body of rigidbody, or INVALID_SOLVER_BODY
+
+		std::vector<uint32_t>	coloured_manifolds;		// Manifold indices sorted by colour
+		std::vector<uint32_t>	colour_offsets;			// Start of colour in coloured_manifolds, size colour_count + 1
+		std::vector<uint64_t>	body_colour_masks;		// Colours used by manifolds of solver body
+		std::vector<uint8_t>	manifold_colours;
+		bool					has_overflow_colour = false;
+
+		contact_batch_collection		batches;				// Regular colours packed into SIMD batches
+
+		std::vector<precomputed_contact_data>	precomputed_contacts;	// Per contact of last resolution
+		std::vector<contact_lambdas>			lambdas;				// Per contact, swapped with lambdas of contact cache
+
+		size_t colour_count() const { return colour_offsets.empty() ? 0 : colour_offsets.size() - 1; }
+	};
+
+}
+
+	/*
+	* @brief	Gather rigidbodies referenced by manifolds into solver bodies.
+	* @param	contact_manifold const *			Manifolds
+	* @param	size_t								Number of manifolds
+	* @param	rigidbody_data_collection const &	Rigidbodies referenced by manifolds
+	* @param	contact_solver_context &			Context receiving solver bodies
+	*/
+	void build_solver_bodies(
+		contact_manifold const _contact_manifold_arr[],
+		size_t const _contact_manifold_count,
+		Component::RigidBodyManager::rigidbody_data_collection const& _rigidbodies,
+		contact_solver_context& _context
+	);
+
+	/*
+	* @brief	Write velocities of dynamic solver bodies back to their rigidbodies.
+	* @param	solver_body_collection const &
+	* @param	rigidbody_data_collection &
+	*/
+	void write_back_solver_bodies(
+		solver_body_collection const& _bodies,
+		Component::RigidBodyManager::rigidbody_data_collection& _rigidbodies
+	);
+
+	/*
+	* @brief	Colour manifolds of solver context greedily in manifold order, which keeps colouring
+	*			deterministic. Requires solver bodies to be built.
+	* @param	contact_solver_context &		Context receiving colouring
+	*/
+	void compute_manifold_colouring(contact_solver_context& _context);
+
+	/*
+	* @brief	Pack manifolds of every regular colour into SIMD batches. The overflow colour is not
+	*			batched, since its manifolds may share bodies. Requires colouring and precomputed
+	*			contact data, and reads lambdas after warm starting.
+	* @param	contact_manifold const *
+	* @param	contact const *
+	* @param	precomputed_contact_data const *	1-1 mapping with contact array.
+	* @param	contact_lambdas const *				1-1 mapping with contact array.
+	* @param	contact_solver_context &			Context receiving batches
+	*/
+	void build_contact_batches(
+		contact_manifold const _contact_manifold_arr[],
+		contact const _contact_arr[],
+		precomputed_contact_data const _precomputed_contact_data_arr[],
+		contact_lambdas const _contact_lambdas_arr[],
+		contact_solver_context& _context
+	);
+
+	/*
+	* @brief	Resolve penetration constraints of all batches once, colour by colour.
+	* @param	contact_solver_context &
+	* @param	job_system *		Job system to distribute batches of a colour over, or null.
+	*/
+	void solve_contact_batches_penetration(contact_solver_context& _context, Utils::job_system* _job_system);
+
+	/*
+	* @brief	Resolve friction constraints of all batches once, colour by colour.
+	* @param	contact_solver_context &
+	* @param	job_system *		Job system to distribute batches of a colour over, or null.
+	*/
+	void solve_contact_batches_friction(contact_solver_context& _context, Utils::job_system* _job_system);
+
+	/*
+	* @brief	Copy accumulated lambdas of batch lanes back to the per-contact array.
+	* @param	contact_batch_collection const &
+	* @param	contact_lambdas *	1-1 mapping with contact array.
+	*/
+	void store_contact_batch_lambdas(contact_batch_collection const& _batches, contact_lambdas _contact_lambdas_arr[]);
+
 	void compute_resolution_gauss_seidel(
 		global_contact_data& _global_contact_data,
-		physics_simulation_parameters const & _parameters
+		physics_simulation_parameters const & _parameters,
+		Utils::job_system* _job_system = nullptr,
+		contact_solver_context* _solver_context = nullptr
 	);
 }
 }
\ No newline at end of file
@@ -0,0 +1,337 @@
+#include "resolution.hpp"
+
+#include <Engine/Utils/job_system.h>
+
+namespace Engine {
+namespace Physics {
+
+	using Math::simd_float;
+	using Math::simd_vec3;
+
+	static size_t constexpr WIDTH = simd_float::WIDTH;
+
+	// Number of batches handed to a thread at once when solving a colour in parallel.
+	static size_t const CONTACT_BATCH_JOB_SIZE = 4;
+
+	static uint32_t constexpr MASKED_CONTACT = ~0u;
+
+	void contact_batch_collection::clear()
+	{
+		batches.clear();
+		rows.clear();
+		colour_offsets.clear();
+	}
+
+	/*
+	* @brief	Velocities of the bodies of every lane of a batch.
+	*/
+	struct batch_velocities
+	{
+		simd_vec3 vA, wA, vB, wB;
+	};
+
+	static simd_vec3 gather_vec3(std::vector<glm::vec3> const& _values, uint32_t const _bodies[])
+	{
+		alignas(32) float lanes[3][WIDTH];
+		for (size_t lane = 0; lane < WIDTH; lane++)
+		{
+			glm::vec3 const value = _bodies[lane] != contact_solver_context::INVALID_SOLVER_BODY
+				? _values[_bodies[lane]]
+				: glm::vec3(0.0f);
+			lanes[0][lane] = value.x;
+			lanes[1][lane] = value.y;
+			lanes[2][lane] = value.z;
+		}
+		return simd_vec3::load(lanes);
+	}
+
+	/*
+	* @details	Static bodies are skipped, as in the scalar solver. Their velocities are unchanged
+	*			since their masses are zero, and they may be shared by lanes or other threads.
+	*/
+	static void scatter_vec3(simd_vec3 const& _value, uint32_t const _bodies[], float const _inv_masses[], std::vector<glm::vec3>& _values)
+	{
+		alignas(32) float lanes[3][WIDTH];
+		_value.store(lanes);
+		for (size_t lane = 0; lane < WIDTH; lane++)
+		{
+			if (_bodies[lane] != contact_solver_context::INVALID_SOLVER_BODY && _inv_masses[lane] > 0.0f)
+				_values[_bodies[lane]] = glm::vec3(lanes[0][lane], lanes[1][lane], lanes[2][lane]);
+		}
+	}
+
+	static batch_velocities load_batch_velocities(contact_batch const& _batch, solver_body_collection const& _bodies)
+	{
+		return {
+			gather_vec3(_bodies.linear_velocities, _batch.bodies_A),
+			gather_vec3(_bodies.angular_velocities, _batch.bodies_A),
+			gather_vec3(_bodies.linear_velocities, _batch.bodies_B),
+			gather_vec3(_bodies.angular_velocities, _batch.bodies_B)
+		};
+	}
+
+	static void store_batch_velocities(contact_batch const& _batch, batch_velocities const& _velocities, solver_body_collection& _bodies)
+	{
+		scatter_vec3(_velocities.vA, _batch.bodies_A, _batch.inv_masses_A, _bodies.linear_velocities);
+		scatter_vec3(_velocities.wA, _batch.bodies_A, _batch.inv_masses_A, _bodies.angular_velocities);
+		scatter_vec3(_velocities.vB, _batch.bodies_B, _batch.inv_masses_B, _bodies.linear_velocities);
+		scatter_vec3(_velocities.wB, _batch.bodies_B, _batch.inv_masses_B, _bodies.angular_velocities);
+	}
+
+	/*
+	* @brief	Relative velocity along a Jacobian. Uses n . (w x r) = w . (r x n), so lever arms
+	*			are not needed.
+	*/
+	static simd_float compute_jacobian_velocity(contact_batch_row::jacobian const& _jacobian, batch_velocities const& _velocities)
+	{
+		return
+			dot(simd_vec3::load(_jacobian.direction), _velocities.vB - _velocities.vA) +
+			dot(simd_vec3::load(_jacobian.angular_B), _velocities.wB) -
+			dot(simd_vec3::load(_jacobian.angular_A), _velocities.wA);
+	}
+
+	static void apply_jacobian_impulse(
+		contact_batch_row::jacobian const& _jacobian,
+		simd_float const _inv_mass_A,
+		simd_float const _inv_mass_B,
+		simd_float const _delta_lambda,
+		batch_velocities& _velocities
+	)
+	{
+		simd_vec3 const direction = simd_vec3::load(_jacobian.direction);
+		_velocities.vA = _velocities.vA - direction * (_inv_mass_A * _delta_lambda);
+		_velocities.wA = _velocities.wA - simd_vec3::load(_jacobian.inv_tensor_angular_A) * _delta_lambda;
+		_velocities.vB = _velocities.vB + direction * (_inv_mass_B * _delta_lambda);
+		_velocities.wB = _velocities.wB + simd_vec3::load(_jacobian.inv_tensor_angular_B) * _delta_lambda;
+	}
+
+	static void solve_batch_penetration(contact_batch const& _batch, contact_batch_row _rows[], solver_body_collection& _bodies)
+	{
+		batch_velocities velocities = load_batch_velocities(_batch, _bodies);
+		simd_float const inv_mass_A = simd_float::load(_batch.inv_masses_A);
+		simd_float const inv_mass_B = simd_float::load(_batch.inv_masses_B);
+
+		// Contacts of a lane share bodies, so rows are solved in order.
+		for (size_t row_idx = 0; row_idx < _batch.row_count; row_idx++)
+		{
+			contact_batch_row& row = _rows[_batch.first_row + row_idx];
+
+			simd_float const JV = compute_jacobian_velocity(row.normal, velocities);
+			simd_float const lambda = simd_float::load(row.lambda_penetration);
+			simd_float const delta_lambda = -(JV + simd_float::load(row.bias)) * simd_float::load(row.normal.inv_effective_mass);
+			simd_float const new_lambda = max(lambda + delta_lambda, simd_float::zero());
+			new_lambda.store(row.lambda_penetration);
+
+			apply_jacobian_impulse(row.normal, inv_mass_A, inv_mass_B, new_lambda - lambda, velocities);
+		}
+
+		store_batch_velocities(_batch, velocities, _bodies);
+	}
+
+	static void solve_batch_friction(contact_batch const& _batch, contact_batch_row _rows[], solver_body_collection& _bodies)
+	{
+		batch_velocities velocities = load_batch_velocities(_batch, _bodies);
+		simd_float const inv_mass_A = simd_float::load(_batch.inv_masses_A);
+		simd_float const inv_mass_B = simd_float::load(_batch.inv_masses_B);
+		simd_float const friction_coefficient = simd_float::load(_batch.friction_coefficients);
+
+		for (size_t row_idx = 0; row_idx < _batch.row_count; row_idx++)
+		{
+			contact_batch_row& row = _rows[_batch.first_row + row_idx];
+
+			// Both tangents use the relative velocity from before either impulse is applied.
+			simd_float const JV_u = compute_jacobian_velocity(row.friction_u, velocities);
+			simd_float const JV_v = compute_jacobian_velocity(row.friction_v, velocities);
+
+			simd_float const max_friction_force = friction_coefficient * simd_float::load(row.lambda_penetration);
+			simd_float const lambda_u = simd_float::load(row.lambda_friction_u);
+			simd_float const lambda_v = simd_float::load(row.lambda_friction_v);
+			simd_float const new_lambda_u = clamp(lambda_u - JV_u * simd_float::load(row.friction_u.inv_effective_mass), -max_friction_force, max_friction_force);
+			simd_float const new_lambda_v = clamp(lambda_v - JV_v * simd_float::load(row.friction_v.inv_effective_mass), -max_friction_force, max_friction_force);
+			new_lambda_u.store(row.lambda_friction_u);
+			new_lambda_v.store(row.lambda_friction_v);
+
+			apply_jacobian_impulse(row.friction_u, inv_mass_A, inv_mass_B, new_lambda_u - lambda_u, velocities);
+			apply_jacobian_impulse(row.friction_v, inv_mass_A, inv_mass_B, new_lambda_v - lambda_v, velocities);
+		}
+
+		store_batch_velocities(_batch, velocities, _bodies);
+	}
+
+	/*
+	* @brief	Fill lane of a Jacobian. A zero effective mass, as for masked lanes, gives a zero impulse.
+	*/
+	static void set_jacobian_lane(
+		contact_batch_row::jacobian& _jacobian,
+		size_t const _lane,
+		glm::vec3 const _direction,
+		glm::vec3 const _rA,
+		glm::vec3 const _rB,
+		glm::mat3 const& _inv_world_tensor_A,
+		glm::mat3 const& _inv_world_tensor_B,
+		float const _effective_mass
+	)
+	{
+		glm::vec3 const angular_A = glm::cross(_rA, _direction);
+		glm::vec3 const angular_B = glm::cross(_rB, _direction);
+		glm::vec3 const inv_tensor_angular_A = _inv_world_tensor_A * angular_A;
+		glm::vec3 const inv_tensor_angular_B = _inv_world_tensor_B * angular_B;
+		for (int axis = 0; axis < 3; axis++)
+		{
+			_jacobian.direction[axis][_lane] = _direction[axis];
+			_jacobian.angular_A[axis][_lane] = angular_A[axis];
+			_jacobian.angular_B[axis][_lane] = angular_B[axis];
+			_jacobian.inv_tensor_angular_A[axis][_lane] = inv_tensor_angular_A[axis];
+			_jacobian.inv_tensor_angular_B[axis][_lane] = inv_tensor_angular_B[axis];
+		}
+		_jacobian.inv_effective_mass[_lane] = _effective_mass > 0.0f ? 1.0f / _effective_mass : 0.0f;
+	}
+
+	void build_contact_batches(
+		contact_manifold const _contact_manifold_arr[],
+		contact const _contact_arr[],
+		precomputed_contact_data const _precomputed_contact_data_arr[],
+		contact_lambdas const _contact_lambdas_arr[],
+		contact_solver_context& _context
+	)
+	{
+		contact_batch_collection& batches = _context.batches;
+		solver_body_collection const& bodies = _context.bodies;
+		batches.clear();
+
+		size_t const regular_colour_count = _context.colour_count() - (_context.has_overflow_colour ? 1 : 0);
+		batches.colour_offsets.push_back(0);
+		for (size_t colour = 0; colour < regular_colour_count; colour++)
+		{
+			uint32_t const colour_begin = _context.colour_offsets[colour];
+			uint32_t const colour_end = _context.colour_offsets[colour + 1];
+			for (uint32_t batch_begin = colour_begin; batch_begin < colour_end; batch_begin += (uint32_t)WIDTH)
+			{
+				size_t const lane_count = std::min<size_t>(WIDTH, colour_end - batch_begin);
+
+				contact_batch& batch = batches.batches.emplace_back();
+				batch.first_row = (uint32_t)batches.rows.size();
+				batch.row_count = 0;
+				for (size_t lane = 0; lane < WIDTH; lane++)
+				{
+					batch.bodies_A[lane] = batch.bodies_B[lane] = contact_solver_context::INVALID_SOLVER_BODY;
+					batch.inv_masses_A[lane] = batch.inv_masses_B[lane] = batch.friction_coefficients[lane] = 0.0f;
+				}
+				for (size_t lane = 0; lane < lane_count; lane++)
+				{
+					uint32_t const manifold_idx = _context.coloured_manifolds[batch_begin + lane];
+					solver_body_pair const body_pair = _context.manifold_bodies[manifold_idx];
+					batch.bodies_A[lane] = body_pair.first;
+					batch.bodies_B[lane] = body_pair.second;
+					batch.inv_masses_A[lane] = bodies.inv_masses[body_pair.first];
+					batch.inv_masses_B[lane] = bodies.inv_masses[body_pair.second];
+					batch.friction_coefficients[lane] = std::min(bodies.friction_coefficients[body_pair.first], bodies.friction_coefficients[body_pair.second]);
+					batch.row_count = std::max<uint32_t>(batch.row_count, _contact_manifold_arr[manifold_idx].data.contact_count);
+				}
+
+				// Zero-initialized rows mask every lane until a contact is written to it.
+				batches.rows.resize(batches.rows.size() + batch.row_count, contact_batch_row{});
+				for (size_t row_idx = 0; row_idx < batch.row_count; row_idx++)
+				{
+					contact_batch_row& row = batches.rows[batch.first_row + row_idx];
+					for (size_t lane = 0; lane < WIDTH; lane++)
+						row.contact_indices[lane] = MASKED_CONTACT;
+				}
+
+				for (size_t lane = 0; lane < lane_count; lane++)
+				{
+					uint32_t const manifold_idx = _context.coloured_manifolds[batch_begin + lane];
+					contact_manifold const& cm = _contact_manifold_arr[manifold_idx];
+					solver_body_pair const body_pair = _context.manifold_bodies[manifold_idx];
+					glm::vec3 const position_A = bodies.positions[body_pair.first];
+					glm::vec3 const position_B = bodies.positions[body_pair.second];
+					glm::mat3 const& inv_world_tensor_A = bodies.inv_world_tensors[body_pair.first];
+					glm::mat3 const& inv_world_tensor_B = bodies.inv_world_tensors[body_pair.second];
+
+					for (uint32_t i = 0; i < cm.data.contact_count; i++)
+					{
+						uint32_t const contact_idx = cm.data.first_contact_index + i;
+						contact const& c = _contact_arr[contact_idx];
+						precomputed_contact_data const& pcd = _precomputed_contact_data_arr[contact_idx];
+						contact_lambdas const& cfl = _contact_lambdas_arr[contact_idx];
+						glm::vec3 const rA = c.point - position_A;
+						glm::vec3 const rB = c.point - position_B;
+
+						contact_batch_row& row = batches.rows[batch.first_row + i];
+						set_jacobian_lane(row.normal, lane, c.normal, rA, rB, inv_world_tensor_A, inv_world_tensor_B, pcd.effective_mass_contact);
+						set_jacobian_lane(row.friction_u, lane, pcd.friction_u, rA, rB, inv_world_tensor_A, inv_world_tensor_B, pcd.effective_mass_friction_u);
+						set_jacobian_lane(row.friction_v, lane, pcd.friction_v, rA, rB, inv_world_tensor_A, inv_world_tensor_B, pcd.effective_mass_friction_v);
+						row.bias[lane] = pcd.bias;
+						row.lambda_penetration[lane] = cfl.lambda_penetration;
+						row.lambda_friction_u[lane] = cfl.lambda_friction_u;
+						row.lambda_friction_v[lane] = cfl.lambda_friction_v;
+						row.contact_indices[lane] = contact_idx;
+					}
+				}
+			}
+			batches.colour_offsets.push_back((uint32_t)batches.batches.size());
+		}
+	}
+
+	/*
+	* @brief	Call function for every batch, colour by colour. Batches of a colour share no
+	*			dynamic body, so they are distributed over the job system if one is given.
+	*/
+	template<typename TFunc>
+	static void for_each_contact_batch(contact_batch_collection& _batches, Utils::job_system* _job_system, TFunc&& _func)
+	{
+		for (size_t colour = 0; colour < _batches.colour_count(); colour++)
+		{
+			uint32_t const colour_begin = _batches.colour_offsets[colour];
+			uint32_t const colour_end = _batches.colour_offsets[colour + 1];
+			if (!_job_system)
+			{
+				for (uint32_t batch_idx = colour_begin; batch_idx < colour_end; batch_idx++)
+					_func(_batches.batches[batch_idx]);
+				continue;
+			}
+
+			_job_system->parallel_for(colour_end - colour_begin, CONTACT_BATCH_JOB_SIZE,
+				[&](size_t _begin, size_t _end, unsigned int _thread_index)
+				{
+					for (size_t i = _begin; i < _end; i++)
+						_func(_batches.batches[colour_begin + i]);
+				}
+			);
+		}
+	}
+
+	void solve_contact_batches_penetration(contact_solver_context& _context, Utils::job_system* _job_system)
+	{
+		contact_batch_row* rows = _context.batches.rows.data();
+		for_each_contact_batch(_context.batches, _job_system,
+			[&](contact_batch const& _batch) { solve_batch_penetration(_batch, rows, _context.bodies); }
+		);
+	}
+
+	void solve_contact_batches_friction(contact_solver_context& _context, Utils::job_system* _job_system)
+	{
+		contact_batch_row* rows = _context.batches.rows.data();
+		for_each_contact_batch(_context.batches, _job_system,
+			[&](contact_batch const& _batch) { solve_batch_friction(_batch, rows, _context.bodies); }
+		);
+	}
+
+	void store_contact_batch_lambdas(contact_batch_collection const& _batches, contact_lambdas _contact_lambdas_arr[])
+	{
+		for (contact_batch_row const& row : _batches.rows)
+		{
+			for (size_t lane = 0; lane < WIDTH; lane++)
+			{
+				if (row.contact_indices[lane] == MASKED_CONTACT)
+					continue;
+				contact_lambdas& cfl = _contact_lambdas_arr[row.contact_indices[lane]];
+				cfl.lambda_penetration = row.lambda_penetration[lane];
+				cfl.lambda_friction_u = row.lambda_friction_u[lane];
+				cfl.lambda_friction_v = row.lambda_friction_v[lane];
+			}
+		}
+	}
+
+}
+}
@@ -18,6 +18,7 @@ namespace Physics {
 		glm::vec3	torque_accumulator;
 		glm::mat3	inertial_tensor;
 		glm::mat3	inv_inertial_tensor;
+		glm::mat3	inv_world_tensor;		// Cached for rotation and inertia when data was read from manager.
 		float		restitution;
 		float		friction_coefficient;
 
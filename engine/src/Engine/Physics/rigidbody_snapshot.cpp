@@ -0,0 +1,230 @@
+#include "rigidbody_snapshot.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace Engine {
+namespace Physics {
+
+	template<typename T>
+	static bool bitwise_equal(T const& _lhs, T const& _rhs)
+	{
+		return std::memcmp(&_lhs, &_rhs, sizeof(T)) == 0;
+	}
+
+	template<typename T>
+	static bool bitwise_equal(std::vector<T> const& _lhs, std::vector<T> const& _rhs)
+	{
+		return _lhs.size() == _rhs.size() && (_lhs.empty() || std::memcmp(_lhs.data(), _rhs.data(), _lhs.size() * sizeof(T)) == 0);
+	}
+
+	template<typename T>
+	static size_t vector_memory_usage(std::vector<T> const& _vector)
+	{
+		return _vector.size() * sizeof(T);
+	}
+
+	rigidbody_snapshot_ring::rigidbody_snapshot_ring(size_t _capacity)
+		: m_frames(std::max<size_t>(_capacity, 1))
+	{
+	}
+
+	/*
+	* @brief	Append snapshot of rigidbody state, overwriting the oldest frame if the ring is full.
+	* @param	rigidbody_data_collection const &	Rigidbody data to record
+	*/
+	void rigidbody_snapshot_ring::record(rigidbody_data_collection const& _data)
+	{
+		static_assert(std::is_trivially_copyable_v<ECS::Entity>, "Entities are copied as plain data.");
+
+		if (frame_count() == capacity())
+			evict_oldest_frame();
+
+		// Deltas can only be encoded against a previous frame with the same bodies.
+		bool const is_keyframe =
+			!m_delta_encoding ||
+			m_force_keyframe ||
+			m_begin == m_end ||
+			m_frames_since_keyframe + 1 >= m_keyframe_interval ||
+			!bitwise_equal(m_last_state.entities, _data.m_index_entities);
+
+		frame& new_frame = get_frame(m_end);
+		new_frame.is_keyframe = is_keyframe;
+		new_frame.changed_indices.clear();
+		if (is_keyframe)
+		{
+			new_frame.entities.assign(_data.m_index_entities.begin(), _data.m_index_entities.end());
+			new_frame.positions.assign(_data.m_positions.begin(), _data.m_positions.end());
+			new_frame.linear_momentums.assign(_data.m_linear_momentums.begin(), _data.m_linear_momentums.end());
+			new_frame.rotations.assign(_data.m_rotations.begin(), _data.m_rotations.end());
+			new_frame.angular_momentums.assign(_data.m_angular_momentums.begin(), _data.m_angular_momentums.end());
+
+			if (m_delta_encoding)
+			{
+				m_last_state.entities = new_frame.entities;
+				m_last_state.positions = new_frame.positions;
+				m_last_state.linear_momentums = new_frame.linear_momentums;
+				m_last_state.rotations = new_frame.rotations;
+				m_last_state.angular_momentums = new_frame.angular_momentums;
+			}
+			m_frames_since_keyframe = 0;
+		}
+		else
+		{
+			new_frame.entities.clear();
+			new_frame.positions.clear();
+			new_frame.linear_momentums.clear();
+			new_frame.rotations.clear();
+			new_frame.angular_momentums.clear();
+
+			for (size_t i = 0; i < _data.size(); i++)
+			{
+				bool const unchanged =
+					bitwise_equal(_data.m_positions[i], m_last_state.positions[i]) &&
+					bitwise_equal(_data.m_linear_momentums[i], m_last_state.linear_momentums[i]) &&
+					bitwise_equal(_data.m_rotations[i], m_last_state.rotations[i]) &&
+					bitwise_equal(_data.m_angular_momentums[i], m_last_state.angular_momentums[i]);
+				if (unchanged)
+					continue;
+
+				new_frame.changed_indices.push_back((uint32_t)i);
+				new_frame.positions.push_back(_data.m_positions[i]);
+				new_frame.linear_momentums.push_back(_data.m_linear_momentums[i]);
+				new_frame.rotations.push_back(_data.m_rotations[i]);
+				new_frame.angular_momentums.push_back(_data.m_angular_momentums[i]);
+
+				m_last_state.positions[i] = _data.m_positions[i];
+				m_last_state.linear_momentums[i] = _data.m_linear_momentums[i];
+				m_last_state.rotations[i] = _data.m_rotations[i];
+				m_last_state.angular_momentums[i] = _data.m_angular_momentums[i];
+			}
+			m_frames_since_keyframe++;
+		}
+
+		m_force_keyframe = false;
+		m_end++;
+	}
+
+	/*
+	* @brief	Restore rigidbody state recorded in frame.
+	* @param	size_t						Frame index relative to oldest recorded frame
+	* @param	rigidbody_data_collection &	Rigidbody data to write state to
+	* @return	bool						False if frame is not recorded.
+	* @details	If bodies were added or removed since the frame was recorded, only bodies
+	*			that still exist are restored.
+	*/
+	bool rigidbody_snapshot_ring::restore(size_t _frame, rigidbody_data_collection& _data)
+	{
+		if (_frame >= frame_count())
+			return false;
+
+		// Oldest frame is always a keyframe.
+		size_t const frame_index = m_begin + _frame;
+		size_t keyframe_index = frame_index;
+		while (!get_frame(keyframe_index).is_keyframe)
+			keyframe_index--;
+
+		frame const& keyframe = get_frame(keyframe_index);
+		m_restore_state.entities = keyframe.entities;
+		m_restore_state.positions = keyframe.positions;
+		m_restore_state.linear_momentums = keyframe.linear_momentums;
+		m_restore_state.rotations = keyframe.rotations;
+		m_restore_state.angular_momentums = keyframe.angular_momentums;
+
+		for (size_t delta_index = keyframe_index + 1; delta_index <= frame_index; delta_index++)
+		{
+			frame const& delta = get_frame(delta_index);
+			for (size_t i = 0; i < delta.changed_indices.size(); i++)
+			{
+				uint32_t const body_index = delta.changed_indices[i];
+				m_restore_state.positions[body_index] = delta.positions[i];
+				m_restore_state.linear_momentums[body_index] = delta.linear_momentums[i];
+				m_restore_state.rotations[body_index] = delta.rotations[i];
+				m_restore_state.angular_momentums[body_index] = delta.angular_momentums[i];
+			}
+		}
+
+		if (bitwise_equal(m_restore_state.entities, _data.m_index_entities))
+		{
+			_data.m_positions = m_restore_state.positions;
+			_data.m_linear_momentums = m_restore_state.linear_momentums;
+			_data.m_rotations = m_restore_state.rotations;
+			_data.m_angular_momentums = m_restore_state.angular_momentums;
+		}
+		else
+		{
+			for (size_t i = 0; i < m_restore_state.entities.size(); i++)
+			{
+				auto iter = _data.m_entity_map.find(m_restore_state.entities[i]);
+				if (iter == _data.m_entity_map.end())
+					continue;
+
+				size_t const body_index = iter->second;
+				_data.m_positions[body_index] = m_restore_state.positions[i];
+				_data.m_linear_momentums[body_index] = m_restore_state.linear_momentums[i];
+				_data.m_rotations[body_index] = m_restore_state.rotations[i];
+				_data.m_angular_momentums[body_index] = m_restore_state.angular_momentums[i];
+			}
+		}
+
+		_data.update_inv_world_tensors();
+
+		// Simulation may continue from restored state, so next frame cannot be a delta.
+		m_force_keyframe = true;
+		return true;
+	}
+
+	/*
+	* @brief	Discard frames recorded after the first frames.
+	* @param	size_t	Number of oldest frames to keep
+	*/
+	void rigidbody_snapshot_ring::truncate(size_t _frame_count)
+	{
+		if (_frame_count >= frame_count())
+			return;
+
+		m_end = m_begin + _frame_count;
+		m_force_keyframe = true;
+	}
+
+	void rigidbody_snapshot_ring::clear()
+	{
+		m_begin = 0;
+		m_end = 0;
+		m_frames_since_keyframe = 0;
+		m_force_keyframe = true;
+	}
+
+	/*
+	* @brief	Number of bytes of snapshot data held by recorded frames.
+	*/
+	size_t rigidbody_snapshot_ring::memory_usage() const
+	{
+		size_t bytes = 0;
+		for (size_t i = m_begin; i < m_end; i++)
+		{
+			frame const& f = get_frame(i);
+			bytes += vector_memory_usage(f.entities);
+			bytes += vector_memory_usage(f.changed_indices);
+			bytes += vector_memory_usage(f.positions);
+			bytes += vector_memory_usage(f.linear_momentums);
+			bytes += vector_memory_usage(f.rotations);
+			bytes += vector_memory_usage(f.angular_momentums);
+		}
+		return bytes;
+	}
+
+	/*
+	* Delta frames cannot be restored without their keyframe,
+	* so they are evicted together with it.
+	*/
+	void rigidbody_snapshot_ring::evict_oldest_frame()
+	{
+		m_begin++;
+		while (m_begin < m_end && !get_frame(m_begin).is_keyframe)
+			m_begin++;
+	}
+
+}
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <Engine/Components/Rigidbody.h>
+
+#include <vector>
+
+namespace Engine {
+namespace Physics {
+
+	/*
+	* @brief	Ring buffer of binary snapshots of rigidbody simulation state.
+	* @details	Snapshots copy the state arrays of the rigidbody data collection (positions,
+	*			rotations and momentums) as plain arrays. Constant properties are not recorded,
+	*			since the simulation never changes them.
+	*			With delta encoding, only keyframes store every body. Other frames store the
+	*			bodies whose state changed since the previous frame, and are restored by applying
+	*			them on top of the preceding keyframe. Frame buffers are reused, so recording does
+	*			not allocate once the ring is full.
+	*/
+	struct rigidbody_snapshot_ring
+	{
+		using rigidbody_data_collection = Component::RigidBodyManager::rigidbody_data_collection;
+
+		explicit rigidbody_snapshot_ring(size_t _capacity = 200);
+
+		bool			m_delta_encoding = true;
+		unsigned int	m_keyframe_interval = 16;
+
+		void	record(rigidbody_data_collection const& _data);
+		bool	restore(size_t _frame, rigidbody_data_collection& _data);
+		void	truncate(size_t _frame_count);
+		void	clear();
+
+		size_t	frame_count() const { return m_end - m_begin; }
+		size_t	capacity() const { return m_frames.size(); }
+		size_t	memory_usage() const;
+
+	private:
+
+		struct frame
+		{
+			bool						is_keyframe = true;
+			std::vector<ECS::Entity>	entities;			// Keyframes only, delta frames share entities of previous frame.
+			std::vector<uint32_t>		changed_indices;	// Delta frames only, body indices of state arrays.
+			std::vector<glm::vec3>		positions;
+			std::vector<glm::vec3>		linear_momentums;
+			std::vector<glm::quat>		rotations;
+			std::vector<glm::vec3>		angular_momentums;
+		};
+
+		std::vector<frame>	m_frames;
+		size_t				m_begin = 0;
+		size_t				m_end = 0;
+
+		// Full state of last recorded frame, used to compute deltas.
+		frame				m_last_state;
+		unsigned int		m_frames_since_keyframe = 0;
+		bool				m_force_keyframe = true;
+
+		// Reconstructed full state of frame being restored.
+		frame				m_restore_state;
+
+		frame&			get_frame(size_t _index) { return m_frames[_index % m_frames.size()]; }
+		frame const&	get_frame(size_t _index) const { return m_frames[_index % m_frames.size()]; }
+		void			evict_oldest_frame();
+	};
+
+}
+}
@@ -0,0 +1,273 @@
+#include "sweep_and_prune.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Engine {
+namespace Physics {
+
+	/*
+	* @brief	Create a proxy for a bounding volume.
+	* @param	aabb		Bounding volume of object
+	* @param	uint32_t	User value returned in computed pairs and events
+	* @return	proxy_id	Handle used to update or destroy the proxy.
+	* @details	Endpoints of new proxies are sorted in, and their pairs found, on the next update().
+	*/
+	sweep_and_prune::proxy_id sweep_and_prune::create_proxy(Math::aabb const& _bounds, uint32_t _user_data)
+	{
+		proxy_id proxy;
+		if (!m_free_proxies.empty())
+		{
+			proxy = m_free_proxies.back();
+			m_free_proxies.pop_back();
+		}
+		else
+		{
+			proxy = (proxy_id)m_proxies.size();
+			m_proxies.emplace_back();
+		}
+
+		proxy_data& data = m_proxies[proxy];
+		data.min = _bounds.center - _bounds.extent;
+		data.max = _bounds.center + _bounds.extent;
+		data.user_data = _user_data;
+		data.in_use = true;
+
+		for (unsigned int axis = 0; axis < 3; axis++)
+		{
+			m_axis_endpoints[axis].push_back({ data.min[axis], uint32_t(proxy) << 1 });
+			m_axis_endpoints[axis].push_back({ data.max[axis], (uint32_t(proxy) << 1) | 1u });
+		}
+		m_proxy_count++;
+		m_has_new_proxies = true;
+		return proxy;
+	}
+
+	/*
+	* @brief	Destroy proxy, reporting all of its current pairs as removed.
+	* @param	proxy_id	Proxy to destroy
+	*/
+	void sweep_and_prune::destroy_proxy(proxy_id _proxy)
+	{
+		assert(_proxy >= 0 && _proxy < (proxy_id)m_proxies.size() && m_proxies[_proxy].in_use);
+
+		for (auto it = m_pairs.begin(); it != m_pairs.end();)
+		{
+			proxy_id const a = proxy_id(*it >> 32);
+			proxy_id const b = proxy_id(*it & 0xFFFFFFFFu);
+			if (a == _proxy || b == _proxy)
+			{
+				m_removed_pairs.push_back(get_user_pair(a, b));
+				it = m_pairs.erase(it);
+			}
+			else
+				++it;
+		}
+
+		for (auto& endpoints : m_axis_endpoints)
+		{
+			endpoints.erase(
+				std::remove_if(endpoints.begin(), endpoints.end(), [_proxy](endpoint const& _e) { return _e.proxy() == _proxy; }),
+				endpoints.end()
+			);
+		}
+
+		m_proxies[_proxy].in_use = false;
+		m_free_proxies.push_back(_proxy);
+		m_proxy_count--;
+	}
+
+	void sweep_and_prune::update_proxy(proxy_id _proxy, Math::aabb const& _bounds)
+	{
+		assert(_proxy >= 0 && _proxy < (proxy_id)m_proxies.size() && m_proxies[_proxy].in_use);
+		m_proxies[_proxy].min = _bounds.center - _bounds.extent;
+		m_proxies[_proxy].max = _bounds.center + _bounds.extent;
+	}
+
+	/*
+	* @brief	Re-sort endpoints using updated proxy bounds, and update overlapping pairs.
+	* @details	Pairs that started or stopped overlapping are appended to m_added_pairs
+	*			and m_removed_pairs respectively.
+	*			If proxies were created since the last update, the endpoints are fully re-sorted
+	*			and pairs recomputed with a single sweep instead, since insertion sort would
+	*			degrade to quadratic time when many proxies are added at once.
+	*/
+	void sweep_and_prune::update()
+	{
+		for (unsigned int axis = 0; axis < 3; axis++)
+		{
+			for (endpoint& e : m_axis_endpoints[axis])
+			{
+				proxy_data const& data = m_proxies[e.proxy()];
+				e.value = e.is_max() ? data.max[axis] : data.min[axis];
+			}
+		}
+
+		if (m_has_new_proxies)
+			rebuild();
+		else
+		{
+			for (unsigned int axis = 0; axis < 3; axis++)
+				sort_axis(axis);
+		}
+	}
+
+	void sweep_and_prune::clear()
+	{
+		for (auto& endpoints : m_axis_endpoints)
+			endpoints.clear();
+		m_proxies.clear();
+		m_free_proxies.clear();
+		m_proxy_count = 0;
+		m_pairs.clear();
+		m_has_new_proxies = false;
+		clear_events();
+	}
+
+	void sweep_and_prune::clear_events()
+	{
+		m_added_pairs.clear();
+		m_removed_pairs.clear();
+	}
+
+	/*
+	* @brief	Output all pairs of proxies whose bounding volumes overlapped at the last update.
+	* @param	std::vector<broadphase_pair> &	Output pairs of user values, sorted in ascending order.
+	*/
+	void sweep_and_prune::compute_pairs(std::vector<broadphase_pair>& _out_pairs) const
+	{
+		_out_pairs.clear();
+		_out_pairs.reserve(m_pairs.size());
+		for (uint64_t const key : m_pairs)
+			_out_pairs.push_back(get_user_pair(proxy_id(key >> 32), proxy_id(key & 0xFFFFFFFFu)));
+
+		// Sort such that pair order does not depend on hash set layout.
+		std::sort(_out_pairs.begin(), _out_pairs.end());
+	}
+
+	uint64_t sweep_and_prune::make_pair_key(proxy_id _a, proxy_id _b)
+	{
+		uint64_t const lo = (uint64_t)std::min(_a, _b);
+		uint64_t const hi = (uint64_t)std::max(_a, _b);
+		return (lo << 32) | hi;
+	}
+
+	bool sweep_and_prune::overlaps(proxy_id _a, proxy_id _b) const
+	{
+		proxy_data const& a = m_proxies[_a];
+		proxy_data const& b = m_proxies[_b];
+		for (unsigned int axis = 0; axis < 3; axis++)
+		{
+			if (a.max[axis] < b.min[axis] || b.max[axis] < a.min[axis])
+				return false;
+		}
+		return true;
+	}
+
+	/*
+	* Endpoints are ordered by value, with minimum endpoints placed before maximum
+	* endpoints of equal value such that touching bounds are considered overlapping.
+	*/
+	bool sweep_and_prune::endpoint_less(endpoint const& _lhs, endpoint const& _rhs)
+	{
+		if (_lhs.value != _rhs.value)
+			return _lhs.value < _rhs.value;
+		return !_lhs.is_max() && _rhs.is_max();
+	}
+
+	/*
+	* @brief	Insertion sort endpoints on given axis, updating pairs on every swap
+	*			between a minimum and a maximum endpoint.
+	* @param	unsigned int	Axis index
+	*/
+	void sweep_and_prune::sort_axis(unsigned int _axis)
+	{
+		std::vector<endpoint>& endpoints = m_axis_endpoints[_axis];
+		for (size_t i = 1; i < endpoints.size(); i++)
+		{
+			endpoint const key = endpoints[i];
+			size_t j = i;
+			while (j > 0 && endpoint_less(key, endpoints[j - 1]))
+			{
+				endpoint const& swapped = endpoints[j - 1];
+				if (key.is_max() != swapped.is_max())
+				{
+					// Minimum moved below a maximum: intervals started overlapping on this axis.
+					if (!key.is_max())
+					{
+						if (overlaps(key.proxy(), swapped.proxy()))
+							add_pair(key.proxy(), swapped.proxy());
+					}
+					// Maximum moved below a minimum: intervals stopped overlapping.
+					else
+						remove_pair(key.proxy(), swapped.proxy());
+				}
+				endpoints[j] = swapped;
+				j--;
+			}
+			endpoints[j] = key;
+		}
+	}
+
+	/*
+	* @brief	Fully re-sort endpoints, and recompute pairs by sweeping the x-axis.
+	*/
+	void sweep_and_prune::rebuild()
+	{
+		for (auto& endpoints : m_axis_endpoints)
+			std::sort(endpoints.begin(), endpoints.end(), endpoint_less);
+
+		std::unordered_set<uint64_t> new_pairs;
+		new_pairs.reserve(m_pairs.size());
+		std::vector<proxy_id> active;
+		for (endpoint const& e : m_axis_endpoints[0])
+		{
+			proxy_id const proxy = e.proxy();
+			if (e.is_max())
+			{
+				active.erase(std::find(active.begin(), active.end(), proxy));
+				continue;
+			}
+			for (proxy_id const other : active)
+			{
+				if (overlaps(proxy, other))
+					new_pairs.insert(make_pair_key(proxy, other));
+			}
+			active.push_back(proxy);
+		}
+
+		for (uint64_t const key : m_pairs)
+		{
+			if (new_pairs.find(key) == new_pairs.end())
+				m_removed_pairs.push_back(get_user_pair(proxy_id(key >> 32), proxy_id(key & 0xFFFFFFFFu)));
+		}
+		for (uint64_t const key : new_pairs)
+		{
+			if (m_pairs.find(key) == m_pairs.end())
+				m_added_pairs.push_back(get_user_pair(proxy_id(key >> 32), proxy_id(key & 0xFFFFFFFFu)));
+		}
+		m_pairs = std::move(new_pairs);
+		m_has_new_proxies = false;
+	}
+
+	void sweep_and_prune::add_pair(proxy_id _a, proxy_id _b)
+	{
+		if (m_pairs.insert(make_pair_key(_a, _b)).second)
+			m_added_pairs.push_back(get_user_pair(_a, _b));
+	}
+
+	void sweep_and_prune::remove_pair(proxy_id _a, proxy_id _b)
+	{
+		if (m_pairs.erase(make_pair_key(_a, _b)) != 0)
+			m_removed_pairs.push_back(get_user_pair(_a, _b));
+	}
+
+	broadphase_pair sweep_and_prune::get_user_pair(proxy_id _a, proxy_id _b) const
+	{
+		uint32_t const user_a = m_proxies[_a].user_data;
+		uint32_t const user_b = m_proxies[_b].user_data;
+		return broadphase_pair(std::min(user_a, user_b), std::max(user_a, user_b));
+	}
+
+}
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "broadphase.h"
+
+#include <Engine/Math/geometry.hpp>
+
+#include <unordered_set>
+#include <vector>
+
+namespace Engine {
+namespace Physics {
+
+	/*
+	* @brief	Sweep-and-prune broadphase with persistent sorted endpoint arrays.
+	* @details	Minimum and maximum endpoints of every proxy are kept sorted on all three axes
+	*			across updates using insertion sort, so a temporally coherent scene only performs
+	*			a handful of swaps per update. Swapping a minimum endpoint with a maximum endpoint
+	*			is what starts or ends an overlap, which is used to maintain a persistent set of
+	*			overlapping pairs without testing all proxies against each other.
+	*/
+	struct sweep_and_prune
+	{
+		typedef broadphase_proxy proxy_id;
+
+		// Pairs of user values that started / stopped overlapping since events were last cleared.
+		std::vector<broadphase_pair>	m_added_pairs;
+		std::vector<broadphase_pair>	m_removed_pairs;
+
+		proxy_id	create_proxy(Math::aabb const& _bounds, uint32_t _user_data);
+		void		destroy_proxy(proxy_id _proxy);
+		void		update_proxy(proxy_id _proxy, Math::aabb const& _bounds);
+		void		update();
+		void		clear();
+		void		clear_events();
+
+		uint32_t	get_user_data(proxy_id _proxy) const { return m_proxies[_proxy].user_data; }
+		void		set_user_data(proxy_id _proxy, uint32_t _user_data) { m_proxies[_proxy].user_data = _user_data; }
+		size_t		proxy_count() const { return m_proxy_count; }
+		size_t		pair_count() const { return m_pairs.size(); }
+
+		void		compute_pairs(std::vector<broadphase_pair>& _out_pairs) const;
+
+	private:
+
+		struct endpoint
+		{
+			float		value;
+			uint32_t	data;	// Proxy ID in upper bits, lowest bit set if endpoint is a maximum.
+
+			proxy_id	proxy() const { return proxy_id(data >> 1); }
+			bool		is_max() const { return data & 1u; }
+		};
+
+		struct proxy_data
+		{
+			glm::vec3	min;
+			glm::vec3	max;
+			uint32_t	user_data = 0;
+			bool		in_use = false;
+		};
+
+		std::vector<endpoint>			m_axis_endpoints[3];
+		std::vector<proxy_data>			m_proxies;
+		std::vector<proxy_id>			m_free_proxies;
+		size_t							m_proxy_count = 0;
+		bool							m_has_new_proxies = false;
+		// Overlapping proxy pairs, keyed by make_pair_key.
+		std::unordered_set<uint64_t>	m_pairs;
+
+		static uint64_t make_pair_key(proxy_id _a, proxy_id _b);
+		static bool		endpoint_less(endpoint const& _lhs, endpoint const& _rhs);
+		bool			overlaps(proxy_id _a, proxy_id _b) const;
+		void			sort_axis(unsigned int _axis);
+		void			rebuild();
+		void			add_pair(proxy_id _a, proxy_id _b);
+		void			remove_pair(proxy_id _a, proxy_id _b);
+		broadphase_pair	get_user_pair(proxy_id _a, proxy_id _b) const;
+	};
+
+}
+}
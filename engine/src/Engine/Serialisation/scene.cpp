@@ -1,6 +1,7 @@
 #include "scene.h"
 
 #include <Engine/ECS/component_manager.h>
+#include <Engine/Utils/allocation_tracker.h>
 
 using namespace nlohmann;
 namespace Engine {
@@ -9,6 +10,11 @@ namespace Serialisation {
 
 	void DeserialiseScene(nlohmann::json const& _j)
 	{
+		ENGINE_ALLOCATION_SCOPE(eSerialisation);
+
+		// Entity handles of component data are converted from the layout the scene was saved with.
+		serialized_entity_format_scope const entity_format_scope(get_serialized_entity_format(_j["EntityManager"]));
+
 		Singleton<EntityManager>().Deserialize(_j["EntityManager"]);
 
 		if (_j.find("resources") != _j.end())
@@ -22,6 +28,8 @@ namespace Serialisation {
 
 	void SerialiseScene(nlohmann::json& _j)
 	{
+		ENGINE_ALLOCATION_SCOPE(eSerialisation);
+
 		Singleton<EntityManager>().Serialize(_j["EntityManager"]);
 
 		Singleton<Engine::Managers::ResourceManager>().ExportSceneResources(_j["resources"]);
@@ -1,6 +1,7 @@
 #ifndef ENGINE_UTILS_ALGORITHM
 #define ENGINE_UTILS_ALGORITHM
 
+#include <algorithm>
 #include <utility>
 
 namespace Engine {
@@ -16,6 +17,29 @@ namespace Utils
 	*/
 	std::pair<int, int> float_binary_search(float const* _array, size_t _array_size, float _value);
 
+	/*
+	* Erase entries at given indices from container, keeping order of remaining entries.
+	* @param	TContainer &	Container with random access iterators
+	* @param	TIndices const&	Ascending, unique indices of entries to erase
+	* @details	Every run of entries between erased indices is moved once, so erasing many entries
+	*			costs a single pass over the container from the first erased index.
+	*/
+	template<typename TContainer, typename TIndices>
+	void erase_sorted_indices(TContainer& _container, TIndices const& _sorted_indices)
+	{
+		if (_sorted_indices.empty())
+			return;
+
+		auto write_iter = _container.begin() + _sorted_indices.front();
+		for (size_t i = 0; i < _sorted_indices.size(); i++)
+		{
+			auto const run_begin = _container.begin() + (_sorted_indices[i] + 1);
+			auto const run_end = (i + 1 < _sorted_indices.size()) ? _container.begin() + _sorted_indices[i + 1] : _container.end();
+			write_iter = std::move(run_begin, run_end, write_iter);
+		}
+		_container.erase(write_iter, _container.end());
+	}
+
 }
 }
 #endif // !ENGINE_UTILS_ALGORITHM
@@ -0,0 +1,290 @@
+#include "allocation_tracker.h"
+
+#include <imgui.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include <ostream>
+
+namespace Engine {
+namespace Utils
+{
+
+	namespace
+	{
+		// Counters of a subsystem. Last slot counts all subsystems together.
+		struct atomic_stats
+		{
+			std::atomic<uint64_t>	allocation_count{ 0 };
+			std::atomic<uint64_t>	deallocation_count{ 0 };
+			std::atomic<uint64_t>	bytes_allocated{ 0 };
+			std::atomic<uint64_t>	bytes_deallocated{ 0 };
+			std::atomic<int64_t>	live_bytes{ 0 };
+			std::atomic<int64_t>	peak_live_bytes{ 0 };
+		};
+
+		size_t constexpr TOTAL_SLOT = allocation_tracker::SUBSYSTEM_COUNT;
+
+		// Constant initialized, so hooks can run before static constructors.
+		atomic_stats s_frame_stats[allocation_tracker::SUBSYSTEM_COUNT + 1];
+		allocation_tracker::frame_report s_last_frame;
+		thread_local allocation_subsystem tl_current_subsystem = allocation_subsystem::eUntagged;
+
+		void update_peak(std::atomic<int64_t>& _peak, int64_t _value)
+		{
+			int64_t peak = _peak.load(std::memory_order_relaxed);
+			while (_value > peak && !_peak.compare_exchange_weak(peak, _value, std::memory_order_relaxed))
+				;
+		}
+
+		void record(atomic_stats& _stats, size_t _bytes, bool _allocation)
+		{
+			if (_allocation)
+			{
+				_stats.allocation_count.fetch_add(1, std::memory_order_relaxed);
+				_stats.bytes_allocated.fetch_add(_bytes, std::memory_order_relaxed);
+				int64_t const live = _stats.live_bytes.fetch_add((int64_t)_bytes, std::memory_order_relaxed) + (int64_t)_bytes;
+				update_peak(_stats.peak_live_bytes, live);
+			}
+			else
+			{
+				_stats.deallocation_count.fetch_add(1, std::memory_order_relaxed);
+				_stats.bytes_deallocated.fetch_add(_bytes, std::memory_order_relaxed);
+				_stats.live_bytes.fetch_sub((int64_t)_bytes, std::memory_order_relaxed);
+			}
+		}
+
+		[[maybe_unused]] void record_allocation(allocation_subsystem _subsystem, size_t _bytes, bool _allocation)
+		{
+			record(s_frame_stats[(size_t)_subsystem], _bytes, _allocation);
+			record(s_frame_stats[TOTAL_SLOT], _bytes, _allocation);
+		}
+
+		allocation_tracker::subsystem_stats load_stats(atomic_stats const& _stats)
+		{
+			allocation_tracker::subsystem_stats result;
+			result.allocation_count = _stats.allocation_count.load(std::memory_order_relaxed);
+			result.deallocation_count = _stats.deallocation_count.load(std::memory_order_relaxed);
+			result.bytes_allocated = _stats.bytes_allocated.load(std::memory_order_relaxed);
+			result.bytes_deallocated = _stats.bytes_deallocated.load(std::memory_order_relaxed);
+			result.live_bytes = _stats.live_bytes.load(std::memory_order_relaxed);
+			result.peak_live_bytes = _stats.peak_live_bytes.load(std::memory_order_relaxed);
+			return result;
+		}
+
+		// Reset per frame counters. Live bytes carry over, and start the peak of the next frame.
+		allocation_tracker::subsystem_stats exchange_stats(atomic_stats& _stats)
+		{
+			allocation_tracker::subsystem_stats result;
+			result.allocation_count = _stats.allocation_count.exchange(0, std::memory_order_relaxed);
+			result.deallocation_count = _stats.deallocation_count.exchange(0, std::memory_order_relaxed);
+			result.bytes_allocated = _stats.bytes_allocated.exchange(0, std::memory_order_relaxed);
+			result.bytes_deallocated = _stats.bytes_deallocated.exchange(0, std::memory_order_relaxed);
+			result.live_bytes = _stats.live_bytes.load(std::memory_order_relaxed);
+			result.peak_live_bytes = _stats.peak_live_bytes.exchange(result.live_bytes, std::memory_order_relaxed);
+			return result;
+		}
+	}
+
+	bool allocation_tracker::enabled()
+	{
+#ifdef ENGINE_ALLOCATION_TRACKING
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	allocation_tracker::frame_report allocation_tracker::current_frame()
+	{
+		frame_report report;
+		for (size_t i = 0; i < SUBSYSTEM_COUNT; i++)
+			report.subsystems[i] = load_stats(s_frame_stats[i]);
+		report.total = load_stats(s_frame_stats[TOTAL_SLOT]);
+		return report;
+	}
+
+	allocation_tracker::frame_report const& allocation_tracker::last_frame()
+	{
+		return s_last_frame;
+	}
+
+	void allocation_tracker::end_frame()
+	{
+		for (size_t i = 0; i < SUBSYSTEM_COUNT; i++)
+			s_last_frame.subsystems[i] = exchange_stats(s_frame_stats[i]);
+		s_last_frame.total = exchange_stats(s_frame_stats[TOTAL_SLOT]);
+	}
+
+	void allocation_tracker::dump(std::ostream& _out, frame_report const& _report)
+	{
+		auto write_row = [&_out](const char* _name, subsystem_stats const& _stats)
+		{
+			_out << std::left << std::setw(16) << _name << std::right
+				<< std::setw(12) << _stats.allocation_count
+				<< std::setw(12) << _stats.deallocation_count
+				<< std::setw(16) << _stats.bytes_allocated
+				<< std::setw(16) << _stats.live_bytes
+				<< std::setw(16) << _stats.peak_live_bytes << '\n';
+		};
+
+		_out << std::left << std::setw(16) << "subsystem" << std::right
+			<< std::setw(12) << "allocs"
+			<< std::setw(12) << "frees"
+			<< std::setw(16) << "bytes"
+			<< std::setw(16) << "live_bytes"
+			<< std::setw(16) << "peak_bytes" << '\n';
+		for (size_t i = 0; i < SUBSYSTEM_COUNT; i++)
+			write_row(subsystem_name((allocation_subsystem)i), _report.subsystems[i]);
+		write_row("Total", _report.total);
+	}
+
+	const char* allocation_tracker::subsystem_name(allocation_subsystem _subsystem)
+	{
+		switch (_subsystem)
+		{
+		case allocation_subsystem::eUntagged:		return "Untagged";
+		case allocation_subsystem::eECS:			return "ECS";
+		case allocation_subsystem::ePhysics:		return "Physics";
+		case allocation_subsystem::eAnimation:		return "Animation";
+		case allocation_subsystem::eGraphics:		return "Graphics";
+		case allocation_subsystem::eSerialisation:	return "Serialisation";
+		default:									return "Unknown";
+		}
+	}
+
+	void allocation_tracker::display_editor_window()
+	{
+		if (ImGui::Begin("Allocations"))
+		{
+			if (!enabled())
+				ImGui::TextWrapped("Build with ENGINE_ALLOCATION_TRACKING to track heap allocations.");
+			else
+			{
+				frame_report const& report = last_frame();
+				ImGui::Text("Last frame: %llu allocations, %.1f KB", (unsigned long long)report.total.allocation_count, report.total.bytes_allocated / 1024.0f);
+				if (ImGui::BeginTable("Subsystems", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+				{
+					ImGui::TableSetupColumn("Subsystem");
+					ImGui::TableSetupColumn("Allocs");
+					ImGui::TableSetupColumn("Frees");
+					ImGui::TableSetupColumn("KB");
+					ImGui::TableSetupColumn("Peak Live KB");
+					ImGui::TableHeadersRow();
+
+					auto display_row = [](const char* _name, subsystem_stats const& _stats)
+					{
+						ImGui::TableNextRow();
+						ImGui::TableNextColumn();
+						ImGui::TextUnformatted(_name);
+						ImGui::TableNextColumn();
+						ImGui::Text("%llu", (unsigned long long)_stats.allocation_count);
+						ImGui::TableNextColumn();
+						ImGui::Text("%llu", (unsigned long long)_stats.deallocation_count);
+						ImGui::TableNextColumn();
+						ImGui::Text("%.1f", _stats.bytes_allocated / 1024.0f);
+						ImGui::TableNextColumn();
+						ImGui::Text("%.1f", _stats.peak_live_bytes / 1024.0f);
+					};
+					for (size_t i = 0; i < SUBSYSTEM_COUNT; i++)
+						display_row(subsystem_name((allocation_subsystem)i), report.subsystems[i]);
+					display_row("Total", report.total);
+					ImGui::EndTable();
+				}
+			}
+		}
+		ImGui::End();
+	}
+
+	allocation_subsystem allocation_tracker::current_subsystem()
+	{
+		return tl_current_subsystem;
+	}
+
+	void allocation_tracker::set_current_subsystem(allocation_subsystem _subsystem)
+	{
+		tl_current_subsystem = _subsystem;
+	}
+
+}
+}
+
+#ifdef ENGINE_ALLOCATION_TRACKING
+
+namespace
+{
+	using Engine::Utils::allocation_subsystem;
+
+	// Stored in front of every allocation, so that deallocation knows what to untrack.
+	struct allocation_header
+	{
+		void*					raw;
+		size_t					size;
+		allocation_subsystem	subsystem;
+	};
+
+	void* tracked_allocate(size_t _size, size_t _alignment) noexcept
+	{
+		_alignment = std::max(_alignment, alignof(allocation_header));
+		void* const raw = std::malloc(_size + _alignment + sizeof(allocation_header));
+		if (!raw)
+			return nullptr;
+
+		uintptr_t const address = (reinterpret_cast<uintptr_t>(raw) + sizeof(allocation_header) + _alignment - 1) & ~(uintptr_t)(_alignment - 1);
+		allocation_header* const header = reinterpret_cast<allocation_header*>(address) - 1;
+		header->raw = raw;
+		header->size = _size;
+		header->subsystem = Engine::Utils::allocation_tracker::current_subsystem();
+		Engine::Utils::record_allocation(header->subsystem, _size, true);
+		return reinterpret_cast<void*>(address);
+	}
+
+	void* tracked_allocate_or_throw(size_t _size, size_t _alignment)
+	{
+		while (true)
+		{
+			if (void* const ptr = tracked_allocate(_size, _alignment))
+				return ptr;
+			std::new_handler const handler = std::get_new_handler();
+			if (!handler)
+				throw std::bad_alloc();
+			handler();
+		}
+	}
+
+	void tracked_deallocate(void* _ptr) noexcept
+	{
+		if (!_ptr)
+			return;
+		allocation_header const* const header = static_cast<allocation_header*>(_ptr) - 1;
+		Engine::Utils::record_allocation(header->subsystem, header->size, false);
+		std::free(header->raw);
+	}
+}
+
+void* operator new(std::size_t _size) { return tracked_allocate_or_throw(_size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](std::size_t _size) { return tracked_allocate_or_throw(_size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(std::size_t _size, std::align_val_t _alignment) { return tracked_allocate_or_throw(_size, (size_t)_alignment); }
+void* operator new[](std::size_t _size, std::align_val_t _alignment) { return tracked_allocate_or_throw(_size, (size_t)_alignment); }
+void* operator new(std::size_t _size, std::nothrow_t const&) noexcept { return tracked_allocate(_size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](std::size_t _size, std::nothrow_t const&) noexcept { return tracked_allocate(_size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(std::size_t _size, std::align_val_t _alignment, std::nothrow_t const&) noexcept { return tracked_allocate(_size, (size_t)_alignment); }
+void* operator new[](std::size_t _size, std::align_val_t _alignment, std::nothrow_t const&) noexcept { return tracked_allocate(_size, (size_t)_alignment); }
+
+void operator delete(void* _ptr) noexcept { tracked_deallocate(_ptr); }
+void operator delete[](void* _ptr) noexcept { tracked_deallocate(_ptr); }
+void operator delete(void* _ptr, std::size_t) noexcept { tracked_deallocate(_ptr); }
+void operator delete[](void* _ptr, std::size_t) noexcept { tracked_deallocate(_ptr); }
+void operator delete(void* _ptr, std::align_val_t) noexcept { tracked_deallocate(_ptr); }
+void operator delete[](void* _ptr, std::align_val_t) noexcept { tracked_deallocate(_ptr); }
+void operator delete(void* _ptr, std::size_t, std::align_val_t) noexcept { tracked_deallocate(_ptr); }
+void operator delete[](void* _ptr, std::size_t, std::align_val_t) noexcept { tracked_deallocate(_ptr); }
+void operator delete(void* _ptr, std::nothrow_t const&) noexcept { tracked_deallocate(_ptr); }
+void operator delete[](void* _ptr, std::nothrow_t const&) noexcept { tracked_deallocate(_ptr); }
+void operator delete(void* _ptr, std::align_val_t, std::nothrow_t const&) noexcept { tracked_deallocate(_ptr); }
+void operator delete[](void* _ptr, std::align_val_t, std::nothrow_t const&) noexcept { tracked_deallocate(_ptr); }
+
+#endif // ENGINE_ALLOCATION_TRACKING
@@ -0,0 +1,112 @@
+#ifndef ENGINE_UTILS_ALLOCATION_TRACKER_H
+#define ENGINE_UTILS_ALLOCATION_TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+namespace Engine {
+namespace Utils
+{
+
+	enum class allocation_subsystem : uint8_t
+	{
+		eUntagged = 0,
+		eECS,
+		ePhysics,
+		eAnimation,
+		eGraphics,
+		eSerialisation,
+		eCount
+	};
+
+	/*
+	* @brief	Heap allocation statistics per subsystem, collected frame by frame.
+	* @details	When built with ENGINE_ALLOCATION_TRACKING, global operator new and delete are replaced
+	*			by hooks that attribute every allocation to the subsystem of the innermost allocation_scope
+	*			of the allocating thread. Allocations outside of any scope, including those of job system
+	*			workers, are untagged. Without ENGINE_ALLOCATION_TRACKING no hooks are installed and all
+	*			statistics stay zero.
+	*/
+	class allocation_tracker
+	{
+	public:
+
+		static size_t constexpr SUBSYSTEM_COUNT = (size_t)allocation_subsystem::eCount;
+
+		struct subsystem_stats
+		{
+			uint64_t	allocation_count = 0;
+			uint64_t	deallocation_count = 0;
+			uint64_t	bytes_allocated = 0;
+			uint64_t	bytes_deallocated = 0;
+			int64_t		live_bytes = 0;			// Bytes allocated and not yet freed, since program start
+			int64_t		peak_live_bytes = 0;	// Largest live bytes during frame
+		};
+
+		struct frame_report
+		{
+			subsystem_stats subsystems[SUBSYSTEM_COUNT];
+			subsystem_stats total;
+
+			subsystem_stats const& operator[](allocation_subsystem _subsystem) const { return subsystems[(size_t)_subsystem]; }
+		};
+
+		// Whether allocation hooks are compiled in.
+		static bool enabled();
+
+		// Statistics since the last end_frame().
+		static frame_report current_frame();
+		static frame_report const& last_frame();
+
+		// Close current frame, its statistics become last_frame().
+		static void end_frame();
+
+		// Write report as a table, for logs and headless runs.
+		static void dump(std::ostream& _out, frame_report const& _report);
+
+		static const char* subsystem_name(allocation_subsystem _subsystem);
+
+		// ImGui window showing the last frame.
+		static void display_editor_window();
+
+		static allocation_subsystem current_subsystem();
+
+	private:
+
+		friend class allocation_scope;
+		static void set_current_subsystem(allocation_subsystem _subsystem);
+	};
+
+	/*
+	* @brief	Attributes heap allocations of the calling thread to a subsystem while in scope.
+	*/
+	class allocation_scope
+	{
+	public:
+
+		explicit allocation_scope(allocation_subsystem _subsystem) :
+			m_previous(allocation_tracker::current_subsystem())
+		{
+			allocation_tracker::set_current_subsystem(_subsystem);
+		}
+		~allocation_scope() { allocation_tracker::set_current_subsystem(m_previous); }
+
+		allocation_scope(allocation_scope const&) = delete;
+		allocation_scope& operator=(allocation_scope const&) = delete;
+
+	private:
+
+		allocation_subsystem m_previous;
+	};
+
+}
+}
+
+#ifdef ENGINE_ALLOCATION_TRACKING
+#define ENGINE_ALLOCATION_SCOPE(subsystem) Engine::Utils::allocation_scope const engine_allocation_scope(Engine::Utils::allocation_subsystem::subsystem)
+#else
+#define ENGINE_ALLOCATION_SCOPE(subsystem)
+#endif
+
+#endif // !ENGINE_UTILS_ALLOCATION_TRACKER_H
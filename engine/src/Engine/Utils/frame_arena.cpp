@@ -0,0 +1,102 @@
+#include "frame_arena.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <new>
+
+namespace Engine {
+namespace Utils
+{
+
+	frame_arena::frame_arena(size_t _initial_block_size) :
+		m_next_block_size(std::max<size_t>(_initial_block_size, 64))
+	{
+	}
+
+	frame_arena::~frame_arena()
+	{
+		for (block const& b : m_blocks)
+			::operator delete(b.data, std::align_val_t(alignof(std::max_align_t)));
+	}
+
+	void frame_arena::reset()
+	{
+		std::lock_guard<std::mutex> const lock(m_mutex);
+
+		// Replace blocks with one block that fits everything allocated this frame.
+		if (m_blocks.size() > 1)
+		{
+			size_t total_size = 0;
+			for (block const& b : m_blocks)
+			{
+				total_size += b.size;
+				::operator delete(b.data, std::align_val_t(alignof(std::max_align_t)));
+			}
+			m_blocks.clear();
+			m_next_block_size = total_size;
+			push_block(total_size);
+		}
+		m_offset = 0;
+
+		m_current_stats.peak_bytes_allocated = std::max(m_current_stats.peak_bytes_allocated, m_current_stats.bytes_allocated);
+		m_last_frame_stats = m_current_stats;
+		m_current_stats = stats();
+		m_current_stats.peak_bytes_allocated = m_last_frame_stats.peak_bytes_allocated;
+	}
+
+	size_t frame_arena::capacity() const
+	{
+		std::lock_guard<std::mutex> const lock(m_mutex);
+		size_t total_size = 0;
+		for (block const& b : m_blocks)
+			total_size += b.size;
+		return total_size;
+	}
+
+	void* frame_arena::do_allocate(size_t _bytes, size_t _alignment)
+	{
+		std::lock_guard<std::mutex> const lock(m_mutex);
+
+		auto aligned_offset = [&]() -> size_t
+		{
+			uintptr_t const address = reinterpret_cast<uintptr_t>(m_blocks.back().data) + m_offset;
+			uintptr_t const aligned_address = (address + _alignment - 1) & ~(uintptr_t)(_alignment - 1);
+			return m_offset + (size_t)(aligned_address - address);
+		};
+
+		size_t offset = m_blocks.empty() ? 0 : aligned_offset();
+		if (m_blocks.empty() || offset + _bytes > m_blocks.back().size)
+		{
+			push_block(_bytes + _alignment);
+			offset = aligned_offset();
+		}
+
+		m_current_stats.allocation_count++;
+		m_current_stats.bytes_allocated += (offset - m_offset) + _bytes;
+		m_offset = offset + _bytes;
+		return m_blocks.back().data + offset;
+	}
+
+	void frame_arena::do_deallocate(void*, size_t, size_t)
+	{
+		// Memory is released by reset().
+	}
+
+	bool frame_arena::do_is_equal(std::pmr::memory_resource const& _other) const noexcept
+	{
+		return this == &_other;
+	}
+
+	void frame_arena::push_block(size_t _min_size)
+	{
+		size_t const size = std::max(m_next_block_size, _min_size);
+		void* const data = ::operator new(size, std::align_val_t(alignof(std::max_align_t)));
+		m_blocks.push_back(block{ static_cast<std::byte*>(data), size });
+		m_offset = 0;
+		m_next_block_size = size * 2;
+		m_current_stats.heap_allocation_count++;
+	}
+
+}
+}
@@ -0,0 +1,80 @@
+#ifndef ENGINE_UTILS_FRAME_ARENA_H
+#define ENGINE_UTILS_FRAME_ARENA_H
+
+#include <cstddef>
+#include <memory_resource>
+#include <mutex>
+#include <vector>
+
+namespace Engine {
+namespace Utils
+{
+
+	/*
+	* @brief	Linear allocator for memory that only lives until the end of the frame.
+	* @details	Allocations bump a pointer through a block of memory and deallocation does nothing.
+	*			reset() releases all allocations at once. When a frame needed more than one block,
+	*			reset() replaces them with a single block large enough for the whole frame, so
+	*			after a few frames the arena stops allocating from the heap.
+	*			Allocation is thread-safe. Containers allocated from the arena must be destroyed
+	*			or cleared before reset() is called.
+	*			Arenas are owned by the frame loop of the host, which is the only code that knows when
+	*			a frame ends. Engine systems keep their own persistent buffers instead.
+	*/
+	class frame_arena final : public std::pmr::memory_resource
+	{
+	public:
+
+		static size_t constexpr DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+		struct stats
+		{
+			size_t	allocation_count = 0;		// Allocations served this frame
+			size_t	bytes_allocated = 0;		// Bytes handed out this frame, including alignment padding
+			size_t	heap_allocation_count = 0;	// Blocks allocated from the heap this frame
+			size_t	peak_bytes_allocated = 0;	// Largest bytes_allocated of any frame
+		};
+
+		explicit frame_arena(size_t _initial_block_size = DEFAULT_BLOCK_SIZE);
+		~frame_arena();
+
+		frame_arena(frame_arena const&) = delete;
+		frame_arena& operator=(frame_arena const&) = delete;
+
+		// Release all allocations made since the last reset.
+		void reset();
+
+		// Statistics of the current frame. Last frame statistics are kept until the next reset.
+		stats const& current_stats() const { return m_current_stats; }
+		stats const& last_frame_stats() const { return m_last_frame_stats; }
+
+		size_t capacity() const;
+
+	private:
+
+		struct block
+		{
+			std::byte*	data;
+			size_t		size;
+		};
+
+		std::vector<block>	m_blocks;
+		size_t				m_offset = 0;	// Offset into last block
+		size_t				m_next_block_size;
+		stats				m_current_stats;
+		stats				m_last_frame_stats;
+		mutable std::mutex	m_mutex;
+
+		void*	do_allocate(size_t _bytes, size_t _alignment) override;
+		void	do_deallocate(void* _ptr, size_t _bytes, size_t _alignment) override;
+		bool	do_is_equal(std::pmr::memory_resource const& _other) const noexcept override;
+
+		void	push_block(size_t _min_size);
+	};
+
+	template<typename T>
+	using frame_vector = std::pmr::vector<T>;
+
+}
+}
+#endif // !ENGINE_UTILS_FRAME_ARENA_H
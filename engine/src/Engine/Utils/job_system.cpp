@@ -0,0 +1,137 @@
+#include "job_system.h"
+
+#include <algorithm>
+
+namespace Engine {
+namespace Utils
+{
+	// Set while a thread is executing batches, such that nested jobs run serially.
+	static thread_local bool tl_executing_job = false;
+
+	job_system::job_system()
+		: job_system(default_thread_count())
+	{
+	}
+
+	job_system::job_system(unsigned int _thread_count)
+	{
+		start_workers(std::max(_thread_count, 1u) - 1);
+	}
+
+	job_system::~job_system()
+	{
+		stop_workers();
+	}
+
+	void job_system::set_thread_count(unsigned int _thread_count)
+	{
+		_thread_count = std::max(_thread_count, 1u);
+		if (_thread_count == thread_count())
+			return;
+
+		stop_workers();
+		start_workers(_thread_count - 1);
+	}
+
+	unsigned int job_system::default_thread_count()
+	{
+		return std::max(std::thread::hardware_concurrency(), 1u);
+	}
+
+	void job_system::run_job(size_t _count, size_t _batch_size, batch_function _function, void* _context)
+	{
+		if (_count == 0)
+			return;
+
+		job new_job;
+		new_job.function = _function;
+		new_job.context = _context;
+		new_job.count = _count;
+		new_job.batch_size = std::max<size_t>(_batch_size, 1);
+
+		// Run serially if there is nothing to distribute, or if called from within a job.
+		if (m_workers.empty() || _count <= new_job.batch_size || tl_executing_job)
+		{
+			_function(_context, 0, _count, 0);
+			return;
+		}
+
+		{
+			std::lock_guard lock(m_mutex);
+			m_job = new_job;
+			m_next_item.store(0, std::memory_order_relaxed);
+			m_busy_workers = (unsigned int)m_workers.size();
+			m_job_generation++;
+		}
+		m_job_cv.notify_all();
+
+		execute_batches(new_job, 0);
+
+		std::unique_lock lock(m_mutex);
+		m_done_cv.wait(lock, [this] { return m_busy_workers == 0; });
+	}
+
+	void job_system::execute_batches(job const& _job, unsigned int _thread_index)
+	{
+		tl_executing_job = true;
+		while (true)
+		{
+			size_t const begin = m_next_item.fetch_add(_job.batch_size, std::memory_order_relaxed);
+			if (begin >= _job.count)
+				break;
+			size_t const end = std::min(begin + _job.batch_size, _job.count);
+			_job.function(_job.context, begin, end, _thread_index);
+		}
+		tl_executing_job = false;
+	}
+
+	void job_system::worker_loop(unsigned int _thread_index)
+	{
+		uint64_t last_generation = 0;
+		while (true)
+		{
+			job current_job;
+			{
+				std::unique_lock lock(m_mutex);
+				m_job_cv.wait(lock, [&] { return m_stop || m_job_generation != last_generation; });
+				if (m_stop)
+					return;
+				last_generation = m_job_generation;
+				current_job = m_job;
+			}
+
+			execute_batches(current_job, _thread_index);
+
+			bool last_worker;
+			{
+				std::lock_guard lock(m_mutex);
+				last_worker = (--m_busy_workers == 0);
+			}
+			if (last_worker)
+				m_done_cv.notify_one();
+		}
+	}
+
+	void job_system::start_workers(unsigned int _worker_count)
+	{
+		m_stop = false;
+		m_job_generation = 0;
+		m_workers.reserve(_worker_count);
+		for (unsigned int i = 0; i < _worker_count; i++)
+			m_workers.emplace_back(&job_system::worker_loop, this, i + 1);
+	}
+
+	void job_system::stop_workers()
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			m_stop = true;
+		}
+		m_job_cv.notify_all();
+		for (std::thread& worker : m_workers)
+			worker.join();
+		m_workers.clear();
+	}
+
+}
+}
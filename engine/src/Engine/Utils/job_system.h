@@ -0,0 +1,97 @@
+#ifndef ENGINE_UTILS_JOB_SYSTEM
+#define ENGINE_UTILS_JOB_SYSTEM
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Engine {
+namespace Utils
+{
+
+	/*
+	* @brief	Pool of worker threads that execute data-parallel jobs.
+	* @details	A job is a range of items split into batches. Batches are handed out to workers
+	*			and to the calling thread, which takes part in the job and blocks until all
+	*			batches have been executed. Only one job runs at a time; jobs started from
+	*			inside a job run serially on the calling thread.
+	*			Batch assignment is dynamic, so callers that need deterministic results should
+	*			write output per thread and merge it in item order afterwards.
+	*/
+	class job_system
+	{
+	public:
+
+		// Signature of batch function: (context, begin item, end item, thread index).
+		using batch_function = void (*)(void*, size_t, size_t, unsigned int);
+
+		job_system();
+		explicit job_system(unsigned int _thread_count);
+		~job_system();
+
+		job_system(job_system const&) = delete;
+		job_system& operator=(job_system const&) = delete;
+
+		/*
+		* @brief	Number of threads executing jobs, including the calling thread.
+		*			Thread indices passed to batch functions are in the range [0, thread_count).
+		*/
+		unsigned int thread_count() const { return (unsigned int)m_workers.size() + 1; }
+		void set_thread_count(unsigned int _thread_count);
+
+		static unsigned int default_thread_count();
+
+		/*
+		* @brief	Call function for every batch of items in [0, count), and wait for completion.
+		* @param	size_t		Number of items
+		* @param	size_t		Maximum number of items per batch
+		* @param	TFunc		Callable with signature void(size_t begin, size_t end, unsigned int thread_index)
+		*/
+		template<typename TFunc>
+		void parallel_for(size_t _count, size_t _batch_size, TFunc&& _func)
+		{
+			using func_type = std::remove_reference_t<TFunc>;
+			run_job(
+				_count, _batch_size,
+				[](void* _context, size_t _begin, size_t _end, unsigned int _thread_index)
+				{
+					(*static_cast<func_type*>(_context))(_begin, _end, _thread_index);
+				},
+				(void*)&_func
+			);
+		}
+
+	private:
+
+		struct job
+		{
+			batch_function		function = nullptr;
+			void*				context = nullptr;
+			size_t				count = 0;
+			size_t				batch_size = 1;
+		};
+
+		std::vector<std::thread>	m_workers;
+		std::mutex					m_mutex;
+		std::condition_variable		m_job_cv;
+		std::condition_variable		m_done_cv;
+		job							m_job;
+		std::atomic<size_t>			m_next_item = 0;
+		uint64_t					m_job_generation = 0;
+		unsigned int				m_busy_workers = 0;
+		bool						m_stop = false;
+
+		void run_job(size_t _count, size_t _batch_size, batch_function _function, void* _context);
+		void execute_batches(job const& _job, unsigned int _thread_index);
+		void worker_loop(unsigned int _thread_index);
+		void start_workers(unsigned int _worker_count);
+		void stop_workers();
+	};
+
+}
+}
+#endif // !ENGINE_UTILS_JOB_SYSTEM
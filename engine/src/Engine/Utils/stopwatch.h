@@ -0,0 +1,37 @@
+#ifndef ENGINE_UTILS_STOPWATCH
+#define ENGINE_UTILS_STOPWATCH
+
+#include <chrono>
+
+namespace Engine {
+namespace Utils
+{
+
+	/*
+	* @brief	Wall-clock timer to profile consecutive phases of a frame.
+	*/
+	class stopwatch
+	{
+	public:
+
+		/*
+		* @brief	Milliseconds since construction or since the previous lap, and restart.
+		*/
+		double lap_ms()
+		{
+			clock::time_point const now = clock::now();
+			double const elapsed = std::chrono::duration<double, std::milli>(now - m_start).count();
+			m_start = now;
+			return elapsed;
+		}
+
+	private:
+
+		using clock = std::chrono::steady_clock;
+		clock::time_point m_start = clock::now();
+	};
+
+}
+}
+
+#endif // !ENGINE_UTILS_STOPWATCH
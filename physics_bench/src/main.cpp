@@ -0,0 +1,350 @@
+/*
+* Headless physics benchmark.
+* Loads the entities, transforms, rigidbodies and colliders of a scene without a graphics context,
+* runs a fixed number of physics steps and reports wall-clock timings of every phase.
+*
+* Usage: physics_bench <scene> [--steps N] [--warmup N] [--dt seconds] [--threads N] [--format json|csv] [--output path]
+*/
+
+#include <Engine/Utils/singleton.h>
+#include <Engine/Utils/job_system.h>
+#include <Engine/Utils/stopwatch.h>
+#include <Engine/ECS/entity.h>
+#include <Engine/ECS/component_manager.h>
+#include <Engine/Components/EngineCompManager.h>
+#include <Engine/Components/Rigidbody.h>
+#include <Engine/Components/Transform.h>
+#include <Engine/Managers/resource_manager.h>
+#include <Engine/Physics/Collider.h>
+#include <Engine/Physics/convex_hull_loader.h>
+#include <Engine/Physics/point_hull.h>
+#include <Engine/Physics/physics_manager.hpp>
+#include <Engine/Serialisation/scene.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct bench_options
+{
+	fs::path		scene_path;
+	fs::path		output_path;
+	size_t			steps = 1000;
+	size_t			warmup_steps = 10;
+	float			timestep = 1.0f / 60.0f;
+	unsigned int	thread_count = 0;		// Zero keeps the default thread count of the job system.
+	bool			csv = false;
+};
+
+// Timings of a single step, in milliseconds.
+struct step_record
+{
+	double broadphase;
+	double narrowphase;
+	double solve;
+	double integrate;
+	double islands;
+	double total;
+	size_t contact_count;
+};
+
+enum EPhase : char { eBroadphase = 0, eNarrowphase, eSolve, eIntegrate, eIslands, eTotal, ePhaseCount };
+
+static const char* const s_phase_names[ePhaseCount] = { "broadphase", "narrowphase", "solve", "integrate", "islands", "total" };
+
+static double get_phase(step_record const& _record, EPhase _phase)
+{
+	double const phases[ePhaseCount] = { _record.broadphase, _record.narrowphase, _record.solve, _record.integrate, _record.islands, _record.total };
+	return phases[_phase];
+}
+
+/*
+* Gravity is a sandbox component of the demo, which the benchmark does not link.
+* Its data is read from the scene and applied the same way instead.
+*/
+struct scene_gravity
+{
+	glm::vec3								gravity{ 0.0f, -9.81f, 0.0f };
+	std::vector<Engine::ECS::Entity>		entities;
+
+	void load(nlohmann::json const& _scene_json)
+	{
+		auto const& managers_json = _scene_json["ComponentManagers"];
+		auto const gravity_iter = managers_json.find("GravityComponent");
+		if (gravity_iter == managers_json.end() || gravity_iter->is_null() || gravity_iter->find("serializer_version") == gravity_iter->end())
+			return;
+
+		int const serializer_version = (*gravity_iter)["serializer_version"];
+		if (serializer_version != 1)
+			return;
+
+		auto const& data_json = (*gravity_iter)["m_data"];
+		gravity = data_json["m_gravity"].get<glm::vec3>();
+
+		// Handles are decoded with the layout the scene was saved with, as DeserialiseScene does for component managers.
+		Engine::ECS::serialized_entity_format const entity_format = Engine::ECS::get_serialized_entity_format(_scene_json["EntityManager"]);
+		entities.clear();
+		for (auto const& entity_json : data_json["m_gravity_entities"])
+			entities.push_back(Engine::ECS::deserialize_entity(entity_json, entity_format));
+	}
+
+	void apply() const
+	{
+		for (Engine::ECS::Entity const e : entities)
+		{
+			auto rb_comp = e.GetComponent<Component::RigidBody>();
+			if (rb_comp.IsValid())
+			{
+				auto rb_data = rb_comp.GetRigidBodyData();
+				rb_data.force_accumulator += gravity * rb_data.get_mass();
+				rb_comp.SetRigidBodyData(rb_data);
+			}
+		}
+	}
+};
+
+static void print_usage()
+{
+	std::cerr
+		<< "Usage: physics_bench <scene> [options]\n"
+		<< "  --steps N          Number of measured steps (default 1000)\n"
+		<< "  --warmup N         Number of steps run before measuring (default 10)\n"
+		<< "  --dt seconds       Timestep of a step (default 1/60)\n"
+		<< "  --threads N        Number of job system threads (default: hardware threads)\n"
+		<< "  --format json|csv  Report format (default json)\n"
+		<< "  --output path      Write report to file instead of standard output\n";
+}
+
+static bool parse_options(int _argc, char* _argv[], bench_options& _options)
+{
+	for (int i = 1; i < _argc; i++)
+	{
+		char const* const arg = _argv[i];
+		bool const has_value = i + 1 < _argc;
+		if (std::strcmp(arg, "--steps") == 0 && has_value)
+			_options.steps = std::strtoull(_argv[++i], nullptr, 10);
+		else if (std::strcmp(arg, "--warmup") == 0 && has_value)
+			_options.warmup_steps = std::strtoull(_argv[++i], nullptr, 10);
+		else if (std::strcmp(arg, "--dt") == 0 && has_value)
+			_options.timestep = std::strtof(_argv[++i], nullptr);
+		else if (std::strcmp(arg, "--threads") == 0 && has_value)
+			_options.thread_count = (unsigned int)std::strtoul(_argv[++i], nullptr, 10);
+		else if (std::strcmp(arg, "--format") == 0 && has_value)
+		{
+			std::string const format = _argv[++i];
+			if (format != "json" && format != "csv")
+				return false;
+			_options.csv = (format == "csv");
+		}
+		else if (std::strcmp(arg, "--output") == 0 && has_value)
+			_options.output_path = _argv[++i];
+		else if (arg[0] != '-' && _options.scene_path.empty())
+			_options.scene_path = arg;
+		else
+			return false;
+	}
+	return !_options.scene_path.empty() && _options.steps > 0 && _options.timestep > 0.0f;
+}
+
+/*
+* @brief	Register loaders of physics resources. Graphics resource types are registered with
+*			dummy loaders, so scene resource tables import without a graphics context.
+*/
+static void register_resource_loaders()
+{
+	using resource_type = Engine::Managers::resource_type;
+
+	auto& resource_manager = Singleton<Engine::Managers::ResourceManager>();
+
+	auto dummy_loader = [](fs::path const& _path)->uint32_t {return 1; };
+	auto dummy_unloader = [](uint32_t _handle) {};
+
+	resource_type const type_texture = resource_manager.register_type("Texture", dummy_loader, dummy_unloader);
+	resource_type const type_model = resource_manager.register_type("Model", dummy_loader, dummy_unloader);
+	resource_type const type_convex_hull = resource_manager.register_type("Collider", Engine::Physics::LoadConvexHull, Engine::Physics::UnloadConvexHull);
+	resource_type const type_point_hull = resource_manager.register_type("Point Hull", Engine::Physics::LoadPointHull, Engine::Physics::UnloadPointHull);
+	resource_type const type_mesh = resource_manager.register_type("Mesh", dummy_loader, dummy_unloader);
+
+	resource_manager.register_type_extension(type_texture, ".png");
+	resource_manager.register_type_extension(type_texture, ".jpeg");
+
+	resource_manager.register_type_extension(type_model, ".gltf");
+
+	resource_manager.register_type_extension(type_convex_hull, ".obj");
+	resource_manager.register_type_extension(type_convex_hull, ".cs350");
+
+	resource_manager.register_type_extension(type_point_hull, ".cs350");
+
+	resource_manager.register_type_extension(type_mesh, ".obj");
+}
+
+static bool load_scene(fs::path const& _scene_path, scene_gravity& _gravity)
+{
+	std::ifstream scene_file(_scene_path, std::ios::binary);
+	if (!scene_file.is_open())
+	{
+		std::cerr << "[physics_bench] Failed to open scene: " << _scene_path.string() << std::endl;
+		return false;
+	}
+
+	try
+	{
+		nlohmann::json scene_json;
+		scene_file >> scene_json;
+		Engine::Serialisation::DeserialiseScene(scene_json);
+		_gravity.load(scene_json);
+	}
+	catch (nlohmann::json::exception& e)
+	{
+		std::cerr << "[physics_bench] Failed to deserialize scene: " << e.what() << std::endl;
+		return false;
+	}
+	return true;
+}
+
+static step_record run_step(float _dt, scene_gravity const& _gravity)
+{
+	auto& collider_mgr = Singleton<Component::ColliderManager>();
+	auto& scene_physics_mgr = Singleton<Engine::Physics::ScenePhysicsManager>();
+
+	Engine::Utils::stopwatch step_stopwatch;
+	Singleton<Component::TransformManager>().UpdateWorldMatrices();
+	collider_mgr.TestColliderIntersections();
+	_gravity.apply();
+	scene_physics_mgr.PhysicsStep(_dt);
+	Singleton<Engine::ECS::EntityManager>().FreeQueuedEntities();
+	double const total = step_stopwatch.lap_ms();
+
+	auto const& intersection_timings = collider_mgr.GetLastTimings();
+	auto const& step_timings = scene_physics_mgr.m_last_step_timings;
+	return {
+		intersection_timings.broadphase_ms,
+		intersection_timings.narrowphase_ms,
+		step_timings.solve_ms,
+		step_timings.integrate_ms,
+		step_timings.islands_ms,
+		total,
+		collider_mgr.m_data.m_global_contact_data.all_contacts.size()
+	};
+}
+
+static void write_csv(std::ostream& _out, std::vector<step_record> const& _records)
+{
+	_out << "step";
+	for (const char* name : s_phase_names)
+		_out << "," << name << "_ms";
+	_out << ",contacts\n";
+
+	for (size_t i = 0; i < _records.size(); i++)
+	{
+		_out << i;
+		for (int phase = 0; phase < ePhaseCount; phase++)
+			_out << "," << get_phase(_records[i], (EPhase)phase);
+		_out << "," << _records[i].contact_count << "\n";
+	}
+}
+
+static void write_json(std::ostream& _out, bench_options const& _options, std::vector<step_record> const& _records)
+{
+	nlohmann::json report;
+	report["scene"] = _options.scene_path.generic_string();
+	report["steps"] = _records.size();
+	report["warmup_steps"] = _options.warmup_steps;
+	report["timestep"] = _options.timestep;
+	report["threads"] = Singleton<Engine::Utils::job_system>().thread_count();
+	report["rigidbodies"] = Singleton<Component::RigidBodyManager>().m_rigidbodies_data.size();
+	report["colliders"] = Singleton<Component::ColliderManager>().m_data.m_entity_map.size();
+
+	nlohmann::json& phases_json = report["phases"];
+	for (int phase = 0; phase < ePhaseCount; phase++)
+	{
+		std::vector<double> samples(_records.size());
+		for (size_t i = 0; i < _records.size(); i++)
+			samples[i] = get_phase(_records[i], (EPhase)phase);
+		std::sort(samples.begin(), samples.end());
+
+		double sum = 0.0;
+		for (double const sample : samples)
+			sum += sample;
+
+		nlohmann::json& phase_json = phases_json[s_phase_names[phase]];
+		phase_json["total_ms"] = sum;
+		phase_json["mean_ms"] = sum / (double)samples.size();
+		phase_json["min_ms"] = samples.front();
+		phase_json["median_ms"] = samples[samples.size() / 2];
+		phase_json["max_ms"] = samples.back();
+	}
+
+	size_t contact_sum = 0;
+	for (step_record const& record : _records)
+		contact_sum += record.contact_count;
+	report["mean_contacts"] = (double)contact_sum / (double)_records.size();
+
+	_out << std::setw(4) << report << "\n";
+}
+
+int main(int argc, char* argv[])
+{
+	bench_options options;
+	if (!parse_options(argc, argv, options))
+	{
+		print_usage();
+		return 1;
+	}
+
+	if (options.thread_count > 0)
+		Singleton<Engine::Utils::job_system>().set_thread_count(options.thread_count);
+
+	Component::InitializeEngineComponentManagers();
+	Singleton<Component::ColliderManager>().SetCreateDebugMeshes(false);
+
+	Singleton<Engine::ECS::EntityManager>().Reset();
+	register_resource_loaders();
+
+	auto& scene_physics_mgr = Singleton<Engine::Physics::ScenePhysicsManager>();
+	scene_physics_mgr.Reset();
+	// Snapshots only serve the editor timeline.
+	scene_physics_mgr.m_snapshot_mode = Engine::Physics::ScenePhysicsManager::eSnapshotDisabled;
+
+	scene_gravity gravity;
+	if (!load_scene(options.scene_path, gravity))
+		return 1;
+
+	for (size_t i = 0; i < options.warmup_steps; i++)
+		run_step(options.timestep, gravity);
+
+	std::vector<step_record> records;
+	records.reserve(options.steps);
+	for (size_t i = 0; i < options.steps; i++)
+		records.push_back(run_step(options.timestep, gravity));
+
+	std::ofstream output_file;
+	if (!options.output_path.empty())
+	{
+		output_file.open(options.output_path);
+		if (!output_file.is_open())
+		{
+			std::cerr << "[physics_bench] Failed to open output: " << options.output_path.string() << std::endl;
+			return 1;
+		}
+	}
+	std::ostream& out = output_file.is_open() ? output_file : std::cout;
+
+	if (options.csv)
+		write_csv(out, records);
+	else
+		write_json(out, options, records);
+
+	Component::ShutdownEngineComponentManagers();
+	Singleton<Engine::Managers::ResourceManager>().reset();
+
+	return 0;
+}
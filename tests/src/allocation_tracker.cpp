@@ -0,0 +1,125 @@
+#include <gtest/gtest.h>
+#include <Engine/Utils/allocation_tracker.h>
+#include <Engine/Utils/singleton.h>
+#include <Engine/Components/Transform.h>
+#include <Engine/Physics/Collider.h>
+#include <Engine/Physics/physics_manager.hpp>
+
+#include "heap_allocation_counter.h"
+
+#include <memory>
+#include <sstream>
+
+using Engine::Utils::allocation_subsystem;
+using Engine::Utils::allocation_tracker;
+using rigidbody_data_collection = Component::RigidBodyManager::rigidbody_data_collection;
+
+static std::string dump_report(allocation_tracker::frame_report const& _report)
+{
+	std::ostringstream out;
+	allocation_tracker::dump(out, _report);
+	return out.str();
+}
+
+TEST(AllocationTracker, AttributesAllocationsToScope)
+{
+	if (!allocation_tracker::enabled())
+		GTEST_SKIP() << "Built without ENGINE_ALLOCATION_TRACKING";
+
+	allocation_tracker::end_frame();
+	{
+		ENGINE_ALLOCATION_SCOPE(ePhysics);
+		auto const values = std::make_unique<int[]>(100);
+		{
+			ENGINE_ALLOCATION_SCOPE(eAnimation);
+			auto const value = std::make_unique<double>(1.0);
+		}
+	}
+
+	allocation_tracker::frame_report const report = allocation_tracker::current_frame();
+	EXPECT_EQ(report[allocation_subsystem::ePhysics].allocation_count, 1u);
+	EXPECT_EQ(report[allocation_subsystem::ePhysics].deallocation_count, 1u);
+	EXPECT_EQ(report[allocation_subsystem::ePhysics].bytes_allocated, 100 * sizeof(int));
+	EXPECT_GE(report[allocation_subsystem::ePhysics].peak_live_bytes, (int64_t)(100 * sizeof(int)));
+	EXPECT_EQ(report[allocation_subsystem::eAnimation].allocation_count, 1u);
+	EXPECT_EQ(allocation_tracker::current_subsystem(), allocation_subsystem::eUntagged);
+
+	allocation_tracker::end_frame();
+	EXPECT_EQ(allocation_tracker::last_frame()[allocation_subsystem::ePhysics].allocation_count, 1u);
+	EXPECT_EQ(allocation_tracker::current_frame()[allocation_subsystem::ePhysics].allocation_count, 0u);
+}
+
+// Chain of bodies resting on a static ground body, every body touching the ground and the next body.
+static void create_resting_chain(size_t _body_count)
+{
+	using namespace Engine::Physics;
+
+	auto& transform_manager = Singleton<Component::TransformManager>();
+	transform_manager.Clear();
+	rigidbody_data_collection& rigidbodies = Singleton<Component::RigidBodyManager>().m_rigidbodies_data;
+	rigidbodies = rigidbody_data_collection();
+	global_contact_data& contact_data = Singleton<Component::ColliderManager>().m_data.m_global_contact_data;
+	contact_data = global_contact_data();
+
+	for (size_t i = 0; i < _body_count; i++)
+	{
+		Engine::ECS::Entity e;
+		e.m_id = (unsigned int)i;
+		e.m_counter = 0;
+		glm::vec3 const position((float)i, i == 0 ? -1.0f : 0.0f, 0.0f);
+		Component::Transform transform = transform_manager.Create(e);
+		transform.SetLocalPosition(position);
+		rigidbodies.push_element(e, position, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), i == 0 ? 0.0f : 1.0f, glm::mat3(1.0f));
+	}
+
+	auto add_manifold = [&](size_t _body_A, size_t _body_B)
+	{
+		Engine::ECS::Entity const entity_A = rigidbodies.m_index_entities[_body_A];
+		Engine::ECS::Entity const entity_B = rigidbodies.m_index_entities[_body_B];
+		contact_manifold& cm = contact_data.all_contact_manifolds.emplace_back();
+		cm.rigidbodies = { Component::RigidBody(entity_A), Component::RigidBody(entity_B) };
+		cm.pair_key = make_contact_pair_key(entity_A, entity_B);
+		cm.data.first_contact_index = (uint32_t)contact_data.all_contacts.size();
+		cm.data.contact_count = 1;
+		cm.data.is_edge_edge = false;
+
+		contact& c = contact_data.all_contacts.emplace_back();
+		c.point = 0.5f * (rigidbodies.m_positions[_body_A] + rigidbodies.m_positions[_body_B]);
+		c.normal = glm::normalize(rigidbodies.m_positions[_body_B] - rigidbodies.m_positions[_body_A]);
+		c.penetration = 0.01f;
+		c.identifier = { entity_A.ID(), entity_B.ID(), 0, 0 };
+	};
+	for (size_t i = 1; i < _body_count; i++)
+	{
+		add_manifold(0, i);
+		if (i + 1 < _body_count)
+			add_manifold(i, i + 1);
+	}
+}
+
+TEST(AllocationTracker, SteadyStatePhysicsStepDoesNotAllocate)
+{
+	create_resting_chain(64);
+
+	Engine::Physics::ScenePhysicsManager physics;
+	physics.m_snapshot_mode = Engine::Physics::ScenePhysicsManager::eSnapshotDisabled;
+	physics.m_physics_parameters.sleeping = false;
+
+	// First steps size solver buffers and the contact cache.
+	for (int step = 0; step < 3; step++)
+		physics.PhysicsStep();
+
+	// Counted by the test executable's operator new unless the engine tracks allocations itself.
+	uint64_t const allocation_count = count_heap_allocations([&physics]()
+	{
+		for (int step = 0; step < 10; step++)
+			physics.PhysicsStep();
+	});
+	allocation_tracker::frame_report const report = allocation_tracker::current_frame();
+	EXPECT_EQ(allocation_count, 0u) << dump_report(report);
+	EXPECT_EQ(report[allocation_subsystem::ePhysics].allocation_count, 0u) << dump_report(report);
+
+	Singleton<Component::RigidBodyManager>().m_rigidbodies_data = rigidbody_data_collection();
+	Singleton<Component::ColliderManager>().m_data.m_global_contact_data = Engine::Physics::global_contact_data();
+	Singleton<Component::TransformManager>().Clear();
+}
@@ -0,0 +1,220 @@
+#include <gtest/gtest.h>
+#include <Engine/Components/SkeletonAnimator.h>
+
+#include "heap_allocation_counter.h"
+
+#include <cmath>
+#include <initializer_list>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+
+using namespace Component;
+using Engine::Math::transform3D;
+
+static transform3D make_joint(float _f)
+{
+	transform3D joint;
+	joint.position = glm::vec3(std::sin(_f), 0.1f * _f, -std::cos(_f));
+	joint.scale = glm::vec3(1.0f + 0.1f * std::sin(_f));
+	joint.rotation = glm::angleAxis(0.3f * _f, glm::normalize(glm::vec3(1.0f, _f, 2.0f)));
+	return joint;
+}
+
+/*
+* Pose of a skeleton with varied joints. The joint count is not a multiple of any lane width,
+* so the last block of joints is only partially filled.
+*/
+static animation_pose make_pose(size_t _joint_count, float _phase)
+{
+	std::vector<transform3D> joints;
+	for (size_t i = 0; i < _joint_count; i++)
+		joints.push_back(make_joint((float)i + _phase));
+	animation_pose pose;
+	pose.set_joint_transforms(joints.data(), joints.size());
+	return pose;
+}
+
+static void expect_joints_near(transform3D const& _expected, transform3D const& _actual)
+{
+	EXPECT_LT(glm::length(_expected.position - _actual.position), 1e-5f);
+	EXPECT_LT(glm::length(_expected.scale - _actual.scale), 1e-5f);
+	EXPECT_NEAR(glm::dot(_expected.rotation, _actual.rotation), 1.0f, 1e-5f);
+}
+
+static void expect_poses_near(animation_pose const& _expected, animation_pose const& _actual)
+{
+	ASSERT_EQ(_expected.joint_count(), _actual.joint_count());
+	for (size_t i = 0; i < _expected.joint_count(); i++)
+		expect_joints_near(_expected.get_joint_transform(i), _actual.get_joint_transform(i));
+}
+
+TEST(AnimationBlending, PoseLanesRoundTrip)
+{
+	animation_pose pose = make_pose(11, 0.0f);
+	ASSERT_EQ(pose.joint_count(), 11u);
+	ASSERT_EQ(pose.m_joint_lanes.size(), 2u);
+	for (size_t i = 0; i < pose.joint_count(); i++)
+		expect_joints_near(make_joint((float)i), pose.get_joint_transform(i));
+
+	// Joints cut off by shrinking come back as identity transforms.
+	pose.resize(5);
+	pose.resize(11);
+	for (size_t i = 0; i < 5; i++)
+		expect_joints_near(make_joint((float)i), pose.get_joint_transform(i));
+	for (size_t i = 5; i < pose.joint_count(); i++)
+		expect_joints_near(transform3D(), pose.get_joint_transform(i));
+}
+
+TEST(AnimationBlending, SIMDBlend_MatchesScalar)
+{
+	size_t const joint_count = 37;
+	animation_pose const poses[3] = { make_pose(joint_count, 0.0f), make_pose(joint_count, 1.5f), make_pose(joint_count, -2.0f) };
+	animation_blend_mask mask;
+	for (size_t i = 0; i < joint_count; i++)
+		mask.m_joint_blend_masks.push_back((float)(i % 5) / 4.0f);
+	float const barycentric_weights[3] = { 0.2f, 0.5f, 0.3f };
+
+	auto blend = [&](Engine::Math::ESIMDLevel _level, animation_pose _results[3])
+	{
+		_results[0].mix(poses[0], poses[1], 0.35f, _level);
+		_results[1].mix(poses, barycentric_weights, _level);
+		_results[2] = poses[0];
+		_results[2].apply_blend_mask(mask, poses[1], _level);
+	};
+
+	animation_pose scalar[3];
+	blend(Engine::Math::eScalar, scalar);
+	for (Engine::Math::ESIMDLevel level : { Engine::Math::eSSE, Engine::Math::eAVX2 })
+	{
+		animation_pose simd[3];
+		blend(level, simd);
+		for (int i = 0; i < 3; i++)
+			expect_poses_near(scalar[i], simd[i]);
+	}
+
+	// Nlerp of unit rotations at the halfway point.
+	transform3D const left = poses[0].get_joint_transform(3);
+	transform3D const right = poses[1].get_joint_transform(3);
+	animation_pose halfway;
+	halfway.mix(poses[0], poses[1], 0.5f);
+	EXPECT_LT(glm::length(halfway.get_joint_transform(3).position - (left.position + right.position) * 0.5f), 1e-5f);
+	EXPECT_NEAR(glm::dot(halfway.get_joint_transform(3).rotation, glm::normalize(left.rotation + right.rotation)), 1.0f, 1e-5f);
+}
+
+TEST(AnimationBlending, BlendMaskWeightsJoints)
+{
+	size_t const joint_count = 21;
+	animation_pose const pose = make_pose(joint_count, 0.0f);
+	animation_pose const other = make_pose(joint_count, 3.0f);
+
+	animation_blend_mask mask;
+	for (size_t i = 0; i < joint_count; i++)
+		mask.m_joint_blend_masks.push_back(i % 3 == 0 ? 1.0f : (i % 3 == 1 ? 0.0f : 0.25f));
+
+	animation_pose masked = pose;
+	masked.apply_blend_mask(mask, other);
+	for (size_t i = 0; i < joint_count; i++)
+	{
+		transform3D const joint = masked.get_joint_transform(i);
+		if (i % 3 == 0)
+			expect_joints_near(pose.get_joint_transform(i), joint);
+		else if (i % 3 == 1)
+			expect_joints_near(other.get_joint_transform(i), joint);
+		else
+		{
+			glm::vec3 const expected_position = other.get_joint_transform(i).position * 0.75f + pose.get_joint_transform(i).position * 0.25f;
+			EXPECT_LT(glm::length(joint.position - expected_position), 1e-5f);
+		}
+	}
+
+	// Empty mask keeps all joints of the pose.
+	animation_pose unmasked = pose;
+	unmasked.apply_blend_mask(animation_blend_mask(), other);
+	expect_poses_near(pose, unmasked);
+}
+
+// Forwards to the heap, counting allocations.
+class counting_resource final : public std::pmr::memory_resource
+{
+public:
+
+	size_t m_allocation_count = 0;
+
+private:
+
+	void* do_allocate(size_t _bytes, size_t _alignment) override
+	{
+		++m_allocation_count;
+		return std::pmr::new_delete_resource()->allocate(_bytes, _alignment);
+	}
+	void do_deallocate(void* _ptr, size_t _bytes, size_t _alignment) override
+	{
+		std::pmr::new_delete_resource()->deallocate(_ptr, _bytes, _alignment);
+	}
+	bool do_is_equal(std::pmr::memory_resource const& _other) const noexcept override { return this == &_other; }
+};
+
+// Restores the default memory resource on scope exit, including early returns of failed assertions.
+struct default_resource_guard
+{
+	std::pmr::memory_resource* m_previous;
+
+	explicit default_resource_guard(std::pmr::memory_resource* _resource) : m_previous(std::pmr::set_default_resource(_resource)) {}
+	~default_resource_guard() { std::pmr::set_default_resource(m_previous); }
+
+	default_resource_guard(default_resource_guard const&) = delete;
+	default_resource_guard& operator=(default_resource_guard const&) = delete;
+};
+
+static std::unique_ptr<animation_tree_node> make_blend_1D(float _blend_parameter)
+{
+	auto node = std::make_unique<animation_blend_1D>();
+	node->add_node(std::make_unique<animation_leaf_node>(), 0.0f, animation_blend_mask());
+	node->add_node(std::make_unique<animation_leaf_node>(), 1.0f, animation_blend_mask());
+	node->m_blend_parameter = _blend_parameter;
+	return node;
+}
+
+TEST(AnimationBlending, BlendTreeEvaluationReusesScratchPoses)
+{
+	counting_resource counting;
+	default_resource_guard const guard(&counting);
+	{
+		// 2D blend of 1D blends and a leaf. Leaves without animations fall back to the bind pose.
+		animation_blend_2D root;
+		root.add_node(make_blend_1D(0.5f), glm::vec2(0.0f, 0.0f), animation_blend_mask());
+		root.add_node(make_blend_1D(0.25f), glm::vec2(1.0f, 0.0f), animation_blend_mask());
+		root.add_node(std::make_unique<animation_leaf_node>(), glm::vec2(0.0f, 1.0f), animation_blend_mask());
+		root.m_blend_parameter = glm::vec2(0.25f, 0.25f);
+		ASSERT_EQ(root.scratch_pose_count(), 5u);
+
+		animation_pose const bind_pose = make_pose(37, 0.0f);
+		animation_pose_stack scratch_poses;
+		compute_pose_context context;
+		context.m_bind_pose = &bind_pose;
+		context.m_scratch_poses = &scratch_poses;
+
+		animation_pose pose;
+		scratch_poses.reserve(root.scratch_pose_count(), bind_pose.joint_count());
+		root.compute_pose(0.0f, &pose, context);
+		EXPECT_EQ(scratch_poses.m_size, 0u);
+		expect_poses_near(bind_pose, pose);
+
+		// Buffers of the stack and the output pose are sized now.
+		size_t const pose_allocation_count = counting.m_allocation_count;
+		uint64_t const heap_allocation_count = count_heap_allocations([&]()
+		{
+			for (int frame = 0; frame < 10; frame++)
+			{
+				scratch_poses.reserve(root.scratch_pose_count(), bind_pose.joint_count());
+				pose.clear();
+				root.compute_pose((float)frame / 60.0f, &pose, context);
+			}
+		});
+		EXPECT_EQ(counting.m_allocation_count, pose_allocation_count);
+		EXPECT_EQ(heap_allocation_count, 0u);
+		EXPECT_EQ(scratch_poses.m_size, 0u);
+		expect_poses_near(bind_pose, pose);
+	}
+}
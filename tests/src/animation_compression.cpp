@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include <Engine/Graphics/animation_compression.h>
+#include <Engine/Graphics/manager.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Engine::Graphics;
+
+// Rotation angle between quaternions, accurate for small angles unlike acos of their dot product.
+static float rotation_error(glm::quat _a, glm::quat _b)
+{
+	_a = glm::normalize(_a);
+	_b = glm::normalize(_b);
+	if (glm::dot(_a, _b) < 0.0f)
+		_b = -_b;
+	glm::quat const difference = _a + (-_b);
+	glm::quat const sum = _a + _b;
+	return 4.0f * std::atan2(std::sqrt(glm::dot(difference, difference)), std::sqrt(glm::dot(sum, sum)));
+}
+
+// Keyframe interval and weight of time, clamped to the keyframe range.
+static std::pair<size_t, float> find_interval(std::vector<float> const& _key_times, float _time)
+{
+	if (_key_times.size() < 2 || _time <= _key_times.front())
+		return { 0, 0.0f };
+	if (_time >= _key_times.back())
+		return { _key_times.size() - 2, 1.0f };
+	size_t const right = std::upper_bound(_key_times.begin(), _key_times.end(), _time) - _key_times.begin();
+	size_t const left = right - 1;
+	return { left, (_time - _key_times[left]) / (_key_times[right] - _key_times[left]) };
+}
+
+static glm::quat sample_rotation(compressed_animation_track const& _track, float _time)
+{
+	auto const [left, weight] = find_interval(_track.m_key_times, _time);
+	glm::quat const left_rotation = _track.rotation(left);
+	glm::quat right_rotation = _track.rotation(std::min(left + 1, _track.m_key_times.size() - 1));
+	if (glm::dot(left_rotation, right_rotation) < 0.0f)
+		right_rotation = -right_rotation;
+	return glm::slerp(left_rotation, right_rotation, weight);
+}
+
+static glm::vec3 sample_vector(compressed_animation_track const& _track, float _time)
+{
+	auto const [left, weight] = find_interval(_track.m_key_times, _time);
+	glm::vec3 const left_vector = _track.vector(left);
+	glm::vec3 const right_vector = _track.vector(std::min(left + 1, _track.m_key_times.size() - 1));
+	return left_vector + (right_vector - left_vector) * weight;
+}
+
+struct source_track
+{
+	std::vector<float>		key_times;
+	std::vector<glm::quat>	rotations;
+	std::vector<glm::vec3>	translations;
+
+	// 30 keys per second of a joint swinging around a slowly turning axis, while moving in a loop.
+	explicit source_track(size_t _key_count)
+	{
+		for (size_t k = 0; k < _key_count; k++)
+		{
+			float const t = (float)k / 30.0f;
+			key_times.push_back(t);
+			glm::vec3 const axis = glm::normalize(glm::vec3(std::cos(0.5f * t), 1.0f, std::sin(0.5f * t)));
+			rotations.push_back(glm::angleAxis(0.6f * std::sin(1.5f * t), axis));
+			translations.push_back(glm::vec3(0.2f * std::sin(t), 0.05f * std::cos(3.0f * t), 0.1f * t));
+		}
+	}
+
+	glm::quat rotation(float _time) const
+	{
+		auto const [left, weight] = find_interval(key_times, _time);
+		return glm::slerp(rotations[left], rotations[left + 1], weight);
+	}
+
+	glm::vec3 translation(float _time) const
+	{
+		auto const [left, weight] = find_interval(key_times, _time);
+		return translations[left] + (translations[left + 1] - translations[left]) * weight;
+	}
+};
+
+TEST(AnimationCompression, QuantizedRotationRoundTrip)
+{
+	std::mt19937 rng(1337);
+	std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+	float max_error = 0.0f;
+	for (int i = 0; i < 10000; i++)
+	{
+		glm::quat const rotation = glm::normalize(glm::quat(dist(rng), dist(rng), dist(rng), dist(rng)));
+		max_error = std::max(max_error, rotation_error(rotation, dequantize_rotation(quantize_rotation(rotation))));
+	}
+	EXPECT_LT(max_error, 2e-4f);
+}
+
+TEST(AnimationCompression, TracksStayWithinTolerance)
+{
+	source_track const source(240);
+	float const rotation_tolerance = 1e-3f;
+	float const translation_tolerance = 1e-3f;
+
+	compressed_animation_track const rotation_track = compress_rotation_track(
+		source.key_times.data(), source.rotations.data(), source.key_times.size(), rotation_tolerance
+	);
+	compressed_animation_track const translation_track = compress_vector_track(
+		source.key_times.data(), source.translations.data(), source.key_times.size(), translation_tolerance
+	);
+	EXPECT_LT(rotation_track.m_key_times.size(), source.key_times.size());
+	EXPECT_LT(translation_track.m_key_times.size(), source.key_times.size());
+	EXPECT_EQ(rotation_track.m_key_times.front(), source.key_times.front());
+	EXPECT_EQ(rotation_track.m_key_times.back(), source.key_times.back());
+
+	// Maximum joint error over the clip, including quantization of kept keys.
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<float> time_dist(0.0f, source.key_times.back());
+	float max_rotation_error = 0.0f;
+	float max_translation_error = 0.0f;
+	for (int i = 0; i < 10000; i++)
+	{
+		float const time = time_dist(rng);
+		max_rotation_error = std::max(max_rotation_error, rotation_error(source.rotation(time), sample_rotation(rotation_track, time)));
+		max_translation_error = std::max(max_translation_error, glm::length(source.translation(time) - sample_vector(translation_track, time)));
+	}
+	EXPECT_LE(max_rotation_error, rotation_tolerance);
+	EXPECT_LE(max_translation_error, translation_tolerance);
+}
+
+TEST(AnimationCompression, DequantizedKeysStayWithinToleranceCloseToQuantizationError)
+{
+	source_track const source(240);
+
+	// Tolerances close to the quantization error, which leave key reduction little of the error budget.
+	float const rotation_tolerance = 4e-4f;
+	compressed_animation_track const rotation_track = compress_rotation_track(
+		source.key_times.data(), source.rotations.data(), source.key_times.size(), rotation_tolerance
+	);
+	compressed_animation_track const probe_track = compress_vector_track(
+		source.key_times.data(), source.translations.data(), source.key_times.size(), 1.0f
+	);
+	float const translation_tolerance = 10.0f * glm::length(probe_track.m_range_extent) / 65535.0f;
+	compressed_animation_track const translation_track = compress_vector_track(
+		source.key_times.data(), source.translations.data(), source.key_times.size(), translation_tolerance
+	);
+	EXPECT_LT(rotation_track.m_key_times.size(), source.key_times.size());
+	EXPECT_LT(translation_track.m_key_times.size(), source.key_times.size());
+
+	// Error of compressed tracks is piecewise linear between source keys for vectors, and close to it
+	// for rotations, so it is largest at source keys.
+	float max_rotation_error = 0.0f;
+	float max_translation_error = 0.0f;
+	for (size_t k = 0; k < source.key_times.size(); k++)
+	{
+		float const time = source.key_times[k];
+		max_rotation_error = std::max(max_rotation_error, rotation_error(source.rotations[k], sample_rotation(rotation_track, time)));
+		max_translation_error = std::max(max_translation_error, glm::length(source.translations[k] - sample_vector(translation_track, time)));
+	}
+	EXPECT_LE(max_rotation_error, rotation_tolerance);
+	EXPECT_LE(max_translation_error, translation_tolerance);
+}
+
+TEST(AnimationCompression, CompressesLinearAnimation)
+{
+	source_track const source(90);
+
+	animation_interpolation_data input, rotation_output, translation_output;
+	input.m_data = source.key_times;
+	for (glm::quat const& rotation : source.rotations)
+		rotation_output.m_data.insert(rotation_output.m_data.end(), { rotation.x, rotation.y, rotation.z, rotation.w });
+	for (glm::vec3 const& translation : source.translations)
+		translation_output.m_data.insert(translation_output.m_data.end(), { translation.x, translation.y, translation.z });
+	animation_sampler_data const sampler = { 1, 2, animation_sampler_data::LINEAR };
+
+	animation_data animation;
+	animation.m_animation_channels.push_back({ 1, animation_channel_data::TRANSLATION, 0, &sampler, &input, &translation_output });
+	animation.m_animation_channels.push_back({ 2, animation_channel_data::ROTATION, 0, &sampler, &input, &rotation_output });
+
+	size_t const raw_bytes = animation_memory_usage(animation);
+	ASSERT_TRUE(compress_animation(animation, animation_compression_settings()));
+	ASSERT_EQ(animation.m_compressed_tracks.size(), 2u);
+	EXPECT_FALSE(animation.m_compressed_tracks[0].m_vectors.empty());
+	EXPECT_FALSE(animation.m_compressed_tracks[1].m_rotations.empty());
+	EXPECT_EQ(animation.m_animation_channels[0].m_input, nullptr);
+	EXPECT_LT(animation_memory_usage(animation), raw_bytes / 2);
+
+	animation_sampler_data const cubic_sampler = { 1, 2, animation_sampler_data::CUBICSPLINE };
+	animation_data cubic_animation;
+	cubic_animation.m_animation_channels.push_back({ 1, animation_channel_data::TRANSLATION, 0, &cubic_sampler, &input, &translation_output });
+	EXPECT_FALSE(compress_animation(cubic_animation, animation_compression_settings()));
+	EXPECT_TRUE(cubic_animation.m_compressed_tracks.empty());
+}
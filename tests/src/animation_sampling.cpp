@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <Engine/Components/SkeletonAnimator.h>
+#include <Engine/Utils/algorithm.h>
+
+#include <random>
+#include <vector>
+
+using Component::AnimationUtil::find_keyframe_interval;
+
+static std::vector<float> make_keyframes(unsigned int _count)
+{
+	std::mt19937 rng(1337);
+	std::uniform_real_distribution<float> step_dist(0.01f, 0.1f);
+	std::vector<float> keyframes;
+	float time = 0.0f;
+	for (unsigned int i = 0; i < _count; i++)
+	{
+		keyframes.push_back(time);
+		time += step_dist(rng);
+	}
+	return keyframes;
+}
+
+static void expect_interval_matches_search(std::vector<float> const& _keyframes, float _time, uint32_t* _cursor)
+{
+	auto const expected = Engine::Utils::float_binary_search(_keyframes.data(), _keyframes.size(), _time);
+	auto const interval = find_keyframe_interval(_keyframes, _time, _cursor);
+	EXPECT_EQ(interval.first, (unsigned int)expected.first) << "time " << _time;
+	EXPECT_EQ(interval.second, (unsigned int)expected.second) << "time " << _time;
+}
+
+TEST(AnimationSampling, CursorFollowsLoopingPlayback)
+{
+	std::vector<float> const keyframes = make_keyframes(50);
+	float const duration = keyframes.back();
+
+	uint32_t cursor = 0;
+	float time = 0.0f;
+	for (int frame = 0; frame < 1000; frame++)
+	{
+		expect_interval_matches_search(keyframes, time, &cursor);
+		time = Component::AnimationUtil::rollover_modulus(time + 1.0f / 60.0f, duration);
+	}
+}
+
+TEST(AnimationSampling, CursorHandlesSeeksAndOutOfRangeTimes)
+{
+	std::vector<float> const keyframes = make_keyframes(50);
+
+	std::mt19937 rng(7);
+	std::uniform_real_distribution<float> time_dist(-1.0f, keyframes.back() + 1.0f);
+	uint32_t cursor = 0;
+	for (int i = 0; i < 1000; i++)
+		expect_interval_matches_search(keyframes, time_dist(rng), &cursor);
+
+	// Stale cursor of a longer animation.
+	cursor = 500;
+	expect_interval_matches_search(keyframes, 0.5f, &cursor);
+	expect_interval_matches_search(keyframes, 0.5f, nullptr);
+
+	std::vector<float> const single_keyframe = { 0.0f };
+	EXPECT_EQ(find_keyframe_interval(single_keyframe, 1.0f, &cursor), std::make_pair(0u, 0u));
+}
@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+#include <Engine/ECS/archetype_comp_manager.h>
+
+#include <vector>
+
+using namespace Engine::ECS;
+
+namespace
+{
+	struct health_data
+	{
+		int m_health = 100;
+
+		NLOHMANN_DEFINE_TYPE_INTRUSIVE(health_data, m_health)
+	};
+
+	class HealthManager;
+	struct Health : public IComp<HealthManager>
+	{
+		DECLARE_COMPONENT(Health);
+
+		int GetHealth() const;
+		void SetHealth(int _health);
+	};
+
+	class HealthManager : public TArchetypeCompManager<Health, health_data>
+	{
+		friend struct Health;
+
+	public:
+
+		virtual const char* GetComponentTypeName() const override { return "Health"; }
+
+	private:
+
+		virtual void impl_edit_component(Entity _entity) override {}
+		virtual void impl_deserialize_data(nlohmann::json const& _j) override { deserialize_storage(_j); }
+		virtual void impl_serialize_data(nlohmann::json& _j) const override { serialize_storage(_j); }
+	};
+
+	int Health::GetHealth() const { return GetManager().get_data(Owner()).m_health; }
+	void Health::SetHealth(int _health) { GetManager().get_data(Owner()).m_health = _health; }
+}
+
+TEST(ArchetypeCompManager, CreatesAndDestroysComponents)
+{
+	auto& entity_manager = Singleton<EntityManager>();
+	auto& health_manager = Singleton<HealthManager>();
+	health_manager.Initialize();
+	health_manager.Clear();
+
+	Entity entities[4];
+	ASSERT_TRUE(entity_manager.EntityCreationRequest(entities, 4));
+	for (int i = 0; i < 3; i++)
+	{
+		Health const health = health_manager.Create(entities[i]);
+		ASSERT_TRUE(health.IsValid());
+		EXPECT_EQ(health.GetHealth(), 100);
+		health.GetManager().Get(entities[i]).SetHealth(10 * i);
+	}
+	EXPECT_FALSE(entities[3].HasComponent<Health>());
+
+	// Creating a component the entity already owns fails.
+	EXPECT_FALSE(health_manager.Create(entities[0]).IsValid());
+	EXPECT_EQ(entities[0].GetComponent<Health>().GetHealth(), 0);
+
+	health_manager.Destroy(&entities[1], 1);
+	EXPECT_FALSE(entities[1].HasComponent<Health>());
+	EXPECT_EQ(entities[2].GetComponent<Health>().GetHealth(), 20);
+
+	// Destroyed entities are removed from the storage of registered managers.
+	entity_manager.EntityDelayedDeletion(entities[2]);
+	entity_manager.FreeQueuedEntities();
+	EXPECT_FALSE(health_manager.ComponentOwnedByEntity(entities[2]));
+	EXPECT_TRUE(entities[0].HasComponent<Health>());
+
+	health_manager.Clear();
+	EXPECT_FALSE(entities[0].HasComponent<Health>());
+
+	entity_manager.EntityDelayedDeletion(entities, 4);
+	entity_manager.FreeQueuedEntities();
+}
+
+TEST(ArchetypeCompManager, SerializationRoundTrip)
+{
+	auto& entity_manager = Singleton<EntityManager>();
+	auto& health_manager = Singleton<HealthManager>();
+	health_manager.Clear();
+
+	std::vector<Entity> entities(10);
+	ASSERT_TRUE(entity_manager.EntityCreationRequest(entities.data(), (unsigned int)entities.size()));
+	for (size_t i = 0; i < entities.size(); i += 2)
+		health_manager.Create(entities[i]).SetHealth((int)i);
+
+	nlohmann::json j;
+	health_manager.Serialize(j);
+	ASSERT_TRUE(j.contains("Health"));
+
+	health_manager.Clear();
+	health_manager.Deserialize(j);
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		ASSERT_EQ(entities[i].HasComponent<Health>(), i % 2 == 0);
+		if (i % 2 == 0)
+			EXPECT_EQ(entities[i].GetComponent<Health>().GetHealth(), (int)i);
+	}
+
+	// Scenes without data of this manager leave it empty.
+	health_manager.Deserialize(nlohmann::json::object());
+	EXPECT_FALSE(entities[0].HasComponent<Health>());
+
+	entity_manager.EntityDelayedDeletion(entities.data(), (unsigned int)entities.size());
+	entity_manager.FreeQueuedEntities();
+}
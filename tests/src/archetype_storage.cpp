@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+#include <Engine/ECS/archetype_storage.h>
+
+#include <memory>
+#include <string>
+
+using Engine::ECS::archetype_storage;
+using Engine::ECS::Entity;
+
+namespace
+{
+	struct position { float x, y, z; };
+	struct velocity { float x, y, z; };
+
+	Entity make_entity(unsigned int _id)
+	{
+		Entity e;
+		e.m_id = _id;
+		e.m_counter = 0;
+		return e;
+	}
+}
+
+TEST(ArchetypeStorage, MigratesComponentsBetweenArchetypes)
+{
+	archetype_storage storage;
+	Entity const e = make_entity(3);
+
+	storage.emplace<position>(e, position{ 1.0f, 2.0f, 3.0f });
+	EXPECT_TRUE(storage.has<position>(e));
+	EXPECT_FALSE(storage.has<velocity>(e));
+
+	storage.emplace<velocity>(e, velocity{ 4.0f, 5.0f, 6.0f });
+	EXPECT_EQ(storage.archetype_count(), 2u);
+	EXPECT_EQ(storage.get<position>(e).y, 2.0f);
+	EXPECT_EQ(storage.get<velocity>(e).z, 6.0f);
+
+	// Emplacing an owned component returns the existing one.
+	EXPECT_EQ(storage.emplace<position>(e, position{}).x, 1.0f);
+
+	EXPECT_TRUE(storage.remove<position>(e));
+	EXPECT_FALSE(storage.remove<position>(e));
+	EXPECT_EQ(storage.try_get<position>(e), nullptr);
+	EXPECT_EQ(storage.get<velocity>(e).x, 4.0f);
+
+	EXPECT_TRUE(storage.remove<velocity>(e));
+	EXPECT_FALSE(storage.contains(e));
+	EXPECT_EQ(storage.chunk_count(), 0u);
+}
+
+TEST(ArchetypeStorage, IteratesEntitiesAcrossChunks)
+{
+	archetype_storage storage;
+	unsigned int const entity_count = 5000;
+	for (unsigned int i = 0; i < entity_count; i++)
+	{
+		storage.emplace<position>(make_entity(i), position{ float(i), 0.0f, 0.0f });
+		if (i % 2 == 0)
+			storage.emplace<velocity>(make_entity(i), velocity{ 1.0f, 0.0f, 0.0f });
+	}
+	EXPECT_GT(storage.chunk_count(), 2u);
+
+	size_t visited = 0;
+	storage.each<position, velocity>([&](Entity _e, position& _position, velocity& _velocity)
+	{
+		EXPECT_EQ(_e.ID() % 2, 0u);
+		EXPECT_EQ(_position.x, float(_e.ID()));
+		_position.x += _velocity.x;
+		visited++;
+	});
+	EXPECT_EQ(visited, entity_count / 2);
+	EXPECT_EQ(storage.get<position>(make_entity(10)).x, 11.0f);
+	EXPECT_EQ(storage.get<position>(make_entity(11)).x, 11.0f);
+
+	// Rows freed from the middle of an archetype are filled with its last entity.
+	for (unsigned int i = 0; i < entity_count; i += 3)
+		storage.destroy(make_entity(i));
+	for (unsigned int i = 1; i < entity_count; i += 3)
+		EXPECT_EQ(storage.get<position>(make_entity(i)).x, float(i) + (i % 2 == 0 ? 1.0f : 0.0f));
+	EXPECT_EQ(storage.entity_count(), entity_count - (entity_count + 2) / 3);
+}
+
+TEST(ArchetypeStorage, DestroysNonTrivialComponents)
+{
+	auto const shared = std::make_shared<int>(0);
+	{
+		archetype_storage storage;
+		for (unsigned int i = 0; i < 100; i++)
+		{
+			storage.emplace<std::shared_ptr<int>>(make_entity(i), shared);
+			storage.emplace<std::string>(make_entity(i), "name");
+		}
+		EXPECT_EQ(shared.use_count(), 101);
+		EXPECT_EQ(storage.get<std::string>(make_entity(50)), "name");
+
+		storage.remove_all<std::string>();
+		EXPECT_EQ(storage.try_get<std::string>(make_entity(50)), nullptr);
+		EXPECT_EQ(shared.use_count(), 101);
+
+		for (unsigned int i = 0; i < 10; i++)
+			storage.destroy(make_entity(i));
+		EXPECT_EQ(shared.use_count(), 91);
+	}
+	EXPECT_EQ(shared.use_count(), 1);
+}
@@ -86,4 +86,15 @@ TEST(Compression, CompressBigTypes)
 	test_compressing_type(std::vector<uint32_t>{1, 2, 3});
 	test_compressing_type(std::vector<uint64_t>{1, 2, 3});
 	test_compressing_type(std::vector<float>{0.0f, -1.0f, 1.0f});
-}
\ No newline at end of file
+}
+
+TEST(Compression, BoolsFillWholeElements)
+{
+	std::vector<bool> values(130);
+	for (size_t i = 0; i < values.size(); i++)
+		values[i] = (i % 3 == 0);
+
+	auto compressed = Engine::Serialisation::compress_data_vector(values);
+	EXPECT_EQ(compressed.size(), 3u);
+	test_compressing_type(values);
+}
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <Engine/Components/CurveFollower.h>
+#include <Engine/Components/Transform.h>
+#include <Engine/Utils/singleton.h>
+
+using namespace Component;
+
+TEST(CurveFollowerManager, AdvancesOnlyPlayingFollowers)
+{
+	auto& entity_manager = Singleton<EntityManager>();
+	auto& transform_manager = Singleton<TransformManager>();
+	auto& curve_manager = Singleton<CurveInterpolatorManager>();
+	auto& follower_manager = Singleton<CurveFollowerManager>();
+	transform_manager.Initialize();
+	curve_manager.Initialize();
+	follower_manager.Initialize();
+	follower_manager.Clear();
+
+	Entity entities[4];
+	ASSERT_TRUE(entity_manager.EntityCreationRequest(entities, 4));
+	transform_manager.Create(entities[0]);
+	CurveInterpolator curve = curve_manager.Create(entities[0]);
+	piecewise_curve linear_curve;
+	linear_curve.m_type = piecewise_curve::EType::Linear;
+	linear_curve.m_nodes = { glm::vec3(0.0f), glm::vec3(10.0f, 0.0f, 0.0f) };
+	curve.SetPiecewiseCurve(linear_curve, 16u);
+
+	for (int i = 1; i < 4; i++)
+	{
+		transform_manager.Create(entities[i]);
+		follower_data& data = follower_manager.Create(entities[i]).GetFollowerData();
+		data.m_curve_component = curve;
+		data.m_arclength = (float)i;
+		data.m_max_travel_rate = 0.0f;
+	}
+	entities[1].GetComponent<CurveFollower>().SetPlayingState(true);
+	entities[3].GetComponent<CurveFollower>().SetPlayingState(true);
+	EXPECT_FALSE(entities[2].GetComponent<CurveFollower>().GetPlayingState());
+
+	follower_manager.UpdateFollowers(0.5f);
+	for (int i = 1; i < 4; i++)
+	{
+		bool const playing = i != 2;
+		EXPECT_EQ(entities[i].GetComponent<CurveFollower>().GetPlayingState(), playing);
+		EXPECT_FLOAT_EQ(entities[i].GetComponent<CurveFollower>().GetFollowerData().m_arclength, (float)i + (playing ? 0.5f : 0.0f));
+	}
+
+	// Playing state survives a serialization round trip.
+	nlohmann::json j;
+	follower_manager.Serialize(j);
+	follower_manager.Clear();
+	EXPECT_FALSE(entities[1].HasComponent<CurveFollower>());
+	follower_manager.Deserialize(j);
+	for (int i = 1; i < 4; i++)
+	{
+		ASSERT_TRUE(entities[i].HasComponent<CurveFollower>());
+		EXPECT_EQ(entities[i].GetComponent<CurveFollower>().GetPlayingState(), i != 2);
+	}
+
+	entity_manager.EntityDelayedDeletion(entities, 4);
+	entity_manager.FreeQueuedEntities();
+	EXPECT_FALSE(CurveFollowerManager::GetStorage().contains(entities[1]));
+}
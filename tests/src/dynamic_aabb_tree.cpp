@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+#include <Engine/Physics/dynamic_aabb_tree.h>
+#include <Engine/Math/geometry_intersection.hpp>
+
+#include <algorithm>
+#include <random>
+
+using namespace Engine::Physics;
+using namespace Engine::Math;
+
+static std::vector<aabb> create_random_bounds(size_t _count, float _side, unsigned int _seed)
+{
+	std::mt19937 rng(_seed);
+	std::uniform_real_distribution<float> position_dist(0.0f, _side);
+	std::uniform_real_distribution<float> extent_dist(0.1f, 1.0f);
+
+	std::vector<aabb> bounds(_count);
+	for (auto& b : bounds)
+	{
+		b.center = glm::vec3(position_dist(rng), position_dist(rng), position_dist(rng));
+		b.extent = glm::vec3(extent_dist(rng), extent_dist(rng), extent_dist(rng));
+	}
+	return bounds;
+}
+
+// Every pair of overlapping bounds must be reported by the tree exactly once.
+static void test_tree_pairs(dynamic_aabb_tree const& _tree, std::vector<aabb> const& _bounds)
+{
+	std::vector<broadphase_pair> pairs;
+	_tree.compute_pairs(pairs);
+
+	EXPECT_TRUE(std::is_sorted(pairs.begin(), pairs.end()));
+	EXPECT_EQ(std::adjacent_find(pairs.begin(), pairs.end()), pairs.end());
+
+	for (uint32_t i = 0; i < (uint32_t)_bounds.size(); i++)
+	{
+		for (uint32_t j = i + 1; j < (uint32_t)_bounds.size(); j++)
+		{
+			if (intersect_aabb_aabb(_bounds[i], _bounds[j]))
+				EXPECT_TRUE(std::binary_search(pairs.begin(), pairs.end(), broadphase_pair(i, j)));
+		}
+	}
+}
+
+TEST(DynamicAABBTree, PairsMatchBruteForce)
+{
+	std::vector<aabb> bounds = create_random_bounds(500, 20.0f, 1);
+
+	dynamic_aabb_tree tree;
+	for (uint32_t i = 0; i < (uint32_t)bounds.size(); i++)
+		tree.create_proxy(bounds[i], i);
+
+	EXPECT_EQ(tree.proxy_count(), bounds.size());
+	test_tree_pairs(tree, bounds);
+}
+
+TEST(DynamicAABBTree, MoveProxies)
+{
+	std::vector<aabb> bounds = create_random_bounds(500, 20.0f, 2);
+
+	dynamic_aabb_tree tree;
+	std::vector<dynamic_aabb_tree::proxy_id> proxies;
+	for (uint32_t i = 0; i < (uint32_t)bounds.size(); i++)
+		proxies.push_back(tree.create_proxy(bounds[i], i));
+
+	std::mt19937 rng(3);
+	std::uniform_real_distribution<float> offset_dist(-0.5f, 0.5f);
+	for (int frame = 0; frame < 10; frame++)
+	{
+		for (size_t i = 0; i < bounds.size(); i++)
+		{
+			bounds[i].center += glm::vec3(offset_dist(rng), offset_dist(rng), offset_dist(rng));
+			tree.move_proxy(proxies[i], bounds[i]);
+		}
+		test_tree_pairs(tree, bounds);
+	}
+}
+
+TEST(DynamicAABBTree, SmallMoveDoesNotReinsert)
+{
+	aabb bounds;
+	bounds.center = glm::vec3(0.0f);
+	bounds.extent = glm::vec3(1.0f);
+
+	dynamic_aabb_tree tree;
+	tree.m_fat_margin = 0.1f;
+	auto proxy = tree.create_proxy(bounds, 0);
+
+	bounds.center.x += 0.05f;
+	EXPECT_FALSE(tree.move_proxy(proxy, bounds));
+	bounds.center.x += 0.1f;
+	EXPECT_TRUE(tree.move_proxy(proxy, bounds));
+}
+
+TEST(DynamicAABBTree, DestroyProxies)
+{
+	std::vector<aabb> bounds = create_random_bounds(300, 15.0f, 4);
+
+	dynamic_aabb_tree tree;
+	std::vector<dynamic_aabb_tree::proxy_id> proxies;
+	for (uint32_t i = 0; i < (uint32_t)bounds.size(); i++)
+		proxies.push_back(tree.create_proxy(bounds[i], i));
+
+	// Destroy every other proxy, and move remaining bounds to front of array,
+	// updating user data to match new indices.
+	std::vector<aabb> remaining_bounds;
+	for (size_t i = 0; i < bounds.size(); i++)
+	{
+		if (i % 2 == 0)
+			tree.destroy_proxy(proxies[i]);
+		else
+		{
+			tree.set_user_data(proxies[i], (uint32_t)remaining_bounds.size());
+			remaining_bounds.push_back(bounds[i]);
+		}
+	}
+
+	EXPECT_EQ(tree.proxy_count(), remaining_bounds.size());
+	test_tree_pairs(tree, remaining_bounds);
+}
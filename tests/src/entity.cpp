@@ -0,0 +1,169 @@
+#include <gtest/gtest.h>
+#include <Engine/ECS/entity.h>
+#include <Engine/Serialisation/compress.h>
+
+#include <stdexcept>
+#include <vector>
+
+using namespace Engine::ECS;
+
+TEST(Entity, InvalidEntityHasInvalidID)
+{
+	Entity const e;
+	EXPECT_EQ(e.ID(), Entity::INVALID_ID);
+	EXPECT_EQ(e.Counter(), 0u);
+	EXPECT_EQ(e, Entity::InvalidEntity);
+}
+
+TEST(EntityManager, CreatesMoreEntitiesThanLegacyHandles)
+{
+	unsigned int const entity_count = 50000;
+	ASSERT_LE(entity_count, EntityManager::MAX_ENTITIES);
+
+	EntityManager entity_manager;
+	std::vector<Entity> entities(entity_count);
+	ASSERT_TRUE(entity_manager.EntityCreationRequest(entities.data(), entity_count));
+	for (unsigned int i = 0; i < entity_count; i++)
+	{
+		EXPECT_EQ(entities[i].ID(), i);
+		EXPECT_TRUE(entity_manager.DoesEntityExist(entities[i]));
+	}
+
+	entity_manager.EntityDelayedDeletion(entities.data(), entity_count);
+	EXPECT_EQ(entity_manager.FreeQueuedEntities().size(), entity_count);
+	EXPECT_FALSE(entity_manager.DoesEntityExist(entities.back()));
+}
+
+TEST(EntityManager, StaleHandleDoesNotExist)
+{
+	EntityManager entity_manager;
+	Entity const first = entity_manager.EntityCreationRequest();
+	entity_manager.EntityDelayedDeletion(first);
+	entity_manager.FreeQueuedEntities();
+
+	// ID is reused with next counter, old handle remains dead.
+	Entity const second = entity_manager.EntityCreationRequest();
+	EXPECT_EQ(second.ID(), first.ID());
+	EXPECT_NE(second.Counter(), first.Counter());
+	EXPECT_TRUE(entity_manager.DoesEntityExist(second));
+	EXPECT_FALSE(entity_manager.DoesEntityExist(first));
+}
+
+TEST(EntityManager, QueuesEntityForDeletionOnce)
+{
+	EntityManager entity_manager;
+	Entity entities[3];
+	entity_manager.EntityCreationRequest(entities, 3);
+
+	Entity const stale = entities[1];
+	entity_manager.EntityDelayedDeletion(entities[1]);
+	entity_manager.EntityDelayedDeletion(entities[1]);
+	EXPECT_FALSE(entity_manager.DoesEntityExist(entities[1]));
+	EXPECT_EQ(entity_manager.FreeQueuedEntities().size(), 1u);
+	entity_manager.EntityDelayedDeletion(entities, 3);
+	EXPECT_EQ(entity_manager.FreeQueuedEntities().size(), 2u);
+	EXPECT_EQ(entity_manager.EntityCount(), 0u);
+
+	// Freed IDs are reused before storage grows, earlier frees first. IDs freed together
+	// are freed in ID order.
+	Entity reused[4];
+	ASSERT_TRUE(entity_manager.EntityCreationRequest(reused, 4));
+	EXPECT_EQ(reused[0].ID(), entities[1].ID());
+	EXPECT_EQ(reused[1].ID(), entities[0].ID());
+	EXPECT_EQ(reused[2].ID(), entities[2].ID());
+	EXPECT_EQ(reused[3].ID(), 3u);
+	EXPECT_EQ(entity_manager.EntityCount(), 4u);
+
+	entity_manager.EntityDelayedDeletion(stale);
+	EXPECT_TRUE(entity_manager.FreeQueuedEntities().empty());
+}
+
+TEST(EntityManager, SerializationRoundTrip)
+{
+	EntityManager entity_manager;
+	std::vector<Entity> entities(100);
+	entity_manager.EntityCreationRequest(entities.data(), (unsigned int)entities.size());
+	entity_manager.EntityDelayedDeletion(&entities[10], 5);
+	entity_manager.FreeQueuedEntities();
+
+	nlohmann::json j;
+	entity_manager.Serialize(j);
+
+	EntityManager loaded_manager;
+	loaded_manager.Deserialize(j);
+	for (size_t i = 0; i < entities.size(); i++)
+		EXPECT_EQ(loaded_manager.DoesEntityExist(entities[i]), i < 10 || i >= 15);
+}
+
+TEST(EntityManager, LoadsLegacyScene)
+{
+	using namespace Engine::Serialisation;
+
+	// Version 2 packed use flags 8 per element. ID 2 is alive with a counter of 5, which 16-bit
+	// handles stored as 5 & 3.
+	std::vector<uint8_t> counters(16383, 0);
+	counters[2] = 5;
+	nlohmann::json j;
+	j["serializer_version"] = 2;
+	j["m_entity_in_use_flag"] = std::vector<compressed_type>{ 0b100 };
+	j["m_entity_counters"] = compress_data_vector(counters);
+	j["m_entity_id_iter"] = 3;
+
+	EntityManager entity_manager;
+	entity_manager.Deserialize(j);
+	serialized_entity_format_scope const format_scope(get_serialized_entity_format(j));
+
+	uint16_t const legacy_handle = (2 << 2) | (5 & 3);
+	Entity const converted = nlohmann::json(legacy_handle).get<Entity>();
+	EXPECT_EQ(converted.ID(), 2u);
+	EXPECT_EQ(converted.Counter(), 1u);
+	EXPECT_TRUE(entity_manager.DoesEntityExist(converted));
+
+	// Default constructed 16-bit handles load as invalid entity.
+	EXPECT_EQ(nlohmann::json(uint16_t(16383)).get<Entity>(), Entity::InvalidEntity);
+
+	// Handles decoded explicitly, outside of a scene load, use the same conversion.
+	EXPECT_EQ(deserialize_entity(nlohmann::json(legacy_handle), get_serialized_entity_format(j)), converted);
+}
+
+TEST(EntityManager, HandleFormatIsRestoredWhenLoadingThrows)
+{
+	nlohmann::json legacy_j;
+	legacy_j["serializer_version"] = 2;
+
+	Entity handle;
+	handle.m_data = Entity::data_type(2u << Entity::COUNTER_BITS);
+	try
+	{
+		serialized_entity_format_scope const format_scope(get_serialized_entity_format(legacy_j));
+		throw std::runtime_error("Scene load failed.");
+	}
+	catch (std::runtime_error const&)
+	{
+	}
+	EXPECT_EQ(nlohmann::json(handle.m_data).get<Entity>(), handle);
+}
+
+TEST(EntityManager, LegacyHandlesConvertForEveryHandleWidth)
+{
+	uint16_t const invalid_16 = uint16_t(((1u << entity_handle_layout<16>::ID_BITS) - 1) << entity_handle_layout<16>::COUNTER_BITS);
+	uint32_t const invalid_32 = ((1u << entity_handle_layout<32>::ID_BITS) - 1) << entity_handle_layout<32>::COUNTER_BITS;
+	uint16_t const legacy_handle = (2 << 2) | 1;
+
+	// Version 2 scene loaded by a build with 16-bit handles. Handle widths match, but the
+	// default handle still has to become the invalid entity.
+	EXPECT_EQ(convert_serialized_entity_handle<16>(16383, 16, true), invalid_16);
+	EXPECT_EQ(convert_serialized_entity_handle<16>(legacy_handle, 16, true), legacy_handle);
+
+	// Version 3 scenes of 16-bit builds round trip as they are, ID 4095 is a live entity there.
+	EXPECT_EQ(convert_serialized_entity_handle<16>(16383, 16, false), 16383u);
+	EXPECT_EQ(convert_serialized_entity_handle<16>(invalid_16, 16, false), invalid_16);
+
+	// Across handle widths.
+	EXPECT_EQ(convert_serialized_entity_handle<32>(16383, 16, true), invalid_32);
+	EXPECT_EQ(convert_serialized_entity_handle<32>(invalid_16, 16, false), invalid_32);
+	EXPECT_EQ(convert_serialized_entity_handle<32>(legacy_handle, 16, false), (2u << 8) | 1u);
+	EXPECT_EQ(convert_serialized_entity_handle<16>(invalid_32, 32, false), invalid_16);
+	EXPECT_EQ(convert_serialized_entity_handle<16>((20000u << 8) | 7u, 32, false), invalid_16);
+	EXPECT_EQ(convert_serialized_entity_handle<16>((2u << 8) | 7u, 32, false), (2u << 2) | 3u);
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+#include <Engine/Utils/frame_arena.h>
+
+#include <cstdint>
+
+using Engine::Utils::frame_arena;
+using Engine::Utils::frame_vector;
+
+TEST(FrameArena, AllocatesAlignedMemory)
+{
+	frame_arena arena(1024);
+	void* const byte = arena.allocate(1, 1);
+	void* const aligned = arena.allocate(64, 64);
+	EXPECT_NE(byte, aligned);
+	EXPECT_EQ(reinterpret_cast<uintptr_t>(aligned) % 64, 0u);
+	EXPECT_EQ(arena.current_stats().allocation_count, 2u);
+	EXPECT_EQ(arena.current_stats().heap_allocation_count, 1u);
+}
+
+TEST(FrameArena, StopsAllocatingFromHeapAfterReset)
+{
+	frame_arena arena(256);
+	auto run_frame = [&arena]()
+	{
+		frame_vector<int> values(&arena);
+		for (int i = 0; i < 1000; i++)
+			values.push_back(i);
+		frame_vector<double> other(500, 1.0, &arena);
+		EXPECT_EQ(values[999], 999);
+	};
+
+	// First frame outgrows the initial block, reset merges blocks into one that fits a whole frame.
+	run_frame();
+	EXPECT_GT(arena.current_stats().heap_allocation_count, 1u);
+	arena.reset();
+
+	run_frame();
+	arena.reset();
+	EXPECT_EQ(arena.last_frame_stats().heap_allocation_count, 0u);
+	EXPECT_GT(arena.last_frame_stats().bytes_allocated, 1000 * sizeof(int));
+	EXPECT_EQ(arena.current_stats().peak_bytes_allocated, arena.last_frame_stats().peak_bytes_allocated);
+}
+
+TEST(FrameArena, ReusesMemoryAfterReset)
+{
+	frame_arena arena;
+	void* const first = arena.allocate(128, 16);
+	arena.reset();
+	EXPECT_EQ(arena.allocate(128, 16), first);
+}
@@ -0,0 +1,88 @@
+#include "heap_allocation_counter.h"
+
+#ifndef ENGINE_ALLOCATION_TRACKING
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	std::atomic<uint64_t> s_allocation_count{ 0 };
+
+	// Pointer returned by malloc, stored in front of every allocation so that aligned allocations can be freed.
+	struct allocation_header
+	{
+		void* raw;
+	};
+
+	void* counted_allocate(size_t _size, size_t _alignment) noexcept
+	{
+		_alignment = std::max(_alignment, alignof(allocation_header));
+		void* const raw = std::malloc(_size + _alignment + sizeof(allocation_header));
+		if (!raw)
+			return nullptr;
+
+		uintptr_t const address = (reinterpret_cast<uintptr_t>(raw) + sizeof(allocation_header) + _alignment - 1) & ~(uintptr_t)(_alignment - 1);
+		reinterpret_cast<allocation_header*>(address)[-1].raw = raw;
+		s_allocation_count.fetch_add(1, std::memory_order_relaxed);
+		return reinterpret_cast<void*>(address);
+	}
+
+	void* counted_allocate_or_throw(size_t _size, size_t _alignment)
+	{
+		while (true)
+		{
+			if (void* const ptr = counted_allocate(_size, _alignment))
+				return ptr;
+			std::new_handler const handler = std::get_new_handler();
+			if (!handler)
+				throw std::bad_alloc();
+			handler();
+		}
+	}
+
+	void counted_deallocate(void* _ptr) noexcept
+	{
+		if (_ptr)
+			std::free(static_cast<allocation_header*>(_ptr)[-1].raw);
+	}
+}
+
+uint64_t heap_allocation_count()
+{
+	return s_allocation_count.load(std::memory_order_relaxed);
+}
+
+void* operator new(std::size_t _size) { return counted_allocate_or_throw(_size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](std::size_t _size) { return counted_allocate_or_throw(_size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(std::size_t _size, std::align_val_t _alignment) { return counted_allocate_or_throw(_size, (size_t)_alignment); }
+void* operator new[](std::size_t _size, std::align_val_t _alignment) { return counted_allocate_or_throw(_size, (size_t)_alignment); }
+void* operator new(std::size_t _size, std::nothrow_t const&) noexcept { return counted_allocate(_size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new[](std::size_t _size, std::nothrow_t const&) noexcept { return counted_allocate(_size, __STDCPP_DEFAULT_NEW_ALIGNMENT__); }
+void* operator new(std::size_t _size, std::align_val_t _alignment, std::nothrow_t const&) noexcept { return counted_allocate(_size, (size_t)_alignment); }
+void* operator new[](std::size_t _size, std::align_val_t _alignment, std::nothrow_t const&) noexcept { return counted_allocate(_size, (size_t)_alignment); }
+
+void operator delete(void* _ptr) noexcept { counted_deallocate(_ptr); }
+void operator delete[](void* _ptr) noexcept { counted_deallocate(_ptr); }
+void operator delete(void* _ptr, std::size_t) noexcept { counted_deallocate(_ptr); }
+void operator delete[](void* _ptr, std::size_t) noexcept { counted_deallocate(_ptr); }
+void operator delete(void* _ptr, std::align_val_t) noexcept { counted_deallocate(_ptr); }
+void operator delete[](void* _ptr, std::align_val_t) noexcept { counted_deallocate(_ptr); }
+void operator delete(void* _ptr, std::size_t, std::align_val_t) noexcept { counted_deallocate(_ptr); }
+void operator delete[](void* _ptr, std::size_t, std::align_val_t) noexcept { counted_deallocate(_ptr); }
+void operator delete(void* _ptr, std::nothrow_t const&) noexcept { counted_deallocate(_ptr); }
+void operator delete[](void* _ptr, std::nothrow_t const&) noexcept { counted_deallocate(_ptr); }
+void operator delete(void* _ptr, std::align_val_t, std::nothrow_t const&) noexcept { counted_deallocate(_ptr); }
+void operator delete[](void* _ptr, std::align_val_t, std::nothrow_t const&) noexcept { counted_deallocate(_ptr); }
+
+#else
+
+// Engine replaces operator new, allocations are counted by the allocation tracker.
+uint64_t heap_allocation_count()
+{
+	return 0;
+}
+
+#endif // !ENGINE_ALLOCATION_TRACKING
@@ -0,0 +1,34 @@
+#ifndef TESTS_HEAP_ALLOCATION_COUNTER_H
+#define TESTS_HEAP_ALLOCATION_COUNTER_H
+
+#include <Engine/Utils/allocation_tracker.h>
+
+#include <cstdint>
+
+/*
+* @brief	Heap allocations of all threads since the test executable started.
+* @details	Counted by global operator new of the test executable. Builds with ENGINE_ALLOCATION_TRACKING
+*			replace operator new in the engine instead, and count allocations with the allocation tracker.
+*/
+uint64_t heap_allocation_count();
+
+/*
+* @brief	Heap allocations of all threads while running _func.
+* @details	Closes the current allocation tracker frame when tracking is enabled.
+*/
+template<typename TFunc>
+uint64_t count_heap_allocations(TFunc&& _func)
+{
+	using Engine::Utils::allocation_tracker;
+	if (allocation_tracker::enabled())
+	{
+		allocation_tracker::end_frame();
+		_func();
+		return allocation_tracker::current_frame().total.allocation_count;
+	}
+	uint64_t const allocation_count = heap_allocation_count();
+	_func();
+	return heap_allocation_count() - allocation_count;
+}
+
+#endif // !TESTS_HEAP_ALLOCATION_COUNTER_H
@@ -61,4 +61,84 @@ TEST(RigidBody, AngularIntegration_ForceFree)
 	//EXPECT_VEC3_EQ(ROT_DEFAULT * rotations[0], glm::vec3(0.0f, 0.0f, -1.0f), 0.0001f);
 	//EXPECT_VEC3_EQ(ROT_DEFAULT * rotations[1], glm::vec3(0.0f, 0.0f, 1.0f), 0.0001f);
 	
-}
\ No newline at end of file
+}
+
+/*
+* Bodies with varied rotations, inertia and momentum. The count is not a multiple of any lane
+* width, so both packed and remainder bodies are integrated.
+*/
+struct integration_bodies
+{
+	std::vector<glm::vec3> positions, linear_momentums, forces;
+	std::vector<float> inv_masses;
+	std::vector<glm::quat> rotations;
+	std::vector<glm::vec3> angular_momentums, torques;
+	std::vector<glm::mat3> inv_inertial_tensors, inv_world_tensors;
+
+	explicit integration_bodies(size_t _count)
+	{
+		for (size_t i = 0; i < _count; i++)
+		{
+			float const f = (float)i;
+			positions.push_back(glm::vec3(f, -f, 0.5f * f));
+			linear_momentums.push_back(glm::vec3(std::sin(f), std::cos(f), 1.0f));
+			forces.push_back(glm::vec3(0.0f, -9.81f, 0.1f * f));
+			inv_masses.push_back(i % 7 == 0 ? 0.0f : 1.0f / (1.0f + f));
+			rotations.push_back(glm::angleAxis(0.1f * f, glm::normalize(glm::vec3(1.0f, f, 2.0f))));
+			angular_momentums.push_back(glm::vec3(0.3f * std::cos(f), 0.2f, -0.1f * std::sin(f)));
+			torques.push_back(glm::vec3(0.01f * f, 0.0f, -0.02f));
+			inv_inertial_tensors.push_back(glm::mat3(glm::vec3(1.0f, 0.1f, 0.0f), glm::vec3(0.1f, 2.0f, 0.0f), glm::vec3(0.0f, 0.0f, 0.5f)) * inv_masses.back());
+		}
+		inv_world_tensors.resize(_count);
+		compute_inv_world_tensors(rotations.data(), inv_inertial_tensors.data(), inv_world_tensors.data(), _count);
+	}
+
+	void integrate(Engine::Math::ESIMDLevel _level, size_t _steps)
+	{
+		for (size_t step = 0; step < _steps; step++)
+		{
+			integrate_linear_euler(1.0f / 60.0f, positions.data(), linear_momentums.data(), forces.data(), inv_masses.data(), positions.size(), _level);
+			integrate_angular_euler(1.0f / 60.0f, rotations.data(), angular_momentums.data(), torques.data(),
+				inv_inertial_tensors.data(), inv_world_tensors.data(), rotations.size(), _level);
+		}
+	}
+};
+
+static void expect_integration_near(integration_bodies const& _expected, integration_bodies const& _actual)
+{
+	for (size_t i = 0; i < _expected.positions.size(); i++)
+	{
+		EXPECT_VEC3_EQ(_expected.positions[i], _actual.positions[i], 1e-3f);
+		EXPECT_VEC3_EQ(_expected.linear_momentums[i], _actual.linear_momentums[i], 1e-3f);
+		EXPECT_VEC3_EQ(_expected.angular_momentums[i], _actual.angular_momentums[i], 1e-4f);
+		EXPECT_NEAR(std::abs(glm::dot(_expected.rotations[i], _actual.rotations[i])), 1.0f, 1e-4f);
+		for (int c = 0; c < 3; c++)
+			EXPECT_VEC3_EQ(_expected.inv_world_tensors[i][c], _actual.inv_world_tensors[i][c], 1e-4f);
+	}
+}
+
+TEST(RigidBody, SIMDIntegration_MatchesScalar)
+{
+	integration_bodies scalar(37);
+	scalar.integrate(Engine::Math::eScalar, 30);
+
+	for (Engine::Math::ESIMDLevel level : { Engine::Math::eSSE, Engine::Math::eAVX2 })
+	{
+		integration_bodies simd(37);
+		simd.integrate(level, 30);
+		expect_integration_near(scalar, simd);
+	}
+}
+
+TEST(RigidBody, AngularIntegration_CachesWorldTensor)
+{
+	integration_bodies bodies(19);
+	bodies.integrate(Engine::Math::get_supported_simd_level(), 10);
+
+	// Cached tensor matches tensor of integrated rotation.
+	std::vector<glm::mat3> expected(bodies.rotations.size());
+	compute_inv_world_tensors(bodies.rotations.data(), bodies.inv_inertial_tensors.data(), expected.data(), expected.size());
+	for (size_t i = 0; i < expected.size(); i++)
+		for (int c = 0; c < 3; c++)
+			EXPECT_VEC3_EQ(expected[i][c], bodies.inv_world_tensors[i][c], 1e-5f);
+}
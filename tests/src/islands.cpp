@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include <Engine/Physics/islands.hpp>
+#include <Engine/Physics/resolution.hpp>
+
+using namespace Engine::Physics;
+using rigidbody_data_collection = Component::RigidBodyManager::rigidbody_data_collection;
+
+static rigidbody_data_collection create_bodies(size_t _count)
+{
+	rigidbody_data_collection data;
+	for (size_t i = 0; i < _count; i++)
+	{
+		Engine::ECS::Entity e;
+		e.m_id = (uint16_t)i;
+		e.m_counter = 0;
+		data.push_element(e, glm::vec3((float)i * 4.0f, 0.0f, 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), 1.0f, glm::mat3(1.0f));
+	}
+	return data;
+}
+
+TEST(SimulationIslands, RestingBodiesFallAsleep)
+{
+	rigidbody_data_collection data = create_bodies(4);
+	data.m_linear_momentums[3] = glm::vec3(0.0f, 10.0f, 0.0f);
+
+	global_contact_data contacts;
+	physics_simulation_parameters parameters;
+	parameters.sleep_frame_count = 5;
+	simulation_islands islands;
+
+	for (unsigned int frame = 0; frame < parameters.sleep_frame_count - 1; frame++)
+		update_simulation_islands(contacts, parameters, data, islands);
+	EXPECT_EQ(islands.sleeping_body_count, 0u);
+	EXPECT_EQ(islands.island_count, 4u);
+
+	update_simulation_islands(contacts, parameters, data, islands);
+	EXPECT_TRUE(data.is_sleeping(0));
+	EXPECT_TRUE(data.is_sleeping(1));
+	EXPECT_TRUE(data.is_sleeping(2));
+	EXPECT_FALSE(data.is_sleeping(3));
+	EXPECT_EQ(islands.sleeping_body_count, 3u);
+}
+
+TEST(SimulationIslands, ForceWakesBody)
+{
+	rigidbody_data_collection data = create_bodies(2);
+	size_t const indices[] = { 0, 1 };
+	data.sleep_island(indices, 2);
+	ASSERT_TRUE(data.is_sleeping(0));
+
+	// Waking one body wakes every body of its island.
+	data.wake(1);
+	EXPECT_FALSE(data.is_sleeping(0));
+	EXPECT_FALSE(data.is_sleeping(1));
+	EXPECT_EQ(data.m_sleep_timers[0], 0u);
+}
+
+TEST(SimulationIslands, DisablingSleepWakesAll)
+{
+	rigidbody_data_collection data = create_bodies(3);
+	size_t const indices[] = { 0, 2 };
+	data.sleep_island(indices, 2);
+
+	global_contact_data contacts;
+	physics_simulation_parameters parameters;
+	parameters.sleeping = false;
+	simulation_islands islands;
+	update_simulation_islands(contacts, parameters, data, islands);
+	for (size_t i = 0; i < data.size(); i++)
+		EXPECT_FALSE(data.is_sleeping(i));
+}
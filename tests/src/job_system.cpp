@@ -0,0 +1,62 @@
+#include <gtest/gtest.h>
+#include <Engine/Utils/job_system.h>
+
+#include <atomic>
+#include <vector>
+
+using namespace Engine::Utils;
+
+TEST(JobSystem, EveryItemExecutedOnce)
+{
+	job_system jobs(4);
+	EXPECT_EQ(jobs.thread_count(), 4u);
+
+	for (size_t count : { 0, 1, 7, 1000, 12345 })
+	{
+		std::vector<std::atomic<int>> executed(count);
+		jobs.parallel_for(count, 16, [&](size_t _begin, size_t _end, unsigned int _thread_index)
+		{
+			EXPECT_LT(_thread_index, jobs.thread_count());
+			for (size_t i = _begin; i < _end; i++)
+				executed[i]++;
+		});
+
+		for (size_t i = 0; i < count; i++)
+			EXPECT_EQ(executed[i].load(), 1);
+	}
+}
+
+TEST(JobSystem, NestedJobsRunSerially)
+{
+	job_system jobs(4);
+	std::atomic<size_t> total = 0;
+	jobs.parallel_for(64, 1, [&](size_t _begin, size_t _end, unsigned int _thread_index)
+	{
+		jobs.parallel_for(100, 10, [&](size_t _inner_begin, size_t _inner_end, unsigned int _inner_thread_index)
+		{
+			EXPECT_EQ(_inner_begin, 0u);
+			EXPECT_EQ(_inner_end, 100u);
+			total += _inner_end - _inner_begin;
+		});
+	});
+	EXPECT_EQ(total.load(), 6400u);
+}
+
+TEST(JobSystem, SetThreadCount)
+{
+	job_system jobs(1);
+	EXPECT_EQ(jobs.thread_count(), 1u);
+
+	jobs.set_thread_count(3);
+	EXPECT_EQ(jobs.thread_count(), 3u);
+
+	std::atomic<size_t> total = 0;
+	jobs.parallel_for(100, 1, [&](size_t _begin, size_t _end, unsigned int)
+	{
+		total += _end - _begin;
+	});
+	EXPECT_EQ(total.load(), 100u);
+
+	jobs.set_thread_count(0);
+	EXPECT_EQ(jobs.thread_count(), 1u);
+}
@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include <Engine/Physics/resolution.hpp>
+
+#include <set>
+
+using namespace Engine::Physics;
+using rigidbody_data_collection = Component::RigidBodyManager::rigidbody_data_collection;
+
+static rigidbody_data_collection create_bodies(size_t _count)
+{
+	rigidbody_data_collection data;
+	for (size_t i = 0; i < _count; i++)
+	{
+		Engine::ECS::Entity e;
+		e.m_id = (uint16_t)i;
+		e.m_counter = 0;
+		data.push_element(e, glm::vec3((float)i, 0.0f, 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), 1.0f, glm::mat3(1.0f));
+	}
+	return data;
+}
+
+static contact_manifold create_manifold(rigidbody_data_collection const& _data, size_t _body_A, size_t _body_B)
+{
+	contact_manifold cm;
+	cm.rigidbodies = { Component::RigidBody(_data.m_index_entities[_body_A]), Component::RigidBody(_data.m_index_entities[_body_B]) };
+	cm.pair_key = make_contact_pair_key(_data.m_index_entities[_body_A], _data.m_index_entities[_body_B]);
+	cm.data = { 0, 0, false };
+	return cm;
+}
+
+// Checks that colours partition manifolds, and that no dynamic body appears twice in a regular colour.
+static void expect_valid_colouring(size_t _manifold_count, contact_solver_context const& _context)
+{
+	ASSERT_EQ(_context.coloured_manifolds.size(), _manifold_count);
+	ASSERT_EQ(_context.colour_offsets.back(), _manifold_count);
+
+	std::set<uint32_t> visited(_context.coloured_manifolds.begin(), _context.coloured_manifolds.end());
+	EXPECT_EQ(visited.size(), _manifold_count);
+
+	size_t const regular_colours = _context.colour_count() - (_context.has_overflow_colour ? 1 : 0);
+	for (size_t colour = 0; colour < regular_colours; colour++)
+	{
+		std::set<uint32_t> colour_bodies;
+		for (uint32_t i = _context.colour_offsets[colour]; i < _context.colour_offsets[colour + 1]; i++)
+		{
+			solver_body_pair const bodies = _context.manifold_bodies[_context.coloured_manifolds[i]];
+			for (uint32_t body : { bodies.first, bodies.second })
+			{
+				if (_context.bodies.inv_masses[body] > 0.0f)
+					EXPECT_TRUE(colour_bodies.insert(body).second);
+			}
+		}
+	}
+}
+
+TEST(ManifoldColouring, ChainSharesNoDynamicBody)
+{
+	rigidbody_data_collection data = create_bodies(101);
+	data.m_inv_masses[0] = 0.0f;
+
+	// Every body rests on the ground and on the previous body.
+	std::vector<contact_manifold> manifolds;
+	for (size_t i = 1; i < data.size(); i++)
+	{
+		manifolds.push_back(create_manifold(data, 0, i));
+		if (i > 1)
+			manifolds.push_back(create_manifold(data, i - 1, i));
+	}
+
+	contact_solver_context context;
+	build_solver_bodies(manifolds.data(), manifolds.size(), data, context);
+	compute_manifold_colouring(context);
+	expect_valid_colouring(manifolds.size(), context);
+	EXPECT_FALSE(context.has_overflow_colour);
+	// Static ground does not constrain colouring, so a chain needs few colours.
+	EXPECT_LE(context.colour_count(), 3u);
+}
+
+TEST(ManifoldColouring, OverflowColourIsLast)
+{
+	size_t const manifold_count = contact_solver_context::MAX_COLOURS + 10;
+	rigidbody_data_collection data = create_bodies(manifold_count + 1);
+
+	// All manifolds share the first body, so each one needs its own colour.
+	std::vector<contact_manifold> manifolds;
+	for (size_t i = 1; i < data.size(); i++)
+		manifolds.push_back(create_manifold(data, 0, i));
+
+	contact_solver_context context;
+	build_solver_bodies(manifolds.data(), manifolds.size(), data, context);
+	compute_manifold_colouring(context);
+	expect_valid_colouring(manifolds.size(), context);
+	EXPECT_TRUE(context.has_overflow_colour);
+	EXPECT_EQ(context.colour_count(), contact_solver_context::MAX_COLOURS + 1);
+	EXPECT_EQ(context.colour_offsets.back() - context.colour_offsets[context.colour_count() - 1], 10u);
+}
+
+TEST(SolverBodies, ManifoldsReferenceDenseBodies)
+{
+	rigidbody_data_collection data = create_bodies(10);
+	data.m_linear_momentums[7] = glm::vec3(2.0f, 0.0f, 0.0f);
+
+	// Only bodies referenced by manifolds become solver bodies, in order of first reference.
+	std::vector<contact_manifold> manifolds = { create_manifold(data, 7, 3), create_manifold(data, 3, 5) };
+
+	contact_solver_context context;
+	build_solver_bodies(manifolds.data(), manifolds.size(), data, context);
+	ASSERT_EQ(context.bodies.size(), 3u);
+	EXPECT_EQ(context.manifold_bodies[0], solver_body_pair(0, 1));
+	EXPECT_EQ(context.manifold_bodies[1], solver_body_pair(1, 2));
+	EXPECT_EQ(context.bodies.rigidbody_indices[0], 7u);
+	EXPECT_EQ(context.bodies.linear_velocities[0], glm::vec3(2.0f, 0.0f, 0.0f));
+
+	context.bodies.linear_velocities[2] = glm::vec3(0.0f, 3.0f, 0.0f);
+	write_back_solver_bodies(context.bodies, data);
+	EXPECT_EQ(data.m_linear_momentums[5], glm::vec3(0.0f, 3.0f, 0.0f));
+	EXPECT_EQ(data.m_linear_momentums[7], glm::vec3(2.0f, 0.0f, 0.0f));
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <Engine/Physics/narrowphase.h>
+#include <Engine/Physics/convex_hull.h>
+#include <Engine/Utils/job_system.h>
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstring>
+#include <random>
+
+using namespace Engine::Physics;
+using namespace Engine::Math;
+
+static half_edge_data_structure create_unit_cube_hull()
+{
+	glm::vec3 const vertices[] = {
+		{ -0.5f, -0.5f, -0.5f }, { 0.5f, -0.5f, -0.5f }, { -0.5f, 0.5f, -0.5f }, { 0.5f, 0.5f, -0.5f },
+		{ -0.5f, -0.5f,  0.5f }, { 0.5f, -0.5f,  0.5f }, { -0.5f, 0.5f,  0.5f }, { 0.5f, 0.5f,  0.5f },
+	};
+	return construct_convex_hull(vertices, 8);
+}
+
+// Randomly rotated unit cubes packed densely enough to produce many intersections.
+static std::vector<narrowphase_body> create_random_bodies(half_edge_data_structure const& _hull, size_t _count, unsigned int _seed)
+{
+	float const side = std::cbrt(float(_count)) * 1.2f;
+	std::mt19937 rng(_seed);
+	std::uniform_real_distribution<float> position_dist(0.0f, side);
+	std::uniform_real_distribution<float> angle_dist(0.0f, 6.2831f);
+
+	std::vector<narrowphase_body> bodies(_count);
+	for (size_t i = 0; i < _count; i++)
+	{
+		narrowphase_body& body = bodies[i];
+		body.hull = &_hull;
+		body.world_transform.position = glm::vec3(position_dist(rng), position_dist(rng), position_dist(rng));
+		body.world_transform.rotation = glm::quat(glm::vec3(angle_dist(rng), angle_dist(rng), angle_dist(rng)));
+		body.bounding_volume.center = body.world_transform.position;
+		body.bounding_volume.extent = glm::vec3(0.8661f);
+		body.entity_id = (uint16_t)i;
+	}
+	return bodies;
+}
+
+static std::vector<broadphase_pair> create_all_pairs(size_t _count)
+{
+	std::vector<broadphase_pair> pairs;
+	for (uint32_t i = 0; i < (uint32_t)_count; i++)
+		for (uint32_t j = i + 1; j < (uint32_t)_count; j++)
+			pairs.emplace_back(i, j);
+	return pairs;
+}
+
+TEST(Narrowphase, ParallelMatchesSerial)
+{
+	half_edge_data_structure const hull = create_unit_cube_hull();
+	std::vector<narrowphase_body> const bodies = create_random_bodies(hull, 300, 1);
+	std::vector<broadphase_pair> const pairs = create_all_pairs(bodies.size());
+
+	narrowphase_context serial_context;
+	compute_narrowphase(bodies.data(), pairs.data(), pairs.size(), nullptr, serial_context);
+	narrowphase_output const& expected = serial_context.merged_output;
+	ASSERT_FALSE(expected.results.empty());
+
+	for (unsigned int thread_count : { 2u, 3u, 8u })
+	{
+		Engine::Utils::job_system jobs(thread_count);
+		narrowphase_context parallel_context;
+		compute_narrowphase(bodies.data(), pairs.data(), pairs.size(), &jobs, parallel_context);
+		narrowphase_output const& output = parallel_context.merged_output;
+
+		ASSERT_EQ(output.results.size(), expected.results.size());
+		ASSERT_EQ(output.contacts.size(), expected.contacts.size());
+		for (size_t i = 0; i < expected.results.size(); i++)
+		{
+			EXPECT_EQ(output.results[i].pair_index, expected.results[i].pair_index);
+			EXPECT_EQ(output.results[i].type, expected.results[i].type);
+			EXPECT_EQ(output.results[i].hull1_is_reference_face, expected.results[i].hull1_is_reference_face);
+			EXPECT_EQ(output.results[i].first_contact_index, expected.results[i].first_contact_index);
+			EXPECT_EQ(output.results[i].contact_count, expected.results[i].contact_count);
+		}
+
+		// Contacts must be bit-identical to single-threaded run.
+		for (size_t i = 0; i < expected.contacts.size(); i++)
+		{
+			contact const& c = output.contacts[i];
+			contact const& e = expected.contacts[i];
+			EXPECT_EQ(std::memcmp(&c.point, &e.point, sizeof(c.point)), 0);
+			EXPECT_EQ(std::memcmp(&c.normal, &e.normal, sizeof(c.normal)), 0);
+			EXPECT_EQ(std::memcmp(&c.penetration, &e.penetration, sizeof(c.penetration)), 0);
+			EXPECT_EQ(c.identifier, e.identifier);
+		}
+	}
+}
@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+#include <Engine/Physics/rigidbody_snapshot.hpp>
+
+using namespace Engine::Physics;
+using rigidbody_data_collection = Component::RigidBodyManager::rigidbody_data_collection;
+
+static rigidbody_data_collection create_bodies(size_t _count)
+{
+	rigidbody_data_collection data;
+	for (size_t i = 0; i < _count; i++)
+	{
+		Engine::ECS::Entity e;
+		e.m_id = (uint16_t)i;
+		e.m_counter = 0;
+		data.push_element(e, glm::vec3((float)i, 0.0f, 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), 1.0f, glm::mat3(1.0f));
+	}
+	return data;
+}
+
+// Only moves every other body, such that delta frames skip the resting bodies.
+static void step_bodies(rigidbody_data_collection& _data, int _frame)
+{
+	for (size_t i = 0; i < _data.size(); i += 2)
+	{
+		_data.m_positions[i].y += 0.1f * (float)_frame;
+		_data.m_linear_momentums[i].y = (float)_frame;
+		_data.m_angular_momentums[i].x = 0.5f * (float)_frame;
+		_data.m_rotations[i] = glm::normalize(_data.m_rotations[i] * glm::quat(0.99f, 0.01f * (float)i, 0.0f, 0.0f));
+	}
+}
+
+static void test_record_restore(bool _delta_encoding)
+{
+	rigidbody_data_collection data = create_bodies(50);
+
+	rigidbody_snapshot_ring ring(30);
+	ring.m_delta_encoding = _delta_encoding;
+	ring.m_keyframe_interval = 8;
+
+	std::vector<std::vector<glm::vec3>> recorded_positions;
+	std::vector<std::vector<glm::quat>> recorded_rotations;
+	for (int frame = 0; frame < 75; frame++)
+	{
+		ring.record(data);
+		recorded_positions.push_back(data.m_positions);
+		recorded_rotations.push_back(data.m_rotations);
+		step_bodies(data, frame);
+	}
+
+	// Oldest frames are evicted, together with delta frames that depend on them.
+	ASSERT_LE(ring.frame_count(), ring.capacity());
+	ASSERT_GT(ring.frame_count(), ring.capacity() - ring.m_keyframe_interval);
+
+	size_t const first_recorded = recorded_positions.size() - ring.frame_count();
+	for (size_t frame = 0; frame < ring.frame_count(); frame++)
+	{
+		ASSERT_TRUE(ring.restore(frame, data));
+		EXPECT_EQ(data.m_positions, recorded_positions[first_recorded + frame]);
+		EXPECT_EQ(data.m_rotations, recorded_rotations[first_recorded + frame]);
+	}
+	EXPECT_FALSE(ring.restore(ring.frame_count(), data));
+}
+
+TEST(RigidBodySnapshot, RecordRestoreFull)
+{
+	test_record_restore(false);
+}
+
+TEST(RigidBodySnapshot, RecordRestoreDelta)
+{
+	test_record_restore(true);
+}
+
+TEST(RigidBodySnapshot, DeltaEncodingUsesLessMemory)
+{
+	rigidbody_data_collection data_full = create_bodies(100);
+	rigidbody_data_collection data_delta = create_bodies(100);
+
+	rigidbody_snapshot_ring ring_full(64), ring_delta(64);
+	ring_full.m_delta_encoding = false;
+	ring_delta.m_delta_encoding = true;
+	for (int frame = 0; frame < 64; frame++)
+	{
+		ring_full.record(data_full);
+		ring_delta.record(data_delta);
+		step_bodies(data_full, frame);
+		step_bodies(data_delta, frame);
+	}
+	EXPECT_EQ(ring_full.frame_count(), ring_delta.frame_count());
+	EXPECT_LT(ring_delta.memory_usage(), ring_full.memory_usage());
+}
+
+TEST(RigidBodySnapshot, TruncateAndContinue)
+{
+	rigidbody_data_collection data = create_bodies(20);
+
+	rigidbody_snapshot_ring ring(100);
+	std::vector<std::vector<glm::vec3>> recorded_positions;
+	for (int frame = 0; frame < 10; frame++)
+	{
+		ring.record(data);
+		recorded_positions.push_back(data.m_positions);
+		step_bodies(data, frame);
+	}
+
+	// Scrub back and continue simulation from there, as the editor does.
+	ASSERT_TRUE(ring.restore(4, data));
+	ring.truncate(5);
+	recorded_positions.resize(5);
+	EXPECT_EQ(ring.frame_count(), 5u);
+
+	for (int frame = 0; frame < 10; frame++)
+	{
+		step_bodies(data, frame + 100);
+		ring.record(data);
+		recorded_positions.push_back(data.m_positions);
+	}
+
+	for (size_t frame = 0; frame < ring.frame_count(); frame++)
+	{
+		ASSERT_TRUE(ring.restore(frame, data));
+		EXPECT_EQ(data.m_positions, recorded_positions[frame]);
+	}
+}
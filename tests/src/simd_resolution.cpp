@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <Engine/Physics/resolution.hpp>
+#include <Engine/Utils/singleton.h>
+
+#include <glm/gtc/quaternion.hpp>
+
+using namespace Engine::Physics;
+using rigidbody_data_collection = Component::RigidBodyManager::rigidbody_data_collection;
+
+/*
+* Bodies on a line, each colliding with the next one, and optionally all of them colliding with a
+* single hub body. Manifolds have 1 to 4 contacts, so batches have ragged lanes.
+*/
+struct resolution_scene
+{
+	global_contact_data contact_data;
+
+	resolution_scene(size_t _body_count, bool _with_hub)
+	{
+		rigidbody_data_collection& rigidbodies = Singleton<Component::RigidBodyManager>().m_rigidbodies_data;
+		rigidbodies = rigidbody_data_collection();
+
+		// Static ground as first body.
+		push_body(rigidbodies, glm::vec3(0.0f, -1.0f, 0.0f), 0.0f);
+		for (size_t i = 1; i < _body_count; i++)
+			push_body(rigidbodies, glm::vec3((float)i * 0.9f, 0.3f * (float)(i % 3), 0.0f), 0.5f + 0.1f * (float)(i % 5));
+		size_t const hub = _with_hub ? push_body(rigidbodies, glm::vec3(0.0f, 5.0f, 0.0f), 2.0f) : 0;
+
+		for (size_t i = 1; i < _body_count; i++)
+		{
+			add_manifold(rigidbodies, 0, i, 1 + i % 4);
+			if (i + 1 < _body_count)
+				add_manifold(rigidbodies, i, i + 1, 1 + (i + 2) % 4);
+			if (_with_hub)
+				add_manifold(rigidbodies, hub, i, 1 + (i + 1) % 4);
+		}
+		reset_velocities();
+	}
+
+	static size_t push_body(rigidbody_data_collection& _rigidbodies, glm::vec3 _position, float _inv_mass)
+	{
+		Engine::ECS::Entity e;
+		e.m_id = (uint16_t)_rigidbodies.size();
+		e.m_counter = 0;
+		glm::quat const rotation = glm::angleAxis(0.3f * (float)_rigidbodies.size(), glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f)));
+		glm::mat3 const inv_tensor = glm::mat3(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.5f, 0.0f), glm::vec3(0.0f, 0.0f, 2.0f)) * _inv_mass;
+		size_t const index = _rigidbodies.push_element(e, _position, rotation, _inv_mass, glm::mat3(1.0f));
+		_rigidbodies.m_inv_inertial_tensors[index] = inv_tensor;
+		_rigidbodies.update_inv_world_tensor(index);
+		_rigidbodies.m_restitution[index] = 0.1f;
+		_rigidbodies.m_friction_coefficient[index] = 0.6f;
+		return index;
+	}
+
+	void add_manifold(rigidbody_data_collection const& _rigidbodies, size_t _body_A, size_t _body_B, size_t _contact_count)
+	{
+		Engine::ECS::Entity const entity_A = _rigidbodies.m_index_entities[_body_A];
+		Engine::ECS::Entity const entity_B = _rigidbodies.m_index_entities[_body_B];
+		glm::vec3 const position_A = _rigidbodies.m_positions[_body_A];
+		glm::vec3 const position_B = _rigidbodies.m_positions[_body_B];
+
+		contact_manifold& cm = contact_data.all_contact_manifolds.emplace_back();
+		cm.rigidbodies = { Component::RigidBody(entity_A), Component::RigidBody(entity_B) };
+		cm.pair_key = make_contact_pair_key(entity_A, entity_B);
+		cm.data.first_contact_index = (uint32_t)contact_data.all_contacts.size();
+		cm.data.contact_count = (uint16_t)_contact_count;
+		cm.data.is_edge_edge = false;
+
+		for (uint16_t i = 0; i < _contact_count; i++)
+		{
+			contact& c = contact_data.all_contacts.emplace_back();
+			c.point = 0.5f * (position_A + position_B) + glm::vec3(0.1f * i, -0.2f * i, 0.3f * (i % 2));
+			c.penetration = 0.01f + 0.005f * i;
+			c.normal = glm::normalize(position_B - position_A);
+			c.identifier = { entity_A.ID(), entity_B.ID(), i, i };
+		}
+	}
+
+	static void reset_velocities()
+	{
+		rigidbody_data_collection& rigidbodies = Singleton<Component::RigidBodyManager>().m_rigidbodies_data;
+		for (size_t i = 0; i < rigidbodies.size(); i++)
+		{
+			float const phase = (float)i;
+			rigidbodies.m_linear_momentums[i] = glm::vec3(std::sin(phase), -1.0f - 0.1f * std::cos(phase), 0.2f);
+			rigidbodies.m_angular_momentums[i] = glm::vec3(0.1f * std::cos(phase), 0.2f, -0.1f * std::sin(phase));
+		}
+	}
+
+	/*
+	* @brief	Solve two steps from the same initial velocities, the second one warm started from the first.
+	* @return	Accumulated lambdas of second step.
+	*/
+	std::vector<contact_lambdas> solve(bool _simd)
+	{
+		physics_simulation_parameters parameters;
+		parameters.parallel_resolution = true;
+		parameters.simd_resolution = _simd;
+		contact_solver_context context;
+
+		contact_data.cache = {};
+		for (int step = 0; step < 2; step++)
+		{
+			reset_velocities();
+			compute_resolution_gauss_seidel(contact_data, parameters, nullptr, &context);
+		}
+		return contact_data.cache.lambdas;
+	}
+};
+
+static void expect_lambdas_near(std::vector<contact_lambdas> const& _expected, std::vector<contact_lambdas> const& _actual)
+{
+	ASSERT_EQ(_expected.size(), _actual.size());
+	for (size_t i = 0; i < _expected.size(); i++)
+	{
+		float const tolerance = 1e-4f + 1e-3f * std::abs(_expected[i].lambda_penetration);
+		EXPECT_NEAR(_expected[i].lambda_penetration, _actual[i].lambda_penetration, tolerance) << "contact " << i;
+		EXPECT_NEAR(_expected[i].lambda_friction_u, _actual[i].lambda_friction_u, tolerance) << "contact " << i;
+		EXPECT_NEAR(_expected[i].lambda_friction_v, _actual[i].lambda_friction_v, tolerance) << "contact " << i;
+	}
+}
+
+TEST(SIMDResolution, LambdasMatchScalar)
+{
+	resolution_scene scene(100, false);
+	std::vector<contact_lambdas> const scalar_lambdas = scene.solve(false);
+	std::vector<contact_lambdas> const simd_lambdas = scene.solve(true);
+
+	float lambda_sum = 0.0f;
+	for (contact_lambdas const& cfl : scalar_lambdas)
+		lambda_sum += cfl.lambda_penetration;
+	EXPECT_GT(lambda_sum, 0.0f);
+	expect_lambdas_near(scalar_lambdas, simd_lambdas);
+}
+
+TEST(SIMDResolution, OverflowColourMatchesScalar)
+{
+	// Every body collides with the hub, which requires more colours than fit in a mask.
+	resolution_scene scene(contact_solver_context::MAX_COLOURS + 20, true);
+	std::vector<contact_lambdas> const scalar_lambdas = scene.solve(false);
+	std::vector<contact_lambdas> const simd_lambdas = scene.solve(true);
+	expect_lambdas_near(scalar_lambdas, simd_lambdas);
+}
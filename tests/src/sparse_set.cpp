@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <Engine/ECS/sparse_set.h>
+
+#include <string>
+#include <unordered_map>
+
+using namespace Engine::ECS;
+
+static Entity make_entity(uint16_t _id, uint16_t _counter = 0)
+{
+	Entity e;
+	e.m_id = _id;
+	e.m_counter = _counter;
+	return e;
+}
+
+TEST(SparseSet, InsertFindErase)
+{
+	sparse_set<std::string> set;
+	Entity const a = make_entity(5), b = make_entity(2, 1), c = make_entity(900);
+
+	EXPECT_TRUE(set.emplace(a, "a").second);
+	EXPECT_FALSE(set.emplace(a, "other").second);
+	set[b] = "b";
+	set.emplace(c, "c");
+	ASSERT_EQ(set.size(), 3u);
+	EXPECT_EQ(set.at(a), "a");
+
+	// Erasing moves back entry into the hole, other entries stay reachable.
+	EXPECT_EQ(set.erase(a), 1u);
+	EXPECT_EQ(set.erase(a), 0u);
+	EXPECT_FALSE(set.contains(a));
+	EXPECT_EQ(set.find(a), set.end());
+	EXPECT_EQ(set.at(b), "b");
+	EXPECT_EQ(set.at(c), "c");
+	EXPECT_THROW(set.at(a), std::out_of_range);
+
+	// Dense entries are contiguous.
+	size_t visited = 0;
+	for (auto const& [entity, value] : set)
+	{
+		EXPECT_EQ(set.index_of(entity), visited);
+		visited++;
+	}
+	EXPECT_EQ(visited, set.size());
+}
+
+TEST(SparseSet, StaleHandleIsNotFound)
+{
+	sparse_set<int> set;
+	set.emplace(make_entity(7, 1), 1);
+	EXPECT_FALSE(set.contains(make_entity(7, 0)));
+	EXPECT_FALSE(set.contains(make_entity(7, 2)));
+	EXPECT_EQ(set.erase(make_entity(7, 0)), 0u);
+
+	// Reuse of ID after erase.
+	set.erase(make_entity(7, 1));
+	set.emplace(make_entity(7, 2), 2);
+	EXPECT_EQ(set.at(make_entity(7, 2)), 2);
+	EXPECT_FALSE(set.contains(make_entity(7, 1)));
+}
+
+TEST(SparseSet, SerializedLikeUnorderedMap)
+{
+	Entity const a = make_entity(3, 1), b = make_entity(40);
+
+	// Scenes saved with std::unordered_map component storage have to remain loadable.
+	std::unordered_map<Entity, int, Entity::hash> map{ { a, 10 }, { b, 20 } };
+	nlohmann::json const j_map = map;
+	auto const set = j_map.get<sparse_set<int>>();
+	ASSERT_EQ(set.size(), 2u);
+	EXPECT_EQ(set.at(a), 10);
+	EXPECT_EQ(set.at(b), 20);
+
+	nlohmann::json const j_set = set;
+	auto const round_trip = j_set.get<std::unordered_map<Entity, int, Entity::hash>>();
+	EXPECT_EQ(round_trip, map);
+}
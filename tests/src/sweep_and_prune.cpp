@@ -0,0 +1,224 @@
+#include <gtest/gtest.h>
+#include <Engine/Physics/sweep_and_prune.h>
+#include <Engine/Physics/contact.h>
+#include <Engine/Math/geometry_intersection.hpp>
+
+#include <algorithm>
+#include <random>
+
+using namespace Engine::Physics;
+using namespace Engine::Math;
+
+static std::vector<aabb> create_random_bounds(size_t _count, float _side, unsigned int _seed)
+{
+	std::mt19937 rng(_seed);
+	std::uniform_real_distribution<float> position_dist(0.0f, _side);
+	std::uniform_real_distribution<float> extent_dist(0.1f, 1.0f);
+
+	std::vector<aabb> bounds(_count);
+	for (auto& b : bounds)
+	{
+		b.center = glm::vec3(position_dist(rng), position_dist(rng), position_dist(rng));
+		b.extent = glm::vec3(extent_dist(rng), extent_dist(rng), extent_dist(rng));
+	}
+	return bounds;
+}
+
+static std::vector<broadphase_pair> compute_brute_force_pairs(std::vector<aabb> const& _bounds)
+{
+	std::vector<broadphase_pair> pairs;
+	for (uint32_t i = 0; i < (uint32_t)_bounds.size(); i++)
+	{
+		for (uint32_t j = i + 1; j < (uint32_t)_bounds.size(); j++)
+		{
+			if (intersect_aabb_aabb(_bounds[i], _bounds[j]))
+				pairs.emplace_back(i, j);
+		}
+	}
+	return pairs;
+}
+
+// Bounds are not fattened, so pairs must match brute force exactly.
+static void test_sap_pairs(sweep_and_prune const& _sap, std::vector<aabb> const& _bounds)
+{
+	std::vector<broadphase_pair> pairs;
+	_sap.compute_pairs(pairs);
+	EXPECT_EQ(_sap.pair_count(), pairs.size());
+	EXPECT_EQ(pairs, compute_brute_force_pairs(_bounds));
+}
+
+TEST(SweepAndPrune, PairsMatchBruteForce)
+{
+	std::vector<aabb> bounds = create_random_bounds(500, 20.0f, 1);
+
+	sweep_and_prune sap;
+	for (uint32_t i = 0; i < (uint32_t)bounds.size(); i++)
+		sap.create_proxy(bounds[i], i);
+	sap.update();
+
+	EXPECT_EQ(sap.proxy_count(), bounds.size());
+	EXPECT_EQ(sap.m_added_pairs.size(), sap.pair_count());
+	test_sap_pairs(sap, bounds);
+}
+
+TEST(SweepAndPrune, MoveProxies)
+{
+	std::vector<aabb> bounds = create_random_bounds(500, 20.0f, 2);
+
+	sweep_and_prune sap;
+	std::vector<sweep_and_prune::proxy_id> proxies;
+	for (uint32_t i = 0; i < (uint32_t)bounds.size(); i++)
+		proxies.push_back(sap.create_proxy(bounds[i], i));
+	sap.update();
+
+	std::mt19937 rng(3);
+	std::uniform_real_distribution<float> offset_dist(-0.5f, 0.5f);
+	for (int frame = 0; frame < 10; frame++)
+	{
+		std::vector<broadphase_pair> previous_pairs;
+		sap.compute_pairs(previous_pairs);
+		sap.clear_events();
+
+		for (size_t i = 0; i < bounds.size(); i++)
+		{
+			bounds[i].center += glm::vec3(offset_dist(rng), offset_dist(rng), offset_dist(rng));
+			sap.update_proxy(proxies[i], bounds[i]);
+		}
+		sap.update();
+		test_sap_pairs(sap, bounds);
+
+		// Applying events to previous pairs must result in current pairs.
+		std::vector<broadphase_pair> current_pairs;
+		sap.compute_pairs(current_pairs);
+		for (broadphase_pair const& pair : sap.m_removed_pairs)
+			previous_pairs.erase(std::find(previous_pairs.begin(), previous_pairs.end(), pair));
+		previous_pairs.insert(previous_pairs.end(), sap.m_added_pairs.begin(), sap.m_added_pairs.end());
+		std::sort(previous_pairs.begin(), previous_pairs.end());
+		EXPECT_EQ(previous_pairs, current_pairs);
+	}
+}
+
+TEST(SweepAndPrune, PairEvents)
+{
+	aabb bounds_a, bounds_b;
+	bounds_a.center = glm::vec3(0.0f);
+	bounds_a.extent = glm::vec3(1.0f);
+	bounds_b.center = glm::vec3(3.0f, 0.0f, 0.0f);
+	bounds_b.extent = glm::vec3(1.0f);
+
+	sweep_and_prune sap;
+	auto proxy_a = sap.create_proxy(bounds_a, 0);
+	sap.create_proxy(bounds_b, 1);
+	sap.update();
+	EXPECT_TRUE(sap.m_added_pairs.empty());
+
+	sap.clear_events();
+	bounds_a.center.x = 1.5f;
+	sap.update_proxy(proxy_a, bounds_a);
+	sap.update();
+	ASSERT_EQ(sap.m_added_pairs.size(), 1);
+	EXPECT_EQ(sap.m_added_pairs[0], broadphase_pair(0, 1));
+	EXPECT_TRUE(sap.m_removed_pairs.empty());
+
+	// Moving without leaving overlap should not generate events.
+	sap.clear_events();
+	bounds_a.center.x = 1.6f;
+	sap.update_proxy(proxy_a, bounds_a);
+	sap.update();
+	EXPECT_TRUE(sap.m_added_pairs.empty());
+	EXPECT_TRUE(sap.m_removed_pairs.empty());
+
+	sap.clear_events();
+	bounds_a.center.x = -5.0f;
+	sap.update_proxy(proxy_a, bounds_a);
+	sap.update();
+	EXPECT_TRUE(sap.m_added_pairs.empty());
+	ASSERT_EQ(sap.m_removed_pairs.size(), 1);
+	EXPECT_EQ(sap.m_removed_pairs[0], broadphase_pair(0, 1));
+	EXPECT_EQ(sap.pair_count(), 0);
+}
+
+TEST(SweepAndPrune, DestroyProxies)
+{
+	std::vector<aabb> bounds = create_random_bounds(300, 15.0f, 4);
+
+	sweep_and_prune sap;
+	std::vector<sweep_and_prune::proxy_id> proxies;
+	for (uint32_t i = 0; i < (uint32_t)bounds.size(); i++)
+		proxies.push_back(sap.create_proxy(bounds[i], i));
+	sap.update();
+
+	// Destroy every other proxy, and move remaining bounds to front of array,
+	// updating user data to match new indices.
+	sap.clear_events();
+	size_t const pair_count = sap.pair_count();
+	std::vector<aabb> remaining_bounds;
+	for (size_t i = 0; i < bounds.size(); i++)
+	{
+		if (i % 2 == 0)
+			sap.destroy_proxy(proxies[i]);
+		else
+		{
+			sap.set_user_data(proxies[i], (uint32_t)remaining_bounds.size());
+			remaining_bounds.push_back(bounds[i]);
+		}
+	}
+	sap.update();
+
+	EXPECT_EQ(sap.proxy_count(), remaining_bounds.size());
+	EXPECT_EQ(sap.pair_count() + sap.m_removed_pairs.size(), pair_count);
+	test_sap_pairs(sap, remaining_bounds);
+}
+
+TEST(SweepAndPrune, PairEventsCreateAndEvictContactCacheEntries)
+{
+	std::vector<aabb> bounds = create_random_bounds(200, 12.0f, 5);
+
+	sweep_and_prune sap;
+	std::vector<sweep_and_prune::proxy_id> proxies;
+	for (uint32_t i = 0; i < (uint32_t)bounds.size(); i++)
+		proxies.push_back(sap.create_proxy(bounds[i], i));
+
+	// Bodies are identified by their index in the tests, the engine uses entities.
+	contact_cache cache;
+	std::vector<contact_pair_key> event_keys;
+	auto apply_events = [&]()
+	{
+		event_keys.clear();
+		for (broadphase_pair const& pair : sap.m_removed_pairs)
+			event_keys.push_back(((uint64_t)pair.first << 32) | pair.second);
+		cache.evict_pairs(event_keys);
+		event_keys.clear();
+		for (broadphase_pair const& pair : sap.m_added_pairs)
+			event_keys.push_back(((uint64_t)pair.first << 32) | pair.second);
+		cache.add_pairs(event_keys);
+		sap.clear_events();
+	};
+
+	std::mt19937 rng(6);
+	std::uniform_real_distribution<float> offset_dist(-0.5f, 0.5f);
+	std::vector<broadphase_pair> pairs;
+	for (int step = 0; step < 20; step++)
+	{
+		sap.update();
+		apply_events();
+
+		// Cache has exactly one entry per overlapping pair, in key order.
+		sap.compute_pairs(pairs);
+		ASSERT_EQ(cache.manifolds.size(), pairs.size());
+		for (size_t i = 0; i < pairs.size(); i++)
+			EXPECT_EQ(cache.manifolds[i].first, ((uint64_t)pairs[i].first << 32) | pairs[i].second);
+
+		for (size_t i = 0; i < bounds.size(); i++)
+		{
+			bounds[i].center += glm::vec3(offset_dist(rng), offset_dist(rng), offset_dist(rng));
+			sap.update_proxy(proxies[i], bounds[i]);
+		}
+	}
+
+	// Entries of destroyed proxies are evicted.
+	sap.destroy_proxy(proxies[0]);
+	apply_events();
+	for (auto const& entry : cache.manifolds)
+		EXPECT_NE(entry.first >> 32, 0u);
+}
@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+#include <Engine/Components/Transform.h>
+#include <Engine/Utils/singleton.h>
+
+#include <glm/gtc/quaternion.hpp>
+
+using Component::Transform;
+using Component::TransformManager;
+using Engine::ECS::Entity;
+using Engine::Math::transform3D;
+
+static Entity create_transform_entity(uint16_t _id)
+{
+	Entity e;
+	e.m_id = _id;
+	e.m_counter = 0;
+	Transform transform = Singleton<TransformManager>().Create(e);
+
+	float const phase = (float)_id;
+	transform3D local;
+	local.position = glm::vec3(std::sin(phase), 0.5f * phase, std::cos(phase));
+	local.scale = glm::vec3(1.0f + 0.01f * phase);
+	local.rotation = glm::angleAxis(0.2f * phase, glm::normalize(glm::vec3(1.0f, 2.0f, 3.0f)));
+	transform.SetLocalTransform(local);
+	return e;
+}
+
+// Reference world transform, concatenated from local transforms up the hierarchy.
+static transform3D compute_reference_world_transform(Entity _e)
+{
+	Transform const transform = Singleton<TransformManager>().Get(_e);
+	transform3D world = transform.GetLocalTransform();
+	for (Entity parent = transform.GetParent(); parent != Entity::InvalidEntity; parent = Singleton<TransformManager>().Get(parent).GetParent())
+		world = Singleton<TransformManager>().Get(parent).GetLocalTransform() * world;
+	return world;
+}
+
+static void expect_world_transforms_near_reference(std::vector<Entity> const& _entities)
+{
+	for (Entity const e : _entities)
+	{
+		transform3D const expected = compute_reference_world_transform(e);
+		Transform const transform = Singleton<TransformManager>().Get(e);
+		transform3D const actual = transform.ComputeWorldTransform();
+		glm::mat4x4 const actual_matrix = transform.ComputeWorldMatrix();
+		glm::mat4x4 const expected_matrix = expected.GetMatrix();
+		for (int axis = 0; axis < 3; axis++)
+		{
+			EXPECT_NEAR(expected.position[axis], actual.position[axis], 1e-4f) << "entity " << e.ID();
+			EXPECT_NEAR(expected.scale[axis], actual.scale[axis], 1e-4f) << "entity " << e.ID();
+		}
+		for (int c = 0; c < 4; c++)
+			for (int r = 0; r < 4; r++)
+				EXPECT_NEAR(expected_matrix[c][r], actual_matrix[c][r], 1e-4f) << "entity " << e.ID();
+	}
+}
+
+/*
+* Three hierarchies, created such that children are created before some of their parents:
+*  0 -> 1 -> 2 -> 3,  0 -> 4,  5 -> 6 -> 7,  8 -> 9
+*/
+static std::vector<Entity> create_hierarchies()
+{
+	Singleton<TransformManager>().Clear();
+	std::vector<Entity> entities;
+	for (uint16_t i = 0; i < 10; i++)
+		entities.push_back(create_transform_entity(i));
+
+	auto attach = [&](size_t _child, size_t _parent) { Singleton<TransformManager>().Get(entities[_child]).SetParent(entities[_parent], false); };
+	attach(3, 2);
+	attach(2, 1);
+	attach(1, 0);
+	attach(4, 0);
+	attach(7, 6);
+	attach(6, 5);
+	attach(9, 8);
+	return entities;
+}
+
+TEST(Transform, WorldMatricesMatchHierarchy)
+{
+	std::vector<Entity> const entities = create_hierarchies();
+
+	// Before an update, world transforms are computed from scratch.
+	expect_world_transforms_near_reference(entities);
+
+	Singleton<TransformManager>().UpdateWorldMatrices();
+	expect_world_transforms_near_reference(entities);
+
+	EXPECT_EQ(Singleton<TransformManager>().GetRootEntities().size(), 3u);
+}
+
+TEST(Transform, DirtySubtreeIsPropagated)
+{
+	std::vector<Entity> const entities = create_hierarchies();
+	auto& transform_manager = Singleton<TransformManager>();
+	transform_manager.UpdateWorldMatrices();
+
+	glm::mat4x4 const untouched_matrix = transform_manager.Get(entities[6]).ComputeWorldMatrix();
+
+	// Moving an inner node moves its whole subtree.
+	transform_manager.Get(entities[1]).SetLocalPosition(glm::vec3(10.0f, -3.0f, 2.0f));
+	expect_world_transforms_near_reference(entities);
+	transform_manager.UpdateWorldMatrices();
+	expect_world_transforms_near_reference(entities);
+
+	EXPECT_EQ(untouched_matrix, transform_manager.Get(entities[6]).ComputeWorldMatrix());
+}
+
+TEST(Transform, HierarchyChangesKeepWorldMatricesValid)
+{
+	std::vector<Entity> entities = create_hierarchies();
+	auto& transform_manager = Singleton<TransformManager>();
+	transform_manager.UpdateWorldMatrices();
+
+	// Attach a root that precedes its new parent in the matrix order.
+	transform_manager.Get(entities[5]).SetParent(entities[9]);
+	transform_manager.UpdateWorldMatrices();
+	expect_world_transforms_near_reference(entities);
+
+	// Destroy inner node, which detaches its children.
+	transform_manager.Destroy(&entities[1], 1);
+	entities.erase(entities.begin() + 1);
+	transform_manager.Get(entities[1]).SetLocalRotation(glm::angleAxis(1.0f, glm::vec3(0.0f, 1.0f, 0.0f)));
+	transform_manager.UpdateWorldMatrices();
+	expect_world_transforms_near_reference(entities);
+
+	// Children of a destroyed node become roots.
+	EXPECT_EQ(transform_manager.Get(entities[1]).GetParent(), Entity::InvalidEntity);
+}
+
+TEST(Transform, BatchedDestroyMaintainsWorldTransforms)
+{
+	std::vector<Entity> const entities = create_hierarchies();
+	auto& transform_manager = Singleton<TransformManager>();
+	transform_manager.UpdateWorldMatrices();
+
+	std::vector<transform3D> world_transforms;
+	for (Entity const e : entities)
+		world_transforms.push_back(transform_manager.Get(e).ComputeWorldTransform());
+
+	// Inner node, root with a child chain and root with a single child, plus a duplicate and an entity without transform.
+	Entity without_transform;
+	without_transform.m_id = 100;
+	without_transform.m_counter = 0;
+	Entity const destroyed[] = { entities[1], entities[5], entities[8], entities[1], without_transform };
+	transform_manager.Destroy(destroyed, 5);
+
+	std::vector<Entity> survivors;
+	for (size_t i = 0; i < entities.size(); i++)
+	{
+		if (i == 1 || i == 5 || i == 8)
+		{
+			EXPECT_FALSE(transform_manager.ComponentOwnedByEntity(entities[i]));
+			continue;
+		}
+		survivors.push_back(entities[i]);
+		transform3D const actual = transform_manager.Get(entities[i]).ComputeWorldTransform();
+		for (int axis = 0; axis < 3; axis++)
+			EXPECT_NEAR(world_transforms[i].position[axis], actual.position[axis], 1e-4f) << "entity " << i;
+	}
+
+	EXPECT_EQ(transform_manager.GetRootEntities().size(), 4u);
+	EXPECT_EQ(transform_manager.Get(entities[2]).GetParent(), Entity::InvalidEntity);
+	EXPECT_EQ(transform_manager.Get(entities[3]).GetParent(), entities[2]);
+	EXPECT_EQ(transform_manager.Get(entities[0]).GetChildren(), std::vector<Entity>{ entities[4] });
+
+	transform_manager.UpdateWorldMatrices();
+	expect_world_transforms_near_reference(survivors);
+}
+
+TEST(Transform, ParallelUpdateMatchesSerialUpdate)
+{
+	auto& transform_manager = Singleton<TransformManager>();
+	transform_manager.Clear();
+
+	// Enough hierarchies of uneven size to be split into several update ranges.
+	std::vector<Entity> entities;
+	uint16_t id = 0;
+	for (unsigned int h = 0; h < 60; h++)
+	{
+		size_t const root_index = entities.size();
+		unsigned int const hierarchy_size = 20 + (h * 37) % 130;
+		for (unsigned int n = 0; n < hierarchy_size; n++)
+		{
+			entities.push_back(create_transform_entity(id++));
+			transform_manager.Get(entities.back()).SetLocalScale(glm::vec3(1.0f));
+			if (n != 0)
+				transform_manager.Get(entities.back()).SetParent(entities[root_index + (n * 13 + 5) % n], false);
+		}
+	}
+	ASSERT_GE(entities.size(), 4096u);
+
+	transform_manager.SetParallelUpdate(false);
+	transform_manager.UpdateWorldMatrices();
+	std::vector<glm::mat4x4> serial_matrices;
+	for (Entity const e : entities)
+		serial_matrices.push_back(transform_manager.Get(e).ComputeWorldMatrix());
+
+	// Dirty every root, so the parallel update recomputes all matrices with the same operations.
+	for (Entity const root : transform_manager.GetRootEntities())
+		transform_manager.Get(root).SetLocalTransform(transform_manager.Get(root).GetLocalTransform());
+
+	transform_manager.SetParallelUpdate(true);
+	transform_manager.UpdateWorldMatrices();
+	for (size_t i = 0; i < entities.size(); i++)
+		EXPECT_EQ(serial_matrices[i], transform_manager.Get(entities[i]).ComputeWorldMatrix()) << "entity " << entities[i].ID();
+}
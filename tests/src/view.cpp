@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+#include <Engine/ECS/view.h>
+#include <Engine/Components/Transform.h>
+#include <Engine/Components/Renderable.h>
+
+#include <algorithm>
+
+using Component::Renderable;
+using Component::RenderableManager;
+using Component::Transform;
+using Component::TransformManager;
+using Engine::ECS::Entity;
+
+// Every entity has a transform, every third entity also has a renderable.
+static std::vector<Entity> create_view_entities(uint16_t _count)
+{
+	Singleton<RenderableManager>().Clear();
+	Singleton<TransformManager>().Clear();
+
+	std::vector<Entity> renderable_entities;
+	for (uint16_t i = 0; i < _count; i++)
+	{
+		Entity e;
+		e.m_id = i;
+		e.m_counter = 0;
+		Singleton<TransformManager>().Create(e);
+		if (i % 3 == 0)
+		{
+			EXPECT_TRUE(Singleton<RenderableManager>().Create(e).IsValid());
+			renderable_entities.push_back(e);
+		}
+	}
+	return renderable_entities;
+}
+
+static std::vector<Entity> sorted(std::vector<Entity> _entities)
+{
+	std::sort(_entities.begin(), _entities.end());
+	return _entities;
+}
+
+TEST(View, VisitsEntitiesOwningAllComponents)
+{
+	std::vector<Entity> const expected = create_view_entities(100);
+
+	Engine::ECS::View<Transform, Renderable> const view;
+	EXPECT_EQ(view.size_hint(), expected.size());
+
+	std::vector<Entity> visited;
+	view.each([&](Entity _e, auto& _transform_data, Engine::Managers::Resource& _mesh)
+	{
+		visited.push_back(_e);
+		// Data is handed out by reference, straight from manager storage.
+		EXPECT_EQ(&_transform_data, &Singleton<TransformManager>().GetComponentStorage().at(_e));
+		EXPECT_EQ(&_mesh, &Singleton<RenderableManager>().GetComponentStorage().at(_e));
+	});
+	EXPECT_EQ(sorted(visited), sorted(expected));
+}
+
+TEST(View, CachedViewFollowsStorageChanges)
+{
+	std::vector<Entity> expected = create_view_entities(30);
+
+	Engine::ECS::CachedView<Transform, Renderable> view;
+	EXPECT_EQ(sorted(view.entities()), sorted(expected));
+
+	// Destroying a component moves entries around in storage, so cache has to be rebuilt.
+	Singleton<RenderableManager>().Destroy(&expected.front(), 1);
+	expected.erase(expected.begin());
+	EXPECT_EQ(sorted(view.entities()), sorted(expected));
+
+	Entity e;
+	e.m_id = 1;
+	e.m_counter = 0;
+	Singleton<RenderableManager>().Create(e);
+	expected.push_back(e);
+
+	size_t visited = 0;
+	view.each([&](Entity _e, auto const&, Engine::Managers::Resource const&)
+	{
+		EXPECT_NE(std::find(expected.begin(), expected.end(), _e), expected.end());
+		visited++;
+	});
+	EXPECT_EQ(visited, expected.size());
+}